@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+
+'''
+Converts a binary FGLogger log (<format>binary</format>) to CSV.
+
+Usage:
+    fglog2csv.py [-d <delimiter>] <in.bin> [<out.csv>]
+
+If <out.csv> is omitted, writes to stdout. See docs-mini/README.logging for
+the file format.
+'''
+
+import struct
+import sys
+
+
+# Column type code => (struct format, size).
+TYPES = {
+        0: ('B', 1),    # bool
+        1: ('i', 4),    # int32
+        2: ('q', 8),    # int64
+        3: ('f', 4),    # float
+        4: ('d', 8),    # double
+        }
+
+
+def read_exact(f, n):
+    data = f.read(n)
+    if len(data) != n:
+        raise EOFError
+    return data
+
+
+def convert(fin, fout, delimiter):
+    if read_exact(fin, 8) != b'FGLOGBIN':
+        raise Exception('not a binary FGLogger file')
+
+    # Work out byte order from the marker written by the logger.
+    version, byte_order = struct.unpack('<II', read_exact(fin, 8))
+    endian = '<'
+    if byte_order != 0x01020304:
+        endian = '>'
+        version, byte_order = struct.unpack('>II', struct.pack('<II', version, byte_order))
+    if version != 1:
+        raise Exception(f'unsupported version {version}')
+
+    ncolumns, = struct.unpack(endian + 'I', read_exact(fin, 4))
+    columns = []
+    for _ in range(ncolumns):
+        code, = struct.unpack('B', read_exact(fin, 1))
+        length, = struct.unpack(endian + 'H', read_exact(fin, 2))
+        title = read_exact(fin, length).decode('utf-8', errors='replace')
+        columns.append((title, TYPES[code]))
+
+    fout.write(delimiter.join(title for title, _ in columns) + '\n')
+
+    while 1:
+        try:
+            nrows, = struct.unpack(endian + 'I', read_exact(fin, 4))
+        except EOFError:
+            break
+        values = []
+        for _, (fmt, size) in columns:
+            values.append(struct.unpack(f'{endian}{nrows}{fmt}', read_exact(fin, nrows * size)))
+        for r in range(nrows):
+            fout.write(delimiter.join(str(column[r]) for column in values) + '\n')
+
+
+if __name__ == '__main__':
+    delimiter = ','
+    paths = []
+    args = iter(sys.argv[1:])
+    for arg in args:
+        if arg == '-d':
+            delimiter = next(args)
+        else:
+            paths.append(arg)
+    if len(paths) not in (1, 2):
+        print(__doc__, file=sys.stderr)
+        sys.exit(1)
+    with open(paths[0], 'rb') as fin:
+        if len(paths) == 2:
+            with open(paths[1], 'w') as fout:
+                convert(fin, fout, delimiter)
+        else:
+            convert(fin, sys.stdout, delimiter)
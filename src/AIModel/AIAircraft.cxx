@@ -152,6 +152,15 @@ void FGAIAircraft::bind() {
                 &FGAIAircraft::_getTransponderCode));
 }
 
+bool FGAIAircraft::getTransponderAltitudeFt(double& altFt) {
+    // assume AI traffic has its transponder switched off while taxiing or
+    // parked (at low speed)
+    if (speed < 40.0)
+        return false;
+    altFt = altitude_ft;
+    return true;
+}
+
 void FGAIAircraft::update(double dt) {
     FGAIBase::update(dt);
     Run(dt);
@@ -46,6 +46,8 @@ public:
     void update(double dt) override;
     void unbind() override;
 
+    bool getTransponderAltitudeFt(double& altFt) override;
+
     void setPerformance(const std::string& acType, const std::string& perfString);
 
     void setFlightPlan(const std::string& fp, bool repat = false);
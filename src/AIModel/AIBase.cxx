@@ -1262,6 +1262,45 @@ SGGeod FGAIBase::getGeodPos() const
     return pos;
 }
 
+bool FGAIBase::getTransponderAltitudeFt(double& altFt)
+{
+    // the node only exists once something (a scenario, Nasal) sets it
+    if (!_transponderAltitudeNode) {
+        _transponderAltitudeNode = props->getNode("instrumentation/transponder/altitude");
+        if (!_transponderAltitudeNode)
+            return false;
+    }
+
+    // -9999 is what src/Instrumentation/transponder.cxx reports when
+    // no altitude is transmitted
+    const int alt = _transponderAltitudeNode->getIntValue();
+    if (alt == -9999)
+        return false;
+    altFt = alt;
+    return true;
+}
+
+bool FGAIBase::isHiddenFromTraffic()
+{
+    if (!_hiddenNode)
+        _hiddenNode = props->getNode("controls/invisible", true);
+    return _hiddenNode->getBoolValue();
+}
+
+SGPropertyNode* FGAIBase::getThreatLevelNode(bool create)
+{
+    if (!_threatLevelNode)
+        _threatLevelNode = props->getNode("tcas/threat-level", create);
+    return _threatLevelNode;
+}
+
+SGPropertyNode* FGAIBase::getRASenseNode()
+{
+    if (!_raSenseNode)
+        _raSenseNode = props->getNode("tcas/ra-sense", true);
+    return _raSenseNode;
+}
+
 void FGAIBase::setGeodPos(const SGGeod& geod)
 {
     pos = geod;
@@ -161,6 +161,27 @@ public:
 
     double getTrueHeadingDeg() const { return hdg; }
 
+    /**
+     * @brief Altitude reported by this object's Mode C transponder, for
+     * traffic surveillance. Returns false if it has no transponder or
+     * is not transmitting an altitude.
+     */
+    virtual bool getTransponderAltitudeFt(double& altFt);
+
+    /**
+     * @brief true if the object is hidden from traffic surveillance by
+     * controls/invisible, e.g. an ignored multiplayer pilot.
+     */
+    bool isHiddenFromTraffic();
+
+    /**
+     * @brief The tcas/threat-level and tcas/ra-sense nodes of this object,
+     * written by TCAS and read by traffic displays. Without create, returns
+     * nullptr while the node doesn't exist.
+     */
+    SGPropertyNode* getThreatLevelNode(bool create = true);
+    SGPropertyNode* getRASenseNode();
+
     double _getCartPosX() const;
     double _getCartPosY() const;
     double _getCartPosZ() const;
@@ -307,6 +328,12 @@ private:
 
     std::vector<std::string> resolveModelPath(ModelSearchOrder searchOrder);
 
+    // traffic surveillance nodes, resolved on first use
+    SGPropertyNode_ptr _hiddenNode;
+    SGPropertyNode_ptr _transponderAltitudeNode;
+    SGPropertyNode_ptr _threatLevelNode;
+    SGPropertyNode_ptr _raSenseNode;
+
 public:
     object_type getType();
 
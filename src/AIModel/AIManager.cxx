@@ -322,6 +322,8 @@ FGAIManager::shutdown()
     }
 
     ai_list.clear();
+    _traffic.clear();
+    _trafficValid = false;
     _environmentVisiblity.clear();
 
     if (_userAircraft) {
@@ -369,6 +371,9 @@ void FGAIManager::removeDeadItem(FGAIBase* base)
 void
 FGAIManager::update(double dt)
 {
+    // the objects are about to move
+    _trafficValid = false;
+
     // initialize these for finding nearest thermals
     range_nearest = 10000.0;
     strength = 0.0;
@@ -446,6 +451,7 @@ FGAIManager::attach(const SGSharedPtr<FGAIBase> &model)
     p = root->getNode(static_cast<std::string>(typeString), i, true);
     model->setManager(this, p);
     ai_list.push_back(model);
+    _trafficValid = false;
 
     model->init(model->getSearchOrder());
     model->bind();
@@ -770,6 +776,63 @@ FGAIManager::calcRangeFt(const SGVec3d& aCartPos, const FGAIBase* aObject) const
     return distM * SG_METER_TO_FEET;
 }
 
+bool
+FGAIManager::TrafficTarget::mayBeWithin(const SGVec3d& aCart, double altFt,
+                                        double rangeM, double verticalRangeFt) const
+{
+    if (fabs(reportedAltFt - altFt) > verticalRangeFt)
+        return false;
+
+    // The straight-line distance is at most the ground range plus the height
+    // difference; the margin allows for ground ranges being measured at sea
+    // level rather than at altitude.
+    const double dzM = fabs(position.getElevationFt() - altFt) * SG_FEET_TO_METER;
+    const double maxDistM = rangeM * 1.01 + dzM;
+    return distSqr(cart, aCart) <= maxDistM * maxDistM;
+}
+
+const FGAIManager::TrafficList&
+FGAIManager::getTraffic()
+{
+    if (_trafficValid)
+        return _traffic;
+
+    _traffic.clear();
+    for (FGAIBase* base : ai_list) {
+        if (base->getDie())
+            continue;
+
+        TrafficTarget t;
+        t.object = base;
+        t.position = SGGeod::fromDegFt(base->_getLongitude(), base->_getLatitude(),
+                                       base->_getAltitude());
+        t.cart = SGVec3d::fromGeod(t.position);
+        t.headingDeg = base->getTrueHeadingDeg();
+        t.speedKt = base->_getSpeed();
+        t.verticalFps = base->_getVS_fps();
+        t.transponder = base->getTransponderAltitudeFt(t.reportedAltFt);
+        if (!t.transponder)
+            t.reportedAltFt = t.position.getElevationFt();
+        t.hidden = base->isHiddenFromTraffic();
+        _traffic.push_back(t);
+    }
+    _trafficValid = true;
+    return _traffic;
+}
+
+void
+FGAIManager::findTraffic(const SGGeod& center, double rangeNm, double verticalRangeFt,
+                         std::vector<const TrafficTarget*>& result)
+{
+    result.clear();
+    const SGVec3d centerCart = SGVec3d::fromGeod(center);
+    const double rangeM = rangeNm * SG_NM_TO_METER;
+    for (const TrafficTarget& t : getTraffic()) {
+        if (t.mayBeWithin(centerCart, center.getElevationFt(), rangeM, verticalRangeFt))
+            result.push_back(&t);
+    }
+}
+
 FGAIAircraft* FGAIManager::getUserAircraft() const
 {
     return _userAircraft.get();
@@ -24,7 +24,9 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
+#include <simgear/math/SGMath.hxx>
 #include <simgear/structure/subsystem_mgr.hxx>
 #include <simgear/structure/SGSharedPtr.hxx>
 
@@ -92,6 +94,48 @@ public:
 
     double calcRangeFt(const SGVec3d& aCartPos, const FGAIBase* aObject) const;
 
+    /**
+     * @brief Kinematics of one live AI or multiplayer object, copied out of
+     * the object so traffic surveillance (TCAS, traffic displays) can scan
+     * all of them without property lookups.
+     */
+    struct TrafficTarget
+    {
+        FGAIBase* object;
+        SGGeod position;        // true altitude
+        SGVec3d cart;
+        double headingDeg;      // true heading
+        double speedKt;         // true airspeed
+        double verticalFps;
+        double reportedAltFt;   // Mode C altitude, or the true altitude without one
+        bool transponder;       // Mode C altitude is being transmitted
+        bool hidden;            // controls/invisible, e.g. an ignored MP pilot
+
+        /**
+         * @brief Coarse check whether the target may be within rangeM (ground
+         * range) of the point aCart at altFt, and its reported altitude within
+         * verticalRangeFt of altFt. Compares straight-line distances only, and
+         * never rejects a target whose ground range is within rangeM.
+         */
+        bool mayBeWithin(const SGVec3d& aCart, double altFt,
+                         double rangeM, double verticalRangeFt) const;
+    };
+    typedef std::vector<TrafficTarget> TrafficList;
+
+    /**
+     * @brief The traffic picture of the current frame, one entry per live AI
+     * object. It is built on first use after each update(); entries are valid
+     * until the next update().
+     */
+    const TrafficList& getTraffic();
+
+    /**
+     * @brief The subset of getTraffic() passing TrafficTarget::mayBeWithin
+     * for the given position.
+     */
+    void findTraffic(const SGGeod& center, double rangeNm, double verticalRangeFt,
+                     std::vector<const TrafficTarget*>& result);
+
     /**
      * @brief Retrieve the representation of the user's aircraft in the AI manager
      * the position and velocity of this object are slaved to the user's aircraft,
@@ -144,6 +188,9 @@ private:
     
     ai_list_type ai_list;
 
+    TrafficList _traffic;
+    bool _trafficValid = false;
+
     double user_altitude_agl = 0.0;
     double user_heading = 0.0;
     double user_pitch = 0.0;
@@ -27,6 +27,7 @@
 
 #include <string>
 #include <stdio.h>
+#include <utility>
 
 #include <Aircraft/replay.hxx>
 #include <Main/globals.hxx>
@@ -39,6 +40,72 @@ using std::string;
 
 // #define SG_DEBUG SG_ALERT
 
+FGMotionHistory::FGMotionHistory(size_t capacity) :
+    mSlots(capacity < 2 ? 2 : capacity)
+{
+}
+
+size_t FGMotionHistory::upperBound(double t) const
+{
+    size_t lo = 0;
+    size_t hi = mSize;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if ((*this)[mid].time > t)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+void FGMotionHistory::insert(double t, FGExternalMotionData& motionInfo)
+{
+    size_t pos = upperBound(t);
+    if (pos > 0 && (*this)[pos - 1].time == t) {
+        (*this)[pos - 1].data.adopt(motionInfo);
+        return;
+    }
+
+    if (mSize == mSlots.size()) {
+        if (pos == 0) {
+            // Older than anything in a full history, it would be dropped
+            // again straight away.
+            motionInfo.clearProperties();
+            ++mDropped;
+            return;
+        }
+        eraseFront(1);
+        ++mDropped;
+        --pos;
+    }
+
+    // Fill the free slot after the newest entry and move it back into
+    // place; only late packets need any moving.
+    Entry& slot = (*this)[mSize];
+    slot.time = t;
+    slot.data.adopt(motionInfo);
+    ++mSize;
+    for (size_t i = mSize - 1; i > pos; --i) {
+        std::swap((*this)[i], (*this)[i - 1]);
+    }
+}
+
+void FGMotionHistory::eraseFront(size_t n)
+{
+    if (n > mSize)
+        n = mSize;
+    mHead = (mHead + n) % mSlots.size();
+    mSize -= n;
+}
+
+void FGMotionHistory::clear()
+{
+    mHead = 0;
+    mSize = 0;
+    mDropped = 0;
+}
+
 FGAIMultiplayer::FGAIMultiplayer() : FGAIBase(object_type::otMultiplayer, fgGetBool("/sim/multiplay/hot", false)),
                                      m_simple_time_enabled(fgGetNode("/sim/time/simple-time/enabled", true)),
                                      m_sim_replay_replay_state(fgGetNode("/sim/replay/replay-state", true)),
@@ -116,6 +183,8 @@ SGRawValueMethods<FGAIMultiplayer, type>(*this, \
         AIMPRWProp(double, playerLag));
     tie("controls/compensate-lag",
         AIMPRWProp(int, compensateLag));
+    tie("motion-history/dropped-packets",
+        AIMPROProp(int, DroppedMotionPackets));
 
 #undef AIMPROProp
 #undef AIMPRWProp
@@ -123,8 +192,8 @@ SGRawValueMethods<FGAIMultiplayer, type>(*this, \
 
 
 void FGAIMultiplayer::FGAIMultiplayerInterpolate(
-        MotionInfo::iterator prevIt,
-        MotionInfo::iterator nextIt,
+        const MotionInfo::Entry& prev,
+        const MotionInfo::Entry& next,
         double tau,
         SGVec3d& ecPos,
         SGQuatf& ecOrient,
@@ -132,27 +201,27 @@ void FGAIMultiplayer::FGAIMultiplayerInterpolate(
         )
 {
     // Here we do just linear interpolation on the position
-    ecPos = interpolate(tau, prevIt->second.position, nextIt->second.position);
-    ecOrient = interpolate((float)tau, prevIt->second.orientation,
-        nextIt->second.orientation);
-    ecLinearVel = interpolate((float)tau, prevIt->second.linearVel, nextIt->second.linearVel);
+    ecPos = interpolate(tau, prev.data.position, next.data.position);
+    ecOrient = interpolate((float)tau, prev.data.orientation,
+        next.data.orientation);
+    ecLinearVel = interpolate((float)tau, prev.data.linearVel, next.data.linearVel);
     speed = norm(ecLinearVel) * SG_METER_TO_NM * 3600.0;
 
-    if (prevIt->second.properties.size() == nextIt->second.properties.size()) {
-        std::vector<FGPropertyData*>::const_iterator prevPropIt;
-        std::vector<FGPropertyData*>::const_iterator prevPropItEnd;
-        std::vector<FGPropertyData*>::const_iterator nextPropIt;
-        std::vector<FGPropertyData*>::const_iterator nextPropItEnd;
+    if (prev.data.properties.size() == next.data.properties.size()) {
+        std::vector<FGPropertyData>::const_iterator prevPropIt;
+        std::vector<FGPropertyData>::const_iterator prevPropItEnd;
+        std::vector<FGPropertyData>::const_iterator nextPropIt;
+        std::vector<FGPropertyData>::const_iterator nextPropItEnd;
 
-        prevPropIt = prevIt->second.properties.begin();
-        prevPropItEnd = prevIt->second.properties.end();
-        nextPropIt = nextIt->second.properties.begin();
-        nextPropItEnd = nextIt->second.properties.end();
+        prevPropIt = prev.data.properties.begin();
+        prevPropItEnd = prev.data.properties.end();
+        nextPropIt = next.data.properties.begin();
+        nextPropItEnd = next.data.properties.end();
 
         while (prevPropIt != prevPropItEnd)
         {
-            PropertyMap::iterator pIt = mPropertyMap.find((*prevPropIt)->id);
-            //cout << " Setting property..." << (*prevPropIt)->id;
+            PropertyMap::iterator pIt = mPropertyMap.find(prevPropIt->id);
+            //cout << " Setting property..." << prevPropIt->id;
 
             if (pIt != mPropertyMap.end())
             {
@@ -170,9 +239,9 @@ void FGAIMultiplayer::FGAIMultiplayerInterpolate(
                  * this by only considering properties where the previous and next id are the same.
                  * It might be a better solution to search the previous and next lists to locate the matching id's
                  */
-                if (*nextPropIt && (*nextPropIt)->id == (*prevPropIt)->id)
+                if (nextPropIt->id == prevPropIt->id)
                 {
-                    switch ((*prevPropIt)->type)
+                    switch (prevPropIt->type)
                     {
                         case simgear::props::INT:
                         case simgear::props::BOOL:
@@ -180,29 +249,29 @@ void FGAIMultiplayer::FGAIMultiplayerInterpolate(
                             // Jean Pellotier, 2018-01-02 : we don't want interpolation for integer values, they are mostly used
                             // for non linearly changing values (e.g. transponder etc ...)
                             // fixes: https://sourceforge.net/p/flightgear/codetickets/1885/
-                            pIt->second->setIntValue((*nextPropIt)->int_value);
+                            pIt->second->setIntValue(nextPropIt->int_value);
                             break;
 
                         case simgear::props::FLOAT:
                         case simgear::props::DOUBLE:
                             {
-                                float val = (1 - tau)*(*prevPropIt)->float_value +
-                                            tau*(*nextPropIt)->float_value;
+                                float val = (1 - tau)*prevPropIt->float_value +
+                                            tau*nextPropIt->float_value;
                                 pIt->second->setFloatValue(val);
                             }
                             break;
                         
                         case simgear::props::STRING:
                         case simgear::props::UNSPECIFIED:
-                            //cout << "Str: " << (*nextPropIt)->string_value << "\n";
-                            pIt->second->setStringValue((*nextPropIt)->string_value);
+                            //cout << "Str: " << nextPropIt->string_value << "\n";
+                            pIt->second->setStringValue(nextPropIt->string_value);
                             break;
 
                         default:
                             // FIXME - currently defaults to float values
                             {
-                                float val = (1 - tau)*(*prevPropIt)->float_value +
-                                            tau*(*nextPropIt)->float_value;
+                                float val = (1 - tau)*prevPropIt->float_value +
+                                            tau*nextPropIt->float_value;
                                 pIt->second->setFloatValue(val);
                             }
                             break;
@@ -210,12 +279,12 @@ void FGAIMultiplayer::FGAIMultiplayerInterpolate(
                 }
                 else
                 {
-                    SG_LOG(SG_AI, SG_WARN, "MP packet mismatch during lag interpolation: " << (*prevPropIt)->id << " != " << (*nextPropIt)->id << "\n");
+                    SG_LOG(SG_AI, SG_WARN, "MP packet mismatch during lag interpolation: " << prevPropIt->id << " != " << nextPropIt->id << "\n");
                 }
             }
             else
             {
-                SG_LOG(SG_AI, SG_DEBUG, "Unable to find property: " << (*prevPropIt)->id << "\n");
+                SG_LOG(SG_AI, SG_DEBUG, "Unable to find property: " << prevPropIt->id << "\n");
             }
 
             ++prevPropIt;
@@ -225,7 +294,7 @@ void FGAIMultiplayer::FGAIMultiplayerInterpolate(
 }
 
 void FGAIMultiplayer::FGAIMultiplayerExtrapolate(
-        MotionInfo::iterator nextIt,
+        const MotionInfo::Entry& next,
         double tInterp,
         bool motion_logging,
         SGVec3d& ecPos,
@@ -233,12 +302,12 @@ void FGAIMultiplayer::FGAIMultiplayerExtrapolate(
         SGVec3f& ecLinearVel
         )
 {
-    const FGExternalMotionData& motionInfo = nextIt->second;
+    const FGExternalMotionData& motionInfo = next.data;
 
     // The time to predict, limit to 3 seconds. But don't do this if we are
     // running motion tests, because it can mess up the results.
     //
-    double t = tInterp - nextIt->first;
+    double t = tInterp - next.time;
     if (!motion_logging)
     {
         props->setDoubleValue("lag/extrapolation-t", t);
@@ -285,46 +354,46 @@ void FGAIMultiplayer::FGAIMultiplayerExtrapolate(
         ecPos += t*(ecVel);
     }
 
-    std::vector<FGPropertyData*>::const_iterator firstPropIt;
-    std::vector<FGPropertyData*>::const_iterator firstPropItEnd;
+    std::vector<FGPropertyData>::const_iterator firstPropIt;
+    std::vector<FGPropertyData>::const_iterator firstPropItEnd;
     speed = norm(ecLinearVel) * SG_METER_TO_NM * 3600.0;
     firstPropIt = motionInfo.properties.begin();
     firstPropItEnd = motionInfo.properties.end();
     while (firstPropIt != firstPropItEnd)
     {
-        PropertyMap::iterator pIt = mPropertyMap.find((*firstPropIt)->id);
-        //cout << " Setting property..." << (*firstPropIt)->id;
+        PropertyMap::iterator pIt = mPropertyMap.find(firstPropIt->id);
+        //cout << " Setting property..." << firstPropIt->id;
 
         if (pIt != mPropertyMap.end())
         {
-            switch ((*firstPropIt)->type)
+            switch (firstPropIt->type)
             {
               case simgear::props::INT:
               case simgear::props::BOOL:
               case simgear::props::LONG:
-                  pIt->second->setIntValue((*firstPropIt)->int_value);
-                  //cout << "Int: " << (*firstPropIt)->int_value << "\n";
+                  pIt->second->setIntValue(firstPropIt->int_value);
+                  //cout << "Int: " << firstPropIt->int_value << "\n";
                   break;
               case simgear::props::FLOAT:
               case simgear::props::DOUBLE:
-                  pIt->second->setFloatValue((*firstPropIt)->float_value);
-                  //cout << "Flo: " << (*firstPropIt)->float_value << "\n";
+                  pIt->second->setFloatValue(firstPropIt->float_value);
+                  //cout << "Flo: " << firstPropIt->float_value << "\n";
                   break;
               case simgear::props::STRING:
               case simgear::props::UNSPECIFIED:
-                  pIt->second->setStringValue((*firstPropIt)->string_value);
-                  //cout << "Str: " << (*firstPropIt)->string_value << "\n";
+                  pIt->second->setStringValue(firstPropIt->string_value);
+                  //cout << "Str: " << firstPropIt->string_value << "\n";
                   break;
               default:
                   // FIXME - currently defaults to float values
-                  pIt->second->setFloatValue((*firstPropIt)->float_value);
-                  //cout << "Unk: " << (*firstPropIt)->float_value << "\n";
+                  pIt->second->setFloatValue(firstPropIt->float_value);
+                  //cout << "Unk: " << firstPropIt->float_value << "\n";
                   break;
             }
         }
         else
         {
-            SG_LOG(SG_AI, SG_DEBUG, "Unable to find property: " << (*firstPropIt)->id << "\n");
+            SG_LOG(SG_AI, SG_DEBUG, "Unable to find property: " << firstPropIt->id << "\n");
         }
 
         ++firstPropIt;
@@ -460,8 +529,8 @@ void FGAIMultiplayer::update(double dt)
     else
     {
         // Get the last available time
-        MotionInfo::reverse_iterator motioninfo_back = mMotionInfo.rbegin();
-        const double curentPkgTime = motioninfo_back->first;
+        const MotionInfo::Entry& motioninfo_back = mMotionInfo.back();
+        const double curentPkgTime = motioninfo_back.time;
 
         // The current simulation time we need to update for,
         // note that the simulation time is updated before calling all the
@@ -478,7 +547,7 @@ void FGAIMultiplayer::update(double dt)
         // component will provide this. We just take the error of the currently
         // requested time to the most recent available packet. This is the
         // target we want to reach in average.
-        double lag = motioninfo_back->second.lag;
+        double lag = motioninfo_back.data.lag;
 
         rawLag = curentPkgTime - curtime;
         realTime = false; //default behaviour
@@ -587,7 +656,7 @@ void FGAIMultiplayer::update(double dt)
                     SG_LOG(SG_AI, SG_DEBUG, "Offset adjust system: time offset = "
                          << mTimeOffset << ", expected longitudinal position error due to "
                          " current adjustment of the offset: "
-                         << fabs(norm(motioninfo_back->second.linearVel)*systemIncrement));
+                         << fabs(norm(motioninfo_back.data.linearVel)*systemIncrement));
                 }
             }
         }
@@ -601,27 +670,27 @@ void FGAIMultiplayer::update(double dt)
     SGQuatf ecOrient;
     SGVec3f ecLinearVel;
 
-    MotionInfo::iterator nextIt = mMotionInfo.upper_bound(tInterp);
-    MotionInfo::iterator prevIt = nextIt;
+    size_t next = mMotionInfo.upperBound(tInterp);
+    size_t prev = next;
     
-    if (nextIt != mMotionInfo.end() && nextIt->first >= tInterp)
+    if (next != mMotionInfo.size() && mMotionInfo[next].time >= tInterp)
     {
         // Ok, we need a time prevous to the last available packet,
         // that is good ...
         // the case tInterp = curentPkgTime need to be in the interpolation, to avoid a bug zeroing the position
 
         double tau = 0;
-        if (nextIt == mMotionInfo.begin())
+        if (next == 0)
         {
-            // Leave prevIt and nextIt pointing at same item.
+            // Leave prev and next pointing at same item.
             SG_LOG(SG_GENERAL, SG_DEBUG, "Only one frame for interpolation: " << _callsign);
         }
         else
         {
-            --prevIt;
+            --prev;
             // Interpolation coefficient is between 0 and 1
-            double intervalStart = prevIt->first;
-            double intervalEnd = nextIt->first;
+            double intervalStart = mMotionInfo[prev].time;
+            double intervalEnd = mMotionInfo[next].time;
 
             double intervalLen = intervalEnd - intervalStart;
             if (intervalLen != 0.0)
@@ -630,21 +699,21 @@ void FGAIMultiplayer::update(double dt)
             }
         }
         
-        FGAIMultiplayerInterpolate(prevIt, nextIt, tau, ecPos, ecOrient, ecLinearVel);
+        FGAIMultiplayerInterpolate(mMotionInfo[prev], mMotionInfo[next], tau, ecPos, ecOrient, ecLinearVel);
     }
     else
     {
         // Ok, we need to predict the future, so, take the best data we can have
         // and do some eom computation to guess that for now.
-        --nextIt;
-        --prevIt;   // so mMotionInfo.erase() does the right thing below.
-        FGAIMultiplayerExtrapolate(nextIt, tInterp, motion_logging, ecPos, ecOrient, ecLinearVel);
+        --next;
+        --prev;   // so mMotionInfo.eraseFront() does the right thing below.
+        FGAIMultiplayerExtrapolate(mMotionInfo[next], tInterp, motion_logging, ecPos, ecOrient, ecLinearVel);
     }
 
-    // Remove any motion information before <prevIt> - we will not need this in
+    // Remove any motion information before <prev> - we will not need this in
     // the future.
     //
-    mMotionInfo.erase(mMotionInfo.begin(), prevIt);
+    mMotionInfo.eraseFront(prev);
     
     // extract the position
     pos = SGGeod::fromCart(ecPos);
@@ -861,20 +930,19 @@ FGAIMultiplayer::addMotionInfo(FGExternalMotionData& motionInfo,
         // m_time_compensation is set to non-zero if packets seem to have
         // wildly different times from us, if simple-time mode is enabled.
         //
-        // So most code with an <iterator> into mMotionInfo that needs to
-        // use the MP packet's time, will actuall use iterator->first, not
-        // iterator->second.time..
+        // So most code with an entry of mMotionInfo that needs to
+        // use the MP packet's time, will actuall use entry.time, not
+        // entry.data.time..
         //
-        mMotionInfo[t_key] = motionInfo;
+        mMotionInfo.insert(t_key, motionInfo);
     }
     else
     {
-        mMotionInfo[motionInfo.time] = motionInfo;
+        mMotionInfo.insert(motionInfo.time, motionInfo);
     }
 
-    // We just copied the property (pointer) list - they are ours now. Clear the
-    // properties list in given/returned object, so former owner won't deallocate them.
-    motionInfo.properties.clear();
+    // The properties are ours now; motionInfo was handed the storage of the
+    // recycled history slot, cleared, and only its kinematic state remains.
   
     {
         // Gather data on multiplayer speed, used by scripts/python/recordreplay.py.
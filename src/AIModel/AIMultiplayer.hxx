@@ -23,11 +23,58 @@
 #include <map>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <MultiPlayer/mpmessages.hxx>
 
 #include "AIBase.hxx"
 
+// Fixed capacity history of received motion packets, kept sorted by key time
+// in a ring of recycled slots. Packets normally arrive in order and are
+// appended; late packets are moved into place. When the ring is full the
+// oldest packet is dropped, and counted in dropped(). The default capacity
+// of 64 packets covers several seconds of history at the usual send rates;
+// the caller prunes older entries with eraseFront().
+class FGMotionHistory {
+public:
+  struct Entry {
+    // Key time: the packet time, possibly compensated for clock offsets.
+    double time = 0.0;
+    FGExternalMotionData data;
+  };
+
+  explicit FGMotionHistory(size_t capacity = 64);
+
+  bool empty() const { return mSize == 0; }
+  size_t size() const { return mSize; }
+  size_t capacity() const { return mSlots.size(); }
+
+  // Packets lost because the history was full: the oldest entries which were
+  // overwritten, and packets older than a full history. Reset by clear().
+  size_t dropped() const { return mDropped; }
+
+  Entry& operator[](size_t i) { return mSlots[(mHead + i) % mSlots.size()]; }
+  const Entry& operator[](size_t i) const { return mSlots[(mHead + i) % mSlots.size()]; }
+  Entry& back() { return (*this)[mSize - 1]; }
+
+  // Index of the first entry with a time greater than t, or size().
+  size_t upperBound(double t) const;
+
+  // Take over motionInfo at key time t. An entry with the same time is
+  // replaced. motionInfo is left with recycled, empty property storage.
+  void insert(double t, FGExternalMotionData& motionInfo);
+
+  // Drop the n oldest entries.
+  void eraseFront(size_t n);
+  void clear();
+
+private:
+  std::vector<Entry> mSlots;
+  size_t mHead = 0;
+  size_t mSize = 0;
+  size_t mDropped = 0;
+};
+
 class FGAIMultiplayer : public FGAIBase {
 public:
   FGAIMultiplayer();
@@ -66,6 +113,11 @@ public:
     mLagAdjustSystemSpeed = lagAdjustSystemSpeed;
   }
   
+  int getDroppedMotionPackets(void) const
+  {
+    return static_cast<int>(mMotionInfo.dropped());
+  }
+
   double getLagAdjustSystemSpeed(void) const
   {
     return mLagAdjustSystemSpeed;
@@ -105,8 +157,8 @@ public:
 
 private:
 
-  // Automatic sorting of motion data according to its timestamp
-  typedef std::map<double,FGExternalMotionData> MotionInfo;
+  // Motion data sorted according to its timestamp
+  typedef FGMotionHistory MotionInfo;
   MotionInfo mMotionInfo;
 
   // Map between the property id's from the multiplayers network packets
@@ -115,14 +167,14 @@ private:
   PropertyMap mPropertyMap;
   
   // Calculates position, orientation and velocity using interpolation between
-  // *prevIt and *nextIt, specifically (1-tau)*(*prevIt) + tau*(*nextIt).
+  // prev and next, specifically (1-tau)*prev + tau*next.
   //
   // Cannot call this method 'interpolate' because that would hide the name in
   // OSG.
   //
   void FGAIMultiplayerInterpolate(
-        MotionInfo::iterator prevIt,
-        MotionInfo::iterator nextIt,
+        const MotionInfo::Entry& prev,
+        const MotionInfo::Entry& next,
         double tau,
         SGVec3d& ecPos,
         SGQuatf& ecOrient,
@@ -130,10 +182,10 @@ private:
         );
 
   // Calculates position, orientation and velocity using extrapolation from
-  // *nextIt.
+  // next.
   //
   void FGAIMultiplayerExtrapolate(
-        MotionInfo::iterator nextIt,
+        const MotionInfo::Entry& next,
         double tInterp,
         bool motion_logging,
         SGVec3d& ecPos,
@@ -85,6 +85,14 @@ void FGAISwiftAircraft::setPlaneTransponder(const AircraftTransponder& transpond
     m_transponderIdentNode->setBoolValue(transponder.ident);
 }
 
+bool FGAISwiftAircraft::getTransponderAltitudeFt(double& altFt)
+{
+    if (!m_transponderCModeNode || !m_transponderCModeNode->getBoolValue())
+        return false;
+    altFt = altitude_ft;
+    return true;
+}
+
 void FGAISwiftAircraft::initProps()
 {
     // Setup node properties
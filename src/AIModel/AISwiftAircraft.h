@@ -75,6 +75,7 @@ public:
 
     string_view getTypeString() const override { return "swift"; }
     void update(double dt) override;
+    bool getTransponderAltitudeFt(double& altFt) override;
 
     void updatePosition(SGGeod& position, SGVec3<double>& orientation, double groundspeed, bool initPos);
     double getGroundElevation(const SGGeod& pos) const;
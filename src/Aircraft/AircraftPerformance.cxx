@@ -31,7 +31,60 @@ double distanceForTimeAndSpeeds(double tSec, double v1, double v2)
     return tSec * 0.5 * (v1 + v2);
 }
 
-AircraftPerformance::AircraftPerformance()
+namespace {
+
+// Counts changes under /aircraft/performance: value changes and added or
+// removed children anywhere below it are reported to the listener there.
+class PerformanceListener : public SGPropertyChangeListener
+{
+public:
+    ~PerformanceListener() override
+    {
+        if (_node) {
+            _node->removeChangeListener(this);
+        }
+    }
+
+    unsigned int revision()
+    {
+        // a reset replaces the property tree, which orphans our node
+        if (!_node || !_node->getParent() || _node->getAttribute(SGPropertyNode::REMOVED)) {
+            if (_node) {
+                _node->removeChangeListener(this);
+            }
+
+            _node = fgGetNode("/aircraft/performance", true);
+            _node->addChangeListener(this);
+            ++_revision;
+        }
+
+        return _revision;
+    }
+
+    void valueChanged(SGPropertyNode*) override { ++_revision; }
+    void childAdded(SGPropertyNode*, SGPropertyNode*) override { ++_revision; }
+    void childRemoved(SGPropertyNode*, SGPropertyNode*) override { ++_revision; }
+
+private:
+    SGPropertyNode_ptr _node;
+    unsigned int _revision = 0;
+};
+
+PerformanceListener& performanceListener()
+{
+    static PerformanceListener listener;
+    return listener;
+}
+
+} // of anonymous namespace
+
+unsigned int AircraftPerformance::dataRevision()
+{
+    return performanceListener().revision();
+}
+
+AircraftPerformance::AircraftPerformance() :
+    _revision(dataRevision())
 {
     // read aircraft supplied performance data
     if (fgGetNode("/aircraft/performance/bracket")) {
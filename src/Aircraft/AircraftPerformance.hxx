@@ -41,6 +41,16 @@ class AircraftPerformance
 public:
     AircraftPerformance();
 
+    /**
+     * Changes whenever anything under /aircraft/performance changes, or
+     * the aircraft (and so the property tree) is replaced. Cheap enough to
+     * poll: compare it with revision() to see if the data is stale.
+     */
+    static unsigned int dataRevision();
+
+    /// the dataRevision() this instance read its data at
+    unsigned int revision() const { return _revision; }
+
     double turnRateDegSec() const;
 
     double turnRadiusMForAltitude(int altitudeFt) const;
@@ -110,6 +120,7 @@ private:
 
 
     PerformanceVec _perfData;
+    unsigned int _revision = 0;
 };
 
 }
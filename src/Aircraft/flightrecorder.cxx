@@ -272,6 +272,7 @@ FGFlightRecorder::reinit(SGPropertyNode_ptr ConfigNode)
     m_CaptureInt16.clear();
     m_CaptureInt8.clear();
     m_CaptureBool.clear();
+    m_ReplayNodes.clear();
 
     m_ConfigNode = ConfigNode;
 
@@ -753,28 +754,87 @@ static void string_to_double(const std::string& s, double& out, bool& ok)
     ok = true;
 }
 
+/* Returns the cached node for extra property <path>, resolving it in the
+global property tree (creating it if necessary) the first time it is seen. The
+interpolation type is derived from the path suffix once at the same time. */
+const FlightRecorder::TReplayNode&
+FGFlightRecorder::getReplayNode(const std::string& path)
+{
+    auto it = m_ReplayNodes.find(path);
+    if (it != m_ReplayNodes.end())
+    {
+        SGPropertyNode* node = it->second.Node;
+        if (node && !node->getAttribute(SGPropertyNode::REMOVED))
+        {
+            return it->second;
+        }
+    }
+    else
+    {
+        it = m_ReplayNodes.emplace(path, TReplayNode()).first;
+    }
+
+    TReplayNode& entry = it->second;
+    entry.Node = globals->get_props()->getNode(path, true /*create*/);
+    entry.Interpolation = TInterpolation::linear;
+    if (simgear::strutils::ends_with(path, "-deg"))
+    {
+        entry.Interpolation = TInterpolation::angular_deg;
+    }
+    else if (simgear::strutils::ends_with(path, "-rad"))
+    {
+        entry.Interpolation = TInterpolation::angular_rad;
+    }
+    return entry;
+}
+
+/* Forgets cached nodes for <path> and everything below it. Called when the
+tape removes a property, because the nodes are then detached from the tree. */
+void
+FGFlightRecorder::invalidateReplayNodes(const std::string& path)
+{
+    auto it = m_ReplayNodes.lower_bound(path);
+    while (it != m_ReplayNodes.end())
+    {
+        const std::string& key = it->first;
+        if (key.compare(0, path.size(), path) != 0)
+        {
+            break;
+        }
+        if (key.size() == path.size() || key[path.size()] == '/' || key[path.size()] == '[')
+        {
+            it = m_ReplayNodes.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
 /* Updates property <path> to <value_next_string>. If property is also in
 <frame_prev> and values look like floating point, we interpolate using <ratio>.
+If <batch> is not null, interpolated values are appended to it instead of being
+written immediately; the caller then applies them with replayInterpolated().
 */
-static void replayProperty(
+void
+FGFlightRecorder::replayProperty(
         const std::string& path,
         const std::string& value_next_string,
         const FGReplayData* frame_prev,
-        double ratio
+        double ratio,
+        FlightRecorder::TReplayInterpolation* batch
         )
 {
-    SGPropertyNode* p = globals->get_props()->getNode(path, true /*create*/);
-    bool done = false;
+    const TReplayNode& entry = getReplayNode(path);
+    SGPropertyNode* p = entry.Node;
     if (frame_prev)
     {
         /* Check whether <path> is in frame_prev's list of property changes. */
-        SG_LOG(SG_SYSTEMS, SG_DEBUG, "p && _pLastBuffer");
         auto p_prev_it = frame_prev->replay_extra_property_changes.find(path);
         if (p_prev_it != frame_prev->replay_extra_property_changes.end())
         {
             /* Property <path> is also in frame_prev. */
-            SG_LOG(SG_SYSTEMS, SG_DEBUG, "property in frame_prev and frame_next:"
-                    << " " << path);
             const std::string&  value_prev_string = p_prev_it->second;
             bool value_prev_ok;
             bool value_next_ok;
@@ -785,33 +845,52 @@ static void replayProperty(
             if (value_prev_ok && value_next_ok)
             {
                 /* Both values look like floating point so we interpolate. */
-                SG_LOG(SG_SYSTEMS, SG_DEBUG, "property is fp");
-                TInterpolation  interpolation = TInterpolation::linear;
-                if (simgear::strutils::ends_with(path, "-deg"))
+                if (batch)
                 {
-                    interpolation = TInterpolation::angular_deg;
+                    batch->Nodes.push_back(p);
+                    batch->Interpolations.push_back(entry.Interpolation);
+                    batch->Prev.push_back(value_prev);
+                    batch->Next.push_back(value_next);
                 }
-                else if (simgear::strutils::ends_with(path, "-rad"))
+                else
                 {
-                    interpolation = TInterpolation::angular_rad;
+                    double value_interpolated = weighting(
+                            entry.Interpolation,
+                            ratio,
+                            value_prev,
+                            value_next
+                            );
+                    SG_LOG(SG_GENERAL, SG_DEBUG, "Interpolating " << path
+                            << ": [" << value_prev << " .. " << value_next
+                            << "] => " << value_interpolated
+                            );
+                    p->setDoubleValue(value_interpolated);
                 }
-                SG_LOG(SG_SYSTEMS, SG_DEBUG, "calling weighting() ratio=" << ratio);
-                double value_interpolated = weighting(
-                        interpolation,
-                        ratio,
-                        value_prev,
-                        value_next
-                        );
-                SG_LOG(SG_GENERAL, SG_DEBUG, "Interpolating " << path
-                        << ": [" << value_prev << " .. " << value_next
-                        << "] => " << value_interpolated
-                        );
-                globals->get_props()->setDoubleValue(path, value_interpolated);
-                done = true;
+                return;
             }
         }
     }
-    if (!done) p->setStringValue(path, value_next_string);
+    p->setStringValue(value_next_string);
+}
+
+/* Interpolates and writes all properties collected in <batch>, then empties
+it while keeping its storage for the next frame. */
+void
+FGFlightRecorder::replayInterpolated(FlightRecorder::TReplayInterpolation& batch, double ratio)
+{
+    const size_t n = batch.Nodes.size();
+    for (size_t i=0; i<n; i++)
+    {
+        batch.Next[i] = weighting(batch.Interpolations[i], ratio, batch.Prev[i], batch.Next[i]);
+    }
+    for (size_t i=0; i<n; i++)
+    {
+        batch.Nodes[i]->setDoubleValue(batch.Next[i]);
+    }
+    batch.Nodes.clear();
+    batch.Interpolations.clear();
+    batch.Prev.clear();
+    batch.Next.clear();
 }
 
 /** Replay.
@@ -984,6 +1063,7 @@ FGFlightRecorder::replay(double SimTime, const FGReplayData* _pNextBuffer,
     if (replay_extra_properties) {
         for (auto extra_property_removed_path: _pNextBuffer->replay_extra_property_removals) {
             SG_LOG(SG_SYSTEMS, SG_DEBUG, "replaying extra property removal: " << extra_property_removed_path);
+            invalidateReplayNodes(extra_property_removed_path);
             globals->get_props()->removeChild(extra_property_removed_path);
         }
     }
@@ -998,17 +1078,17 @@ FGFlightRecorder::replay(double SimTime, const FGReplayData* _pNextBuffer,
     // property so when recording we don't always pick up all changes.
     //
     if (replay_main_view) {
-        for (auto prop_change: _pNextBuffer->replay_extra_property_changes) {
+        for (const auto& prop_change: _pNextBuffer->replay_extra_property_changes) {
             const std::string& path = prop_change.first;
             const std::string& value = prop_change.second;
             if (simgear::strutils::starts_with(path, "/sim/current-view/view-number")) {
                 SG_LOG(SG_SYSTEMS, SG_DEBUG, "SimTime=" << SimTime << " replaying view " << path << "=" << value);
-                globals->get_props()->setStringValue(path, value);
+                getReplayNode(path).Node->setStringValue(value);
             }
         }
     }
     
-    for (auto prop_change: _pNextBuffer->replay_extra_property_changes) {
+    for (const auto& prop_change: _pNextBuffer->replay_extra_property_changes) {
         const std::string& path = prop_change.first;
         const std::string& value = prop_change.second;
         
@@ -1030,58 +1110,16 @@ FGFlightRecorder::replay(double SimTime, const FGReplayData* _pNextBuffer,
                 SG_LOG(SG_SYSTEMS, SG_DEBUG, "SimTime=" << SimTime
                         << " replaying view change: " << path << "=" << value);
                 /* Interpolate floating point values if possible. */
-                replayProperty(path, value, _pLastBuffer, ratio);
+                replayProperty(path, value, _pLastBuffer, ratio, nullptr);
             }
         }
         else if (replay_extra_properties) {
             SG_LOG(SG_SYSTEMS, SG_DEBUG, "SimTime=" << SimTime
                     << " replaying extra_property change: " << path << "=" << value);
-            SGPropertyNode* p = globals->get_props()->getNode(path, true /*create*/);
-            bool done = false;
-            if (p && _pLastBuffer) {
-                SG_LOG(SG_SYSTEMS, SG_DEBUG, "p && _pLastBuffer");
-                auto p_prev_it = _pLastBuffer->replay_extra_property_changes.find(path);
-                if (p_prev_it != _pLastBuffer->replay_extra_property_changes.end()) {
-                    /* Property <path> is in both _pLastBuffer and
-                    _pNextBuffer, so if it is floating point, we will
-                    interpolate. */
-                    SG_LOG(SG_SYSTEMS, SG_DEBUG, "property in _pLastBuffer and _pNextBuffer:"
-                            << " " << path);
-                    const std::string&  valus_prev = p_prev_it->second;
-                    size_t  value_prev_len;
-                    size_t  value_next_len;
-                    double value_prev = std::stod(valus_prev, &value_prev_len);
-                    double value_next = std::stod(value, &value_next_len);
-                    if (value_prev_len == valus_prev.size() && value_next_len == value.size()) {
-                        /* Both values look like floating point so we will
-                        interpolate. */
-                        SG_LOG(SG_SYSTEMS, SG_DEBUG, "property is fp");
-                        TInterpolation  interpolation = TInterpolation::linear;
-                        if (simgear::strutils::ends_with(path, "-deg")) {
-                            interpolation = TInterpolation::angular_deg;
-                        }
-                        else if (simgear::strutils::ends_with(path, "-rad")) {
-                            interpolation = TInterpolation::angular_rad;
-                        }
-                        SG_LOG(SG_SYSTEMS, SG_DEBUG, "calling weighting()");
-                        double value_interpolated = weighting(
-                                interpolation,
-                                ratio,
-                                value_prev,
-                                value_next
-                                );
-                        SG_LOG(SG_GENERAL, SG_DEBUG, "Interpolating " << path
-                                << ": [" << value_prev << " .. " << value_next
-                                << "] => " << value_interpolated
-                                );
-                        globals->get_props()->setDoubleValue(path, value_interpolated);
-                        done = true;
-                    }
-                }
-            }
-            if (!done) p->setStringValue(path, value);
+            replayProperty(path, value, _pLastBuffer, ratio, &m_ReplayInterpolation);
         }
     }
+    replayInterpolated(m_ReplayInterpolation, ratio);
 }
 
 int
@@ -23,6 +23,10 @@
 #ifndef FLIGHTRECORDER_HXX_
 #define FLIGHTRECORDER_HXX_
 
+#include <map>
+#include <string>
+#include <vector>
+
 #include <simgear/props/props.hxx>
 #include <MultiPlayer/multiplaymgr.hxx>
 #include "replay-internal.hxx"
@@ -46,6 +50,26 @@ namespace FlightRecorder
 
     typedef std::vector<TCapture> TSignalList;
 
+    // Resolved node for an extra property path seen in a replay tape.
+    typedef struct
+    {
+        SGPropertyNode_ptr  Node;
+        TInterpolation      Interpolation;
+    } TReplayNode;
+
+    typedef std::map<std::string, TReplayNode> TReplayNodeMap;
+
+    // Extra properties that are numeric in both the previous and next frame,
+    // collected into contiguous arrays so that they can be interpolated and
+    // written in a single pass.
+    typedef struct
+    {
+        std::vector<SGPropertyNode*>    Nodes;
+        std::vector<TInterpolation>     Interpolations;
+        std::vector<double>             Prev;
+        std::vector<double>             Next;
+    } TReplayInterpolation;
+
 }
 
 class FGFlightRecorder
@@ -81,6 +105,13 @@ private:
     bool haveProperty(FlightRecorder::TSignalList& Capture,SGPropertyNode* pProperty);
     bool haveProperty(SGPropertyNode* pProperty);
 
+    const FlightRecorder::TReplayNode& getReplayNode(const std::string& path);
+    void invalidateReplayNodes(const std::string& path);
+    void replayProperty(const std::string& path, const std::string& value_next,
+                        const FGReplayData* frame_prev, double ratio,
+                        FlightRecorder::TReplayInterpolation* batch);
+    void replayInterpolated(FlightRecorder::TReplayInterpolation& batch, double ratio);
+
     int  getConfig(SGPropertyNode* root, const char* typeStr, const FlightRecorder::TSignalList& SignalList);
 
     SGPropertyNode_ptr m_RecorderNode;
@@ -109,6 +140,12 @@ private:
     FlightRecorder::TSignalList m_CaptureInt8;
     FlightRecorder::TSignalList m_CaptureBool;
 
+    // Extra property paths of the current tape resolved to nodes, so that
+    // replay does not walk the property tree for every property and frame.
+    // Cleared on reinit() and pruned when the tape removes a property.
+    FlightRecorder::TReplayNodeMap m_ReplayNodes;
+    FlightRecorder::TReplayInterpolation m_ReplayInterpolation;
+
     unsigned m_TotalRecordSize;
     std::string m_ConfigName;
     bool m_usingDefaultConfig;
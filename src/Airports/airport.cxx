@@ -47,6 +47,7 @@
 #include <Navaids/waypoint.hxx>
 #include <ATC/CommStation.hxx>
 #include <Navaids/NavDataCache.hxx>
+#include <Navaids/ProcedureCache.hxx>
 #include <Navaids/navrecord.hxx>
 #include <Navaids/positioned.hxx>
 #include <Airports/groundnetwork.hxx>
@@ -519,9 +520,10 @@ FGAirportRef FGAirport::getByIdent(const std::string& aIdent)
   return r;
 }
 
-char** FGAirport::searchNamesAndIdents(const std::string& aFilter)
+char** FGAirport::searchNamesAndIdents(const std::string& aFilter,
+                                       unsigned int maxResults)
 {
-  return NavDataCache::instance()->searchAirportNamesAndIdents(aFilter);
+  return NavDataCache::instance()->searchAirportNamesAndIdents(aFilter, maxResults);
 }
 
 // find basic airport location info from airport database
@@ -592,6 +594,18 @@ void FGAirport::loadProcedures() const
   RouteBase::loadAirportProcedures(path, const_cast<FGAirport*>(this));
 }
 
+void FGAirport::prefetchProcedures() const
+{
+  if (mProceduresLoaded) {
+    return;
+  }
+
+  SGPath path;
+  if (XMLLoader::findAirportData(ident(), "procedures", path)) {
+    flightgear::ProcedureCache::prefetch(path);
+  }
+}
+
 void FGAirport::loadRunwayRenames() const
 {
     if (mRunwayRenamesLoaded) {
@@ -1051,6 +1065,15 @@ FGAirportDynamicsRef FGAirport::getDynamics() const
 
 FGGroundNetwork *FGAirport::groundNetwork() const
 {
+    if (_groundNetworkLoad.valid()) {
+        const SGPath errorPath = _groundNetworkLoad.get();
+        _groundNetwork = std::move(_loadingGroundNetwork);
+        if (!errorPath.isNull()) {
+            XMLLoader::reportGroundnetErrors(_groundNetwork.get(), errorPath);
+        }
+        _groundNetwork->init();
+    }
+
     if (!_groundNetwork.get()) {
         _groundNetwork.reset(new FGGroundNetwork(const_cast<FGAirport*>(this)));
         XMLLoader::load(_groundNetwork.get());
@@ -1060,6 +1083,32 @@ FGGroundNetwork *FGAirport::groundNetwork() const
     return _groundNetwork.get();
 }
 
+void FGAirport::prefetchGroundNetwork() const
+{
+    if (_groundNetwork.get() || _groundNetworkLoad.valid()) {
+        return;
+    }
+
+    if (!fgGetBool("/sim/ai/groundnet-background-load", true)) {
+        return;
+    }
+
+    std::unique_ptr<FGGroundNetwork> net(new FGGroundNetwork(const_cast<FGAirport*>(this)));
+    SGPath path, cachePath;
+    if (!XMLLoader::findGroundnet(net.get(), path, cachePath)) {
+        // nothing to parse, install the empty network right away
+        _groundNetwork = std::move(net);
+        _groundNetwork->init();
+        return;
+    }
+
+    FGGroundNetwork* loading = net.get();
+    _loadingGroundNetwork = std::move(net);
+    _groundNetworkLoad = std::async(std::launch::async, [loading, path, cachePath]() {
+        return XMLLoader::loadGroundnet(loading, path, cachePath) ? path : SGPath();
+    });
+}
+
 flightgear::Transition* FGAirport::selectSIDByEnrouteTransition(FGPositioned* enroute) const
 {
     loadProcedures();
@@ -33,6 +33,9 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <future>
+
+#include <simgear/misc/sg_path.hxx>
 
 #include <Navaids/positioned.hxx>
 #include <Navaids/procedure.hxx>
@@ -97,6 +100,14 @@ class FGAirport : public FGPositioned
 
     FGGroundNetwork* groundNetwork() const;
 
+    /**
+     * Start loading the ground network on a worker thread, so a later
+     * groundNetwork() call only has to wait for whatever is left of the
+     * parse. Does nothing if the network is loaded or already loading, or
+     * if /sim/ai/groundnet-background-load is false.
+     */
+    void prefetchGroundNetwork() const;
+
     unsigned int numRunways() const;
     unsigned int numHelipads() const;
     FGRunwayRef getRunwayByIndex(unsigned int aIndex) const;
@@ -251,6 +262,12 @@ class FGAirport : public FGPositioned
       const std::vector<flightgear::STAR*>& aStars,
       const std::vector<flightgear::Approach*>& aApproaches);
 
+     /**
+      * Start parsing the procedures file for this airport in the background,
+      * so a later request for its SIDs, STARs or approaches is cheap.
+      */
+     void prefetchProcedures() const;
+
      void addSID(flightgear::SID* aSid);
       void addSTAR(flightgear::STAR* aStar);
       void addApproach(flightgear::Approach* aApp);
@@ -302,9 +319,11 @@ class FGAirport : public FGPositioned
      /**
       * Specialised helper to implement the AirportList dialog. Performs a
       * case-insensitive search on airport names and ICAO codes, and returns
-      * matches in a format suitable for use by a puaList.
+      * matches in a format suitable for use by a puaList, best matches
+      * first and at most maxResults of them if it is non-zero.
       */
-     static char** searchNamesAndIdents(const std::string& aFilter);
+     static char** searchNamesAndIdents(const std::string& aFilter,
+                                        unsigned int maxResults = 0);
 
 
     /**
@@ -398,6 +417,12 @@ private:
 
     mutable std::unique_ptr<FGGroundNetwork> _groundNetwork;
 
+    // network being filled by prefetchGroundNetwork(); the load result is
+    // the groundnet path if it had errors. Declared after the network so
+    // the future is destroyed (and waited for) first.
+    mutable std::unique_ptr<FGGroundNetwork> _loadingGroundNetwork;
+    mutable std::future<SGPath> _groundNetworkLoad;
+
     using RunwayRenameMap = std::map<std::string, std::string>;
     // map from new name (eg in Navigraph) to old name (in apt.dat)
     RunwayRenameMap _renamedRunways;
@@ -78,6 +78,9 @@ FGAirportDynamicsRef AirportDynamicsManager::dynamicsForICAO(const std::string &
     if (!apt)
         return FGAirportDynamicsRef();
 
+    // parse the groundnet while the rest of the dynamics are set up
+    apt->prefetchGroundNetwork();
+
     FGAirportDynamicsRef d(new FGAirportDynamics(apt));
     d->init();
 
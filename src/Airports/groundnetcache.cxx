@@ -0,0 +1,401 @@
+// groundnetcache.cxx - binary cache of parsed ground networks
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <config.h>
+
+#include "groundnetcache.hxx"
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+#include <simgear/compiler.h>
+
+#if !defined(SG_WINDOWS)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_path.hxx>
+
+#include <Main/globals.hxx>
+
+#include "groundnetwork.hxx"
+#include "parking.hxx"
+
+namespace flightgear
+{
+
+namespace
+{
+
+const char CACHE_MAGIC[4] = {'F', 'G', 'G', 'N'};
+const uint32_t CACHE_FORMAT = 1;
+const unsigned FREQUENCY_LISTS = 6;
+
+// All records are written in host byte order and layout, and sized to
+// keep the following arrays 8-byte aligned in the mapped file.
+struct Header
+{
+    char magic[4];
+    uint32_t format;
+    uint64_t sourceSize;
+    int64_t sourceModTime;
+    int32_t version;
+    uint32_t nodeCount;
+    uint32_t segmentCount;
+    uint32_t parkingCount;
+    uint32_t frequencyCount[FREQUENCY_LISTS];
+    uint32_t stringBytes;
+    uint32_t reserved;
+};
+
+struct NodeRecord
+{
+    double lat;
+    double lon;
+    double heading;         // parkings only
+    double radius;          // parkings only
+    int32_t index;
+    int32_t pushBack;       // node record, -1 for none
+    uint32_t name;          // offsets into the string table
+    uint32_t type;
+    uint32_t codes;
+    uint8_t parking;
+    uint8_t onRunway;
+    int8_t holdType;
+    uint8_t detached;       // push-back point that no segment references
+};
+
+struct SegmentRecord
+{
+    uint32_t from;
+    uint32_t to;
+};
+
+static_assert(sizeof(Header) % 8 == 0, "groundnet cache header breaks alignment");
+static_assert(sizeof(NodeRecord) % 8 == 0, "groundnet cache node record breaks alignment");
+
+/// Read-only view of a whole file.
+class MappedFile
+{
+public:
+    explicit MappedFile(const SGPath& path)
+    {
+#if defined(SG_WINDOWS)
+        sg_ifstream in(path, std::ios::in | std::ios::binary);
+        if (in.is_open()) {
+            _buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            _data = _buffer.data();
+            _size = _buffer.size();
+        }
+#else
+        int fd = ::open(path.local8BitStr().c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat st;
+        if ((::fstat(fd, &st) == 0) && (st.st_size > 0)) {
+            void* map = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (map != MAP_FAILED) {
+                _data = static_cast<const char*>(map);
+                _size = st.st_size;
+            }
+        }
+        ::close(fd);
+#endif
+    }
+
+    ~MappedFile()
+    {
+#if !defined(SG_WINDOWS)
+        if (_data) {
+            ::munmap(const_cast<char*>(_data), _size);
+        }
+#endif
+    }
+
+    const char* data() const { return _data; }
+    size_t size() const { return _size; }
+
+private:
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* _data = nullptr;
+    size_t _size = 0;
+#if defined(SG_WINDOWS)
+    std::vector<char> _buffer;
+#endif
+};
+
+} // of anonymous namespace
+
+std::vector<int>* GroundNetCache::frequencyList(FGGroundNetwork* net, unsigned i)
+{
+    switch (i) {
+    case 0: return &net->freqAwos;
+    case 1: return &net->freqUnicom;
+    case 2: return &net->freqClearance;
+    case 3: return &net->freqGround;
+    case 4: return &net->freqTower;
+    default: return &net->freqApproach;
+    }
+}
+
+SGPath GroundNetCache::pathForAirport(const std::string& ident)
+{
+    return SGPath(globals->get_fg_home()) / "GroundNets" / (ident + ".groundnet.bin");
+}
+
+bool GroundNetCache::load(FGGroundNetwork* net, const SGPath& cachePath, const SGPath& sourcePath)
+{
+    if (!cachePath.exists()) {
+        return false;
+    }
+
+    MappedFile file(cachePath);
+    if (!file.data() || (file.size() < sizeof(Header))) {
+        return false;
+    }
+
+    const Header* header = reinterpret_cast<const Header*>(file.data());
+    if (memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) ||
+        (header->format != CACHE_FORMAT) ||
+        (header->sourceSize != sourcePath.sizeInBytes()) ||
+        (header->sourceModTime != static_cast<int64_t>(sourcePath.modTime()))) {
+        SG_LOG(SG_NAVAID, SG_DEBUG, "groundnet cache is stale: " << cachePath);
+        return false;
+    }
+
+    size_t frequencies = 0;
+    for (unsigned i = 0; i < FREQUENCY_LISTS; ++i) {
+        frequencies += header->frequencyCount[i];
+    }
+    const size_t expectedSize = sizeof(Header) +
+        header->nodeCount * sizeof(NodeRecord) +
+        header->segmentCount * sizeof(SegmentRecord) +
+        header->parkingCount * sizeof(uint32_t) +
+        frequencies * sizeof(int32_t) +
+        header->stringBytes;
+    if (file.size() != expectedSize) {
+        SG_LOG(SG_NAVAID, SG_WARN, "groundnet cache is truncated: " << cachePath);
+        return false;
+    }
+
+    const char* p = file.data() + sizeof(Header);
+    const NodeRecord* nodes = reinterpret_cast<const NodeRecord*>(p);
+    p += header->nodeCount * sizeof(NodeRecord);
+    const SegmentRecord* segments = reinterpret_cast<const SegmentRecord*>(p);
+    p += header->segmentCount * sizeof(SegmentRecord);
+    const uint32_t* parkings = reinterpret_cast<const uint32_t*>(p);
+    p += header->parkingCount * sizeof(uint32_t);
+    const int32_t* frequencyData = reinterpret_cast<const int32_t*>(p);
+    p += frequencies * sizeof(int32_t);
+    const char* strings = p;
+
+    // validate everything before touching the network
+    const uint32_t nodeCount = header->nodeCount;
+    if ((header->stringBytes == 0) || (strings[header->stringBytes - 1] != '\0')) {
+        return false;
+    }
+    for (uint32_t i = 0; i < nodeCount; ++i) {
+        const NodeRecord& r = nodes[i];
+        if ((r.name >= header->stringBytes) || (r.type >= header->stringBytes) ||
+            (r.codes >= header->stringBytes) ||
+            ((r.pushBack >= 0) && (static_cast<uint32_t>(r.pushBack) >= nodeCount))) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->segmentCount; ++i) {
+        if ((segments[i].from >= nodeCount) || (segments[i].to >= nodeCount)) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->parkingCount; ++i) {
+        if ((parkings[i] >= nodeCount) || !nodes[parkings[i]].parking) {
+            return false;
+        }
+    }
+
+    std::vector<FGTaxiNodeRef> taxiNodes(nodeCount);
+    for (uint32_t i = 0; i < nodeCount; ++i) {
+        const NodeRecord& r = nodes[i];
+        const SGGeod pos(SGGeod::fromDeg(r.lon, r.lat));
+        if (r.parking) {
+            taxiNodes[i] = new FGParking(r.index, pos, r.heading, r.radius,
+                                         strings + r.name, strings + r.type, strings + r.codes);
+        } else {
+            taxiNodes[i] = new FGTaxiNode(FGPositioned::TAXI_NODE, r.index, pos,
+                                          r.onRunway != 0, r.holdType);
+        }
+    }
+
+    for (uint32_t i = 0; i < nodeCount; ++i) {
+        if (nodes[i].parking && (nodes[i].pushBack >= 0)) {
+            static_cast<FGParking*>(taxiNodes[i].ptr())->setPushBackPoint(taxiNodes[nodes[i].pushBack]);
+        }
+        if (!nodes[i].detached) {
+            net->m_nodes.push_back(taxiNodes[i]);
+        }
+    }
+
+    for (uint32_t i = 0; i < header->parkingCount; ++i) {
+        net->m_parkings.push_back(static_cast<FGParking*>(taxiNodes[parkings[i]].ptr()));
+    }
+
+    net->segments.reserve(header->segmentCount);
+    for (uint32_t i = 0; i < header->segmentCount; ++i) {
+        net->segments.push_back(new FGTaxiSegment(taxiNodes[segments[i].from], taxiNodes[segments[i].to]));
+    }
+
+    for (unsigned i = 0; i < FREQUENCY_LISTS; ++i) {
+        std::vector<int>* list = frequencyList(net, i);
+        list->assign(frequencyData, frequencyData + header->frequencyCount[i]);
+        frequencyData += header->frequencyCount[i];
+    }
+
+    net->version = header->version;
+    return true;
+}
+
+bool GroundNetCache::save(FGGroundNetwork* net, const SGPath& cachePath, const SGPath& sourcePath)
+{
+    std::unordered_map<const FGTaxiNode*, uint32_t> recordIndex;
+    std::vector<FGTaxiNodeRef> recordNodes(net->m_nodes.begin(), net->m_nodes.end());
+    for (uint32_t i = 0; i < recordNodes.size(); ++i) {
+        recordIndex[recordNodes[i].ptr()] = i;
+    }
+
+    // push-back points normally sit on a segment, but keep the odd one that does not
+    const size_t networkNodes = recordNodes.size();
+    for (const auto& park : net->m_parkings) {
+        FGTaxiNodeRef pushBack = park->getPushBackPoint();
+        if (pushBack && (recordIndex.find(pushBack.ptr()) == recordIndex.end())) {
+            recordIndex[pushBack.ptr()] = recordNodes.size();
+            recordNodes.push_back(pushBack);
+        }
+    }
+
+    // offset 0 is the empty string
+    std::string strings(1, '\0');
+    auto addString = [&strings](const std::string& s) -> uint32_t {
+        if (s.empty()) {
+            return 0;
+        }
+        const uint32_t offset = strings.size();
+        strings.append(s);
+        strings.push_back('\0');
+        return offset;
+    };
+
+    std::vector<NodeRecord> nodes(recordNodes.size());
+    for (size_t i = 0; i < recordNodes.size(); ++i) {
+        FGTaxiNode* node = recordNodes[i].ptr();
+        NodeRecord& r = nodes[i];
+        memset(&r, 0, sizeof(r));
+        r.lat = node->latitude();
+        r.lon = node->longitude();
+        r.index = node->getIndex();
+        r.pushBack = -1;
+        r.onRunway = node->getIsOnRunway() ? 1 : 0;
+        r.holdType = node->getHoldPointType();
+        r.detached = (i >= networkNodes) ? 1 : 0;
+        if (node->type() == FGPositioned::PARKING) {
+            FGParking* park = static_cast<FGParking*>(node);
+            r.parking = 1;
+            r.heading = park->getHeading();
+            r.radius = park->getRadius();
+            r.name = addString(park->getName());
+            r.type = addString(park->getType());
+            r.codes = addString(park->getCodes());
+            FGTaxiNodeRef pushBack = park->getPushBackPoint();
+            if (pushBack) {
+                r.pushBack = recordIndex[pushBack.ptr()];
+            }
+        }
+    }
+
+    std::vector<SegmentRecord> segments;
+    segments.reserve(net->segments.size());
+    for (auto seg : net->segments) {
+        segments.push_back(SegmentRecord{recordIndex[seg->getStart().ptr()],
+                                         recordIndex[seg->getEnd().ptr()]});
+    }
+
+    std::vector<uint32_t> parkings;
+    for (const auto& park : net->m_parkings) {
+        parkings.push_back(recordIndex[park.ptr()]);
+    }
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.format = CACHE_FORMAT;
+    header.sourceSize = sourcePath.sizeInBytes();
+    header.sourceModTime = sourcePath.modTime();
+    header.version = net->version;
+    header.nodeCount = nodes.size();
+    header.segmentCount = segments.size();
+    header.parkingCount = parkings.size();
+    for (unsigned i = 0; i < FREQUENCY_LISTS; ++i) {
+        header.frequencyCount[i] = frequencyList(net, i)->size();
+    }
+    header.stringBytes = strings.size();
+
+    // write next to the final file and rename, so readers never see half a cache
+    SGPath tempPath(cachePath);
+    tempPath.concat(".tmp");
+    tempPath.create_dir(0755);
+    {
+        sg_ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            SG_LOG(SG_NAVAID, SG_WARN, "unable to write groundnet cache: " << tempPath);
+            return false;
+        }
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(NodeRecord));
+        out.write(reinterpret_cast<const char*>(segments.data()), segments.size() * sizeof(SegmentRecord));
+        out.write(reinterpret_cast<const char*>(parkings.data()), parkings.size() * sizeof(uint32_t));
+        for (unsigned i = 0; i < FREQUENCY_LISTS; ++i) {
+            for (int freq : *frequencyList(net, i)) {
+                const int32_t value = freq;
+                out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+            }
+        }
+        out.write(strings.data(), strings.size());
+        if (!out.good()) {
+            SG_LOG(SG_NAVAID, SG_WARN, "unable to write groundnet cache: " << tempPath);
+            out.close();
+            tempPath.remove();
+            return false;
+        }
+    }
+
+    if (cachePath.exists()) {
+        SGPath(cachePath).remove();
+    }
+    return tempPath.rename(cachePath);
+}
+
+} // of namespace flightgear
@@ -0,0 +1,56 @@
+// groundnetcache.hxx - binary cache of parsed ground networks
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef _GROUNDNET_CACHE_HXX_
+#define _GROUNDNET_CACHE_HXX_
+
+#include <string>
+#include <vector>
+
+class FGGroundNetwork;
+class SGPath;
+
+namespace flightgear
+{
+
+/**
+ * Compact binary copy of a parsed groundnet.xml, kept in $FG_HOME/GroundNets
+ * next to the navdata cache. Cache files are mapped into memory to load, and
+ * are only used while the size and modification time of the source XML match
+ * the ones recorded when the cache was written.
+ *
+ * load() and save() only touch the network and the files, so both can run
+ * on a worker thread.
+ */
+class GroundNetCache
+{
+public:
+    static SGPath pathForAirport(const std::string& ident);
+
+    /// Fill an empty network from the cache, false if it is missing or stale.
+    static bool load(FGGroundNetwork* net, const SGPath& cachePath, const SGPath& sourcePath);
+
+    /// Write the cache for a freshly parsed network.
+    static bool save(FGGroundNetwork* net, const SGPath& cachePath, const SGPath& sourcePath);
+
+private:
+    /// frequency lists in file order: AWOS, UNICOM, clearance, ground, tower, approach
+    static std::vector<int>* frequencyList(FGGroundNetwork* net, unsigned i);
+};
+
+} // of namespace flightgear
+
+#endif
@@ -29,6 +29,13 @@
 #include <fstream>
 #include <map>
 #include <iterator>
+#include <queue>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 #include <simgear/debug/logstream.hxx>
 #include <simgear/scene/util/OsgMath.hxx>
@@ -41,6 +48,7 @@
 #include <Airports/airport.hxx>
 #include <Airports/runways.hxx>
 
+#include <Main/fg_props.hxx>
 #include <Scenery/scenery.hxx>
 
 using std::string;
@@ -183,6 +191,10 @@ FGGroundNetwork::FGGroundNetwork(FGAirport* airport) :
 
 FGGroundNetwork::~FGGroundNetwork()
 {
+  // the pool drops the remaining rows, nothing there refers to us
+  if (m_routeJob) {
+    m_routeJob->cancel = true;
+  }
 
   for (auto seg : segments) {
     delete seg;
@@ -219,6 +231,10 @@ void FGGroundNetwork::init()
     }
 
     networkInitialized = true;
+
+    if (fgGetBool("/sim/ai/precompute-taxi-routes", false)) {
+        precomputeRoutes();
+    }
 }
 
 FGTaxiNodeRef FGGroundNetwork::findNearestNode(const SGGeod & aGeod) const
@@ -381,6 +397,17 @@ FGTaxiRoute FGGroundNetwork::findShortestRoute(FGTaxiNode* start, FGTaxiNode* en
     if (!start || !end) {
         throw sg_exception("Bad arguments to findShortestRoute");
     }
+
+    FGTaxiRoute route;
+    if (findPrecomputedRoute(start, end, fullSearch, route)) {
+        return route;
+    }
+
+    return searchShortestRoute(start, end, fullSearch);
+}
+
+FGTaxiRoute FGGroundNetwork::searchShortestRoute(FGTaxiNode* start, FGTaxiNode* end, bool fullSearch)
+{
 //implements Dijkstra's algorithm to find shortest distance route from start to end
 //taken from http://en.wikipedia.org/wiki/Dijkstra's_algorithm
     FGTaxiNodeVector unvisited(m_nodes);
@@ -446,6 +473,324 @@ FGTaxiRoute FGGroundNetwork::findShortestRoute(FGTaxiNode* start, FGTaxiNode* en
     return FGTaxiRoute(nodes, routes, searchData[end].score, 0);
 }
 
+/***************************************************************************
+ * Precomputed routes
+ **************************************************************************/
+
+// Shortest path trees for a fixed set of source nodes, one row of
+// nodeCount entries per source, indexed like m_nodes.
+class FGGroundNetwork::RouteTable
+{
+public:
+    std::unordered_map<const FGTaxiNode*, int> nodeIndex;
+    std::unordered_map<const FGTaxiNode*, int> sourceRow;
+    size_t nodeCount = 0;
+    std::vector<int> previous;  // previous node, -1 at the source and when unreachable
+    std::vector<int> segment;   // index of the segment from the previous node
+    std::vector<double> score;
+};
+
+// Progress of one table through the worker pool. The tasks only hold on to
+// the job, the table and the network snapshot, so the network can go away
+// while rows are still queued.
+class FGGroundNetwork::RouteJob
+{
+public:
+    std::atomic<bool> cancel{false};
+    std::atomic<size_t> remaining{0};
+
+    std::mutex lock;
+    std::condition_variable finished;
+    bool done = false;
+    std::shared_ptr<const RouteTable> table; // set once all rows are computed
+};
+
+namespace {
+
+// Worker threads shared by all ground networks, so loading many airports
+// does not start a set of threads for each of them.
+class RoutePool
+{
+public:
+    static RoutePool& instance()
+    {
+        static RoutePool pool;
+        return pool;
+    }
+
+    void post(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> g(_lock);
+            _tasks.push_back(std::move(task));
+        }
+        _wake.notify_one();
+    }
+
+private:
+    RoutePool()
+    {
+        // hardware_concurrency() may be 0 when unknown; leave one core to
+        // the main thread otherwise
+        const unsigned int cores = std::thread::hardware_concurrency();
+        const unsigned int workers = (cores > 1) ? (cores - 1) : 1;
+        for (unsigned int i = 0; i < workers; ++i) {
+            _threads.emplace_back(&RoutePool::workerMain, this);
+        }
+    }
+
+    ~RoutePool()
+    {
+        {
+            std::lock_guard<std::mutex> g(_lock);
+            _quit = true;
+        }
+        _wake.notify_all();
+        for (auto& t : _threads) {
+            t.join();
+        }
+    }
+
+    void workerMain()
+    {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> g(_lock);
+                _wake.wait(g, [this] { return _quit || !_tasks.empty(); });
+                if (_quit) {
+                    return;
+                }
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex _lock;
+    std::condition_variable _wake;
+    std::deque<std::function<void()>> _tasks;
+    std::vector<std::thread> _threads;
+    bool _quit = false;
+};
+
+struct RouteEdge
+{
+    int target;
+    int segment;
+    double length;
+};
+
+// Snapshot of the network, so the workers never touch the (ref-counted) nodes.
+struct RouteGraph
+{
+    std::vector<std::vector<RouteEdge>> edges;
+    std::vector<int> penalty;
+    std::vector<int> sources;
+};
+
+// The search of searchShortestRoute(), run to completion. Ordering the heap
+// by score and then node index settles the nodes in the same order as the
+// linear scan there, so both produce the same routes.
+void searchRouteTree(const RouteGraph& graph, int source,
+                     int* previous, int* segment, double* score)
+{
+    const size_t count = graph.penalty.size();
+    std::fill(previous, previous + count, -1);
+    std::fill(segment, segment + count, 0);
+    std::fill(score, score + count, HUGE_VAL);
+    std::vector<bool> settled(count, false);
+
+    typedef std::pair<double, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    score[source] = 0.0;
+    open.push(Entry(0.0, source));
+
+    while (!open.empty()) {
+        const Entry best = open.top();
+        open.pop();
+        const int u = best.second;
+        if (settled[u] || (best.first > score[u])) {
+            continue;
+        }
+        settled[u] = true;
+
+        for (const auto& edge : graph.edges[u]) {
+            double alt = score[u] + edge.length + graph.penalty[edge.target];
+            if (alt < score[edge.target]) {
+                score[edge.target] = alt;
+                previous[edge.target] = u;
+                segment[edge.target] = edge.segment;
+                open.push(Entry(alt, edge.target));
+            }
+        }
+    }
+}
+
+} // of anonymous namespace
+
+void FGGroundNetwork::precomputeRoutes()
+{
+    if (m_routeJob || m_nodes.empty()) {
+        return;
+    }
+
+    auto table = std::make_shared<RouteTable>();
+    auto graph = std::make_shared<RouteGraph>();
+
+    table->nodeCount = m_nodes.size();
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        table->nodeIndex[m_nodes[i].ptr()] = i;
+        graph->penalty.push_back(edgePenalty(m_nodes[i]));
+    }
+
+    // segments in order, so parallel segments resolve like findSegment()
+    graph->edges.resize(m_nodes.size());
+    for (auto seg : segments) {
+        const int from = table->nodeIndex[seg->getStart().ptr()];
+        const int to = table->nodeIndex[seg->getEnd().ptr()];
+        graph->edges[from].push_back(RouteEdge{to, seg->getIndex(),
+                                               dist(seg->getStart()->cart(), seg->getEnd()->cart())});
+    }
+
+    auto addSource = [&table, &graph](const FGTaxiNode* node) {
+        auto it = table->nodeIndex.find(node);
+        if (it == table->nodeIndex.end()) {
+            return;
+        }
+        if (table->sourceRow.emplace(node, graph->sources.size()).second) {
+            graph->sources.push_back(it->second);
+        }
+    };
+    for (const auto& park : m_parkings) {
+        addSource(park.ptr());
+        addSource(park->getPushBackPoint().ptr());
+    }
+    for (const auto& node : m_nodes) {
+        if (node->getIsOnRunway()) {
+            addSource(node.ptr());
+        }
+    }
+
+    const size_t size = graph->sources.size() * table->nodeCount;
+    table->previous.resize(size);
+    table->segment.resize(size);
+    table->score.resize(size);
+
+    const std::string ident = parent->getId();
+    auto job = std::make_shared<RouteJob>();
+    m_routeJob = job;
+    if (graph->sources.empty()) {
+        job->done = true;
+        return;
+    }
+
+    const SGTimeStamp start = SGTimeStamp::now();
+    job->remaining = graph->sources.size();
+
+    // rows are independent, queue them one by one
+    for (size_t row = 0; row < graph->sources.size(); ++row) {
+        RoutePool::instance().post([job, table, graph, row, ident, start]() {
+            if (!job->cancel) {
+                const size_t offset = row * table->nodeCount;
+                searchRouteTree(*graph, graph->sources[row], &table->previous[offset],
+                                &table->segment[offset], &table->score[offset]);
+            }
+
+            if (--job->remaining > 0) {
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> g(job->lock);
+                if (!job->cancel) {
+                    job->table = table;
+                }
+                job->done = true;
+            }
+            job->finished.notify_all();
+
+            if (!job->cancel) {
+                SG_LOG(SG_GENERAL, SG_INFO, "Precomputed taxi routes from " << graph->sources.size()
+                       << " nodes at " << ident << " in " << start.elapsedMSec() << " msec");
+            }
+        });
+    }
+}
+
+void FGGroundNetwork::waitForPrecomputedRoutes()
+{
+    if (!m_routeJob) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> g(m_routeJob->lock);
+    m_routeJob->finished.wait(g, [this] { return m_routeJob->done; });
+}
+
+bool FGGroundNetwork::hasPrecomputedRoutes()
+{
+    if (!m_routeJob) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> g(m_routeJob->lock);
+    return m_routeJob->table.get() != nullptr;
+}
+
+bool FGGroundNetwork::findPrecomputedRoute(FGTaxiNode* start, FGTaxiNode* end, bool fullSearch, FGTaxiRoute& route)
+{
+    if (!m_routeJob) {
+        return false;
+    }
+
+    std::shared_ptr<const RouteTable> table;
+    {
+        std::lock_guard<std::mutex> g(m_routeJob->lock);
+        table = m_routeJob->table;
+    }
+    if (!table) {
+        return false;
+    }
+
+    auto source = table->sourceRow.find(start);
+    auto target = table->nodeIndex.find(end);
+    if ((source == table->sourceRow.end()) || (target == table->nodeIndex.end())) {
+        return false;
+    }
+
+    const size_t offset = source->second * table->nodeCount;
+    const double score = table->score[offset + target->second];
+    if (score == HUGE_VAL) {
+        // no valid route found
+        if (fullSearch) {
+            SG_LOG(SG_GENERAL, SG_ALERT,
+                   "Failed to find route from waypoint " << start << " to "
+                   << end << " at " << parent->getId());
+        }
+
+        route = FGTaxiRoute();
+        return true;
+    }
+
+    // assemble route from the tree
+    FGTaxiNodeVector nodes;
+    intVec routes;
+    int bt = target->second;
+
+    while (table->previous[offset + bt] >= 0) {
+        nodes.push_back(m_nodes[bt]);
+        routes.push_back(table->segment[offset + bt]);
+        bt = table->previous[offset + bt];
+    }
+    nodes.push_back(start);
+    reverse(nodes.begin(), nodes.end());
+    reverse(routes.begin(), routes.end());
+    route = FGTaxiRoute(nodes, routes, score, 0);
+    return true;
+}
+
 void FGGroundNetwork::unblockAllSegments(time_t now)
 {
     for (auto& seg : segments) {
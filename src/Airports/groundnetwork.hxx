@@ -26,6 +26,7 @@
 
 #include <simgear/compiler.h>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -34,6 +35,8 @@
 
 class FGAirportDynamicsXMLLoader;
 
+namespace flightgear { class GroundNetCache; }
+
 typedef std::vector<int> intVec;
 typedef std::vector<int>::iterator intVecIterator;
 
@@ -174,6 +177,7 @@ class FGGroundNetwork
 {
 private:
     friend class FGGroundNetXMLLoader;
+    friend class flightgear::GroundNetCache;
 
     bool hasNetwork;
     bool networkInitialized;
@@ -231,6 +235,15 @@ private:
     /// this map exists specifcially to make blockSegmentsEndingAt not be a bottleneck
     NodeFromSegmentMap m_segmentsEndingAtNodeMap;
 
+    /// shortest path trees from every parking, push-back point and runway node
+    class RouteTable;
+    /// the background computation of the table, shared with the worker pool
+    class RouteJob;
+    std::shared_ptr<RouteJob> m_routeJob;
+
+    FGTaxiRoute searchShortestRoute(FGTaxiNode* start, FGTaxiNode* end, bool fullSearch);
+    bool findPrecomputedRoute(FGTaxiNode* start, FGTaxiNode* end, bool fullSearch, FGTaxiRoute& route);
+
 public:
     FGGroundNetwork(FGAirport* pr);
     ~FGGroundNetwork();
@@ -277,6 +290,17 @@ public:
 
     FGTaxiRoute findShortestRoute(FGTaxiNode* start, FGTaxiNode* end, bool fullSearch=true);
 
+    /**
+     * Compute the routes from all parkings and push-back points to the
+     * runways and back in the background. Once done, findShortestRoute()
+     * answers those from the table. Called from init() when
+     * /sim/ai/precompute-taxi-routes is set.
+     */
+    void precomputeRoutes();
+    /// block until the background route computation has finished
+    void waitForPrecomputedRoutes();
+    bool hasPrecomputedRoutes();
+
 
     void blockSegmentsEndingAt(FGTaxiSegment* seg, int blockId,
                                time_t blockTime, time_t now);
@@ -32,6 +32,7 @@
 #include "runwayprefloader.hxx"
 
 #include "dynamics.hxx"
+#include "groundnetcache.hxx"
 #include "airport.hxx"
 #include "runwayprefs.hxx"
 
@@ -45,27 +46,64 @@ XMLLoader::~XMLLoader() {}
 
 void XMLLoader::load(FGGroundNetwork* net)
 {
-  SGPath path;
-  if (!findAirportData(net->airport()->ident(), "groundnet", path)) {
+  SGPath path, cachePath;
+  if (!findGroundnet(net, path, cachePath)) {
     return;
   }
 
-  SG_LOG(SG_NAVAID, SG_DEBUG, "reading groundnet data from " << path);
+  if (loadGroundnet(net, path, cachePath)) {
+    reportGroundnetErrors(net, path);
+  }
+}
+
+bool XMLLoader::findGroundnet(FGGroundNetwork* net, SGPath& path, SGPath& cachePath)
+{
+  if (!findAirportData(net->airport()->ident(), "groundnet", path)) {
+    return false;
+  }
+
+  cachePath = SGPath();
+  if (fgGetBool("/sim/ai/groundnet-cache", true)) {
+    cachePath = flightgear::GroundNetCache::pathForAirport(net->airport()->ident());
+  }
+  return true;
+}
+
+bool XMLLoader::loadGroundnet(FGGroundNetwork* net, const SGPath& path, const SGPath& cachePath)
+{
   SGTimeStamp t;
   t.stamp();
+  if (!cachePath.isNull() && flightgear::GroundNetCache::load(net, cachePath, path)) {
+    SG_LOG(SG_NAVAID, SG_DEBUG, "loading groundnet cache " << cachePath << " took " << t.elapsedMSec());
+    return false;
+  }
+
+  SG_LOG(SG_NAVAID, SG_DEBUG, "reading groundnet data from " << path);
+  bool hasErrors = false;
   try {
       FGGroundNetXMLLoader visitor(net);
       readXML(path, visitor);
-
-      if (visitor.hasErrors() && fgGetBool("/sim/terrasync/enabled")) {
-          flightgear::updateSentryTag("ground-net", net->airport()->ident());
-          flightgear::sentryReportException("Ground-net load error", path.utf8Str());
-      }
+      hasErrors = visitor.hasErrors();
   } catch (sg_exception& e) {
     SG_LOG(SG_NAVAID, SG_DEV_WARN, "parsing groundnet XML failed:" << e.getFormattedMessage());
+    return false;
   }
 
   SG_LOG(SG_NAVAID, SG_DEBUG, "parsing groundnet XML took " << t.elapsedMSec());
+
+  // only cache clean parses, so broken files keep being reported
+  if (!cachePath.isNull() && !hasErrors) {
+    flightgear::GroundNetCache::save(net, cachePath, path);
+  }
+  return hasErrors;
+}
+
+void XMLLoader::reportGroundnetErrors(FGGroundNetwork* net, const SGPath& path)
+{
+  if (fgGetBool("/sim/terrasync/enabled")) {
+      flightgear::updateSentryTag("ground-net", net->airport()->ident());
+      flightgear::sentryReportException("Ground-net load error", path.utf8Str());
+  }
 }
 
 void XMLLoader::loadFromStream(FGGroundNetwork* net, std::istream& inData)
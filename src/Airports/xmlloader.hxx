@@ -30,6 +30,19 @@ public:
   static void load(FGGroundNetwork*  net);
   static void load(FGSidStar*          s);
   
+  /**
+   * Split form of load(FGGroundNetwork*), so the parse can run on a worker
+   * thread. findGroundnet() looks up the scenery XML and the binary cache to
+   * use for it (an empty cache path disables the cache) and must run on the
+   * main thread. loadGroundnet() fills the network from the cache if it is
+   * current, otherwise parses the XML and refreshes the cache; it only
+   * touches the network and returns true if the XML had errors, which
+   * reportGroundnetErrors() then reports back on the main thread.
+   */
+  static bool findGroundnet(FGGroundNetwork* net, SGPath& path, SGPath& cachePath);
+  static bool loadGroundnet(FGGroundNetwork* net, const SGPath& path, const SGPath& cachePath);
+  static void reportGroundnetErrors(FGGroundNetwork* net, const SGPath& path);
+
   static void loadFromStream(FGGroundNetwork* net, std::istream& inData);
   static void loadFromPath(FGGroundNetwork* net, const SGPath& path);
 
@@ -28,6 +28,7 @@
 #include "autopilot.hxx"
 
 #include <simgear/structure/StateMachine.hxx>
+#include <simgear/structure/exception.hxx>
 #include <simgear/sg_inlines.h>
 
 #include "component.hxx"
@@ -39,7 +40,9 @@
 #include "logic.hxx"
 #include "flipflop.hxx"
 
+#include "FDM/fdm_shell.hxx"
 #include "Main/fg_props.hxx"
+#include "Main/globals.hxx"
 
 using std::map;
 using std::string;
@@ -127,6 +130,9 @@ static ComponentForge componentForge;
 Autopilot::Autopilot( SGPropertyNode_ptr rootNode, SGPropertyNode_ptr configNode ) :
   _name("unnamed autopilot"),
   _serviceable(true),
+  _compiled(false),
+  _fdmSubstep(false),
+  _substepRegistered(false),
   _rootNode(rootNode)
 {
   if (componentForge.empty())
@@ -154,6 +160,16 @@ Autopilot::Autopilot( SGPropertyNode_ptr rootNode, SGPropertyNode_ptr configNode
   SGPropertyNode_ptr prop_root =
     fgGetNode(prop_root_node ? prop_root_node->getStringValue() : "/", true);
 
+  // like property-root, the local system node may override the config file
+  auto getFlag = [&rootNode, &configNode]( const char* name ) {
+    SGPropertyNode_ptr node = rootNode->getChild(name);
+    if( !node )
+      node = configNode->getChild(name);
+    return node && node->getBoolValue();
+  };
+  _compiled = getFlag("compiled");
+  _fdmSubstep = getFlag("fdm-substep");
+
   // Just like the JSBSim interface properties for systems, create properties
   // given in the autopilot file and set to given (default) values.
   readInterfaceProperties(prop_root, configNode);
@@ -169,7 +185,9 @@ Autopilot::Autopilot( SGPropertyNode_ptr rootNode, SGPropertyNode_ptr configNode
     SGPropertyNode_ptr node = configNode->getChild(i);
     string childName = node->getNameString();
     if(    childName == "property"
-        || childName == "property-root" )
+        || childName == "property-root"
+        || childName == "compiled"
+        || childName == "fdm-substep" )
       continue;
     if( componentForge.count(childName) == 0 )
     {
@@ -201,12 +219,55 @@ void Autopilot::bind()
   SGSubsystemGroup::bind();
 }
 
+void Autopilot::init()
+{
+  SGSubsystemGroup::init();
+
+  if( !_fdmSubstep || _substepRegistered )
+    return;
+
+  FDMShell* fdm = globals->get_subsystem<FDMShell>();
+  if( !fdm )
+  {
+    SG_LOG( SG_AUTOPILOT, SG_DEV_WARN, "autopilot " << _name
+            << ": no FDM to run in, updating with the FDM group instead" );
+    return;
+  }
+
+  // register even if the current FDM does not run the callbacks, update()
+  // checks again each frame since the FDM can be replaced on reinit
+  fdm->addSubstepCallback( this, [this]( double dt ) { step( dt ); } );
+  _substepRegistered = true;
+
+  if( !fdm->runsSubstepCallbacks() )
+    SG_LOG( SG_AUTOPILOT, SG_INFO, "autopilot " << _name
+            << ": FDM has no substep callbacks, updating with the FDM group instead" );
+}
+
+void Autopilot::shutdown()
+{
+  removeSubstepCallback();
+  SGSubsystemGroup::shutdown();
+}
+
 void Autopilot::unbind() 
 {
+  removeSubstepCallback();
   _rootNode->untie( "serviceable" );
   SGSubsystemGroup::unbind();
 }
 
+void Autopilot::removeSubstepCallback()
+{
+  if( !_substepRegistered )
+    return;
+
+  FDMShell* fdm = globals->get_subsystem<FDMShell>();
+  if( fdm )
+    fdm->removeSubstepCallbacks( this );
+  _substepRegistered = false;
+}
+
 void Autopilot::add_component( Component * component, double updateInterval )
 {
   if( component == NULL ) return;
@@ -229,11 +290,57 @@ void Autopilot::add_component( Component * component, double updateInterval )
   }
 
   set_subsystem( name, component, updateInterval );
+  _program.push_back( ProgramStep{ component, updateInterval, 0.0 } );
 }
 
 void Autopilot::update( double dt ) 
+{
+  // driven from the FDM integration loop instead, as long as the current
+  // FDM runs substep callbacks at all; it may be swapped on reinit
+  if( _substepRegistered ) {
+    FDMShell* fdm = globals->get_subsystem<FDMShell>();
+    if( fdm && fdm->runsSubstepCallbacks() )
+      return;
+  }
+
+  step( dt );
+}
+
+void Autopilot::step( double dt )
 {
   if( !_serviceable || dt <= SGLimitsd::min() )
     return;
-  SGSubsystemGroup::update( dt );
+
+  if( _compiled )
+    runProgram( dt );
+  else
+    SGSubsystemGroup::update( dt );
+}
+
+// Evaluate all components in one loop, in configuration order.  That order
+// is the dataflow order of the autopilot: a component reading the output of
+// a later one sees the previous frame's value, exactly as when the group
+// updates its members, so reordering would change the results.  The update
+// interval and suspend handling mirror SGSubsystemGroup's members.
+void Autopilot::runProgram( double dt )
+{
+  for( auto& step : _program )
+  {
+    step.elapsed += dt;
+    if( step.elapsed < step.updateInterval || step.component->is_suspended() )
+      continue;
+
+    try
+    {
+      step.component->update( step.elapsed );
+    }
+    catch( const sg_exception& e )
+    {
+      SG_LOG( SG_AUTOPILOT, SG_ALERT, "autopilot component "
+              << step.component->subsystemId() << " failed, suspending it: "
+              << e.getFormattedMessage() );
+      step.component->suspend();
+    }
+    step.elapsed = 0.0;
+  }
 }
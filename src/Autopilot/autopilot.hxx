@@ -23,6 +23,8 @@
 #ifndef __AUTOPILOT_HXX
 #define __AUTOPILOT_HXX 1
 
+#include <vector>
+
 #include <simgear/props/props.hxx>
 #include <simgear/structure/subsystem_mgr.hxx>
 
@@ -42,6 +44,8 @@ public:
 
     // Subsystem API.
     void bind() override;
+    void init() override;
+    void shutdown() override;
     void unbind() override;
     void update(double dt) override;
 
@@ -56,12 +60,42 @@ public:
 
     void add_component( Component * component, double updateInterval );
 
+    /**
+     * @brief true if the components are evaluated as one flat program
+     * rather than through the SGSubsystemGroup member dispatch
+     */
+    bool is_compiled() const { return _compiled; }
+
+    /**
+     * @brief true if this autopilot runs inside the FDM integration loop,
+     * once per FDM substep, rather than once per FDM group update.  FDMs
+     * without substep callbacks fall back to the group update.
+     */
+    bool is_fdm_substep() const { return _fdmSubstep; }
+
 protected:
 
 private:
+    /**
+     * @brief one component of the compiled program, in configuration order
+     */
+    struct ProgramStep {
+        Component* component;
+        double updateInterval;
+        double elapsed;
+    };
+
+    void runProgram( double dt );
+    void step( double dt );
+    void removeSubstepCallback();
+
     std::string _name;
     bool _serviceable;
+    bool _compiled;
+    bool _fdmSubstep;
+    bool _substepRegistered;
     SGPropertyNode_ptr _rootNode;
+    std::vector<ProgramStep> _program;
 };
 
 }
@@ -67,6 +67,13 @@ double PeriodicalValue::normalizeSymmetric( double value ) const
   return value > width_2 ? width_2 - value : value;
 }
 
+//------------------------------------------------------------------------------
+bool PeriodicalValue::isConstant() const
+{
+  return (!minPeriod || minPeriod->isConstant())
+      && (!maxPeriod || maxPeriod->isConstant());
+}
+
 //------------------------------------------------------------------------------
 InputValue::InputValue( SGPropertyNode& prop_root,
                         SGPropertyNode& cfg,
@@ -74,7 +81,8 @@ InputValue::InputValue( SGPropertyNode& prop_root,
                         double offset,
                         double scale ):
   _value(0.0),
-  _abs(false)
+  _abs(false),
+  _constant(false)
 {
   parse(prop_root, cfg, value, offset, scale);
 }
@@ -103,6 +111,7 @@ void InputValue::parse( SGPropertyNode& prop_root,
                         double aScale )
 {
   _value = aValue;
+  _constant = false;
   _property = NULL;
   _offset = NULL;
   _scale = NULL;
@@ -191,6 +200,19 @@ void InputValue::parse( SGPropertyNode& prop_root,
     if( endp == textnode.c_str() )
       _property = prop_root.getNode(textnode, true);
   }
+
+  // a static value, optionally transformed by other static values, can be
+  // evaluated once here instead of on every get_value()
+  if(    !_property
+      && (!_scale || _scale->isConstant())
+      && (!_offset || _offset->isConstant())
+      && (!_min || _min->isConstant())
+      && (!_max || _max->isConstant())
+      && (!_periodical || _periodical->isConstant()) )
+  {
+    _value = get_value();
+    _constant = true;
+  }
 }
 
 void InputValue::set_value( double aValue ) 
@@ -207,6 +229,9 @@ void InputValue::set_value( double aValue )
 
 double InputValue::get_value() const
 {
+    if (_constant)
+        return _value;
+
     double value = _value;
 
     if (_expression) {
@@ -48,6 +48,7 @@ public:
                       SGPropertyNode& cfg );
      double normalize( double value ) const;
      double normalizeSymmetric( double value ) const;
+     bool isConstant() const;
 };
 
 /**
@@ -61,6 +62,7 @@ class InputValue : public SGReferenced, public SGPropertyChangeListener {
 private:
      double             _value;    // The value as a constant or initializer for the property
      bool               _abs;      // return absolute value
+     bool               _constant; // _value is the folded result of a static input
      SGPropertyNode_ptr _property; // The name of the property containing the value
      InputValue_ptr _offset;   // A fixed offset, defaults to zero
      InputValue_ptr _scale;    // A constant scaling factor defaults to one
@@ -112,6 +114,9 @@ public:
 
     bool is_enabled() const;
 
+    /* true if the value doesn't depend on any property or expression */
+    bool isConstant() const { return _constant; }
+
     void collectDependentProperties(std::set<const SGPropertyNode*>& props) const;
 };
 
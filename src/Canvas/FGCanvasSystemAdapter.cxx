@@ -69,7 +69,8 @@ namespace canvas
   //----------------------------------------------------------------------------
   void FGCanvasSystemAdapter::addCamera(osg::Camera* camera) const
   {
-    globals->get_renderer()->addCamera(camera, false);
+    if( globals->get_renderer() )
+      globals->get_renderer()->addCamera(camera, false);
   }
 
   //----------------------------------------------------------------------------
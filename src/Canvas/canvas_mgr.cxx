@@ -140,7 +140,7 @@ CanvasMgr::getCanvasTexId(const simgear::canvas::CanvasPtr& canvas) const
 //    return 0;
 
   osg::Camera* guiCamera = flightgear::getGUICamera(flightgear::CameraGroup::getDefault());
-  if (!guiCamera)
+  if (!guiCamera || !guiCamera->getGraphicsContext())
     return 0;
 
   osg::State* state = guiCamera->getGraphicsContext()->getState(); //contexts[0]->getState();
@@ -25,6 +25,7 @@
 
 #include <cassert>
 #include <algorithm>
+#include <limits>
 
 #include <osg/Array>
 #include <osg/Geometry>
@@ -60,6 +61,7 @@ using std::string;
 
 #include <Main/fg_props.hxx>
 #include <Main/globals.hxx>
+#include <AIModel/AIBase.hxx>
 #include "panel.hxx"
 #include <Navaids/routePath.hxx>
 #include <Autopilot/route_mgr.hxx>
@@ -1021,7 +1023,7 @@ void NavDisplay::processRoute()
 {
     _routeSources.clear();
     flightgear::FlightPlan* fp = _route->flightPlan();
-    RoutePath path(fp);
+    const RoutePath& path(fp->routePath());
     int current = _route->currentIndex();
     
     for (int l=0; l<fp->numLegs(); ++l) {
@@ -1314,41 +1316,43 @@ static string mapAINodeToType(SGPropertyNode* model)
 
 void NavDisplay::processAI()
 {
-    SGPropertyNode *ai = fgGetNode("/ai/models", true);
-    for (int i = ai->nChildren() - 1; i >= 0; i--) {
-        SGPropertyNode *model = ai->getChild(i);
-        if (!model->nChildren()) {
-            continue;
-        }
-        
+    auto aiManager = globals->get_subsystem<FGAIManager>();
+    if (!aiManager) {
+        return;
+    }
+
+    std::vector<const FGAIManager::TrafficTarget*> traffic;
+    aiManager->findTraffic(_pos, _rangeNm, std::numeric_limits<double>::max(), traffic);
+    for (const FGAIManager::TrafficTarget* target : traffic) {
+        SGPropertyNode *model = target->object->_getProps();
+
     // prefix types with 'ai-', to avoid any chance of namespace collisions
     // with fg-positioned.
         string_set ss;
-        computeAIStates(model, ss);        
+        computeAIStates(*target, ss);
         SymbolRuleVector rules;
         findRules(mapAINodeToType(model), ss, rules);
         if (rules.empty()) {
-            return; // no rules matched, we can skip this item
+            continue; // no rules matched, we can skip this item
         }
 
-        double heading = model->getDoubleValue("orientation/true-heading-deg");
-        SGGeod aiModelPos = SGGeod::fromDegFt(model->getDoubleValue("position/longitude-deg"), 
-                                            model->getDoubleValue("position/latitude-deg"), 
-                                            model->getDoubleValue("position/altitude-ft"));
+        double heading = target->headingDeg;
+        const SGGeod& aiModelPos = target->position;
     // compute some additional props
         int fl = (aiModelPos.getElevationFt() / 1000);
         model->setIntValue("flight-level", fl * 10);
                                             
         osg::Vec2 projected = projectGeod(aiModelPos);
         for (SymbolRule* r : rules) {
-            addSymbolInstance(projected, heading, r->getDefinition(), (SGPropertyNode*) model);
+            addSymbolInstance(projected, heading, r->getDefinition(), model);
         }
     } // of ai models iteration
 }
 
-void NavDisplay::computeAIStates(const SGPropertyNode* ai, string_set& states)
+void NavDisplay::computeAIStates(const FGAIManager::TrafficTarget& ai, string_set& states)
 {
-    int threatLevel = ai->getIntValue("tcas/threat-level",-1);
+    const SGPropertyNode* threatNode = ai.object->getThreatLevelNode(false);
+    int threatLevel = threatNode ? threatNode->getIntValue() : -1;
     if (threatLevel < 1)
       threatLevel = 0;
   
@@ -1358,7 +1362,7 @@ void NavDisplay::computeAIStates(const SGPropertyNode* ai, string_set& states)
     os << "tcas-threat-level-" << threatLevel;
     states.insert(os.str());
 
-    double vspeed = ai->getDoubleValue("velocities/vertical-speed-fps");
+    double vspeed = ai.verticalFps;
     if (vspeed < -3.0) {
         states.insert("descending");
     } else if (vspeed > 3.0) {
@@ -36,6 +36,7 @@
 #include <string>
 #include <memory>
 
+#include <AIModel/AIManager.hxx>
 #include <Navaids/positioned.hxx>
 
 class FGODGauge;
@@ -124,7 +125,7 @@ private:
     void processNavRadios();
     FGNavRecord* processNavRadio(const SGPropertyNode_ptr& radio);
     void processAI();
-    void computeAIStates(const SGPropertyNode* ai, string_set& states);
+    void computeAIStates(const FGAIManager::TrafficTarget& ai, string_set& states);
 
     void computeCustomSymbolStates(const SGPropertyNode* sym, string_set& states);
     void processCustomSymbols();
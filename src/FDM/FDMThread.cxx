@@ -0,0 +1,283 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "FDMThread.hxx"
+
+#include <chrono>
+#include <condition_variable>
+
+#include <simgear/constants.h>
+#include <simgear/debug/logstream.hxx>
+#include <simgear/math/SGMisc.hxx>
+#include <simgear/structure/exception.hxx>
+
+namespace flightgear {
+
+namespace {
+
+// steps run in one tick when the thread is catching up
+const int MAX_STEPS_PER_TICK = 4;
+
+// queued simulation time beyond which the backlog is stepped inline
+const double MAX_LAG_SEC = 0.25;
+
+std::mutex s_windowLock;
+std::condition_variable s_windowChanged;
+std::atomic<bool> s_windowOpen{false};
+int s_stepping = 0;
+FDMThread* s_active = nullptr;
+
+bool samePose(const FGInterface::Pose& a, const FGInterface::Pose& b)
+{
+    return (a.position.getLatitudeRad() == b.position.getLatitudeRad()) &&
+           (a.position.getLongitudeRad() == b.position.getLongitudeRad()) &&
+           (a.position.getElevationFt() == b.position.getElevationFt()) &&
+           (a.euler == b.euler);
+}
+
+double lerp(double from, double to, double alpha)
+{
+    return from + (to - from) * alpha;
+}
+
+double lerpAngle(double from, double to, double alpha)
+{
+    const double delta = SGMiscd::normalizePeriodic(-SGD_PI, SGD_PI, to - from);
+    const double result = from + delta * alpha;
+
+    // stay in the range the FDM reports 'to' in
+    if (to >= 0.0) {
+        return SGMiscd::normalizePeriodic(0.0, SGD_2PI, result);
+    }
+    return SGMiscd::normalizePeriodic(-SGD_PI, SGD_PI, result);
+}
+
+} // of anonymous namespace
+
+FDMThread::FDMThread(FGInterface* fdm, double stepSec) :
+    _fdm(fdm),
+    _stepSec(stepSec)
+{
+    resync();
+
+    {
+        std::lock_guard<std::mutex> g(s_windowLock);
+        s_active = this;
+    }
+
+    _thread = std::thread(&FDMThread::run, this);
+}
+
+FDMThread::~FDMThread()
+{
+    {
+        std::lock_guard<std::mutex> g(s_windowLock);
+        s_active = nullptr;
+        _quit = true;
+    }
+    s_windowChanged.notify_all();
+    _thread.join();
+}
+
+void FDMThread::queue(double dt)
+{
+    _queuedTotal += dt;
+    _lastQueued.stamp();
+
+    bool behind;
+    {
+        std::lock_guard<std::mutex> g(_exchangeLock);
+        _queuedSec += dt;
+        behind = _queuedSec > MAX_LAG_SEC;
+    }
+
+    if (!behind) {
+        return;
+    }
+
+    // no window was opened for a while: we are outside one, so the FDM can
+    // be stepped here. Like run(), at most MAX_STEPS_PER_TICK steps per
+    // frame, the rest carries over to the next one
+    SG_LOG(SG_FLIGHT, SG_DEBUG, "FDM thread fell behind, stepping inline");
+    for (int i = 0; (i < MAX_STEPS_PER_TICK) && step(); ++i) {
+    }
+
+    // while frames take longer than that, drop what can never be caught up
+    // instead of letting the backlog grow
+    std::lock_guard<std::mutex> g(_exchangeLock);
+    if (_queuedSec > MAX_LAG_SEC) {
+        _queuedTotal -= _queuedSec - MAX_LAG_SEC;
+        _queuedSec = MAX_LAG_SEC;
+    }
+}
+
+void FDMThread::resync()
+{
+    std::lock_guard<std::mutex> g(_exchangeLock);
+    _queuedSec = 0.0;
+    _queuedTotal = _fdmTime;
+    _presented = false;
+
+    const StateBlock current{_fdm->getPose(), _fdmTime};
+    _blocks[0] = current;
+    _blocks[1] = current;
+}
+
+FGInterface::Pose FDMThread::interpolate(const FGInterface::Pose& from,
+                                         const FGInterface::Pose& to,
+                                         double alpha)
+{
+    FGInterface::Pose result;
+    result.position = SGGeod::fromRadFt(
+        lerpAngle(from.position.getLongitudeRad(), to.position.getLongitudeRad(), alpha),
+        lerp(from.position.getLatitudeRad(), to.position.getLatitudeRad(), alpha),
+        lerp(from.position.getElevationFt(), to.position.getElevationFt(), alpha));
+    result.euler = SGVec3d(lerpAngle(from.euler[0], to.euler[0], alpha),
+                           lerp(from.euler[1], to.euler[1], alpha),
+                           lerpAngle(from.euler[2], to.euler[2], alpha));
+    return result;
+}
+
+void FDMThread::openWindow()
+{
+    {
+        std::lock_guard<std::mutex> g(s_windowLock);
+        s_windowOpen = true;
+    }
+    s_windowChanged.notify_all();
+}
+
+void FDMThread::closeWindow()
+{
+    std::unique_lock<std::mutex> g(s_windowLock);
+    s_windowOpen = false;
+    s_windowChanged.wait(g, [] { return s_stepping == 0; });
+
+    if (s_active) {
+        s_active->present();
+    }
+}
+
+void FDMThread::run()
+{
+    using clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(_stepSec));
+
+    auto next = clock::now();
+    for (;;) {
+        next += period;
+        {
+            std::unique_lock<std::mutex> g(s_windowLock);
+            s_windowChanged.wait_until(g, next, [this] { return _quit.load(); });
+            s_windowChanged.wait(g, [this] { return _quit || s_windowOpen; });
+            if (_quit) {
+                return;
+            }
+            ++s_stepping;
+        }
+
+        // one step per tick, unless there is a backlog to catch up on
+        for (int i = 0; (i < MAX_STEPS_PER_TICK) && s_windowOpen && step(); ++i) {
+            std::lock_guard<std::mutex> g(_exchangeLock);
+            if (_queuedSec < 2 * _stepSec) {
+                break;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> g(s_windowLock);
+            --s_stepping;
+        }
+        s_windowChanged.notify_all();
+
+        // after a long stall, restart the schedule rather than bursting
+        const auto now = clock::now();
+        if (now - next > MAX_STEPS_PER_TICK * period) {
+            next = now;
+        }
+    }
+}
+
+bool FDMThread::step()
+{
+    FGInterface::Pose fdmPose;
+    {
+        std::lock_guard<std::mutex> g(_exchangeLock);
+        if (_queuedSec < 0.5 * _stepSec) {
+            return false;
+        }
+        _queuedSec -= _stepSec;
+        fdmPose = _blocks[_latest].pose;
+    }
+
+    // the FDM integrates from its own pose, not the interpolated one
+    if (_presented && samePose(_fdm->getPose(), _presentedPose)) {
+        _fdm->setPose(fdmPose);
+    }
+    _presented = false;
+
+    try {
+        _fdm->update(_stepSec);
+    } catch (const sg_exception& e) {
+        SG_LOG(SG_FLIGHT, SG_ALERT, "caught exception stepping FDM: " << e.getFormattedMessage());
+    } catch (const std::exception& e) {
+        SG_LOG(SG_FLIGHT, SG_ALERT, "caught exception stepping FDM: " << e.what());
+    }
+    _fdmTime += _stepSec;
+
+    std::lock_guard<std::mutex> g(_exchangeLock);
+    StateBlock& back = _blocks[1 - _latest];
+    back.pose = _fdm->getPose();
+    back.time = _fdmTime;
+    _latest = 1 - _latest;
+    return true;
+}
+
+void FDMThread::present()
+{
+    StateBlock from, to;
+    {
+        std::lock_guard<std::mutex> g(_exchangeLock);
+        from = _blocks[1 - _latest];
+        to = _blocks[_latest];
+    }
+
+    // the main thread moved the FDM (reposition): start again from there
+    const FGInterface::Pose& expected = _presented ? _presentedPose : to.pose;
+    if (!samePose(_fdm->getPose(), expected)) {
+        resync();
+        return;
+    }
+
+    if (to.time <= from.time) {
+        return;
+    }
+
+    // present the state one step behind the queued time, so there is
+    // usually a step on either side of it
+    const double t = _queuedTotal + _lastQueued.elapsedMSec() / 1000.0 - _stepSec;
+    const double alpha = SGMiscd::clip((t - from.time) / (to.time - from.time), 0.0, 1.0);
+
+    _presentedPose = interpolate(from.pose, to.pose, alpha);
+    _fdm->setPose(_presentedPose);
+    _presented = true;
+}
+
+} // namespace flightgear
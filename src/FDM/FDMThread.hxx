@@ -0,0 +1,125 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include <simgear/timing/timestamp.hxx>
+
+#include "flight.hxx"
+
+namespace flightgear {
+
+/**
+ * Step an FDM on its own thread at a fixed rate, instead of in bursts from
+ * the FDM group.
+ *
+ * JSBSim and YASim read and write the property tree (and fire listeners)
+ * from inside their integration loop, so the thread only steps while the
+ * main thread has opened a stepping window: during the rendering
+ * traversals and the frame-rate throttle sleep. Everything the main thread
+ * does outside a window, including latching environment inputs into the
+ * FGInterface, sees a FDM which is not running.
+ *
+ * The main thread queues simulation time with queue(); the thread spends
+ * it one step per tick. Each step ends by writing the FDM pose into the
+ * back half of a double-buffered state block. When a window closes, the
+ * pose presented to the rest of the simulator is interpolated between the
+ * two halves; the FDM pose is put back before the next step.
+ *
+ * Only the FDM itself (and its substep callbacks) run at the step rate. The
+ * other members of the FDM group run once per frame against the presented
+ * state, see TimeManager. Headless, the FDM is stepped inline instead.
+ */
+class FDMThread
+{
+public:
+    FDMThread(FGInterface* fdm, double stepSec);
+    ~FDMThread();
+
+    /**
+     * Queue simulation time for the thread, from the main thread. If the
+     * thread fell too far behind (or no window is ever opened), the backlog
+     * is stepped inline, a few steps per call.
+     */
+    void queue(double dt);
+
+    /**
+     * Discard queued time and take the current FDM pose as both halves of
+     * the state block, after the main thread moved or reset the FDM
+     * (replay, reinit).
+     */
+    void resync();
+
+    double stepSec() const { return _stepSec; }
+
+    /**
+     * Interpolate between two poses, taking the shortest way round for
+     * longitude and the Euler angles.
+     */
+    static FGInterface::Pose interpolate(const FGInterface::Pose& from,
+                                         const FGInterface::Pose& to,
+                                         double alpha);
+
+    /**
+     * Let the FDM thread step until closeWindow(). Called by the main
+     * thread around work which does not touch the simulation state.
+     */
+    static void openWindow();
+    static void closeWindow();
+
+    class SteppingWindow
+    {
+    public:
+        SteppingWindow() { openWindow(); }
+        ~SteppingWindow() { closeWindow(); }
+    };
+
+private:
+    struct StateBlock {
+        FGInterface::Pose pose;
+        double time = 0.0;
+    };
+
+    void run();
+    bool step();
+    void present();
+
+    FGInterface* _fdm;
+    const double _stepSec;
+
+    std::mutex _exchangeLock;
+    StateBlock _blocks[2];
+    int _latest = 0;
+    double _queuedSec = 0.0;
+
+    // only touched outside a window, or by the stepping thread inside one
+    double _queuedTotal = 0.0;
+    SGTimeStamp _lastQueued;
+    bool _presented = false;
+    FGInterface::Pose _presentedPose;
+    double _fdmTime = 0.0;
+
+    std::atomic<bool> _quit{false};
+    std::thread _thread;
+};
+
+} // namespace flightgear
@@ -556,6 +556,15 @@ void FGJSBsim::update( double dt )
         break;
       }
       update_external_forces(fdmex->GetSimTime() + i * fdmex->GetDeltaT());
+
+      if (has_substep_callbacks()) {
+        // let the callbacks see this substep's state, and feed what they
+        // write to the controls into the next one
+        copy_from_JSBsim();
+        run_substep_callbacks(fdmex->GetDeltaT());
+        if (i + 1 < multiloop)
+          copy_to_JSBsim();
+      }
     }
 
     FGJSBBase::Message* msg;
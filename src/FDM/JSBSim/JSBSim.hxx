@@ -117,6 +117,8 @@ public:
     // Subsystem identification.
     static const char* staticSubsystemClassId() { return "jsb"; }
 
+    bool supportsSubstepCallbacks() const override { return true; }
+
     /// copy FDM state to LaRCsim structures
     bool copy_to_JSBsim();
 
@@ -287,6 +287,9 @@ void YASim::update(double dt)
         copyToYASim(false);
         _fdm->iterate(_dt);
         copyFromYASim();
+        // anything written to the controls here is picked up by the
+        // copyToYASim() of the next substep
+        run_substep_callbacks(_dt);
     }
 
     // Increment the local sim time
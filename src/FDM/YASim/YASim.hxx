@@ -25,6 +25,8 @@ public:
             std::function<void(const std::string& from, const std::string& to)> fn
             ) override;
 
+    bool supportsSubstepCallbacks() const override { return true; }
+
 private:
     void report();
     void copyFromYASim();
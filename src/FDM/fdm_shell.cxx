@@ -24,12 +24,14 @@
 #  include <config.h>
 #endif
 
+#include <algorithm>
 #include <cassert>
 #include <simgear/structure/exception.hxx>
 #include <simgear/props/props_io.hxx>
 
 #include <FDM/fdm_shell.hxx>
 #include <FDM/flight.hxx>
+#include <FDM/FDMThread.hxx>
 #include <Aircraft/replay.hxx>
 #include <Main/globals.hxx>
 #include <Main/fg_props.hxx>
@@ -120,6 +122,8 @@ void FDMShell::postinit()
 
 void FDMShell::shutdown()
 {
+    _thread.reset();
+
     if (_impl) {
         fgSetBool("/sim/fdm-initialized", false);
         _impl->unbind();
@@ -182,6 +186,11 @@ void FDMShell::doInitAndBind()
 
         fgSetBool("/sim/fdm-initialized", true);
         fgSetBool("/sim/signals/fdm-initialized", true);
+
+        if (_useThread) {
+            SG_LOG(SG_FLIGHT, SG_INFO, "Stepping the FDM on its own thread");
+            _thread.reset(new flightgear::FDMThread(_impl, 1.0 / fgGetInt("/sim/model-hz")));
+        }
     } catch (std::exception& e) {
         flightgear::fatalMessageBoxThenExit("Aircraft FDM initialization error",
                                             string{"The aircraft flight dynamics model contains errors and cannot be used. ("} + e.what() + ")");
@@ -271,14 +280,24 @@ void FDMShell::update(double dt)
   {
       case 0:
           // normal FDM operation
-          _impl->update(dt);
+          if (_thread) {
+              _thread->queue(dt);
+          } else {
+              _impl->update(dt);
+          }
           break;
       case 3:
           // resume FDM operation at current replay position
           _impl->reinit();
+          if (_thread) {
+              _thread->resync();
+          }
           break;
       default:
           // replay is active
+          if (_thread) {
+              _thread->resync();
+          }
           break;
   }
 
@@ -294,9 +313,20 @@ void FDMShell::createImplementation()
 {
   assert(!_impl);
   
-  double dt = 1.0 / fgGetInt("/sim/model-hz");
   string model = fgGetString("/sim/flight-model");
 
+  int substeps = substepsFor(model);
+  double dt = 1.0 / (fgGetInt("/sim/model-hz") * substeps);
+
+  // headless, windows only open in the frame-rate throttle sleep, which
+  // does not happen at all without a maximum frame rate: the FDM would only
+  // be stepped in bursts once it fell MAX_LAG_SEC behind
+  _useThread = (model == "jsb" || model == "yasim") && fgGetBool("/sim/fdm/threaded", false);
+  if (_useThread && fgGetBool("/sim/headless/enabled")) {
+    SG_LOG(SG_FLIGHT, SG_INFO, "Headless: stepping the FDM inline instead of on its own thread");
+    _useThread = false;
+  }
+
   bool fdmUnavailable = false;
 
   if ( model == "ufo" ) {
@@ -408,6 +438,44 @@ void FDMShell::createImplementation()
                 + ("' is not available with this binary (deprecated/disabled).\n"
                    "If you still need it, please rebuild FlightGear and enable its support."));
     }
+
+    attachSubsteps(substeps);
+}
+
+int FDMShell::substepsFor(const string& model)
+{
+    // JSBSim and YASim can integrate each FDM group update in several
+    // substeps, running the substep callbacks (for example fast inner
+    // control loops) in between
+    if ( model == "jsb" || model == "yasim" ) {
+        return std::max(1, fgGetInt("/sim/fdm-substeps", 1));
+    }
+    return 1;
+}
+
+void FDMShell::attachSubsteps(int substeps)
+{
+    _impl->set_substeps(substeps);
+    _impl->set_substep_callbacks(&_substepCallbacks);
+}
+
+bool FDMShell::runsSubstepCallbacks() const
+{
+    return _impl && _impl->supportsSubstepCallbacks();
+}
+
+void FDMShell::addSubstepCallback(const void* owner, std::function<void(double dt)> cb)
+{
+    _substepCallbacks.emplace_back(owner, std::move(cb));
+}
+
+void FDMShell::removeSubstepCallbacks(const void* owner)
+{
+    _substepCallbacks.erase(std::remove_if(_substepCallbacks.begin(), _substepCallbacks.end(),
+                                           [owner](const FGInterface::SubstepCallbackList::value_type& cb) {
+                                               return cb.first == owner;
+                                           }),
+                            _substepCallbacks.end());
 }
 
 void FDMShell::validateOutputProperties()
@@ -23,6 +23,12 @@
 #ifndef FG_FDM_SHELL_HXX
 #define FG_FDM_SHELL_HXX
 
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <simgear/math/SGGeod.hxx>
 #include <simgear/structure/subsystem_mgr.hxx>
 
@@ -32,6 +38,12 @@
 class FGInterface;
 class FGAIManager;
 
+namespace flightgear {
+class FDMThread;
+}
+
+namespace FGTestApi { namespace PrivateAccessor { namespace FDM { class Accessor; } } }
+
 /**
  * Wrap an FDM implementation in a subsystem with standard semantics
  * Notably, deal with the various cases in which update() should not
@@ -42,6 +54,8 @@ class FGAIManager;
  */
 class FDMShell : public SGSubsystem
 {
+    friend class FGTestApi::PrivateAccessor::FDM::Accessor;
+
 public:
     FDMShell();
     ~FDMShell() override;
@@ -60,9 +74,35 @@ public:
 
     FGInterface* getInterface() const;
 
+    /**
+     * True while the FDM steps on its own thread. The rest of the FDM group
+     * then runs once per frame (see TimeManager), against the state the
+     * thread published, instead of model-hz times against the same state.
+     */
+    bool isThreaded() const { return _thread != nullptr; }
+
+    /**
+     * Run cb inside the FDM integration loop, after every substep.  Only
+     * FDMs integrating in substeps (JSBSim and YASim) call these, so callers
+     * must check runsSubstepCallbacks() and keep updating themselves while
+     * it is false; owner identifies the registration for
+     * removeSubstepCallbacks().
+     */
+    void addSubstepCallback(const void* owner, std::function<void(double dt)> cb);
+    void removeSubstepCallbacks(const void* owner);
+
+    /// true if the current FDM implementation runs the substep callbacks
+    bool runsSubstepCallbacks() const;
+
 private:
     void createImplementation();
 
+    // number of substeps per FDM group update for the given flight model
+    static int substepsFor(const std::string& model);
+
+    // let the new _impl integrate in substeps and run _substepCallbacks
+    void attachSubsteps(int substeps);
+
     void validateOutputProperties();
 
     void doInitAndBind();
@@ -85,6 +125,14 @@ private:
     SGSharedPtr<FGAIManager> _ai_mgr;
     SGPropertyNode_ptr _max_radius_nm;
     SGPropertyNode_ptr _ai_wake_enabled;
+
+    // JSBSim and YASim step on their own thread with /sim/fdm/threaded,
+    // except when headless: no rendering runs there to overlap with
+    bool _useThread = false;
+    std::unique_ptr<flightgear::FDMThread> _thread;
+
+    // handed to each FDM implementation, see FGInterface::set_substep_callbacks
+    std::vector<std::pair<const void*, std::function<void(double)>>> _substepCallbacks;
 };
 
 #endif // of FG_FDM_SHELL_HXX
@@ -68,11 +68,24 @@ FGInterface::_calc_multiloop (double dt)
         return 0; // paused
     }
 
-    // this method is now obsolete - multiloop is handled by
-    // SGSubsystemGroup; the FDM group operates with a fixed time interval
-    // (defined by /sim/model-hz), so at this level we always want to run
-    // exactly one FDM iteration
-    return 1;
+    // multiloop is handled by SGSubsystemGroup; the FDM group operates
+    // with a fixed time interval (defined by /sim/model-hz), so at this
+    // level we only run more than one FDM iteration when the FDM was set
+    // up to integrate in substeps (/sim/fdm-substeps)
+    return _substeps;
+}
+
+
+void
+FGInterface::run_substep_callbacks (double dt)
+{
+    if (!_substepCallbacks) {
+        return;
+    }
+
+    for (const auto& cb : *_substepCallbacks) {
+        cb.second(dt);
+    }
 }
 
 
@@ -525,6 +538,17 @@ void FGInterface::_updatePosition(const SGGeoc& geoc)
 }
 
 
+void FGInterface::setPose(const Pose& pose)
+{
+    _state.geodetic_position_v = pose.position;
+    _state.cartesian_position_v = SGVec3d::fromGeod(_state.geodetic_position_v);
+    _state.geocentric_position_v = SGGeoc::fromCart(_state.cartesian_position_v);
+    _set_Sea_level_radius( SGGeodesy::SGGeodToSeaLevelRadius(_state.geodetic_position_v)*SG_METER_TO_FEET );
+
+    _state.euler_angles_v = pose.euler;
+}
+
+
 void FGInterface::_updateGeodeticPosition( double lat, double lon, double alt )
 {
     _updatePosition(SGGeod::fromRadFt(lon, lat, alt));
@@ -75,6 +75,8 @@
 
 #include <cmath>
 #include <functional>
+#include <utility>
+#include <vector>
 
 #include <simgear/compiler.h>
 #include <simgear/constants.h>
@@ -227,6 +229,15 @@ class FGInterface : public SGSubsystem
 protected:
     int _calc_multiloop (double dt);
 
+    // true if anything is registered to run between integration substeps
+    bool has_substep_callbacks() const {
+        return _substepCallbacks && !_substepCallbacks->empty();
+    }
+
+    // run the substep callbacks; call after each integration substep once
+    // the new state has been copied back into this interface
+    void run_substep_callbacks(double dt);
+
 
     // deliberately not virtual so that
     // FGInterface constructor will call
@@ -400,6 +411,53 @@ public:
     virtual bool ToggleDataLogging(bool state) { return false; }
     virtual bool ToggleDataLogging(void) { return false; }
 
+    using SubstepCallback = std::function<void(double dt)>;
+    using SubstepCallbackList = std::vector<std::pair<const void*, SubstepCallback>>;
+
+    /**
+     * Integrate each update() in n substeps of dt/n, for FDMs whose update
+     * loop supports it (JSBSim and YASim).  The FDM must have been
+     * constructed with the substep dt.
+     */
+    void set_substeps(int n) { _substeps = n; }
+    int get_substeps() const { return _substeps; }
+
+    /**
+     * Callbacks to run after each integration substep.  The list is owned
+     * by the FDMShell, so registrations survive the FDM being recreated.
+     */
+    void set_substep_callbacks(const SubstepCallbackList* callbacks) {
+        _substepCallbacks = callbacks;
+    }
+
+    /**
+     * True if update() runs the substep callbacks after each integration
+     * substep.  Clients must keep updating themselves otherwise.
+     */
+    virtual bool supportsSubstepCallbacks() const { return false; }
+
+    /**
+     * Position and attitude, as handed between a threaded FDM and the
+     * main thread (see flightgear::FDMThread).
+     */
+    struct Pose {
+        SGGeod position;
+        SGVec3d euler; // phi, theta, psi in radians
+    };
+
+    Pose getPose() const {
+        return {_state.geodetic_position_v, _state.euler_angles_v};
+    }
+
+    // Unlike _set_Geodetic_Position(), this leaves the track and path alone,
+    // and does not query the ground elevation (it runs on the FDM thread)
+    void setPose(const Pose& pose);
+
+private:
+    int _substeps = 1;
+    const SubstepCallbackList* _substepCallbacks = nullptr;
+
+public:
     bool readState(SGIOChannel* io);
     bool writeState(SGIOChannel* io);
     
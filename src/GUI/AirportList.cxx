@@ -7,6 +7,9 @@
 
 #include "AirportList.hxx"
 
+// matches listed for a filter; the best ones come first
+static const unsigned int MAX_FILTERED_MATCHES = 1000;
+
 AirportList::AirportList(int x, int y, int width, int height) :
     puaList(x, y, width, height),
     GUI_ID(FGCLASS_AIRPORTLIST),
@@ -25,7 +28,7 @@ AirportList::~AirportList()
 void
 AirportList::create_list()
 {
-   char **content = FGAirport::searchNamesAndIdents(_filter);
+   char **content = FGAirport::searchNamesAndIdents(_filter, MAX_FILTERED_MATCHES);
    int n = (content[0] != NULL) ? 1 : 0;
     
     // work around plib 2006/04/18 bug: lists with no entries cause crash on arrow-up
@@ -188,7 +188,8 @@ void NavaidSearchModel::setSearch(QString t, NavaidSearchModel::AircraftType air
     resort();
     endResetModel();
 
-    m_search.reset(new NavDataCache::ThreadedGUISearch(term, m_airportsOnly));
+    const unsigned int maxResults = (m_maxResults > 0) ? static_cast<unsigned int>(m_maxResults) : 0;
+    m_search.reset(new NavDataCache::ThreadedGUISearch(term, m_airportsOnly, maxResults));
     QTimer::singleShot(100, this, SLOT(onSearchResultsPoll()));
     m_searchActive = true;
     emit searchActiveChanged();
@@ -558,6 +558,7 @@ TCAS::ThreatDetector::update(void)
     self.heading       = nodeHeading->getDoubleValue();
     self.velocityKt    = nodeVelocity->getDoubleValue();
     self.verticalFps   = nodeVerticalFps->getDoubleValue();
+    self.cart          = SGVec3d::fromGeod(SGGeod::fromDegFt(self.lon, self.lat, self.pressureAltFt));
 
     /* radar altimeter provides a lot of spikes due to uneven terrain
      * MK-VIII GPWS-spec requires smoothing the radar altitude with a
@@ -581,62 +582,19 @@ TCAS::ThreatDetector::update(void)
     tcas->advisoryGenerator.setAlarmThresholds(pAlarmThresholds);
 }
 
-// If plane's transponder is enabled, return true with o_altFt set to
-// altitude. Otherwise return false.
-//
-static bool checkTransponderLocal(const SGPropertyNode* pModel, float velocityKt, float& o_altFt)
-{
-    if (pModel->getBoolValue("controls/invisible", false /*default*/))
-    {
-        // For MP aircraft (name='multiplayer') that are being ignored.
-        return false;
-    }
-    if (pModel->getNameString() == "swift")
-    {
-        /* Transponder info is in ./swift/transponder/ but altitude needs to
-        come from ./position/altitude-ft. */
-        bool xpdr_on = pModel->getBoolValue("swift/transponder/c-mode", false);
-        if (!xpdr_on) return false;
-        o_altFt = pModel->getDoubleValue("position/altitude-ft");
-        return true;
-    }
-    else if (pModel->getNameString() == "aircraft")
-    {
-        /* assume all non-MP and non-Swift (i.e. AI) aircraft have their transponder switched off while taxiing/parking
-         * (at low speed) */
-        if (velocityKt < 40.0)  return false;
-        o_altFt = pModel->getDoubleValue("position/altitude-ft");
-        return true;
-    }
-    o_altFt = pModel->getIntValue("instrumentation/transponder/altitude", -9999);
-    // must have Mode C (altitude) transponder to be visible.
-    // "-9999" is a special value used by src/Instrumentation/transponder.cxx to indicate the non-transmission of a value.
-    return (o_altFt != -9999);
-}
-
-/** Check if plane's transponder is enabled. */
-bool
-TCAS::ThreatDetector::checkTransponder(const SGPropertyNode* pModel, float velocityKt)
-{
-    float altFt;
-    return checkTransponderLocal(pModel, velocityKt, altFt);
-}
-
 /** Check if plane is a threat. */
 int
-TCAS::ThreatDetector::checkThreat(int mode, const SGPropertyNode* pModel)
+TCAS::ThreatDetector::checkThreat(int mode, const FGAIManager::TrafficTarget& target)
 {
 #ifdef FEATURE_TCAS_DEBUG_THREAT_DETECTOR
     checkCount++;
 #endif
-    if (!pModel->getBoolValue("valid", true))
+    // must have Mode C (altitude) transponder to be visible
+    if (target.hidden || !target.transponder)
         return ThreatInvisible;
 
-    float velocityKt  = pModel->getDoubleValue("velocities/true-airspeed-kt");
-
-    float altFt;
-    if (!checkTransponderLocal(pModel, velocityKt, altFt))
-        return ThreatInvisible;
+    float velocityKt  = target.speedKt;
+    float altFt       = target.reportedAltFt;
 
     int threatLevel = ThreatNone;
     currentThreat.relativeAltitudeFt = altFt - self.pressureAltFt;
@@ -645,10 +603,16 @@ TCAS::ThreatDetector::checkThreat(int mode, const SGPropertyNode* pModel)
     if (fabs(currentThreat.relativeAltitudeFt) > tcas->_verticalRange)
         return threatLevel;
 
+    // save more computation time: cheap straight-line check before the great
+    // circle one
+    if (!target.mayBeWithin(self.cart, self.pressureAltFt,
+                            tcas->_lateralRange * SG_NM_TO_METER, tcas->_verticalRange))
+        return threatLevel;
+
     // position data of current intruder
-    double lat        = pModel->getDoubleValue("position/latitude-deg");
-    double lon        = pModel->getDoubleValue("position/longitude-deg");
-    float heading     = pModel->getDoubleValue("orientation/true-heading-deg");
+    double lat        = target.position.getLatitudeDeg();
+    double lon        = target.position.getLongitudeDeg();
+    float heading     = target.headingDeg;
 
     double distanceNm, bearing;
     calcRangeBearing(self.lat, self.lon, lat, lon, distanceNm, bearing);
@@ -657,7 +621,7 @@ TCAS::ThreatDetector::checkThreat(int mode, const SGPropertyNode* pModel)
     if ((distanceNm > tcas->_lateralRange) || (distanceNm < 0))
         return threatLevel;
 
-    currentThreat.verticalFps = pModel->getDoubleValue("velocities/vertical-speed-fps");
+    currentThreat.verticalFps = target.verticalFps;
 
     /* Detect proximity targets
      * [TCASII]: "Any target that is less than 6 nmi in range and within +/-1200ft
@@ -678,7 +642,7 @@ TCAS::ThreatDetector::checkThreat(int mode, const SGPropertyNode* pModel)
 
     if (tcas->tracker.active())
     {
-        currentThreat.callsign = pModel->getStringValue("callsign");
+        currentThreat.callsign = target.object->getCallSign();
         currentThreat.isTracked = tcas->tracker.isTracked(currentThreat.callsign);
     }
     else
@@ -705,14 +669,14 @@ TCAS::ThreatDetector::checkThreat(int mode, const SGPropertyNode* pModel)
             (currentThreat.verticalTau < 0))
         {
             // do not trigger new alerts when Tau is negative, but keep existing alerts
-            int previousThreatLevel = pModel->getIntValue("tcas/threat-level", 0);
+            int previousThreatLevel = target.object->getThreatLevelNode()->getIntValue();
             if (previousThreatLevel == 0)
                 return threatLevel;
         }
     }
 
 #ifdef FEATURE_TCAS_DEBUG_THREAT_DETECTOR
-    cout << "#" << checkCount << ": " << pModel->getStringValue("callsign") << endl;
+    cout << "#" << checkCount << ": " << target.object->getCallSign() << endl;
 #endif
 
 
@@ -726,7 +690,7 @@ TCAS::ThreatDetector::checkThreat(int mode, const SGPropertyNode* pModel)
         threatLevel = ThreatRA;
 
     if (!tcas->tracker.active())
-        currentThreat.callsign = pModel->getStringValue("callsign");
+        currentThreat.callsign = target.object->getCallSign();
 
     tcas->tracker.add(currentThreat.callsign, threatLevel);
 
@@ -1333,20 +1297,19 @@ TCAS::update(double dt)
         else
 #endif
         {
-            SGPropertyNode* pAi = fgGetNode("/ai/models", true);
+            auto aiManager = globals->get_subsystem<FGAIManager>();
 
             // check all aircraft
-            for (int i = pAi->nChildren() - 1; i >= -1; i--)
+            if (aiManager)
             {
-                SGPropertyNode* pModel = pAi->getChild(i);
-                if ((pModel)&&(pModel->nChildren()))
+                for (const auto& target : aiManager->getTraffic())
                 {
-                    int threatLevel = threatDetector.checkThreat(mode, pModel);
+                    int threatLevel = threatDetector.checkThreat(mode, target);
                     /* expose aircraft threat-level (to be used by other instruments,
                      * i.e. TCAS display) */
                     if (threatLevel==ThreatRA)
-                        pModel->setIntValue("tcas/ra-sense", -threatDetector.getRASense());
-                    pModel->setIntValue("tcas/threat-level", threatLevel);
+                        target.object->getRASenseNode()->setIntValue(-threatDetector.getRASense());
+                    target.object->getThreatLevelNode()->setIntValue(threatLevel);
                 }
             }
         }
@@ -28,6 +28,7 @@
 
 #include <simgear/props/props.hxx>
 #include <simgear/structure/subsystem_mgr.hxx>
+#include <AIModel/AIManager.hxx>
 #include <Sound/voiceplayer.hxx>
 
 class SGSampleGroup;
@@ -139,6 +140,7 @@ class TCAS : public SGSubsystem
         float  heading;
         float  velocityKt;
         float  verticalFps;
+        SGVec3d cart;
     } LocalInfo; /*< info structure for local aircraft */
 
     /////////////////////////////////////////////////////////////////////////////
@@ -311,8 +313,7 @@ class TCAS : public SGSubsystem
         void  init                (void);
         void  update              (void);
 
-        bool  checkTransponder    (const SGPropertyNode* pModel, float velocityKt);
-        int   checkThreat         (int mode, const SGPropertyNode* pModel);
+        int   checkThreat         (int mode, const FGAIManager::TrafficTarget& target);
         void  checkVerticalThreat (void);
         void  horizontalThreat    (float bearing, float distanceNm, float heading,
                                    float velocityKt);
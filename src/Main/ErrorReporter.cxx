@@ -621,6 +621,10 @@ bool ErrorReporter::ErrorReporterPrivate::showErrorReportCommand(const SGPropert
     presentErrorToUser(report);
 
     auto gui = globals->get_subsystem<NewGUI>();
+    if (!gui) {
+        return false; // headless: the report is only logged
+    }
+
     if (!gui->getDialog("error-report")) {
         gui->showDialog("error-report");
     }
@@ -897,7 +901,9 @@ void ErrorReporter::update(double dt)
     // as this can trigger deadlocks
     if (showDialog) {
         auto gui = globals->get_subsystem<NewGUI>();
-        gui->showDialog("error-report");
+        if (gui) {
+            gui->showDialog("error-report");
+        }
         // this needs a bit more thought, disabling for the now
 #if 0
         // pause the sim when showing the popup
@@ -0,0 +1,192 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "PropertyAccessStats.hxx"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+#include <simgear/debug/logstream.hxx>
+
+namespace flightgear {
+
+namespace {
+
+const char* kindNames[PropertyAccessStats::NUM_KINDS] = {
+    "get",
+    "set",
+    "lookup",
+    "tree-walk",
+    "string-conversion",
+    "notification"
+};
+
+} // of anonymous namespace
+
+std::atomic<PropertyAccessStats*> PropertyAccessStats::s_active{nullptr};
+
+uint64_t PropertyAccessStats::Counters::total() const
+{
+    uint64_t result = 0;
+    for (auto c : counts) {
+        result += c;
+    }
+    return result;
+}
+
+PropertyAccessStats::PropertyAccessStats() = default;
+
+PropertyAccessStats::~PropertyAccessStats()
+{
+    setEnabled(false, nullptr);
+}
+
+void PropertyAccessStats::setEnabled(bool enabled, SGPropertyNode* root)
+{
+    if (enabled == isEnabled()) {
+        return;
+    }
+
+    if (enabled) {
+        _root = root;
+        _root->addChangeListener(this);
+        s_active.store(this);
+        SG_LOG(SG_GENERAL, SG_INFO, "Property access statistics enabled");
+    } else {
+        PropertyAccessStats* self = this;
+        s_active.compare_exchange_strong(self, nullptr);
+        _root->removeChangeListener(this);
+        _root.clear();
+        SG_LOG(SG_GENERAL, SG_INFO, "Property access statistics disabled");
+    }
+}
+
+void PropertyAccessStats::countPath(const char* path, Kind kind)
+{
+    if (!path) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> g(_lock);
+    _paths[path].counts[kind]++;
+}
+
+void PropertyAccessStats::valueChanged(SGPropertyNode* node)
+{
+    // every listener between the node and the root is notified; the
+    // change bubbles up to us last, so don't count ourselves
+    int listeners = -1;
+    for (const SGPropertyNode* n = node; n; n = n->getParent()) {
+        listeners += n->nListeners();
+    }
+
+    if (listeners <= 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> g(_lock);
+    auto& entry = _notified[node];
+    if (!entry.first) {
+        entry.first = node;
+    }
+    entry.second += listeners;
+}
+
+void PropertyAccessStats::frameDone()
+{
+    std::lock_guard<std::mutex> g(_lock);
+    ++_frames;
+}
+
+void PropertyAccessStats::reset()
+{
+    std::lock_guard<std::mutex> g(_lock);
+    _paths.clear();
+    _notified.clear();
+    _frames = 0;
+}
+
+std::vector<PropertyAccessStats::Entry>
+PropertyAccessStats::topEntries(size_t maxEntries, uint64_t& frames)
+{
+    std::unordered_map<std::string, Counters> merged;
+    {
+        std::lock_guard<std::mutex> g(_lock);
+        frames = _frames;
+        merged = _paths;
+        for (const auto& n : _notified) {
+            merged[n.second.first->getPath()].counts[NOTIFICATION] += n.second.second;
+        }
+    }
+
+    std::vector<Entry> result(merged.begin(), merged.end());
+    const size_t count = std::min(maxEntries, result.size());
+    std::partial_sort(result.begin(), result.begin() + count, result.end(),
+                      [](const Entry& a, const Entry& b) {
+                          return a.second.total() > b.second.total();
+                      });
+    result.resize(count);
+    return result;
+}
+
+void PropertyAccessStats::writeReport(std::ostream& os, size_t maxEntries)
+{
+    uint64_t frames = 0;
+    const auto entries = topEntries(maxEntries, frames);
+    const double perFrame = 1.0 / std::max<uint64_t>(frames, 1);
+
+    os << "Property access statistics over " << frames
+       << " frames (calls per frame)\n";
+    os << std::setw(10) << "total";
+    for (auto name : kindNames) {
+        os << std::setw(19) << name;
+    }
+    os << "  path\n";
+
+    os << std::fixed << std::setprecision(2);
+    for (const auto& e : entries) {
+        os << std::setw(10) << e.second.total() * perFrame;
+        for (auto c : e.second.counts) {
+            os << std::setw(19) << c * perFrame;
+        }
+        os << "  " << e.first << "\n";
+    }
+}
+
+void PropertyAccessStats::updateProperties(SGPropertyNode* statsNode, size_t maxEntries)
+{
+    uint64_t frames = 0;
+    const auto entries = topEntries(maxEntries, frames);
+    const double perFrame = 1.0 / std::max<uint64_t>(frames, 1);
+
+    // written outside the lock: these writes reach valueChanged() too
+    statsNode->setLongValue("frames", static_cast<long>(frames));
+    statsNode->removeChildren("entry");
+    for (size_t i = 0; i < entries.size(); ++i) {
+        SGPropertyNode* n = statsNode->getChild("entry", static_cast<int>(i), true);
+        n->setStringValue("path", entries[i].first);
+        n->setDoubleValue("total", entries[i].second.total() * perFrame);
+        for (int k = 0; k < NUM_KINDS; ++k) {
+            n->setDoubleValue(kindNames[k], entries[i].second.counts[k] * perFrame);
+        }
+    }
+}
+
+} // namespace flightgear
@@ -0,0 +1,113 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <simgear/props/props.hxx>
+
+namespace flightgear {
+
+/**
+ * Optional counters for by-path property access, to find the code doing
+ * string lookups, string conversions or heavy listener fan-out each frame.
+ *
+ * While enabled, the fgGet* / fgSet* / fgGetNode helpers report every call
+ * here, keyed by path, and a listener on the property root counts how many
+ * change listeners each write notifies. Results are averaged over the
+ * frames seen since the last reset.
+ */
+class PropertyAccessStats : public SGPropertyChangeListener
+{
+public:
+    enum Kind {
+        GET = 0,
+        SET,
+        LOOKUP,
+        TREE_WALK,
+        STRING_CONVERSION,
+        NOTIFICATION,
+        NUM_KINDS
+    };
+
+    PropertyAccessStats();
+    ~PropertyAccessStats();
+
+    /**
+     * Record one access to a path, if instrumentation is enabled. Cheap
+     * enough to leave in the helpers permanently.
+     */
+    static void count(const char* path, Kind kind)
+    {
+        PropertyAccessStats* stats = s_active.load(std::memory_order_relaxed);
+        if (stats) {
+            stats->countPath(path, kind);
+        }
+    }
+
+    void setEnabled(bool enabled, SGPropertyNode* root);
+    bool isEnabled() const { return _root.valid(); }
+
+    void frameDone();
+    void reset();
+
+    /**
+     * Write the top entries, ordered by total calls per frame, as a table.
+     */
+    void writeReport(std::ostream& os, size_t maxEntries);
+
+    /**
+     * Publish the top entries as entry[n] children of the given node.
+     */
+    void updateProperties(SGPropertyNode* statsNode, size_t maxEntries);
+
+    // SGPropertyChangeListener
+    void valueChanged(SGPropertyNode* node) override;
+
+private:
+    struct Counters {
+        std::array<uint64_t, NUM_KINDS> counts = {};
+
+        uint64_t total() const;
+    };
+
+    using Entry = std::pair<std::string, Counters>;
+
+    void countPath(const char* path, Kind kind);
+    std::vector<Entry> topEntries(size_t maxEntries, uint64_t& frames);
+
+    static std::atomic<PropertyAccessStats*> s_active;
+
+    std::mutex _lock;
+    std::unordered_map<std::string, Counters> _paths;
+    // notifications are keyed by node; paths are only built for reports
+    std::unordered_map<SGPropertyNode*, std::pair<SGPropertyNode_ptr, uint64_t>> _notified;
+    uint64_t _frames = 0;
+    SGPropertyNode_ptr _root;
+};
+
+} // namespace flightgear
@@ -0,0 +1,395 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "SubsystemScheduler.hxx"
+
+#include <algorithm>
+#include <iterator>
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/structure/exception.hxx>
+
+namespace flightgear {
+
+namespace {
+
+const char* groupNames[SGSubsystemMgr::MAX_GROUPS] = {
+    "init",
+    "general",
+    "fdm",
+    "post-fdm",
+    "display",
+    "sound"
+};
+
+// property subtrees overlap when one is the other or one of its parents
+bool overlaps(const std::string& a, const std::string& b)
+{
+    const std::string& shorter = (a.size() <= b.size()) ? a : b;
+    const std::string& longer = (a.size() <= b.size()) ? b : a;
+    if (longer.compare(0, shorter.size(), shorter) != 0) {
+        return false;
+    }
+
+    return (longer.size() == shorter.size()) || (shorter.back() == '/') ||
+           (longer[shorter.size()] == '/');
+}
+
+bool anyOverlap(const string_list& a, const string_list& b)
+{
+    for (const auto& x : a) {
+        for (const auto& y : b) {
+            if (overlaps(x, y)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool contains(const string_list& list, const std::string& s)
+{
+    return std::find(list.begin(), list.end(), s) != list.end();
+}
+
+double elapsedMSecSince(const SGTimeStamp& start)
+{
+    return (SGTimeStamp::now() - start).toUSecs() / 1000.0;
+}
+
+} // of anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+SubsystemScheduler::SubsystemScheduler(SGSubsystemMgr* mgr) :
+    _mgr(mgr)
+{
+}
+
+SubsystemScheduler::~SubsystemScheduler() = default;
+
+void SubsystemScheduler::declare(const std::string& name,
+                                 const string_list& reads,
+                                 const string_list& writes,
+                                 const string_list& after)
+{
+    Declaration& d = _declarations[name];
+    d.reads = reads;
+    d.writes = writes;
+    d.after = after;
+    ++_revision;
+}
+
+void SubsystemScheduler::setMinStep(const std::string& name, double minStepSec)
+{
+    if (minStepSec > 0.0) {
+        _minSteps[name] = minStepSec;
+    } else {
+        _minSteps.erase(name);
+    }
+    ++_revision;
+}
+
+void SubsystemScheduler::setEnabled(bool enabled)
+{
+    if (enabled == _enabled) {
+        return;
+    }
+
+    SG_LOG(SG_GENERAL, SG_INFO, "Subsystem scheduler: " << (enabled ? "enabled" : "disabled"));
+    _enabled = enabled;
+}
+
+bool SubsystemScheduler::isScheduled(int group)
+{
+    // FDM runs a fixed number of substeps, and DISPLAY and SOUND talk to
+    // OSG and the sound device: none of them could ever share a wave
+    return (group == SGSubsystemMgr::GENERAL) || (group == SGSubsystemMgr::POST_FDM);
+}
+
+bool SubsystemScheduler::conflicts(const Member& earlier, const Member& later)
+{
+    const Declaration* a = earlier.declaration;
+    const Declaration* b = later.declaration;
+    if (!a || !b) {
+        return true;
+    }
+
+    if (contains(b->after, earlier.name) || contains(a->after, later.name)) {
+        return true;
+    }
+
+    return anyOverlap(a->writes, b->writes) ||
+           anyOverlap(a->writes, b->reads) ||
+           anyOverlap(b->writes, a->reads);
+}
+
+bool SubsystemScheduler::planIsCurrent(SGSubsystemGroup* group, const Plan& plan) const
+{
+    if (plan.revision != _revision) {
+        return false;
+    }
+
+    const string_list names = group->member_names();
+    if (names.size() != plan.members.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < names.size(); ++i) {
+        const Member& m = plan.members[i];
+        if ((m.name != names[i]) || (m.subsystem != group->get_subsystem(names[i]))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void SubsystemScheduler::rebuildPlan(SGSubsystemGroup* group, Plan& plan)
+{
+    std::vector<Member> members;
+    for (const auto& name : group->member_names()) {
+        Member m;
+        m.name = name;
+        m.subsystem = group->get_subsystem(name);
+
+        auto d = _declarations.find(name);
+        if (d != _declarations.end()) {
+            m.declaration = &d->second;
+        }
+
+        auto step = _minSteps.find(name);
+        if (step != _minSteps.end()) {
+            m.minStep = step->second;
+        }
+
+        // keep accumulated time and timing of members we already had
+        auto old = std::find_if(plan.members.begin(), plan.members.end(),
+                                [&m](const Member& o) { return o.subsystem == m.subsystem; });
+        if (old != plan.members.end()) {
+            m.elapsed = old->elapsed;
+            m.lastMSec = old->lastMSec;
+            m.totalMSec = old->totalMSec;
+            m.maxMSec = old->maxMSec;
+            m.updates = old->updates;
+        }
+
+        members.push_back(m);
+    }
+
+    plan.waves.clear();
+    for (size_t i = 0; i < members.size(); ++i) {
+        unsigned int wave = 0;
+        for (size_t j = 0; j < i; ++j) {
+            if (conflicts(members[j], members[i])) {
+                wave = std::max(wave, members[j].wave + 1);
+            }
+        }
+
+        members[i].wave = wave;
+        if (plan.waves.size() <= wave) {
+            plan.waves.resize(wave + 1);
+        }
+        plan.waves[wave].push_back(i);
+    }
+
+    plan.members = std::move(members);
+    plan.revision = _revision;
+
+    // without minimum steps there is no time to hand back to the group
+    plan.ownsElapsed = plan.ownsElapsed &&
+        std::any_of(plan.members.begin(), plan.members.end(),
+                    [](const Member& m) { return m.minStep > 0.0; });
+}
+
+// the same accounting as SGSubsystemGroup: time accumulates while the
+// member is suspended, and is handed over once it resumes
+void SubsystemScheduler::updateMember(Member& member, double dt)
+{
+    member.elapsed += dt;
+    if ((member.elapsed < member.minStep) || !member.subsystem ||
+        member.subsystem->is_suspended()) {
+        return;
+    }
+
+    const SGTimeStamp start = SGTimeStamp::now();
+    try {
+        member.subsystem->update(member.elapsed);
+    } catch (const sg_exception& e) {
+        SG_LOG(SG_GENERAL, SG_ALERT, "caught exception updating subsystem "
+               << member.name << ": " << e.getFormattedMessage());
+    } catch (const std::exception& e) {
+        SG_LOG(SG_GENERAL, SG_ALERT, "caught exception updating subsystem "
+               << member.name << ": " << e.what());
+    }
+    member.elapsed = 0.0;
+
+    member.lastMSec = elapsedMSecSince(start);
+    member.totalMSec += member.lastMSec;
+    member.maxMSec = std::max(member.maxMSec, member.lastMSec);
+    ++member.updates;
+}
+
+void SubsystemScheduler::updateGroup(SGSubsystemGroup* group, Plan& plan, double dt)
+{
+    if (!planIsCurrent(group, plan)) {
+        rebuildPlan(group, plan);
+    }
+
+    for (auto& m : plan.members) {
+        m.lastMSec = 0.0;
+        updateMember(m, dt);
+        plan.ownsElapsed |= (m.minStep > 0.0);
+    }
+}
+
+// follow the group's accumulators while it updates the members itself
+void SubsystemScheduler::trackGroupElapsed(SGSubsystemGroup* group, Plan& plan, double dt)
+{
+    if (!planIsCurrent(group, plan)) {
+        rebuildPlan(group, plan);
+    }
+
+    for (auto& m : plan.members) {
+        if (m.minStep <= 0.0) {
+            continue;
+        }
+
+        m.elapsed += dt;
+        if ((m.elapsed >= m.minStep) && m.subsystem && !m.subsystem->is_suspended()) {
+            m.elapsed = 0.0;
+        }
+    }
+}
+
+void SubsystemScheduler::update(double dt)
+{
+    const bool owning = std::any_of(std::begin(_plans), std::end(_plans),
+                                    [](const Plan& p) { return p.ownsElapsed; });
+    if (!_enabled && !owning) {
+        _mgr->update(dt);
+        if (_minSteps.empty()) {
+            return;
+        }
+
+        for (int g = 0; g < SGSubsystemMgr::MAX_GROUPS; ++g) {
+            auto group = _mgr->get_group(static_cast<SGSubsystemMgr::GroupType>(g));
+            if (isScheduled(g) && group && !group->is_suspended()) {
+                trackGroupElapsed(group, _plans[g], dt);
+            }
+        }
+        return;
+    }
+
+    for (int g = 0; g < SGSubsystemMgr::MAX_GROUPS; ++g) {
+        auto group = _mgr->get_group(static_cast<SGSubsystemMgr::GroupType>(g));
+        if (!group || group->is_suspended()) {
+            continue;
+        }
+
+        Plan& plan = _plans[g];
+        const SGTimeStamp start = SGTimeStamp::now();
+        if (isScheduled(g) && (_enabled || plan.ownsElapsed)) {
+            updateGroup(group, plan, dt);
+        } else {
+            group->update(dt);
+            if (isScheduled(g) && !_minSteps.empty()) {
+                trackGroupElapsed(group, plan, dt);
+            }
+        }
+        plan.lastMSec = elapsedMSecSince(start);
+    }
+}
+
+std::vector<string_list> SubsystemScheduler::waves(SGSubsystemMgr::GroupType type)
+{
+    std::vector<string_list> result;
+    auto group = _mgr->get_group(type);
+    if (!group) {
+        return result;
+    }
+
+    if (!isScheduled(type)) {
+        for (const auto& name : group->member_names()) {
+            result.push_back({name});
+        }
+        return result;
+    }
+
+    Plan& plan = _plans[type];
+    if (!planIsCurrent(group, plan)) {
+        rebuildPlan(group, plan);
+    }
+
+    for (const auto& wave : plan.waves) {
+        string_list names;
+        for (auto index : wave) {
+            names.push_back(plan.members[index].name);
+        }
+        result.push_back(names);
+    }
+    return result;
+}
+
+void SubsystemScheduler::publishTiming(SGPropertyNode* node)
+{
+    node->removeChildren("group");
+    node->removeChildren("subsystem");
+
+    int index = 0;
+    for (int g = 0; g < SGSubsystemMgr::MAX_GROUPS; ++g) {
+        Plan& plan = _plans[g];
+        SGPropertyNode* groupNode = node->getChild("group", g, true);
+        groupNode->setStringValue("name", groupNames[g]);
+        groupNode->setDoubleValue("last-ms", plan.lastMSec);
+        groupNode->setIntValue("waves", static_cast<int>(plan.waves.size()));
+
+        if (!isScheduled(g)) {
+            groupNode->setDoubleValue("critical-path-ms", plan.lastMSec);
+            continue;
+        }
+
+        double criticalPath = 0.0;
+        for (const auto& wave : plan.waves) {
+            double slowest = 0.0;
+            for (auto i : wave) {
+                slowest = std::max(slowest, plan.members[i].lastMSec);
+            }
+            criticalPath += slowest;
+        }
+        groupNode->setDoubleValue("critical-path-ms", criticalPath);
+
+        for (auto& m : plan.members) {
+            SGPropertyNode* n = node->getChild("subsystem", index++, true);
+            n->setStringValue("name", m.name);
+            n->setStringValue("group", groupNames[g]);
+            n->setIntValue("wave", static_cast<int>(m.wave));
+            n->setBoolValue("declared", m.declaration != nullptr);
+            n->setDoubleValue("last-ms", m.lastMSec);
+            n->setDoubleValue("mean-ms", m.updates ? m.totalMSec / m.updates : 0.0);
+            n->setDoubleValue("max-ms", m.maxMSec);
+
+            m.totalMSec = 0.0;
+            m.maxMSec = 0.0;
+            m.updates = 0;
+        }
+    }
+}
+
+} // namespace flightgear
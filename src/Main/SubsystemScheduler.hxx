@@ -0,0 +1,159 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <simgear/props/props.hxx>
+#include <simgear/structure/subsystem_mgr.hxx>
+#include <simgear/timing/timestamp.hxx>
+
+namespace flightgear {
+
+/**
+ * Per-frame subsystem update, optionally measuring which subsystems of
+ * the GENERAL and POST_FDM groups could be updated concurrently.
+ *
+ * Subsystems opt in by declaring the property subtrees they read and
+ * write, and any subsystems they must run after. Within a group, members
+ * are split into waves in registration order: a member joins the first
+ * wave after every earlier member it conflicts with (overlapping writes,
+ * a write overlapping a read, or an explicit dependency). Undeclared
+ * members conflict with everything, so they sit in a wave of their own.
+ * A declaration is a promise that the update touches nothing else: no
+ * Nasal, and no listeners outside the declared writes.
+ *
+ * Disabled, update() is exactly SGSubsystemMgr::update(). Enabled, the
+ * scheduled groups are updated member by member, still in registration
+ * order on the calling thread, and timed: publishTiming() reports each
+ * group's serial time next to its critical path (the sum of the slowest
+ * member of each wave), which bounds what running the waves on a worker
+ * pool could save. No pool is used, since none of the declared members
+ * are both independent and expensive enough to gain from one.
+ */
+class SubsystemScheduler
+{
+public:
+    explicit SubsystemScheduler(SGSubsystemMgr* mgr);
+    ~SubsystemScheduler();
+
+    /**
+     * Declare the property subtrees (e.g. "/ai", "/environment") a
+     * subsystem reads and writes, and the subsystems it has to follow.
+     * Dependencies never reorder members: they only stop two members
+     * sharing a wave.
+     */
+    void declare(const std::string& name,
+                 const string_list& reads,
+                 const string_list& writes,
+                 const string_list& after = {});
+
+    /**
+     * Record the minimum update interval a subsystem was added with,
+     * since the group does not expose it.
+     */
+    void setMinStep(const std::string& name, double minStepSec);
+
+    /**
+     * Switch between the plain manager update and the timed one. Time
+     * accumulated towards a member's minimum step carries over either
+     * way, see update().
+     */
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return _enabled; }
+
+    /**
+     * Update every group. While a group updates its members itself, their
+     * time towards a minimum step is tracked alongside, so enabling hands
+     * it over exactly. The group's own count cannot be set, so a group
+     * with such members stays updated from here once the scheduler has
+     * held its time, even when disabled again.
+     */
+    void update(double dt);
+
+    /**
+     * The current waves of a group, by subsystem name. Only GENERAL and
+     * POST_FDM are scheduled; other groups report a single wave per member.
+     */
+    std::vector<string_list> waves(SGSubsystemMgr::GroupType group);
+
+    /**
+     * Publish per-subsystem timing as subsystem[n] children of the node:
+     * name, group, wave, last-ms, mean-ms and max-ms since the last call;
+     * and per group[n]: name, last-ms, waves, and critical-path-ms, the
+     * last update's time if each wave only took as long as its slowest
+     * member.
+     */
+    void publishTiming(SGPropertyNode* node);
+
+private:
+    struct Declaration {
+        string_list reads;
+        string_list writes;
+        string_list after;
+    };
+
+    struct Member {
+        std::string name;
+        SGSubsystem* subsystem = nullptr;
+        const Declaration* declaration = nullptr;
+        double minStep = 0.0;
+        // time towards minStep; mirrors the group's own accumulator while
+        // the group updates the member itself
+        double elapsed = 0.0;
+        unsigned int wave = 0;
+
+        // timing, in milliseconds, since the last publishTiming()
+        double lastMSec = 0.0;
+        double totalMSec = 0.0;
+        double maxMSec = 0.0;
+        unsigned int updates = 0;
+    };
+
+    struct Plan {
+        std::vector<Member> members;
+        std::vector<std::vector<size_t>> waves;
+        unsigned int revision = 0;
+        double lastMSec = 0.0;
+        // set once members' minimum step time is held here rather than by
+        // the group, which then must not update them itself again
+        bool ownsElapsed = false;
+    };
+
+    static bool isScheduled(int group);
+    static bool conflicts(const Member& earlier, const Member& later);
+
+    bool planIsCurrent(SGSubsystemGroup* group, const Plan& plan) const;
+    void rebuildPlan(SGSubsystemGroup* group, Plan& plan);
+    void updateGroup(SGSubsystemGroup* group, Plan& plan, double dt);
+    void updateMember(Member& member, double dt);
+    void trackGroupElapsed(SGSubsystemGroup* group, Plan& plan, double dt);
+
+    SGSubsystemMgr* _mgr;
+    bool _enabled = false;
+    std::map<std::string, Declaration> _declarations;
+    std::map<std::string, double> _minSteps;
+    // bumped by declare() / setMinStep() so plans are rebuilt
+    unsigned int _revision = 1;
+    Plan _plans[SGSubsystemMgr::MAX_GROUPS];
+};
+
+} // namespace flightgear
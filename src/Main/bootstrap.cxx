@@ -275,7 +275,8 @@ int main ( int argc, char **argv )
     // we don't want to accidently show a GUI box and block startup in
     // non_GUI setups, so check this value early here, before options are
     // processed
-    const bool headless = flightgear::Options::checkForArg(argc, argv, "disable-gui");
+    const bool headless = flightgear::Options::checkForArg(argc, argv, "disable-gui") ||
+                          flightgear::Options::checkForArg(argc, argv, "headless");
     flightgear::setHeadlessMode(headless);
 
 #ifdef ENABLE_SIMD
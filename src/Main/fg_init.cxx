@@ -112,6 +112,7 @@
 #include <Main/locale.hxx>
 #include <Navaids/navdb.hxx>
 #include <Navaids/navlist.hxx>
+#include <Radio/propagation.hxx>
 #include <Scenery/scenery.hxx>
 #include <Scenery/SceneryPager.hxx>
 #include <Scripting/NasalSys.hxx>
@@ -133,6 +134,7 @@
 #include <FDM/fdm_shell.hxx>
 #include <Instrumentation/HUD/HUD.hxx>
 #include <Navaids/NavDataCache.hxx>
+#include <Navaids/ProcedureCache.hxx>
 #include <Network/DNSClient.hxx>
 #include <Network/HTTPClient.hxx>
 #include <Network/fgcom.hxx>
@@ -154,6 +156,7 @@
 #include "logger.hxx"
 #include "main.hxx"
 #include "positioninit.hxx"
+#include "SubsystemScheduler.hxx"
 #include "util.hxx"
 #include "AircraftDirVisitorBase.hxx"
 #include <Main/sentryIntegration.hxx>
@@ -984,13 +987,19 @@ void fgCreateSubsystems(bool duringReset) {
     globals->get_event_mgr()->init();
     globals->get_event_mgr()->setRealtimeProperty(fgGetNode("/sim/time/delta-realtime-sec", true));
 
+    // without a window, subsystems which only draw (or talk) are left out;
+    // the scenery, models and views stay for ground queries and Nasal
+    const bool headless = fgGetBool("/sim/headless/enabled");
+
     // SGSubsystemMgr::INIT
     {
         // Initialize the property interpolator subsystem. Put into the INIT
         // group because the "nasal" subsystem may need it at GENERAL take-down.
         globals->add_subsystem("prop-interpolator", new FGInterpolator, SGSubsystemMgr::INIT);
         globals->add_new_subsystem<Highlight>(SGSubsystemMgr::INIT);
-        globals->add_subsystem("gui", new NewGUI, SGSubsystemMgr::INIT);
+        if (!headless) {
+            globals->add_subsystem("gui", new NewGUI, SGSubsystemMgr::INIT);
+        }
     }
 
     // SGSubsystemMgr::GENERAL
@@ -1057,6 +1066,7 @@ void fgCreateSubsystems(bool duringReset) {
     {
         globals->add_new_subsystem<PerformanceDB>(SGSubsystemMgr::POST_FDM);
         globals->add_subsystem("ATC", new FGATCManager, SGSubsystemMgr::POST_FDM);
+        globals->add_new_subsystem<FGRadioPropagation>(SGSubsystemMgr::POST_FDM);
         globals->add_subsystem("ai-model", new FGAIManager, SGSubsystemMgr::POST_FDM);
         globals->add_subsystem("mp", new FGMultiplayMgr, SGSubsystemMgr::POST_FDM);
 
@@ -1093,20 +1103,54 @@ void fgCreateSubsystems(bool duringReset) {
         fgSetArchivable("/sim/panel/y-offset");
         fgSetArchivable("/sim/panel/jitter");
     }
+
+    // Property domains for the subsystem scheduler. Only declared members
+    // may share a wave; with /sim/subsystem-scheduler/enabled the waves'
+    // critical path is published next to each group's serial time.
+    {
+        auto scheduler = globals->get_subsystem_scheduler();
+        scheduler->declare(Ephemeris::staticSubsystemClassId(),
+                           {"/sim/time", "/position"},
+                           {"/ephemeris", "/environment/moonlight"});
+        scheduler->declare(PerformanceDB::staticSubsystemClassId(), {}, {});
+        // ATC controllers, driven by ATC and by the AI aircraft, queue their
+        // transmissions on the (unlocked) propagation subsystem, and both
+        // sides deliver them to /sim/messages/atc: keep them in separate waves
+        scheduler->declare(FGRadioPropagation::staticSubsystemClassId(),
+                           {"/position", "/orientation", "/sim/radio"},
+                           {"/sim/radio/propagation", "/sim/messages/atc"});
+        scheduler->declare("ATC",
+                           {"/position", "/orientation", "/velocities",
+                            "/autopilot/route-manager"},
+                           {"/ai", "/sim/atc", "/sim/messages/atc"});
+        scheduler->declare("ai-model",
+                           {"/position", "/orientation", "/velocities",
+                            "/environment", "/sim/time"},
+                           {"/ai", "/sim/messages/atc"}, {"ATC"});
+        scheduler->declare("traffic-manager",
+                           {"/position", "/sim/presets", "/environment/metar"},
+                           {"/ai", "/sim/traffic-manager"}, {"ai-model"});
+    }
     
     // SGSubsystemMgr::DISPLAY
     {
-        globals->add_subsystem("hud", new HUD, SGSubsystemMgr::DISPLAY);
-        globals->add_subsystem("cockpit-displays", new flightgear::CockpitDisplayManager, SGSubsystemMgr::DISPLAY);
+        if (!headless) {
+            globals->add_subsystem("hud", new HUD, SGSubsystemMgr::DISPLAY);
+            globals->add_subsystem("cockpit-displays", new flightgear::CockpitDisplayManager, SGSubsystemMgr::DISPLAY);
+        }
 
         simgear::canvas::Canvas::setSystemAdapter(
           simgear::canvas::SystemAdapterPtr(new canvas::FGCanvasSystemAdapter)
         );
         globals->add_subsystem("Canvas", new CanvasMgr, SGSubsystemMgr::DISPLAY);
-        globals->add_subsystem("CanvasGUI", new GUIMgr, SGSubsystemMgr::DISPLAY);
+        if (!headless) {
+            globals->add_subsystem("CanvasGUI", new GUIMgr, SGSubsystemMgr::DISPLAY);
+        }
 
         #ifdef ENABLE_AUDIO_SUPPORT
-        globals->add_subsystem("voice", new FGVoiceMgr, SGSubsystemMgr::DISPLAY);
+        if (!headless) {
+            globals->add_subsystem("voice", new FGVoiceMgr, SGSubsystemMgr::DISPLAY);
+        }
         #endif
 
         // ordering here is important : Nasal (via events), then models, then views
@@ -1285,6 +1329,9 @@ void fgStartNewReset()
     subsystemManger->shutdown();
     subsystemManger->unbind();
 
+    // procedures prefetched for airports nobody looked at
+    flightgear::ProcedureCache::clearPrefetches();
+
     // hack fix for many reset crashes relating to the static instance
     // of this class. Will be fixed better for future versions by making
     // this a proper subsystem.
@@ -1440,10 +1487,12 @@ void fgStartNewReset()
     else {
         viewer->getDatabasePager()->setUpThreads(2, 1);
         viewer->getDatabasePager()->setAcceptNewDatabaseRequests(true);
-        // must do this before preinit for Rembrandthe
-        flightgear::CameraGroup::buildDefaultGroup(viewer.get());
-        render->preinit();
-        viewer->startThreading();
+        if (!fgGetBool("/sim/headless/enabled")) {
+            // must do this before preinit for Rembrandthe
+            flightgear::CameraGroup::buildDefaultGroup(viewer.get());
+            render->preinit();
+            viewer->startThreading();
+        }
     }
     
     fgOSResetProperties();
@@ -22,12 +22,17 @@
 
 #include "config.h"
 
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
 #include <simgear/compiler.h>
 #include <simgear/structure/exception.hxx>
 #include <simgear/props/props_io.hxx>
 #include <simgear/misc/strutils.hxx>
 #include <simgear/timing/sg_time.hxx>
 #include <simgear/misc/sg_path.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
 #include <simgear/scene/model/particles.hxx>
 #include <simgear/sound/soundmgr.hxx>
 
@@ -35,10 +40,13 @@
 
 #include "globals.hxx"
 #include "fg_props.hxx"
+#include "PropertyAccessStats.hxx"
+#include "util.hxx"
 
 static bool frozen = false;	// FIXME: temporary
 
 using std::string;
+using flightgear::PropertyAccessStats;
 ////////////////////////////////////////////////////////////////////////
 // Default property bindings (not yet handled by any module).
 ////////////////////////////////////////////////////////////////////////
@@ -359,7 +367,8 @@ const char* FGProperties::getLatitudeString ()
 }
 
 
-FGProperties::FGProperties ()
+FGProperties::FGProperties () :
+    _accessStats(new PropertyAccessStats)
 {
 }
 
@@ -430,6 +439,18 @@ FGProperties::bind ()
     _magVar = initDoubleNode("/environment/magnetic-variation-deg", 0.0);
     _trueHeading = initDoubleNode("/orientation/heading-deg", 0.0);
     _trueTrack = initDoubleNode("/orientation/track-deg", 0.0);
+
+    // property access instrumentation, off unless asked for
+    _statsNode = fgGetNode("/sim/debug/property-stats", true);
+    _statsEnabled = _statsNode->getChild("enabled", 0, true);
+    _statsCount = _statsNode->getChild("top-count", 0, true);
+    if (_statsCount->getType() == simgear::props::NONE) {
+        _statsCount->setIntValue(20);
+    }
+
+    auto cmdMgr = globals->get_commands();
+    cmdMgr->addCommand("dump-property-stats", this, &FGProperties::commandDumpStats);
+    cmdMgr->addCommand("reset-property-stats", this, &FGProperties::commandResetStats);
 }
 
 void
@@ -437,6 +458,14 @@ FGProperties::unbind ()
 {
     _tiedProperties.Untie();
 
+    _accessStats->setEnabled(false, nullptr);
+    auto cmdMgr = globals->get_commands();
+    cmdMgr->removeCommand("dump-property-stats");
+    cmdMgr->removeCommand("reset-property-stats");
+    _statsNode.clear();
+    _statsEnabled.clear();
+    _statsCount.clear();
+
     // drop static references to properties
     _longDeg = 0;
     _latDeg = 0;
@@ -476,6 +505,58 @@ FGProperties::update (double dt)
     
     const auto trackMag = SGMiscd::normalizePeriodic(0, 360.0, _trueTrack->getDoubleValue() - magvar);
     _trackMagnetic->setDoubleValue(trackMag);
+
+    const bool statsEnabled = _statsEnabled->getBoolValue();
+    if (statsEnabled != _accessStats->isEnabled()) {
+        _accessStats->setEnabled(statsEnabled, globals->get_props());
+        _statsPublished.stamp();
+    }
+
+    if (statsEnabled) {
+        _accessStats->frameDone();
+        // publishing is not free, once a second is plenty
+        if (_statsPublished.elapsedMSec() >= 1000) {
+            _accessStats->updateProperties(_statsNode, std::max(0, _statsCount->getIntValue()));
+            _statsPublished.stamp();
+        }
+    }
+}
+
+bool
+FGProperties::commandDumpStats(const SGPropertyNode* arg, SGPropertyNode* root)
+{
+    const int count = std::max(0, arg->getIntValue("count", _statsCount->getIntValue()));
+    const std::string file = arg->getStringValue("file");
+    if (file.empty()) {
+        std::ostringstream os;
+        _accessStats->writeReport(os, count);
+        SG_LOG(SG_GENERAL, SG_MANDATORY_INFO, os.str());
+        return true;
+    }
+
+    const SGPath path = fgValidatePath(SGPath::fromUtf8(file), true);
+    if (path.isNull()) {
+        SG_LOG(SG_IO, SG_ALERT, "dump-property-stats: writing '" << file << "' denied "
+                "(unauthorized access)");
+        return false;
+    }
+
+    sg_ofstream f(path, std::ios::out | std::ios::trunc);
+    if (!f.is_open()) {
+        SG_LOG(SG_IO, SG_WARN, "dump-property-stats: unable to write " << path);
+        return false;
+    }
+
+    _accessStats->writeReport(f, count);
+    SG_LOG(SG_IO, SG_INFO, "Wrote property access statistics to " << path);
+    return true;
+}
+
+bool
+FGProperties::commandResetStats(const SGPropertyNode* arg, SGPropertyNode* root)
+{
+    _accessStats->reset();
+    return true;
 }
 
 
@@ -563,15 +644,90 @@ fgLoadProps (const std::string& path, SGPropertyNode * props, bool in_fg_root, i
 // Property convenience functions.
 ////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+// Interned path -> node cache behind the fgGet*/fgSet* helpers. Most hot
+// callers pass string literals, so the C-string address is the key; the
+// stored copy of the path guards against a buffer being reused for a
+// different path. Each thread keeps its own table, so lookups take no lock.
+struct PathCacheEntry
+{
+    std::string path;
+    SGPropertyNode_ptr node;
+};
+
+// paths built at runtime each get their own key; drop everything rather
+// than grow without bound
+const size_t MAX_CACHED_PATHS = 4096;
+
+// A cached node is only valid while it is still reachable from the current
+// root: removal marks the removed node, and destroying a node (including
+// an old root after a reset) clears the parent pointers of its children.
+bool isAttached(const SGPropertyNode* node, const SGPropertyNode* root)
+{
+    for (; node; node = node->getParent()) {
+        if (node == root) {
+            return true;
+        }
+
+        if (node->getAttribute(SGPropertyNode::REMOVED)) {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+SGPropertyNode* cachedNode(const char* path, bool create)
+{
+    SGPropertyNode* root = globals->get_props();
+    thread_local std::unordered_map<const char*, PathCacheEntry> cache;
+
+    auto it = cache.find(path);
+    if (it != cache.end()) {
+        const PathCacheEntry& entry = it->second;
+        if ((entry.path == path) && isAttached(entry.node, root)) {
+            return entry.node;
+        }
+    }
+
+    PropertyAccessStats::count(path, PropertyAccessStats::TREE_WALK);
+    SGPropertyNode* node = root->getNode(path, create);
+    if (!node) {
+        // missing nodes are not cached, they may be created later
+        if (it != cache.end()) {
+            cache.erase(it);
+        }
+        return nullptr;
+    }
+
+    if (it != cache.end()) {
+        it->second.path = path;
+        it->second.node = node;
+    } else {
+        if (cache.size() >= MAX_CACHED_PATHS) {
+            cache.clear();
+        }
+        cache.emplace(path, PathCacheEntry{path, node});
+    }
+
+    return node;
+}
+
+} // of anonymous namespace
+
 SGPropertyNode *
 fgGetNode (const char * path, bool create)
 {
-  return globals->get_props()->getNode(path, create);
+  PropertyAccessStats::count(path, PropertyAccessStats::LOOKUP);
+  return cachedNode(path, create);
 }
 
 SGPropertyNode * 
 fgGetNode (const char * path, int index, bool create)
 {
+  PropertyAccessStats::count(path, PropertyAccessStats::LOOKUP);
+  PropertyAccessStats::count(path, PropertyAccessStats::TREE_WALK);
   return globals->get_props()->getNode(path, index, create);
 }
 
@@ -597,73 +753,105 @@ fgAddChangeListener (SGPropertyChangeListener * listener,
 bool
 fgGetBool (const char * name, bool defaultValue)
 {
-  return globals->get_props()->getBoolValue(name, defaultValue);
+  PropertyAccessStats::count(name, PropertyAccessStats::GET);
+  SGPropertyNode * node = cachedNode(name, false);
+  return node ? node->getBoolValue() : defaultValue;
 }
 
 int
 fgGetInt (const char * name, int defaultValue)
 {
-  return globals->get_props()->getIntValue(name, defaultValue);
+  PropertyAccessStats::count(name, PropertyAccessStats::GET);
+  SGPropertyNode * node = cachedNode(name, false);
+  return node ? node->getIntValue() : defaultValue;
 }
 
 long
 fgGetLong (const char * name, long defaultValue)
 {
-  return globals->get_props()->getLongValue(name, defaultValue);
+  PropertyAccessStats::count(name, PropertyAccessStats::GET);
+  SGPropertyNode * node = cachedNode(name, false);
+  return node ? node->getLongValue() : defaultValue;
 }
 
 float
 fgGetFloat (const char * name, float defaultValue)
 {
-  return globals->get_props()->getFloatValue(name, defaultValue);
+  PropertyAccessStats::count(name, PropertyAccessStats::GET);
+  SGPropertyNode * node = cachedNode(name, false);
+  return node ? node->getFloatValue() : defaultValue;
 }
 
 double
 fgGetDouble (const char * name, double defaultValue)
 {
-  return globals->get_props()->getDoubleValue(name, defaultValue);
+  PropertyAccessStats::count(name, PropertyAccessStats::GET);
+  SGPropertyNode * node = cachedNode(name, false);
+  return node ? node->getDoubleValue() : defaultValue;
 }
 
 std::string
 fgGetString (const char * name, const char * defaultValue)
 {
-  return globals->get_props()->getStringValue(name, defaultValue);
+  PropertyAccessStats::count(name, PropertyAccessStats::GET);
+  SGPropertyNode * node = cachedNode(name, false);
+  if (!node) {
+    return defaultValue;
+  }
+
+  const auto type = node->getType();
+  if ((type != simgear::props::STRING) && (type != simgear::props::UNSPECIFIED)) {
+    PropertyAccessStats::count(name, PropertyAccessStats::STRING_CONVERSION);
+  }
+  return node->getStringValue();
 }
 
 bool
 fgSetBool (const char * name, bool val)
 {
-  return globals->get_props()->setBoolValue(name, val);
+  PropertyAccessStats::count(name, PropertyAccessStats::SET);
+  SGPropertyNode * node = cachedNode(name, true);
+  return node ? node->setBoolValue(val) : false;
 }
 
 bool
 fgSetInt (const char * name, int val)
 {
-  return globals->get_props()->setIntValue(name, val);
+  PropertyAccessStats::count(name, PropertyAccessStats::SET);
+  SGPropertyNode * node = cachedNode(name, true);
+  return node ? node->setIntValue(val) : false;
 }
 
 bool
 fgSetLong (const char * name, long val)
 {
-  return globals->get_props()->setLongValue(name, val);
+  PropertyAccessStats::count(name, PropertyAccessStats::SET);
+  SGPropertyNode * node = cachedNode(name, true);
+  return node ? node->setLongValue(val) : false;
 }
 
 bool
 fgSetFloat (const char * name, float val)
 {
-  return globals->get_props()->setFloatValue(name, val);
+  PropertyAccessStats::count(name, PropertyAccessStats::SET);
+  SGPropertyNode * node = cachedNode(name, true);
+  return node ? node->setFloatValue(val) : false;
 }
 
 bool
 fgSetDouble (const char * name, double val)
 {
-  return globals->get_props()->setDoubleValue(name, val);
+  PropertyAccessStats::count(name, PropertyAccessStats::SET);
+  SGPropertyNode * node = cachedNode(name, true);
+  return node ? node->setDoubleValue(val) : false;
 }
 
 bool
 fgSetString (const char * name, const char * val)
 {
-  return globals->get_props()->setStringValue(name, val);
+  PropertyAccessStats::count(name, PropertyAccessStats::SET);
+  SGPropertyNode * node = cachedNode(name, true);
+  return node ? node->setStringValue(val) : false;
 }
 
 void
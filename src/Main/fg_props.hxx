@@ -8,12 +8,18 @@
 
 #include <iosfwd>
 #include <algorithm>
+#include <memory>
 
 #include <simgear/structure/subsystem_mgr.hxx>
 #include <simgear/props/tiedpropertylist.hxx>
+#include <simgear/timing/timestamp.hxx>
 
 #include <Main/globals.hxx>
 
+namespace flightgear {
+class PropertyAccessStats;
+}
+
 ////////////////////////////////////////////////////////////////////////
 // Property management.
 ////////////////////////////////////////////////////////////////////////
@@ -36,6 +42,13 @@ public:
 private:
     simgear::TiedPropertyList _tiedProperties;
 
+    bool commandDumpStats(const SGPropertyNode* arg, SGPropertyNode* root);
+    bool commandResetStats(const SGPropertyNode* arg, SGPropertyNode* root);
+
+    std::unique_ptr<flightgear::PropertyAccessStats> _accessStats;
+    SGPropertyNode_ptr _statsNode, _statsEnabled, _statsCount;
+    SGTimeStamp _statsPublished;
+
     static const char* getLatitudeString ();
     static const char* getLongitudeString ();
 
@@ -97,6 +110,13 @@ void setLoggingPriority (const char * p);
 
 ////////////////////////////////////////////////////////////////////////
 // Convenience functions for getting property values.
+//
+// The path-based helpers below (fgGetNode without an index, fgGetX and
+// fgSetX) remember the node each path resolved to, per thread, keyed on
+// the address of the path string. Repeated calls with the same literal
+// skip the path parse and tree walk; a cached node is dropped once it
+// (or one of its parents) is removed from the tree. Paths which do not
+// resolve to a node are never cached.
 ////////////////////////////////////////////////////////////////////////
 
 /**
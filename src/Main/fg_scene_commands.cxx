@@ -309,6 +309,9 @@ static bool
 do_dialog_show (const SGPropertyNode * arg, SGPropertyNode * root)
 {
     NewGUI * gui = (NewGUI *)globals->get_subsystem("gui");
+    if (!gui) {
+      return false;
+    }
     gui->showDialog(arg->getStringValue("dialog-name"));
     return true;
 }
@@ -322,6 +325,9 @@ static bool
 do_dialog_toggle (const SGPropertyNode * arg, SGPropertyNode * root)
 {
     NewGUI * gui = (NewGUI *)globals->get_subsystem("gui");
+    if (!gui) {
+      return false;
+    }
     gui->toggleDialog(arg->getStringValue("dialog-name"));
     return true;
 }
@@ -334,6 +340,9 @@ static bool
 do_dialog_close (const SGPropertyNode * arg, SGPropertyNode * root)
 {
     NewGUI * gui = (NewGUI *)globals->get_subsystem("gui");
+    if (!gui) {
+      return false;
+    }
     if(arg->hasValue("dialog-name"))
         return gui->closeDialog(arg->getStringValue("dialog-name"));
     return gui->closeActiveDialog();
@@ -349,6 +358,9 @@ static bool
 do_dialog_update (const SGPropertyNode * arg, SGPropertyNode * root)
 {
     NewGUI * gui = (NewGUI *)globals->get_subsystem("gui");
+    if (!gui) {
+      return false;
+    }
     FGDialog * dialog;
     if (arg->hasValue("dialog-name"))
         dialog = gui->getDialog(arg->getStringValue("dialog-name"));
@@ -402,6 +414,9 @@ static bool
 do_dialog_apply (const SGPropertyNode * arg, SGPropertyNode * root)
 {
     NewGUI * gui = (NewGUI *)globals->get_subsystem("gui");
+    if (!gui) {
+      return false;
+    }
     FGDialog * dialog;
     if (arg->hasValue("dialog-name"))
         dialog = gui->getDialog(arg->getStringValue("dialog-name"));
@@ -425,6 +440,9 @@ static bool
 do_gui_redraw (const SGPropertyNode * arg, SGPropertyNode * root)
 {
     NewGUI * gui = (NewGUI *)globals->get_subsystem("gui");
+    if (!gui) {
+      return false;
+    }
     gui->redraw();
     return true;
 }
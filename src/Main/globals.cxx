@@ -67,6 +67,7 @@
 
 #include "fg_props.hxx"
 #include "fg_io.hxx"
+#include "SubsystemScheduler.hxx"
 
 class AircraftResourceProvider : public simgear::ResourceProvider
 {
@@ -147,6 +148,7 @@ FGGlobals *globals = NULL;
 FGGlobals::FGGlobals() :
     renderer( new FGRenderer ),
     subsystem_mgr( new SGSubsystemMgr ),
+    subsystem_scheduler( new flightgear::SubsystemScheduler(subsystem_mgr) ),
     event_mgr( new SGEventMgr ),
     sim_time_sec( 0.0 ),
     fg_root( "" ),
@@ -234,6 +236,8 @@ FGGlobals::~FGGlobals()
     FGFontCache::shutdown();
     fgCancelSnapShot();
 
+    delete subsystem_scheduler;
+    subsystem_scheduler = nullptr;
     delete subsystem_mgr;
     subsystem_mgr = nullptr; // important so ::get_subsystem returns NULL
     vb = nullptr;
@@ -563,6 +567,12 @@ FGGlobals::get_subsystem_mgr () const
     return subsystem_mgr;
 }
 
+flightgear::SubsystemScheduler *
+FGGlobals::get_subsystem_scheduler () const
+{
+    return subsystem_scheduler;
+}
+
 SGSubsystem *
 FGGlobals::get_subsystem (const char * name) const
 {
@@ -580,6 +590,7 @@ FGGlobals::add_subsystem (const char * name,
                           double min_time_sec)
 {
     subsystem_mgr->add(name, subsystem, type, min_time_sec);
+    subsystem_scheduler->setMinStep(name, min_time_sec);
 }
 
 SGEventMgr *
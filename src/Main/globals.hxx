@@ -69,6 +69,7 @@ namespace simgear { namespace pkg {
 namespace flightgear
 {
     class View;
+    class SubsystemScheduler;
 }
 
 /**
@@ -88,6 +89,7 @@ private:
 
     FGRenderer *renderer;
     SGSubsystemMgr *subsystem_mgr;
+    flightgear::SubsystemScheduler *subsystem_scheduler;
     SGEventMgr *event_mgr;
 
     // Number of milliseconds elapsed since the start of the program.
@@ -171,6 +173,12 @@ public:
 
     SGSubsystemMgr *get_subsystem_mgr () const;
 
+    /**
+     * Runs the per-frame subsystem update; see SubsystemScheduler for
+     * declaring which subsystems could be updated concurrently.
+     */
+    flightgear::SubsystemScheduler *get_subsystem_scheduler () const;
+
     SGSubsystem *get_subsystem (const char * name) const;
 
     template<class T>
@@ -9,13 +9,20 @@
 
 #include "logger.hxx"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <ios>
+#include <mutex>
 #include <string>
-#include <cstdlib>
 
 #include <simgear/debug/logstream.hxx>
 #include <simgear/io/iostreams/sgstream.hxx>
 #include <simgear/misc/sg_path.hxx>
+#include <simgear/threads/SGThread.hxx>
 
 #include "fg_props.hxx"
 #include "globals.hxx"
@@ -23,6 +30,277 @@
 
 using std::string;
 using std::endl;
+
+////////////////////////////////////////////////////////////////////////
+// Implementation of FGLogger::BinaryWriter
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * Background writer for binary logs.
+ *
+ * The main thread copies one row of raw typed values per sample into a
+ * fixed-size ring buffer. The writer thread takes rows out in blocks,
+ * transposes them into columns and appends the block to the file, so the
+ * main thread never formats values or touches the disk.
+ */
+class FGLogger::BinaryWriter : public SGThread
+{
+public:
+  // Column type codes as written to the file header.
+  enum ColumnType : uint8_t {
+    COLUMN_BOOL   = 0,
+    COLUMN_INT32  = 1,
+    COLUMN_INT64  = 2,
+    COLUMN_FLOAT  = 3,
+    COLUMN_DOUBLE = 4
+  };
+
+  BinaryWriter(std::unique_ptr<sg_ofstream> output, SGPropertyNode* config,
+               size_t capacity, size_t block_rows) :
+    _output(std::move(output)),
+    _config(config),
+    _stride(0),
+    _capacity(std::max<size_t>(capacity, 1)),
+    _blockRows(std::max<size_t>(std::min(block_rows, _capacity), 1)),
+    _head(0),
+    _count(0),
+    _dropped(0),
+    _stop(false),
+    _started(false)
+  {
+    // Time is always the first column.
+    addColumn(COLUMN_DOUBLE);
+  }
+
+  ~BinaryWriter()
+  {
+    if (_started) {
+      {
+        std::lock_guard<std::mutex> g(_lock);
+        _stop = true;
+      }
+      _cond.notify_one();
+      join();
+    }
+
+    if (_dropped > 0) {
+      SG_LOG(SG_GENERAL, SG_WARN, "FGLogger: dropped " << _dropped
+             << " samples because the binary log writer could not keep up");
+    }
+  }
+
+  static ColumnType columnTypeFor(simgear::props::Type type)
+  {
+    switch (type) {
+    case simgear::props::BOOL:  return COLUMN_BOOL;
+    case simgear::props::INT:   return COLUMN_INT32;
+    case simgear::props::LONG:  return COLUMN_INT64;
+    case simgear::props::FLOAT: return COLUMN_FLOAT;
+    default:                    return COLUMN_DOUBLE;
+    }
+  }
+
+  static size_t columnSize(ColumnType type)
+  {
+    switch (type) {
+    case COLUMN_BOOL:  return 1;
+    case COLUMN_INT32: return 4;
+    case COLUMN_INT64: return 8;
+    case COLUMN_FLOAT: return 4;
+    default:           return 8;
+    }
+  }
+
+  void addColumn(ColumnType type)
+  {
+    _types.push_back(type);
+    _offsets.push_back(_stride);
+    _stride += columnSize(type);
+  }
+
+  /**
+   * Allocate the ring buffer and write the file header. Must be called
+   * once, after all columns have been added and before startWriting().
+   */
+  bool writeHeader(const std::vector<string>& titles)
+  {
+    _ring.resize(_capacity * _stride);
+    _row.resize(_stride);
+
+    const uint32_t version = 1;
+    const uint32_t byteOrder = 0x01020304;
+    const uint32_t columns = _types.size();
+    _output->write("FGLOGBIN", 8);
+    writeRaw(version);
+    writeRaw(byteOrder);
+    writeRaw(columns);
+    for (size_t i = 0; i < _types.size(); ++i) {
+      const string& title = titles[i];
+      const uint16_t length = std::min<size_t>(title.size(), UINT16_MAX);
+      writeRaw(_types[i]);
+      writeRaw(length);
+      _output->write(title.data(), length);
+    }
+    return static_cast<bool>(*_output);
+  }
+
+  void startWriting()
+  {
+    _started = true;
+    start();
+  }
+
+  /**
+   * Snapshot the current values of <nodes> as one row. Called on the main
+   * thread; never blocks on file I/O.
+   */
+  void sample(double time, const std::vector<SGPropertyNode_ptr>& nodes)
+  {
+    char* row = _row.data();
+    std::memcpy(row, &time, sizeof(time));
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      SGPropertyNode* node = nodes[i];
+      char* dst = row + _offsets[i + 1];
+      switch (_types[i + 1]) {
+      case COLUMN_BOOL: {
+        const uint8_t v = node->getBoolValue() ? 1 : 0;
+        std::memcpy(dst, &v, sizeof(v));
+        break;
+      }
+      case COLUMN_INT32: {
+        const int32_t v = node->getIntValue();
+        std::memcpy(dst, &v, sizeof(v));
+        break;
+      }
+      case COLUMN_INT64: {
+        const int64_t v = node->getLongValue();
+        std::memcpy(dst, &v, sizeof(v));
+        break;
+      }
+      case COLUMN_FLOAT: {
+        const float v = node->getFloatValue();
+        std::memcpy(dst, &v, sizeof(v));
+        break;
+      }
+      default: {
+        const double v = node->getDoubleValue();
+        std::memcpy(dst, &v, sizeof(v));
+        break;
+      }
+      }
+    }
+
+    bool wake = false;
+    bool dropped = false;
+    {
+      std::lock_guard<std::mutex> g(_lock);
+      if (_count == _capacity) {
+        ++_dropped;
+        dropped = true;
+      } else {
+        const size_t slot = (_head + _count) % _capacity;
+        std::memcpy(&_ring[slot * _stride], row, _stride);
+        ++_count;
+        wake = (_count >= _blockRows);
+      }
+    }
+
+    if (wake) {
+      _cond.notify_one();
+    }
+    if (dropped && _config) {
+      _config->setLongValue("dropped-samples", _config->getLongValue("dropped-samples") + 1);
+    }
+  }
+
+protected:
+  void run() override
+  {
+    std::vector<char> rows(_blockRows * _stride);
+    std::vector<char> block(_blockRows * _stride);
+
+    for (;;) {
+      size_t n = 0;
+      {
+        std::unique_lock<std::mutex> g(_lock);
+        // Wake up periodically so that slow logs still reach the disk.
+        _cond.wait_for(g, std::chrono::seconds(1),
+                       [this] { return _stop || _count >= _blockRows; });
+        n = std::min(_count, _blockRows);
+        if (n == 0 && _stop) {
+          break;
+        }
+
+        const size_t first = std::min(n, _capacity - _head);
+        std::memcpy(rows.data(), &_ring[_head * _stride], first * _stride);
+        if (n > first) {
+          std::memcpy(rows.data() + first * _stride, _ring.data(), (n - first) * _stride);
+        }
+        _head = (_head + n) % _capacity;
+        _count -= n;
+      }
+
+      if (n > 0) {
+        writeBlock(rows, block, n);
+      }
+    }
+
+    _output->flush();
+  }
+
+private:
+  template <typename T>
+  void writeRaw(const T& value)
+  {
+    _output->write(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  /**
+   * Write <n> rows as one block: a row count followed by the values of each
+   * column in turn.
+   */
+  void writeBlock(const std::vector<char>& rows, std::vector<char>& block, size_t n)
+  {
+    char* dst = block.data();
+    for (size_t c = 0; c < _types.size(); ++c) {
+      const size_t size = columnSize(_types[c]);
+      const char* src = rows.data() + _offsets[c];
+      for (size_t r = 0; r < n; ++r) {
+        std::memcpy(dst, src, size);
+        dst += size;
+        src += _stride;
+      }
+    }
+
+    const uint32_t count = n;
+    writeRaw(count);
+    _output->write(block.data(), n * _stride);
+  }
+
+  std::unique_ptr<sg_ofstream> _output;
+  SGPropertyNode_ptr _config;
+
+  std::vector<ColumnType> _types;
+  std::vector<size_t> _offsets;
+  size_t _stride;
+
+  // Main thread scratch row.
+  std::vector<char> _row;
+
+  // Ring buffer of rows, guarded by _lock.
+  std::vector<char> _ring;
+  const size_t _capacity;
+  const size_t _blockRows;
+  size_t _head;
+  size_t _count;
+  size_t _dropped;
+  bool _stop;
+  bool _started;
+
+  std::mutex _lock;
+  std::condition_variable _cond;
+};
+
 
 ////////////////////////////////////////////////////////////////////////
 // Implementation of FGLogger
@@ -45,9 +323,11 @@ FGLogger::init ()
     _logs.emplace_back(new Log());
     Log &log = *_logs.back();
 
+    const bool binary = (child->getStringValue("format", "csv") == "binary");
+
     string filename = child->getStringValue("filename");
     if (filename.empty()) {
-        filename = "fg_log.csv";
+        filename = binary ? "fg_log.bin" : "fg_log.csv";
         child->setStringValue("filename", filename.c_str());
     }
 
@@ -79,19 +359,13 @@ FGLogger::init ()
     log.interval_ms = child->getLongValue("interval-ms");
     log.last_time_ms = globals->get_sim_time_sec() * 1000;
     log.delimiter = delimiter.c_str()[0];
-    // Security: use the return value of fgValidatePath()
-    log.output.reset(new sg_ofstream(authorizedPath, std::ios_base::out));
-    if ( !(*log.output) ) {
-      SG_LOG(SG_GENERAL, SG_ALERT, "Cannot write log to " << filename);
-      _logs.pop_back();
-      continue;
-    }
 
     //
     // Process the individual entries (Time is automatic).
     //
+    std::vector<string> titles;
+    titles.push_back("Time");
     std::vector<SGPropertyNode_ptr> entries = child->getChildren("entry");
-    (*log.output) << "Time";
     for (unsigned int j = 0; j < entries.size(); j++) {
       SGPropertyNode * entry = entries[j];
 
@@ -109,13 +383,65 @@ FGLogger::init ()
       SGPropertyNode * node =
 	fgGetNode(entry->getStringValue("property"), true);
       log.nodes.push_back(node);
-      (*log.output) << log.delimiter
-		    << entry->getStringValue("title", node->getPath().c_str());
+      titles.push_back(entry->getStringValue("title", node->getPath().c_str()));
+    }
+
+    if (binary) {
+      if (!initBinary(log, authorizedPath, child, titles)) {
+        SG_LOG(SG_GENERAL, SG_ALERT, "Cannot write log to " << filename);
+        _logs.pop_back();
+      }
+      continue;
+    }
+
+    // Security: use the return value of fgValidatePath()
+    log.output.reset(new sg_ofstream(authorizedPath, std::ios_base::out));
+    if ( !(*log.output) ) {
+      SG_LOG(SG_GENERAL, SG_ALERT, "Cannot write log to " << filename);
+      _logs.pop_back();
+      continue;
+    }
+
+    for (unsigned int j = 0; j < titles.size(); j++) {
+      if (j > 0)
+        (*log.output) << log.delimiter;
+      (*log.output) << titles[j];
     }
     (*log.output) << endl;
   }
 }
 
+bool
+FGLogger::initBinary (Log& log, const SGPath& path, SGPropertyNode* config,
+                      const std::vector<string>& titles)
+{
+    std::unique_ptr<sg_ofstream> output(
+        new sg_ofstream(path, std::ios_base::out | std::ios_base::binary));
+    if ( !(*output) )
+      return false;
+
+    const long capacity = config->getLongValue("buffer-samples", 4096);
+    const long block = config->getLongValue("block-samples", 256);
+    config->setLongValue("dropped-samples", 0);
+
+    log.writer.reset(new BinaryWriter(std::move(output), config,
+                                      std::max(capacity, 1L),
+                                      std::max(block, 1L)));
+
+    // Column types are fixed when the log starts; a property whose type is
+    // not yet known is logged as double.
+    for (const auto& node : log.nodes)
+      log.writer->addColumn(BinaryWriter::columnTypeFor(node->getType()));
+
+    if (!log.writer->writeHeader(titles)) {
+      log.writer.reset();
+      return false;
+    }
+
+    log.writer->startWriting();
+    return true;
+}
+
 void
 FGLogger::reinit ()
 {
@@ -139,14 +465,21 @@ FGLogger::update (double dt)
     double sim_time_sec = globals->get_sim_time_sec();
     double sim_time_ms = sim_time_sec * 1000;
     for (unsigned int i = 0; i < _logs.size(); i++) {
-        while ((sim_time_ms - _logs[i]->last_time_ms) >= _logs[i]->interval_ms) {
-            _logs[i]->last_time_ms += _logs[i]->interval_ms;
-            (*_logs[i]->output) << sim_time_sec;
-            for (unsigned int j = 0; j < _logs[i]->nodes.size(); j++) {
-                (*_logs[i]->output) << _logs[i]->delimiter
-                                    << _logs[i]->nodes[j]->getStringValue();
+        Log& log = *_logs[i];
+        while ((sim_time_ms - log.last_time_ms) >= log.interval_ms) {
+            log.last_time_ms += log.interval_ms;
+            if (log.writer) {
+                log.writer->sample(sim_time_sec, log.nodes);
+                continue;
+            }
+
+            (*log.output) << sim_time_sec;
+            for (unsigned int j = 0; j < log.nodes.size(); j++) {
+                (*log.output) << log.delimiter
+                              << log.nodes[j]->getStringValue();
             }
-            (*_logs[i]->output) << endl;
+            // No std::endl: flushing every sample stalls the frame.
+            (*log.output) << '\n';
         }
     }
 }
@@ -164,6 +497,11 @@ FGLogger::Log::Log ()
 {
 }
 
+// Out of line so that BinaryWriter is complete where it is destroyed.
+FGLogger::Log::~Log ()
+{
+}
+
 
 // Register the subsystem.
 SGSubsystemMgr::Registrant<FGLogger> registrantFGLogger;
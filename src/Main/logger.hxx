@@ -7,15 +7,21 @@
 #define __LOGGER_HXX 1
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <simgear/compiler.h>
 #include <simgear/io/iostreams/sgstream.hxx>
 #include <simgear/structure/subsystem_mgr.hxx>
 #include <simgear/props/props.hxx>
+#include <simgear/misc/sg_path.hxx>
 
 /**
- * Log any property values to any number of CSV files.
+ * Log any property values to any number of CSV or binary files.
+ *
+ * CSV logs are formatted on the main thread. Binary logs only copy the raw
+ * typed values into a ring buffer on the main thread; a background thread
+ * writes them to disk in column blocks (see docs-mini/README.logging).
  */
 class FGLogger : public SGSubsystem
 {
@@ -31,19 +37,28 @@ public:
     static const char* staticSubsystemClassId() { return "logger"; }
 
 private:
+    class BinaryWriter;
+
     /**
      * A single instance of a log file (the logger can contain many).
      */
     struct Log {
       Log ();
+      ~Log ();
 
       std::vector<SGPropertyNode_ptr> nodes;
       std::unique_ptr<sg_ofstream> output;
       long interval_ms;
       double last_time_ms;
       char delimiter;
+
+      // Binary mode only; null for CSV logs.
+      std::unique_ptr<BinaryWriter> writer;
     };
 
+    bool initBinary(Log& log, const SGPath& path, SGPropertyNode* config,
+                    const std::vector<std::string>& titles);
+
     std::vector< std::unique_ptr<Log> > _logs;
 };
 
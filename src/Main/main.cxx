@@ -76,6 +76,7 @@
 #include "positioninit.hxx"
 #include "screensaver_control.hxx"
 #include "subsystemFactory.hxx"
+#include "SubsystemScheduler.hxx"
 #include "util.hxx"
 #include <Main/ErrorReporter.hxx>
 #include <Main/sentryIntegration.hxx>
@@ -103,6 +104,9 @@ extern int _bootstrap_OSInit;
 static SGPropertyNode_ptr frame_signal;
 static SGPropertyNode_ptr nasal_gc_threaded;
 static SGPropertyNode_ptr nasal_gc_threaded_wait;
+static SGPropertyNode_ptr scheduler_node;
+static SGPropertyNode_ptr scheduler_enabled;
+static SGTimeStamp scheduler_published;
 
 #ifdef NASAL_BACKGROUND_GC_THREAD
 extern "C" {
@@ -162,7 +166,13 @@ static void fgMainLoop( void )
     timeManager->computeTimeDeltas(sim_dt, real_dt);
 
     // update all subsystems
-    globals->get_subsystem_mgr()->update(sim_dt);
+    auto scheduler = globals->get_subsystem_scheduler();
+    scheduler->setEnabled(scheduler_enabled->getBoolValue());
+    scheduler->update(sim_dt);
+    if (scheduler->isEnabled() && (scheduler_published.elapsedMSec() >= 1000)) {
+        scheduler->publishTiming(scheduler_node);
+        scheduler_published.stamp();
+    }
 
     // flush commands waiting in the queue
     SGCommandMgr::instance()->executedQueuedCommands();
@@ -279,6 +289,9 @@ void registerMainLoop()
     frame_signal = fgGetNode("/sim/signals/frame", true);
     nasal_gc_threaded = fgGetNode("/sim/nasal-gc-threaded", true);
     nasal_gc_threaded_wait = fgGetNode("/sim/nasal-gc-threaded-wait", true);
+    scheduler_node = fgGetNode("/sim/subsystem-scheduler", true);
+    scheduler_enabled = scheduler_node->getChild("enabled", 0, true);
+    scheduler_published.stamp();
 
     // init the Emesary receiver for Nasal
     nasal::initMainLoopRecipient();
@@ -292,6 +305,8 @@ void unregisterMainLoopProperties()
     frame_signal.reset();
     nasal_gc_threaded.reset();
     nasal_gc_threaded_wait.reset();
+    scheduler_node.reset();
+    scheduler_enabled.reset();
 }
 
 } // namespace flightgear
@@ -311,7 +326,11 @@ static void fgIdleFunction ( void ) {
     // splash screen up and running right away.
 
     if ( idle_state == 0 ) {
-        if (guiInit())
+        if (fgGetBool("/sim/headless/enabled")) {
+            // nothing to draw with: skip the GUI and OpenGL set-up
+            idle_state+=2;
+            fgSplashProgress("loading-aircraft-list");
+        } else if (guiInit())
         {
             checkOpenGLVersion();
             fgSetVideoOptions();
@@ -419,14 +438,16 @@ static void fgIdleFunction ( void ) {
     } else if ( idle_state == 900 ) {
         idle_state = 1000;
 
-        // setup OpenGL view parameters
-        globals->get_renderer()->setupView();
+        if (!fgGetBool("/sim/headless/enabled")) {
+            // setup OpenGL view parameters
+            globals->get_renderer()->setupView();
 
-        globals->get_renderer()->resize( fgGetInt("/sim/startup/xsize"),
-                                         fgGetInt("/sim/startup/ysize") );
-        WindowSystemAdapter::getWSA()->windows[0]->gc->add(
-          new simgear::canvas::VGInitOperation()
-        );
+            globals->get_renderer()->resize( fgGetInt("/sim/startup/xsize"),
+                                             fgGetInt("/sim/startup/ysize") );
+            WindowSystemAdapter::getWSA()->windows[0]->gc->add(
+              new simgear::canvas::VGInitOperation()
+            );
+        }
 
         int session = fgGetInt("/sim/session",0);
         session++;
@@ -799,19 +820,24 @@ int fgMainInit( int argc, char **argv )
     fgOSOpenWindow(true /* request stencil buffer */);
     fgOSResetProperties();
 
-    fntInit();
-    globals->get_renderer()->preinit();
+    const bool headless = fgGetBool("/sim/headless/enabled");
+    if (!headless) {
+        fntInit();
+        globals->get_renderer()->preinit();
 
-    if (fgGetBool("/sim/ati-viewport-hack", true)) {
-        SG_LOG(SG_GENERAL, SG_WARN, "Enabling ATI/AMD viewport hack");
-        flightgear::addSentryTag("ati-viewport-hack", "enabled");
-        ATIScreenSizeHack();
+        if (fgGetBool("/sim/ati-viewport-hack", true)) {
+            SG_LOG(SG_GENERAL, SG_WARN, "Enabling ATI/AMD viewport hack");
+            flightgear::addSentryTag("ati-viewport-hack", "enabled");
+            ATIScreenSizeHack();
+        }
     }
 
     fgOutputSettings();
 
     //try to disable the screensaver
-    fgOSDisableScreensaver();
+    if (!headless) {
+        fgOSDisableScreensaver();
+    }
 
     // pass control off to the master event handler
     int result = fgOSMainLoop();
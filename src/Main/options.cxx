@@ -1748,6 +1748,15 @@ static int fgOptDisableGUI(const char*)
     return FG_OPTIONS_OK;
 }
 
+static int fgOptHeadless(const char*)
+{
+    // no window, GUI or sound: the simulation runs in fixed steps
+    globals->set_headless(true);
+    fgSetBool("/sim/headless/enabled", true);
+    fgSetBool("/sim/sound/working", false);
+    return FG_OPTIONS_OK;
+}
+
 /*
    option       has_param type        property         b_param s_param  func
 
@@ -1873,6 +1882,8 @@ struct OptionDesc {
     {"aircraft-dir",                 true,  OPTION_IGNORE, "", false, "", 0 },
     {"state",                        true,  OPTION_IGNORE, "", false, "", 0 },
     {"model-hz",                     true,  OPTION_INT,    "/sim/model-hz", false, "", 0 },
+    {"enable-fdm-thread",            false, OPTION_BOOL,   "/sim/fdm/threaded", true, "", 0 },
+    {"disable-fdm-thread",           false, OPTION_BOOL,   "/sim/fdm/threaded", false, "", 0 },
     {"max-fps",                      true,  OPTION_DOUBLE, "/sim/frame-rate-throttle-hz", false, "", 0 },
     {"speed",                        true,  OPTION_DOUBLE, "/sim/speed-up", false, "", 0 },
     {"trim",                         false, OPTION_BOOL,   "/sim/presets/trim", true, "", 0 },
@@ -2015,6 +2026,8 @@ struct OptionDesc {
     {"developer",                    true,  OPTION_IGNORE | OPTION_BOOL, "", false, "", nullptr },
     {"jsbsim-output-directive-file", true,  OPTION_STRING, "/sim/jsbsim/output-directive-file", false, "", nullptr },
     {"disable-gui",                  false, OPTION_FUNC, "", false, "", fgOptDisableGUI },
+    {"headless",                     false, OPTION_FUNC, "", false, "", fgOptHeadless },
+    {"headless-max-speed-up",        true,  OPTION_DOUBLE, "/sim/headless/max-speed-up", false, "", nullptr },
     {"graphics-preset",              true,  OPTION_STRING, "/sim/rendering/preset", false, "", nullptr},
     {"composite-viewer",             true,  OPTION_INT,    "/sim/rendering/composite-viewer-enabled", false, "", nullptr},
     {"restart-launcher",             false, OPTION_BOOL, "/sim/restart-launcher-on-exit", true, "", nullptr},
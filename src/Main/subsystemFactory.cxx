@@ -29,6 +29,7 @@
 #include <simgear/structure/event_mgr.hxx>
 
 #include <Main/globals.hxx>
+#include <Main/SubsystemScheduler.hxx>
 #include <Sound/soundmanager.hxx>
 
 // subsystem includes
@@ -137,6 +138,15 @@ SGSubsystemMgr::GroupType mapGroupNameToType(const std::string& s)
     return SGSubsystemMgr::GENERAL;
 }
 
+static string_list childValues(const SGPropertyNode* arg, const char* name)
+{
+  string_list result;
+  for (auto c : arg->getChildren(name)) {
+    result.push_back(c->getStringValue());
+  }
+  return result;
+}
+
 static SGSubsystem* getSubsystem(const SGPropertyNode* arg, bool create)
 {
   std::string subsystem(arg->getStringValue("subsystem"));
@@ -191,6 +201,18 @@ static SGSubsystem* getSubsystem(const SGPropertyNode* arg, bool create)
   globals->get_subsystem_mgr()
          ->add(name.c_str(), sys, group, minTime);
 
+  auto scheduler = globals->get_subsystem_scheduler();
+  scheduler->setMinStep(name, minTime);
+
+  // optional <reads>, <writes> and <after> entries let the scheduler
+  // place the new subsystem in a wave with others
+  auto reads = childValues(arg, "reads");
+  auto writes = childValues(arg, "writes");
+  auto after = childValues(arg, "after");
+  if (!reads.empty() || !writes.empty() || !after.empty()) {
+    scheduler->declare(name, reads, writes, after);
+  }
+
   return sys;
 }
 
@@ -0,0 +1,126 @@
+/*
+ MPLoopbackGenerator.cxx - synthetic multiplayer traffic for testing
+
+ This file is part of FlightGear.
+
+ FlightGear is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 2 of the License, or
+ (at your option) any later version.
+
+ FlightGear is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with FlightGear.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include <cmath>
+#include <cstring>
+
+#include <simgear/constants.h>
+#include <simgear/debug/logstream.hxx>
+
+#include "MPLoopbackGenerator.hxx"
+#include "mpmessages.hxx"
+
+namespace {
+// Radius of the innermost circle, and the spacing between circles.
+const double CIRCLE_RADIUS_M = 2000.0;
+const double CIRCLE_SPACING_M = 150.0;
+const double SPEED_MPS = 60.0;
+const unsigned MAX_AIRCRAFT = 1000;
+}
+
+MPLoopbackGenerator::MPLoopbackGenerator(const SGGeod& center, unsigned count) :
+  _center(center),
+  _count(count < MAX_AIRCRAFT ? count : MAX_AIRCRAFT)
+{
+}
+
+bool MPLoopbackGenerator::open(const std::string& host, int port)
+{
+  if (!_socket.open(false)) {
+    SG_LOG(SG_NETWORK, SG_ALERT, "MP loopback generator: cannot create socket");
+    return false;
+  }
+  _socket.setBlocking(false);
+  _target.set(host.c_str(), port);
+  SG_LOG(SG_NETWORK, SG_INFO, "MP loopback generator: " << _count
+         << " aircraft to " << host << ":" << port);
+  return true;
+}
+
+std::string MPLoopbackGenerator::callsign(unsigned index)
+{
+  return "LOOP" + std::to_string(index);
+}
+
+void MPLoopbackGenerator::send(double t)
+{
+  for (unsigned i = 0; i < _count; ++i) {
+    makePacket(i, t, _packet);
+    _socket.sendto(_packet.data(), _packet.size(), 0, &_target);
+  }
+}
+
+void MPLoopbackGenerator::makePacket(unsigned index, double t,
+                                     std::vector<char>& packet) const
+{
+  // Each aircraft flies its own circle, spread out in phase.
+  const double radius = CIRCLE_RADIUS_M + index * CIRCLE_SPACING_M;
+  const double rate = SPEED_MPS / radius;
+  const double phase = rate * t + SGD_2PI * index / (_count ? _count : 1);
+  const double heading = phase + SGD_PI_2;
+
+  SGGeod geod;
+  double az2;
+  SGGeodesy::direct(_center, phase * SGD_RADIANS_TO_DEGREES, radius, geod, az2);
+  geod.setElevationFt(_center.getElevationFt() + 1000.0 + 50.0 * index);
+  const SGVec3d position = SGVec3d::fromGeod(geod);
+
+  const SGQuatf qEc2Hl = SGQuatf::fromLonLatRad((float)geod.getLongitudeRad(),
+                                                (float)geod.getLatitudeRad());
+  const float bank = (float)atan(SPEED_MPS * rate / 9.81);
+  const SGQuatf orientation = qEc2Hl * SGQuatf::fromYawPitchRoll((float)heading, 0.0f, bank);
+  SGVec3f angleAxis;
+  orientation.getAngleAxis(angleAxis);
+
+  packet.assign(sizeof(T_MsgHdr) + sizeof(T_PositionMsg), 0);
+  T_PositionMsg* posMsg = reinterpret_cast<T_PositionMsg*>(&packet[sizeof(T_MsgHdr)]);
+  strncpy(posMsg->Model, "Aircraft/c172p/Models/c172p.xml", MAX_MODEL_NAME_LEN - 1);
+  posMsg->time = XDR_encode_double(t);
+  posMsg->lag = XDR_encode_double(0.1);
+  for (unsigned i = 0; i < 3; ++i) {
+    posMsg->position[i] = XDR_encode_double(position(i));
+    posMsg->orientation[i] = XDR_encode_float(angleAxis(i));
+    posMsg->linearVel[i] = XDR_encode_float(i == 0 ? SPEED_MPS : 0.0);
+    posMsg->angularVel[i] = XDR_encode_float(i == 2 ? rate : 0.0);
+    posMsg->linearAccel[i] = XDR_encode_float(0.0);
+    posMsg->angularAccel[i] = XDR_encode_float(0.0);
+  }
+  posMsg->pad = 0;
+
+  auto put = [&packet](xdr_data_t word) {
+    const char* bytes = reinterpret_cast<const char*>(&word);
+    packet.insert(packet.end(), bytes, bytes + sizeof(word));
+  };
+  // protocol version, then the control surfaces moving gently
+  put(XDR_encode_shortints32(10, 2));
+  for (int id = 100; id < 104; ++id) {
+    put(XDR_encode_shortints32(id, (int)(32767 * 0.2 * sin(t + id))));
+  }
+
+  T_MsgHdr* hdr = reinterpret_cast<T_MsgHdr*>(packet.data());
+  hdr->Magic = XDR_encode_uint32(MSG_MAGIC);
+  hdr->Version = XDR_encode_uint32(PROTO_VER);
+  hdr->MsgId = XDR_encode_uint32(POS_DATA_ID);
+  hdr->MsgLen = XDR_encode_uint32(packet.size());
+  hdr->RequestedRangeNm = 0;
+  hdr->ReplyPort = 0;
+  strncpy(hdr->Callsign, callsign(index).c_str(), MAX_CALLSIGN_LEN - 1);
+}
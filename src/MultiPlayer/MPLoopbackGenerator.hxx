@@ -0,0 +1,69 @@
+/*
+ MPLoopbackGenerator.hxx - synthetic multiplayer traffic for testing
+
+ This file is part of FlightGear.
+
+ FlightGear is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 2 of the License, or
+ (at your option) any later version.
+
+ FlightGear is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with FlightGear.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef __FG_MPLOOPBACKGENERATOR_HXX
+#define __FG_MPLOOPBACKGENERATOR_HXX
+
+#include <string>
+#include <vector>
+
+#include <simgear/io/raw_socket.hxx>
+#include <simgear/math/SGMath.hxx>
+
+/**
+ * Generates position packets for a number of synthetic aircraft circling
+ * around a point and sends them over UDP, normally to our own receive port.
+ * This exercises the whole receive path without a multiplayer server.
+ *
+ * The aircraft are called LOOP0, LOOP1, ...
+ */
+class MPLoopbackGenerator {
+public:
+  MPLoopbackGenerator(const SGGeod& center, unsigned count);
+
+  /**
+   * Open the sending socket.
+   *
+   * \param host address to send to
+   * \param port port to send to
+   */
+  bool open(const std::string& host, int port);
+
+  /**
+   * Send one position packet per aircraft for time t (MP protocol clock).
+   */
+  void send(double t);
+
+  /**
+   * Build the packet of aircraft index at time t, in wire format.
+   */
+  void makePacket(unsigned index, double t, std::vector<char>& packet) const;
+
+  unsigned count() const { return _count; }
+
+  static std::string callsign(unsigned index);
+
+private:
+  SGGeod _center;
+  unsigned _count;
+  simgear::Socket _socket;
+  simgear::IPAddress _target;
+  std::vector<char> _packet;
+};
+
+#endif // __FG_MPLOOPBACKGENERATOR_HXX
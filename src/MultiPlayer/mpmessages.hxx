@@ -35,6 +35,9 @@
 *
 ******************************************************************/
 
+#include <cstring>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include <simgear/compiler.h>
@@ -119,22 +122,76 @@ struct T_PositionMsg {
 struct FGPropertyData {
   unsigned id;
   
-  // While the type isn't transmitted, it is needed for the destructor
+  // While the type isn't transmitted, it is needed to pick the union member
   simgear::props::Type type;
   union { 
     int int_value;
     float float_value;
-    char* string_value;
+    // Points into the FGPropertyArena of the owning FGExternalMotionData,
+    // or to static storage.
+    const char* string_value;
   }; 
-  FGPropertyData() : string_value(nullptr) {}
-  ~FGPropertyData() {
-    if ((type == simgear::props::STRING) || (type == simgear::props::UNSPECIFIED))
-    {
-      delete [] string_value;
+  FGPropertyData() : id(0), type(simgear::props::NONE), string_value(nullptr) {}
+};
+
+// Storage for the string payloads of a motion data packet. Memory is handed
+// out from fixed blocks which are kept when the arena is reset, so decoding
+// into a recycled FGExternalMotionData does not touch the heap once the
+// blocks are warm. Pointers stay valid until the next reset().
+class FGPropertyArena {
+public:
+  char* allocate(size_t len)
+  {
+    while (mBlock < mBlocks.size()) {
+      Block& b = mBlocks[mBlock];
+      if (b.size - mUsed >= len) {
+        char* p = b.data.get() + mUsed;
+        mUsed += len;
+        return p;
+      }
+      ++mBlock;
+      mUsed = 0;
     }
+    const size_t size = len > BLOCK_SIZE ? len : BLOCK_SIZE;
+    mBlocks.push_back({std::unique_ptr<char[]>(new char[size]), size});
+    mBlock = mBlocks.size() - 1;
+    mUsed = len;
+    return mBlocks.back().data.get();
   }
-};
 
+  // Copy a string into the arena; returns the null terminated copy.
+  const char* copy(const char* str, size_t len)
+  {
+    char* p = allocate(len + 1);
+    memcpy(p, str, len);
+    p[len] = '\0';
+    return p;
+  }
+
+  void reset()
+  {
+    mBlock = 0;
+    mUsed = 0;
+  }
+
+  void swap(FGPropertyArena& other)
+  {
+    mBlocks.swap(other.mBlocks);
+    std::swap(mBlock, other.mBlock);
+    std::swap(mUsed, other.mUsed);
+  }
+
+private:
+  enum { BLOCK_SIZE = 2048 };
+
+  struct Block {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+  std::vector<Block> mBlocks;
+  size_t mBlock = 0;
+  size_t mUsed = 0;
+};
 
 
 // Position message
@@ -165,21 +222,34 @@ struct FGExternalMotionData {
   // the earth centered frame
   SGVec3f angularAccel;
   
-  // The set of properties received for this timeslot
-  std::vector<FGPropertyData*> properties;
+  // The set of properties received for this timeslot, and the storage
+  // for their string values
+  std::vector<FGPropertyData> properties;
+  FGPropertyArena strings;
 
-  ~FGExternalMotionData()
+  // Drop all properties, keeping the allocated storage for reuse.
+  void clearProperties()
   {
-      std::vector<FGPropertyData*>::const_iterator propIt;
-      std::vector<FGPropertyData*>::const_iterator propItEnd;
-      propIt = properties.begin();
-      propItEnd = properties.end();
-
-      while (propIt != propItEnd)
-      {
-        delete *propIt;
-        propIt++;
-      }
+    properties.clear();
+    strings.reset();
+  }
+
+  // Take over the state and properties of other. Our previous property
+  // storage is handed to other, cleared, so both objects can be recycled
+  // without allocating.
+  void adopt(FGExternalMotionData& other)
+  {
+    time = other.time;
+    lag = other.lag;
+    position = other.position;
+    orientation = other.orientation;
+    linearVel = other.linearVel;
+    angularVel = other.angularVel;
+    linearAccel = other.linearAccel;
+    angularAccel = other.angularAccel;
+    properties.swap(other.properties);
+    strings.swap(other.strings);
+    other.clearProperties();
   }
 };
 
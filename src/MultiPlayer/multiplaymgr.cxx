@@ -31,6 +31,7 @@
 
 #include <iostream>
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <errno.h>
 #include <memory>
@@ -44,6 +45,7 @@
 #include <simgear/props/props_io.hxx>
 #include <simgear/structure/commands.hxx>
 #include <simgear/structure/event_mgr.hxx>
+#include <simgear/threads/SGThread.hxx>
 #include <simgear/timing/timestamp.hxx>
 
 #include <AIModel/AIManager.hxx>
@@ -57,9 +59,13 @@
 #include <Main/sentryIntegration.hxx>
 #include "mpirc.hxx"
 #include "cpdlc.hxx"
+#include "MPLoopbackGenerator.hxx"
 
 #if defined(_MSC_VER) || defined(__MINGW32__)
 #include <WS2tcpip.h>
+#else
+#include <netinet/in.h>
+#include <sys/socket.h>
 #endif
 using namespace std;
 
@@ -153,7 +159,7 @@ struct IdPropertyList {
     simgear::props::Type type;
     TransmissionType TransmitAs;
     int version;
-    xdr_data_t* (*encode_for_transmit)(const IdPropertyList *propDef, const xdr_data_t*, FGPropertyData*);
+    xdr_data_t* (*encode_for_transmit)(const IdPropertyList *propDef, const xdr_data_t*, const FGPropertyData*);
     xdr_data_t* (*decode_received)(const IdPropertyList *propDef, const xdr_data_t*, FGPropertyData*);
 };
 
@@ -167,7 +173,7 @@ struct BoolArrayBuffer {
     int boolValue;
 };
 
-static xdr_data_t *encode_launchbar_state_for_transmission(const IdPropertyList *propDef, const xdr_data_t *_xdr, FGPropertyData*p)
+static xdr_data_t *encode_launchbar_state_for_transmission(const IdPropertyList *propDef, const xdr_data_t *_xdr, const FGPropertyData*p)
 {
     xdr_data_t *xdr = (xdr_data_t *)_xdr;
 
@@ -210,10 +216,7 @@ static xdr_data_t *decode_received_launchbar_state(const IdPropertyList *propDef
     }
 
     p->id = 108; // this is for the string property for gear/launchbar/state
-    if (p->string_value && p->type == simgear::props::STRING)
-        delete[] p->string_value;
-    p->string_value = new char[strlen(stringvalue) + 1];
-    strcpy(p->string_value, stringvalue);
+    p->string_value = stringvalue;
     p->type = simgear::props::STRING;
     return xdr;
 }
@@ -1029,6 +1032,195 @@ static bool do_cpdlc_disconnect(const SGPropertyNode* arg, SGPropertyNode* root)
 }
 
 
+/**
+ * The buffer that holds a multi-player message, suitably aligned.
+ */
+union FGMultiplayMgr::MsgBuf
+{
+    MsgBuf()
+    {
+        memset(&Msg, 0, sizeof(Msg));
+    }
+
+    T_MsgHdr* msgHdr()
+    {
+        return &Header;
+    }
+
+    const T_MsgHdr* msgHdr() const
+    {
+        return reinterpret_cast<const T_MsgHdr*>(&Header);
+    }
+
+    T_PositionMsg* posMsg()
+    {
+        return reinterpret_cast<T_PositionMsg*>(Msg + sizeof(T_MsgHdr));
+    }
+
+    const T_PositionMsg* posMsg() const
+    {
+        return reinterpret_cast<const T_PositionMsg*>(Msg + sizeof(T_MsgHdr));
+    }
+
+    xdr_data_t* properties()
+    {
+        return reinterpret_cast<xdr_data_t*>(Msg + sizeof(T_MsgHdr)
+                                             + sizeof(T_PositionMsg));
+    }
+
+    const xdr_data_t* properties() const
+    {
+        return reinterpret_cast<const xdr_data_t*>(Msg + sizeof(T_MsgHdr)
+                                                   + sizeof(T_PositionMsg));
+    }
+    /**
+     * The end of the properties buffer.
+     */
+    xdr_data_t* propsEnd()
+    {
+        return reinterpret_cast<xdr_data_t*>(Msg + MAX_PACKET_SIZE);
+    };
+
+    const xdr_data_t* propsEnd() const
+    {
+        return reinterpret_cast<const xdr_data_t*>(Msg + MAX_PACKET_SIZE);
+    };
+    /**
+     * The end of properties actually in the buffer. This assumes that
+     * the message header is valid.
+     */
+    xdr_data_t* propsRecvdEnd()
+    {
+        return reinterpret_cast<xdr_data_t*>(Msg + Header.MsgLen);
+    }
+
+    const xdr_data_t* propsRecvdEnd() const
+    {
+        return reinterpret_cast<const xdr_data_t*>(Msg + Header.MsgLen);
+    }
+
+    xdr_data2_t double_val;
+    char Msg[MAX_PACKET_SIZE];
+    T_MsgHdr Header;
+};
+
+/**
+ * Receives packets from the multiplayer socket, validates their headers and
+ * decodes position messages, handing the results to the main thread through
+ * a single producer, single consumer ring of reusable slots. Only the
+ * aircraft state update is left to FGMultiplayMgr::update().
+ */
+class FGMultiplayMgr::ReceiveThread : public SGThread
+{
+public:
+    struct Message
+    {
+        MsgBuf msgBuf;
+        int length = 0;
+        long stamp = 0;
+        simgear::IPAddress sender;
+        // Only set for position messages that decoded successfully.
+        bool decoded = false;
+        int fallbackModelIndex = 0;
+        FGExternalMotionData motionInfo;
+    };
+
+    explicit ReceiveThread(FGMultiplayMgr* mgr) :
+        mMgr(mgr),
+        mSlots(SLOT_COUNT)
+    {
+    }
+
+    ~ReceiveThread()
+    {
+        stop();
+    }
+
+    void stop()
+    {
+        if (mRunning) {
+            mStop = true;
+            join();
+            mRunning = false;
+        }
+    }
+
+    void begin()
+    {
+        mStop = false;
+        mRunning = true;
+        start();
+    }
+
+    // Consumer side, main thread only: the oldest message, or nullptr.
+    Message* front()
+    {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire))
+            return nullptr;
+        return &mSlots[head % SLOT_COUNT];
+    }
+
+    void pop()
+    {
+        mHead.store(mHead.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // How often the receiver found the ring full and had to wait.
+    unsigned fullCount() const { return mFullCount; }
+
+protected:
+    void run() override
+    {
+        simgear::Socket* socket = mMgr->mSocket.get();
+        while (!mStop) {
+            simgear::Socket* reads[2] = {socket, nullptr};
+            if (simgear::Socket::select(reads, nullptr, 100) <= 0)
+                continue;
+
+            for (;;) {
+                const size_t tail = mTail.load(std::memory_order_relaxed);
+                if (tail - mHead.load(std::memory_order_acquire) == SLOT_COUNT) {
+                    // The main loop is behind; leave the rest in the socket
+                    // buffer and give it a moment.
+                    ++mFullCount;
+                    SGTimeStamp::sleepForMSec(5);
+                    break;
+                }
+
+                Message& m = mSlots[tail % SLOT_COUNT];
+                m.length = mMgr->GetMsgNetwork(m.msgBuf, m.sender);
+                if (m.length == 0)
+                    break;
+                if (!mMgr->CheckMsgHeader(m.msgBuf, m.length))
+                    continue;
+
+                m.stamp = SGTimeStamp::now().getSeconds();
+                m.decoded = false;
+                if (m.msgBuf.msgHdr()->MsgId == POS_DATA_ID) {
+                    m.motionInfo.clearProperties();
+                    m.fallbackModelIndex = 0;
+                    m.decoded = mMgr->DecodePosMsg(m.msgBuf, m.motionInfo,
+                                                   m.fallbackModelIndex);
+                }
+                mTail.store(tail + 1, std::memory_order_release);
+            }
+        }
+    }
+
+private:
+    enum { SLOT_COUNT = 256 };
+
+    FGMultiplayMgr* mMgr;
+    std::vector<Message> mSlots;
+    std::atomic<size_t> mHead{0};
+    std::atomic<size_t> mTail{0};
+    std::atomic<bool> mStop{false};
+    std::atomic<unsigned> mFullCount{0};
+    bool mRunning = false;
+};
+
+
 //////////////////////////////////////////////////////////////////////
 //
 //  MultiplayMgr constructor
@@ -1040,6 +1232,8 @@ FGMultiplayMgr::FGMultiplayMgr()
   mInitialised   = false;
   mHaveServer    = false;
   mListener = NULL;
+  mSendMotionInfo.reset(new FGExternalMotionData);
+  mRecvMotionInfo.reset(new FGExternalMotionData);
   globals->get_commands()->addCommand("multiplayer-connect", do_multiplayer_connect);
   globals->get_commands()->addCommand("multiplayer-disconnect", do_multiplayer_disconnect);
   globals->get_commands()->addCommand("multiplayer-refreshserverlist", do_multiplayer_refreshserverlist);
@@ -1058,6 +1252,7 @@ FGMultiplayMgr::FGMultiplayMgr()
   pMultiPlayRange->setIntValue(100);
   pReplayState = fgGetNode("/sim/replay/replay-state", true);
   pLogRawSpeedMultiplayer = fgGetNode("/sim/replay/log-raw-speed-multiplayer", true);
+  pReceiveQueueFull = fgGetNode("/sim/multiplay/stats/receive-queue-full", true);
 
 
 } // FGMultiplayMgr::FGMultiplayMgr()
@@ -1078,6 +1273,9 @@ FGMultiplayMgr::~FGMultiplayMgr()
    globals->get_commands()->removeCommand("cpdlc-send");
    globals->get_commands()->removeCommand("cpdlc-next-message");
    globals->get_commands()->removeCommand("cpdlc-disconnect");
+
+   // stop receiving before the socket goes away
+   mReceiveThread.reset();
 } // FGMultiplayMgr::~FGMultiplayMgr()
 //////////////////////////////////////////////////////////////////////
 
@@ -1104,7 +1302,9 @@ FGMultiplayMgr::init (void)
   //////////////////////////////////////////////////
   //  Set members from property values
   //////////////////////////////////////////////////
-  short rxPort = fgGetInt("/sim/multiplay/rxport");
+  int rxPort = fgGetInt("/sim/multiplay/rxport");
+  // let the OS pick a free receive port (for tests); it is published in rxport
+  const bool anyRxPort = fgGetBool("/sim/multiplay/rxport-any", false);
   string rxAddress = fgGetString("/sim/multiplay/rxhost");
   short txPort = fgGetInt("/sim/multiplay/txport", 5000);
   string txAddress = fgGetString("/sim/multiplay/txhost");
@@ -1133,14 +1333,16 @@ FGMultiplayMgr::init (void)
       SG_LOG(SG_NETWORK, SG_INFO, "FGMultiplayMgr - have server");
       mHaveServer = true;
     }
-    if (rxPort <= 0)
+    if (anyRxPort)
+      rxPort = 0;
+    else if (rxPort <= 0)
       rxPort = txPort;
   } else {
     SG_LOG(SG_NETWORK, SG_INFO, "FGMultiplayMgr - multiplayer mode disabled (no MP server specificed).");
     return;
   }
 
-  if (rxPort <= 0) {
+  if ((rxPort <= 0) && !anyRxPort) {
     SG_LOG(SG_NETWORK, SG_ALERT,
       "Cannot enable multiplayer mode: No receiver port specified.");
     return;
@@ -1167,6 +1369,36 @@ FGMultiplayMgr::init (void)
     return;
   }
 
+  if (anyRxPort) {
+    sockaddr_in bound;
+    socklen_t boundLength = sizeof(bound);
+    if (getsockname(mSocket->getHandle(), reinterpret_cast<sockaddr*>(&bound), &boundLength) != 0) {
+      SG_LOG(SG_NETWORK, SG_ALERT,
+             "Cannot enable multiplayer mode: reading the receive port failed.");
+      return;
+    }
+    rxPort = ntohs(bound.sin_port);
+    fgSetInt("/sim/multiplay/rxport", rxPort);
+    SG_LOG(SG_NETWORK, SG_INFO, "FGMultiplayMgr::init-rxport assigned= " << rxPort);
+  }
+
+  if (fgGetBool("/sim/multiplay/receive-thread", true)) {
+    mReceiveThread.reset(new ReceiveThread(this));
+    mReceiveThread->begin();
+  }
+
+  int loopbackCount = fgGetInt("/sim/multiplay/loopback-generator/aircraft");
+  if (loopbackCount > 0) {
+    SGGeod center = SGGeod::fromDegFt(fgGetDouble("/position/longitude-deg"),
+                                      fgGetDouble("/position/latitude-deg"),
+                                      fgGetDouble("/position/altitude-ft"));
+    mLoopback.reset(new MPLoopbackGenerator(center, loopbackCount));
+    std::string loopbackHost = rxAddress.empty() ? std::string("127.0.0.1") : rxAddress;
+    if (!mLoopback->open(loopbackHost, rxPort)) {
+      mLoopback.reset();
+    }
+  }
+
   mPropertiesChanged = true;
   mListener = new MPPropertyListener(this);
   globals->get_props()->addChangeListener(mListener, false);
@@ -1207,6 +1439,10 @@ FGMultiplayMgr::shutdown (void)
 {
   fgSetBool("/sim/multiplay/online", false);
 
+  // the receive thread reads from the socket, so stop it first
+  mReceiveThread.reset();
+  mLoopback.reset();
+
   if (mSocket.get()) {
     mSocket->close();
     mSocket.reset();
@@ -1248,78 +1484,6 @@ FGMultiplayMgr::reinit()
 //
 //////////////////////////////////////////////////////////////////////
 
-/**
- * The buffer that holds a multi-player message, suitably aligned.
- */
-union FGMultiplayMgr::MsgBuf
-{
-    MsgBuf()
-    {
-        memset(&Msg, 0, sizeof(Msg));
-    }
-
-    T_MsgHdr* msgHdr()
-    {
-        return &Header;
-    }
-
-    const T_MsgHdr* msgHdr() const
-    {
-        return reinterpret_cast<const T_MsgHdr*>(&Header);
-    }
-
-    T_PositionMsg* posMsg()
-    {
-        return reinterpret_cast<T_PositionMsg*>(Msg + sizeof(T_MsgHdr));
-    }
-
-    const T_PositionMsg* posMsg() const
-    {
-        return reinterpret_cast<const T_PositionMsg*>(Msg + sizeof(T_MsgHdr));
-    }
-
-    xdr_data_t* properties()
-    {
-        return reinterpret_cast<xdr_data_t*>(Msg + sizeof(T_MsgHdr)
-                                             + sizeof(T_PositionMsg));
-    }
-
-    const xdr_data_t* properties() const
-    {
-        return reinterpret_cast<const xdr_data_t*>(Msg + sizeof(T_MsgHdr)
-                                                   + sizeof(T_PositionMsg));
-    }
-    /**
-     * The end of the properties buffer.
-     */
-    xdr_data_t* propsEnd()
-    {
-        return reinterpret_cast<xdr_data_t*>(Msg + MAX_PACKET_SIZE);
-    };
-
-    const xdr_data_t* propsEnd() const
-    {
-        return reinterpret_cast<const xdr_data_t*>(Msg + MAX_PACKET_SIZE);
-    };
-    /**
-     * The end of properties actually in the buffer. This assumes that
-     * the message header is valid.
-     */
-    xdr_data_t* propsRecvdEnd()
-    {
-        return reinterpret_cast<xdr_data_t*>(Msg + Header.MsgLen);
-    }
-
-    const xdr_data_t* propsRecvdEnd() const
-    {
-        return reinterpret_cast<const xdr_data_t*>(Msg + Header.MsgLen);
-    }
-
-    xdr_data2_t double_val;
-    char Msg[MAX_PACKET_SIZE];
-    T_MsgHdr Header;
-};
-
 bool
 FGMultiplayMgr::isSane(const FGExternalMotionData& motionInfo)
 {
@@ -1440,9 +1604,9 @@ FGMultiplayMgr::SendMyPosition(const FGExternalMotionData& motionInfo)
 
       for (int partition = 1; partition <= protocolToUse; partition++)
       {
-          std::vector<FGPropertyData*>::const_iterator it = motionInfo.properties.begin();
+          std::vector<FGPropertyData>::const_iterator it = motionInfo.properties.begin();
           while (it != motionInfo.properties.end()) {
-              const struct IdPropertyList* propDef = mPropertyDefinition[(*it)->id];
+              const struct IdPropertyList* propDef = mPropertyDefinition[it->id];
 
               /*
                * Excludes the 2017.2 property for the protocol version from V1 packets.
@@ -1472,20 +1636,20 @@ FGMultiplayMgr::SendMyPosition(const FGExternalMotionData& motionInfo)
               {
                   if (ptr + 2 >= msgEnd)
                   {
-                      SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer packet truncated prop id: " << (*it)->id << ": " << propDef->name);
+                      SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer packet truncated prop id: " << it->id << ": " << propDef->name);
                       break;
                   }
 
                   // First element is the ID. Write it out when we know we have room for
                   // the whole property.
-                  xdr_data_t id = XDR_encode_uint32((*it)->id);
+                  xdr_data_t id = XDR_encode_uint32(it->id);
 
 
                   /*
                    * 2017.2 protocol has the ability to transmit as a different type (to save space), so
                    * process this when using this protocol (protocolVersion 2) or later
                    */
-                  int transmit_type = (*it)->type;
+                  int transmit_type = it->type;
 
                   if (propDef->TransmitAs != TT_ASIS && protocolToUse > 1)
                   {
@@ -1498,11 +1662,11 @@ FGMultiplayMgr::SendMyPosition(const FGExternalMotionData& motionInfo)
                       SG_LOG(SG_NETWORK, SG_INFO,
                           "[SEND] pt " << partition <<
                           ": buf[" << (ptr - data) * sizeof(*ptr)
-                          << "] id=" << (*it)->id << " type " << transmit_type);
+                          << "] id=" << it->id << " type " << transmit_type);
 
                   if (propDef->encode_for_transmit && protocolToUse > 1)
                   {
-                      ptr = (*propDef->encode_for_transmit)(propDef, ptr, (*it));
+                      ptr = (*propDef->encode_for_transmit)(propDef, ptr, &*it);
                   }
                   else
                   {
@@ -1512,53 +1676,53 @@ FGMultiplayMgr::SendMyPosition(const FGExternalMotionData& motionInfo)
                           break;
                       case TT_SHORTINT:
                       {
-                          *ptr++ = XDR_encode_shortints32((*it)->id, (*it)->int_value);
+                          *ptr++ = XDR_encode_shortints32(it->id, it->int_value);
                           break;
                       }
                       case TT_SHORT_FLOAT_1:
                       {
-                          short value = get_scaled_short((*it)->float_value, 10.0);
-                          *ptr++ = XDR_encode_shortints32((*it)->id, value);
+                          short value = get_scaled_short(it->float_value, 10.0);
+                          *ptr++ = XDR_encode_shortints32(it->id, value);
                           break;
                       }
                       case TT_SHORT_FLOAT_2:
                       {
-                          short value = get_scaled_short((*it)->float_value, 100.0);
-                          *ptr++ = XDR_encode_shortints32((*it)->id, value);
+                          short value = get_scaled_short(it->float_value, 100.0);
+                          *ptr++ = XDR_encode_shortints32(it->id, value);
                           break;
                       }
                       case TT_SHORT_FLOAT_3:
                       {
-                          short value = get_scaled_short((*it)->float_value, 1000.0);
-                          *ptr++ = XDR_encode_shortints32((*it)->id, value);
+                          short value = get_scaled_short(it->float_value, 1000.0);
+                          *ptr++ = XDR_encode_shortints32(it->id, value);
                           break;
                       }
                       case TT_SHORT_FLOAT_4:
                       {
-                          short value = get_scaled_short((*it)->float_value, 10000.0);
-                          *ptr++ = XDR_encode_shortints32((*it)->id, value);
+                          short value = get_scaled_short(it->float_value, 10000.0);
+                          *ptr++ = XDR_encode_shortints32(it->id, value);
                           break;
                       }
 
                       case TT_SHORT_FLOAT_NORM:
                       {
-                          short value = get_scaled_short((*it)->float_value, 32767.0);
-                          *ptr++ = XDR_encode_shortints32((*it)->id, value);
+                          short value = get_scaled_short(it->float_value, 32767.0);
+                          *ptr++ = XDR_encode_shortints32(it->id, value);
                           break;
                       }
                       case TT_BOOLARRAY:
                       {
                           struct BoolArrayBuffer *boolBuf = nullptr;
-                          if ((*it)->id >= BOOLARRAY_START_ID && (*it)->id <= BOOLARRAY_END_ID + BOOLARRAY_BLOCKSIZE)
+                          if (it->id >= BOOLARRAY_START_ID && it->id <= BOOLARRAY_END_ID + BOOLARRAY_BLOCKSIZE)
                           {
-                              int buffer_block = ((*it)->id - BOOLARRAY_BASE_1) / BOOLARRAY_BLOCKSIZE;
+                              int buffer_block = (it->id - BOOLARRAY_BASE_1) / BOOLARRAY_BLOCKSIZE;
                               boolBuf = &boolBuffer[buffer_block];
                               boolBuf->propertyId = BOOLARRAY_START_ID + buffer_block * BOOLARRAY_BLOCKSIZE;
                           }
                           if (boolBuf)
                           {
-                              int bitidx = (*it)->id - boolBuf->propertyId;
-                              if ((*it)->int_value)
+                              int bitidx = it->id - boolBuf->propertyId;
+                              if (it->int_value)
                                   boolBuf->boolValue |= 1 << bitidx;
                           }
                           break;
@@ -1567,12 +1731,12 @@ FGMultiplayMgr::SendMyPosition(const FGExternalMotionData& motionInfo)
                       case simgear::props::BOOL:
                       case simgear::props::LONG:
                           *ptr++ = id;
-                          *ptr++ = XDR_encode_uint32((*it)->int_value);
+                          *ptr++ = XDR_encode_uint32(it->int_value);
                           break;
                       case simgear::props::FLOAT:
                       case simgear::props::DOUBLE:
                           *ptr++ = id;
-                          *ptr++ = XDR_encode_float((*it)->float_value);
+                          *ptr++ = XDR_encode_float(it->float_value);
                           break;
                       case simgear::props::STRING:
                       case simgear::props::UNSPECIFIED:
@@ -1582,7 +1746,7 @@ FGMultiplayMgr::SendMyPosition(const FGExternalMotionData& motionInfo)
                               // New string encoding:
                               // xdr[0] : ID length packed into 32 bit containing two shorts.
                               // xdr[1..len/4] The string itself (char[length])
-                              const char* lcharptr = (*it)->string_value;
+                              const char* lcharptr = it->string_value;
 
                               if (lcharptr != 0)
                               {
@@ -1591,7 +1755,7 @@ FGMultiplayMgr::SendMyPosition(const FGExternalMotionData& motionInfo)
                                   if (len >= MAX_TEXT_SIZE)
                                   {
                                       len = MAX_TEXT_SIZE - 1;
-                                      SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer property truncated at MAX_TEXT_SIZE in string " << (*it)->id);
+                                      SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer property truncated at MAX_TEXT_SIZE in string " << it->id);
                                   }
 
                                   char *encodeStart = (char*)ptr;
@@ -1599,11 +1763,11 @@ FGMultiplayMgr::SendMyPosition(const FGExternalMotionData& motionInfo)
 
                                   if (encodeStart + 2 + len >= msgEndbyte)
                                   {
-                                      SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer property not sent (no room) string " << (*it)->id);
+                                      SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer property not sent (no room) string " << it->id);
                                       goto escape;
                                   }
 
-                                  *ptr++ = XDR_encode_shortints32((*it)->id, len);
+                                  *ptr++ = XDR_encode_shortints32(it->id, len);
                                   encodeStart = (char*)ptr;
                                   if (len != 0)
                                   {
@@ -1612,7 +1776,7 @@ FGMultiplayMgr::SendMyPosition(const FGExternalMotionData& motionInfo)
                                       {
                                           if (encodeStart + 2 >= msgEndbyte)
                                           {
-                                              SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer packet truncated in string " << (*it)->id << " lcount " << lcount);
+                                              SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer packet truncated in string " << it->id << " lcount " << lcount);
                                               break;
                                           }
                                           *encodeStart++ = *lcharptr++;
@@ -1634,7 +1798,7 @@ FGMultiplayMgr::SendMyPosition(const FGExternalMotionData& motionInfo)
                               // The length of the string
                               // The string itself
                               // Padding to the nearest 4-bytes.
-                              const char* lcharptr = (*it)->string_value;
+                              const char* lcharptr = it->string_value;
 
                               if (lcharptr != 0)
                               {
@@ -1644,7 +1808,7 @@ FGMultiplayMgr::SendMyPosition(const FGExternalMotionData& motionInfo)
                                   if (len >= MAX_TEXT_SIZE)
                                   {
                                       len = MAX_TEXT_SIZE - 1;
-                                      SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer property truncated at MAX_TEXT_SIZE in string " << (*it)->id);
+                                      SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer property truncated at MAX_TEXT_SIZE in string " << it->id);
                                   }
 
                                   // XXX This should not be using 4 bytes per character!
@@ -1652,7 +1816,7 @@ FGMultiplayMgr::SendMyPosition(const FGExternalMotionData& motionInfo)
                                   // on the floor.
                                   if (ptr + 2 + ((len + 3) & ~3) >= msgEnd)
                                   {
-                                      SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer property not sent (no room) string " << (*it)->id);
+                                      SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer property not sent (no room) string " << it->id);
                                       goto escape;
                                   }
                                   //cout << "String length unint32: " << len << "\n";
@@ -1667,7 +1831,7 @@ FGMultiplayMgr::SendMyPosition(const FGExternalMotionData& motionInfo)
                                       {
                                           if (ptr + 2 >= msgEnd)
                                           {
-                                              SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer packet truncated in string " << (*it)->id << " lcount " << lcount);
+                                              SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer packet truncated in string " << it->id << " lcount " << lcount);
                                               break;
                                           }
                                           *ptr++ = XDR_encode_int8(*lcharptr);
@@ -1679,7 +1843,7 @@ FGMultiplayMgr::SendMyPosition(const FGExternalMotionData& motionInfo)
                                       {
                                           if (ptr + 2 >= msgEnd)
                                           {
-                                              SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer packet truncated in string " << (*it)->id << " lcount " << lcount);
+                                              SG_LOG(SG_NETWORK, SG_ALERT, "Multiplayer packet truncated in string " << it->id << " lcount " << lcount);
                                               break;
                                           }
                                           *ptr++ = XDR_encode_int8(0);
@@ -1699,7 +1863,7 @@ FGMultiplayMgr::SendMyPosition(const FGExternalMotionData& motionInfo)
 
                       default:
                           *ptr++ = id;
-                          *ptr++ = XDR_encode_float((*it)->float_value);;
+                          *ptr++ = XDR_encode_float(it->float_value);;
                           break;
                       }
                   }
@@ -1889,9 +2053,9 @@ int FGMultiplayMgr::GetMsg(MsgBuf& msgBuf, simgear::IPAddress& SenderAddress)
         
             if (mReplayMessageQueue.empty()) {
                 // No recorded messages available, so look for live messages
-                // from <mSocket>.
+                // from <mSocket>, unless the receive thread owns it.
                 //
-                int RecvStatus = GetMsgNetwork(msgBuf, SenderAddress);
+                int RecvStatus = mReceiveThread ? 0 : GetMsgNetwork(msgBuf, SenderAddress);
                 if (RecvStatus == 0) {
                     // No recorded messages, and no live messages, so return 0.
                     return 0;
@@ -1930,7 +2094,7 @@ int FGMultiplayMgr::GetMsg(MsgBuf& msgBuf, simgear::IPAddress& SenderAddress)
         }
     }
     else {
-        int length = GetMsgNetwork(msgBuf, SenderAddress);
+        int length = mReceiveThread ? 0 : GetMsgNetwork(msgBuf, SenderAddress);
         
         // Make raw incoming packet available to recording code.
         if (length) {
@@ -1943,6 +2107,78 @@ int FGMultiplayMgr::GetMsg(MsgBuf& msgBuf, simgear::IPAddress& SenderAddress)
 }
 
 
+// Validates the header of a received message (already converted to host
+// byte order by GetMsgNetwork).
+//
+bool FGMultiplayMgr::CheckMsgHeader(const MsgBuf& msgBuf, int bytes)
+{
+    if (bytes <= static_cast<int>(sizeof(T_MsgHdr))) {
+      SG_LOG( SG_NETWORK, SG_INFO, "FGMultiplayMgr::MP_ProcessData - "
+              << "received message with insufficient data" );
+      return false;
+    }
+
+    const T_MsgHdr* MsgHdr = msgBuf.msgHdr();
+    if (MsgHdr->Magic != MSG_MAGIC) {
+        SG_LOG(SG_NETWORK, SG_INFO, "FGMultiplayMgr::MP_ProcessData - "
+              << "message has invalid magic number!" );
+      return false;
+    }
+    if (MsgHdr->Version != PROTO_VER) {
+        SG_LOG(SG_NETWORK, SG_INFO, "FGMultiplayMgr::MP_ProcessData - "
+              << "message has invalid protocol number!" );
+      return false;
+    }
+    if (static_cast<int>(MsgHdr->MsgLen) != bytes) {
+        SG_LOG(SG_NETWORK, SG_INFO, "FGMultiplayMgr::MP_ProcessData - "
+             << "message from " << MsgHdr->Callsign << " has invalid length!");
+      return false;
+    }
+    return true;
+}
+
+// Dispatches the messages received and decoded by the receive thread. Like
+// GetMsg(), everything is recorded, and while replaying only live chat
+// messages are processed.
+//
+void FGMultiplayMgr::ProcessReceivedMessages()
+{
+    const bool replaying = pReplayState->getIntValue();
+    while (ReceiveThread::Message* m = mReceiveThread->front()) {
+        // Make raw incoming packet available to recording code.
+        std::shared_ptr<std::vector<char>> data(new std::vector<char>(m->length));
+        memcpy(&data->front(), m->msgBuf.Msg, m->length);
+        mRecordMessageQueue.push_back(data);
+
+        const T_MsgHdr* MsgHdr = m->msgBuf.msgHdr();
+        if (pMultiPlayDebugLevel->getIntValue() & 16)
+            SG_LOG_HEXDUMP(SG_NETWORK, SG_INFO, m->msgBuf.Msg, MsgHdr->MsgLen);
+
+        switch (MsgHdr->MsgId) {
+        case CHAT_MSG_ID:
+            ProcessChatMsg(m->msgBuf, m->sender);
+            break;
+        case POS_DATA_ID:
+            if (m->decoded && !replaying) {
+                HandlePosMsg(m->msgBuf, m->motionInfo, m->fallbackModelIndex, m->stamp);
+            }
+            break;
+        case UNUSABLE_POS_DATA_ID:
+        case OLD_OLD_POS_DATA_ID:
+        case OLD_PROP_MSG_ID:
+        case OLD_POS_DATA_ID:
+            break;
+        default:
+            SG_LOG(SG_NETWORK, SG_INFO, "FGMultiplayMgr::MP_ProcessData - "
+                  << "Unknown message Id received: " << MsgHdr->MsgId );
+            break;
+        }
+        mReceiveThread->pop();
+    }
+    pReceiveQueueFull->setIntValue(mReceiveThread->fullCount());
+}
+
+
 //////////////////////////////////////////////////////////////////////
 //
 //  Name: update
@@ -1970,8 +2206,13 @@ FGMultiplayMgr::update(double dt)
   // also trigger a send
   if ((mpTime >= mNextTransmitTime) || (mpTime < (mNextTransmitTime - 2.0 * mDt))) {
       Send(mpTime);
+      if (mLoopback) {
+          mLoopback->send(mpTime);
+      }
   }
 
+  mDebugLevel = pMultiPlayDebugLevel->getIntValue();
+
   //////////////////////////////////////////////////
   //  Read from receive socket and/or multiplayer
   //  replay, and process any data.
@@ -1986,31 +2227,11 @@ FGMultiplayMgr::update(double dt)
     }
     // status is positive: bytes received
     bytes = (ssize_t) RecvStatus;
-    if (bytes <= static_cast<ssize_t>(sizeof(T_MsgHdr))) {
-      SG_LOG( SG_NETWORK, SG_INFO, "FGMultiplayMgr::MP_ProcessData - "
-              << "received message with insufficient data" );
+    if (!CheckMsgHeader(msgBuf, RecvStatus)) {
       break;
     }
-    
-    //////////////////////////////////////////////////
-    //  Read header
-    //////////////////////////////////////////////////
     T_MsgHdr* MsgHdr = msgBuf.msgHdr();
-    if (MsgHdr->Magic != MSG_MAGIC) {
-        SG_LOG(SG_NETWORK, SG_INFO, "FGMultiplayMgr::MP_ProcessData - "
-              << "message has invalid magic number!" );
-      break;
-    }
-    if (MsgHdr->Version != PROTO_VER) {
-        SG_LOG(SG_NETWORK, SG_INFO, "FGMultiplayMgr::MP_ProcessData - "
-              << "message has invalid protocol number!" );
-      break;
-    }
-    if (static_cast<ssize_t>(MsgHdr->MsgLen) != bytes) {
-        SG_LOG(SG_NETWORK, SG_INFO, "FGMultiplayMgr::MP_ProcessData - "
-             << "message from " << MsgHdr->Callsign << " has invalid length!");
-      break;
-    }
+
     //hexdump the incoming packet
     if (pMultiPlayDebugLevel->getIntValue() & 16)
         SG_LOG_HEXDUMP(SG_NETWORK, SG_INFO, msgBuf.Msg, MsgHdr->MsgLen);
@@ -2037,6 +2258,10 @@ FGMultiplayMgr::update(double dt)
     }
   } while (bytes > 0);
 
+  if (mReceiveThread) {
+    ProcessReceivedMessages();
+  }
+
   // check for expiry
   MultiPlayerMap::iterator it = mMultiPlayerMap.begin();
   while (it != mMultiPlayerMap.end()) {
@@ -2080,7 +2305,10 @@ void FGMultiplayMgr::Send(double mpTime)
 
     // put together a motion info struct, you will get that later
     // from FGInterface directly ...
-    FGExternalMotionData motionInfo;
+    // The struct is reused between sends so its property storage is
+    // recycled instead of reallocated.
+    FGExternalMotionData& motionInfo = *mSendMotionInfo;
+    motionInfo.clearProperties();
 
     // The current simulation time we need to update for,
     // note that the simulation time is updated before calling all the
@@ -2136,9 +2364,10 @@ void FGMultiplayMgr::Send(double mpTime)
         motionInfo.angularAccel = SGVec3f::zeros();
     }
 
+    motionInfo.properties.resize(mPropertyMap.size());
+    auto pData = motionInfo.properties.begin();
     PropertyMap::iterator it;
-    for (it = mPropertyMap.begin(); it != mPropertyMap.end(); ++it) {
-        FGPropertyData* pData = new FGPropertyData;
+    for (it = mPropertyMap.begin(); it != mPropertyMap.end(); ++it, ++pData) {
         pData->id = it->first;
         pData->type = findProperty(pData->id)->type;
 
@@ -2168,8 +2397,7 @@ void FGMultiplayMgr::Send(double mpTime)
 
             if (len > 0)
             {
-                pData->string_value = new char[len + 1];
-                strcpy(pData->string_value, cstr.c_str());
+                pData->string_value = motionInfo.strings.copy(cstr.c_str(), len);
             }
             else
             {
@@ -2186,7 +2414,6 @@ void FGMultiplayMgr::Send(double mpTime)
             pData->float_value = it->second->getFloatValue();
             break;
         }
-        motionInfo.properties.push_back(pData);
     }
     SendMyPosition(motionInfo);
 }
@@ -2194,22 +2421,21 @@ void FGMultiplayMgr::Send(double mpTime)
 
 //////////////////////////////////////////////////////////////////////
 //
-//  handle a position message
+//  decode a position message into motionInfo; the properties are
+//  appended to whatever motionInfo already holds
 //
 //////////////////////////////////////////////////////////////////////
-void
-FGMultiplayMgr::ProcessPosMsg(const FGMultiplayMgr::MsgBuf& Msg,
-   const simgear::IPAddress& SenderAddress, long stamp)
+bool
+FGMultiplayMgr::DecodePosMsg(const FGMultiplayMgr::MsgBuf& Msg,
+   FGExternalMotionData& motionInfo, int& fallback_model_index)
 {
    const T_MsgHdr* MsgHdr = Msg.msgHdr();
    if (MsgHdr->MsgLen < sizeof(T_MsgHdr) + sizeof(T_PositionMsg)) {
       SG_LOG(SG_NETWORK, SG_DEBUG, "FGMultiplayMgr::MP_ProcessData - "
          << "Position message received with insufficient data");
-      return;
+      return false;
    }
    const T_PositionMsg* PosMsg = Msg.posMsg();
-   FGExternalMotionData motionInfo;
-   int fallback_model_index = 0;
    motionInfo.time = XDR_decode_double(PosMsg->time);
    motionInfo.lag = XDR_decode_double(PosMsg->lag);
    for (unsigned i = 0; i < 3; ++i)
@@ -2234,7 +2460,7 @@ FGMultiplayMgr::ProcessPosMsg(const FGMultiplayMgr::MsgBuf& Msg,
       SG_LOG(SG_NETWORK, SG_DEBUG, "FGMultiplayMgr::ProcessPosMsg - "
          << "Position message with invalid data (NaN) received from "
          << MsgHdr->Callsign);
-      return;
+      return false;
    }
 
    //cout << "INPUT MESSAGE\n";
@@ -2289,7 +2515,7 @@ FGMultiplayMgr::ProcessPosMsg(const FGMultiplayMgr::MsgBuf& Msg,
             short_int_encoded = true;
         }
 
-        if (pMultiPlayDebugLevel->getIntValue() & 8)
+        if (mDebugLevel & 8)
             SG_LOG(SG_NETWORK, SG_INFO,
                 "[RECV] add " << std::hex << xdr
                 << std::dec <<
@@ -2302,7 +2528,8 @@ FGMultiplayMgr::ProcessPosMsg(const FGMultiplayMgr::MsgBuf& Msg,
 
       if (plist)
       {
-        FGPropertyData* pData = new FGPropertyData;
+        FGPropertyData prop;
+        FGPropertyData* pData = &prop;
         if (plist->decode_received)
         {
             //
@@ -2337,12 +2564,12 @@ FGMultiplayMgr::ProcessPosMsg(const FGMultiplayMgr::MsgBuf& Msg,
                           if (first_bool)
                               first_bool = false;
                           else
-                              pData = new FGPropertyData;
+                              pData = &prop;
 
                           pData->id = id + bitidx;
                           pData->int_value = (val & (1 << bitidx)) != 0;
                           pData->type = simgear::props::BOOL;
-                          motionInfo.properties.push_back(pData);
+                          motionInfo.properties.push_back(*pData);
 
                           // ensure that this is null because this section of code manages the property data and list directly
                           // it has to be this way because one MP value results in multiple properties being set.
@@ -2403,15 +2630,9 @@ FGMultiplayMgr::ProcessPosMsg(const FGMultiplayMgr::MsgBuf& Msg,
               if (short_int_encoded)
               {
                   uint32_t length = int_value;
-                  pData->string_value = new char[length + 1];
-
-                  char *cptr = (char*)xdr;
-                  for (unsigned i = 0; i < length; i++)
-                  {
-                      pData->string_value[i] = *cptr++;
-                  }
-                  pData->string_value[length] = '\0';
-                  xdr = (xdr_data_t*)cptr;
+                  const char *cptr = (const char*)xdr;
+                  pData->string_value = motionInfo.strings.copy(cptr, length);
+                  xdr = (const xdr_data_t*)(cptr + length);
               }
               else {
                   // String is complicated. It consists of
@@ -2424,15 +2645,16 @@ FGMultiplayMgr::ProcessPosMsg(const FGMultiplayMgr::MsgBuf& Msg,
                   // Old versions truncated the string but left the length unadjusted.
                   if (length > MAX_TEXT_SIZE)
                       length = MAX_TEXT_SIZE;
-                  pData->string_value = new char[length + 1];
+                  char* string_value = motionInfo.strings.allocate(length + 1);
                   //cout << " String: ";
                   for (unsigned i = 0; i < length; i++)
                   {
-                      pData->string_value[i] = (char)XDR_decode_int8(*xdr);
+                      string_value[i] = (char)XDR_decode_int8(*xdr);
                       xdr++;
                   }
 
-                  pData->string_value[length] = '\0';
+                  string_value[length] = '\0';
+                  pData->string_value = string_value;
 
                   // Now handle the padding
                   while ((length % 4) != 0)
@@ -2454,7 +2676,7 @@ FGMultiplayMgr::ProcessPosMsg(const FGMultiplayMgr::MsgBuf& Msg,
           }
       }
       if (pData) {
-        motionInfo.properties.push_back(pData);
+        motionInfo.properties.push_back(*pData);
 
         // Special case - we need the /sim/model/fallback-model-index to create
         // the MP model
@@ -2477,9 +2699,42 @@ FGMultiplayMgr::ProcessPosMsg(const FGMultiplayMgr::MsgBuf& Msg,
     }
   }
  noprops:
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+//  handle a position message
+//
+//////////////////////////////////////////////////////////////////////
+void
+FGMultiplayMgr::ProcessPosMsg(const FGMultiplayMgr::MsgBuf& Msg,
+   const simgear::IPAddress& SenderAddress, long stamp)
+{
+  // Decode into the recycled receive buffer; the aircraft takes over its
+  // properties and hands back the storage of the history slot it reused.
+  FGExternalMotionData& motionInfo = *mRecvMotionInfo;
+  motionInfo.clearProperties();
+  int fallback_model_index = 0;
+  if (!DecodePosMsg(Msg, motionInfo, fallback_model_index))
+    return;
+
+  HandlePosMsg(Msg, motionInfo, fallback_model_index, stamp);
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+//  hand a decoded position message to its aircraft
+//
+//////////////////////////////////////////////////////////////////////
+void
+FGMultiplayMgr::HandlePosMsg(const FGMultiplayMgr::MsgBuf& Msg,
+   FGExternalMotionData& motionInfo, int fallback_model_index, long stamp)
+{
+  const T_MsgHdr* MsgHdr = Msg.msgHdr();
   FGAIMultiplayer* mp = getMultiplayer(MsgHdr->Callsign);
   if (!mp)
-    mp = addMultiplayer(MsgHdr->Callsign, PosMsg->Model, fallback_model_index);
+    mp = addMultiplayer(MsgHdr->Callsign, Msg.posMsg()->Model, fallback_model_index);
   mp->addMotionInfo(motionInfo, stamp);
   
   // Optionally gather information about the raw speed of a selected
@@ -2532,6 +2787,25 @@ void FGMultiplayMgr::pushMessageHistory(std::shared_ptr<std::vector<char>> messa
     mReplayMessageQueue.push_back(message);
 }
 
+bool FGMultiplayMgr::decodePositionPacket(const std::vector<char>& packet,
+                                          FGExternalMotionData& motionInfo)
+{
+    if (packet.size() <= sizeof(T_MsgHdr) || packet.size() > MAX_PACKET_SIZE) {
+        return false;
+    }
+
+    MsgBuf msgBuf;
+    memcpy(msgBuf.Msg, packet.data(), packet.size());
+    const T_MsgHdr* MsgHdr = msgBuf.msgHdr();
+    if (MsgHdr->MsgId != POS_DATA_ID || MsgHdr->MsgLen != packet.size()) {
+        return false;
+    }
+
+    motionInfo.clearProperties();
+    int fallback_model_index = 0;
+    return DecodePosMsg(msgBuf, motionInfo, fallback_model_index);
+}
+
 //////////////////////////////////////////////////////////////////////
 
 //////////////////////////////////////////////////////////////////////
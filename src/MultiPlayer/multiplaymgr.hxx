@@ -34,6 +34,7 @@
 const int MIN_MP_PROTOCOL_VERSION = 1;
 const int MAX_MP_PROTOCOL_VERSION = 2;
 
+#include <atomic>
 #include <deque>
 #include <string>
 #include <vector>
@@ -56,6 +57,7 @@ struct FGExternalMotionData;
 class MPPropertyListener;
 struct T_MsgHdr;
 class FGAIMultiplayer;
+class MPLoopbackGenerator;
 
 
 class FGMultiplayMgr : public SGSubsystem
@@ -82,6 +84,12 @@ public:
 
     std::shared_ptr<vector<char>> popMessageHistory();
     void pushMessageHistory(std::shared_ptr<vector<char>> message);
+
+    // Decode a recorded position packet (as kept in the message history,
+    // with the header already in host byte order) into motionInfo without
+    // handing it to an aircraft. Returns false for unusable packets.
+    bool decodePositionPacket(const std::vector<char>& packet,
+                              FGExternalMotionData& motionInfo);
     
     // Remove motion information for all multiplayer aircraft, e.g. when
     // scrubbing during replay.
@@ -117,8 +125,14 @@ private:
                                     const std::string& modelName,
                                     const int fallback_model_index);
     void FillMsgHdr(T_MsgHdr *MsgHdr, int iMsgId, unsigned _len = 0u);
+    bool CheckMsgHeader(const MsgBuf& msgBuf, int bytes);
+    bool DecodePosMsg(const MsgBuf& Msg, FGExternalMotionData& motionInfo,
+                      int& fallback_model_index);
+    void HandlePosMsg(const MsgBuf& Msg, FGExternalMotionData& motionInfo,
+                      int fallback_model_index, long stamp);
     void ProcessPosMsg(const MsgBuf& Msg, const simgear::IPAddress& SenderAddress,
                        long stamp);
+    void ProcessReceivedMessages();
     void ProcessChatMsg(const MsgBuf& Msg, const simgear::IPAddress& SenderAddress);
     bool isSane(const FGExternalMotionData& motionInfo);
     int GetMsgNetwork(MsgBuf& msgBuf, simgear::IPAddress& SenderAddress);
@@ -145,6 +159,10 @@ private:
     SGPropertyNode *pMultiPlayTransmitPropertyBase;
     SGPropertyNode *pReplayState;
     SGPropertyNode *pLogRawSpeedMultiplayer;
+    SGPropertyNode *pReceiveQueueFull;
+
+    // Copy of /sim/multiplay/debug-level readable from the receive thread
+    std::atomic<int> mDebugLevel{0};
    
     typedef std::map<unsigned int, const struct IdPropertyList*> PropertyDefinitionMap;
     PropertyDefinitionMap mPropertyDefinition;
@@ -156,6 +174,20 @@ private:
     double mDt; // reciprocal of /sim/multiplay/tx-rate-hz
     double mNextTransmitTime = 0.0;
 
+    // Receives and decodes packets off the main thread, unless
+    // /sim/multiplay/receive-thread is false
+    class ReceiveThread;
+    std::unique_ptr<ReceiveThread> mReceiveThread;
+
+    // Synthetic traffic sent to our own receive port, for testing without
+    // a server; see /sim/multiplay/loopback-generator/aircraft
+    std::unique_ptr<MPLoopbackGenerator> mLoopback;
+
+    // Reused for every packet sent and received, so property payloads
+    // don't go through the allocator per packet.
+    std::unique_ptr<FGExternalMotionData> mSendMotionInfo;
+    std::unique_ptr<FGExternalMotionData> mRecvMotionInfo;
+
     std::deque<std::shared_ptr<std::vector<char>>>  mRecordMessageQueue;
     std::deque<std::shared_ptr<std::vector<char>>>  mReplayMessageQueue;
 };
@@ -1,11 +1,12 @@
 #ifndef FG_NAVCACHE_SCHEMA_HXX
 #define FG_NAVCACHE_SCHEMA_HXX
 
-const int SCHEMA_VERSION = 20;
+const int SCHEMA_VERSION = 23;
 
 #define SCHEMA_SQL \
 "CREATE TABLE properties (key VARCHAR, value VARCHAR);" \
 "CREATE TABLE stat_cache (path VARCHAR unique, stamp INT);"\
+"CREATE TABLE procedures (path VARCHAR unique, stamp INT, data BLOB);"\
 \
 "CREATE TABLE positioned (type INT, ident VARCHAR collate nocase," \
     "name VARCHAR collate nocase, airport INT64, lon FLOAT, lat FLOAT," \
@@ -32,7 +33,13 @@ const int SCHEMA_VERSION = 20;
 \
 "CREATE TABLE airway_edge (network INT,airway INT64,a INT64,b INT64);" \
 "CREATE INDEX airway_edge_from ON airway_edge(a);" \
-"CREATE INDEX airway_edge_to ON airway_edge(b);"
+"CREATE INDEX airway_edge_to ON airway_edge(b);" \
+\
+"CREATE TABLE search_trigram (trigram INT, positioned INT64);"
+
+// created once the search_trigram table is filled, at the end of a rebuild
+#define SEARCH_INDEX_SQL \
+"CREATE INDEX search_trigram_key ON search_trigram(trigram, positioned);"
 
 #endif
 
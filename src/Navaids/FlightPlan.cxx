@@ -1527,6 +1527,16 @@ void FlightPlan::activate()
   _currentIndex = 0;
   _currentWaypointChanged = true;
     _waypointsChanged = expandVias();
+
+    // arrival procedures are usually requested later in the flight: parse
+    // them in the background now
+    if (_destination) {
+        _destination->prefetchProcedures();
+    }
+
+    if (_alternate) {
+        _alternate->prefetchProcedures();
+    }
   
   for (auto d : _delegates) {
     d->activated();
@@ -1730,7 +1740,7 @@ void FlightPlan::rebuildLegData()
 {
   _totalDistance = 0.0;
   double totalDistanceIncludingMissed = 0.0;
-  RoutePath path(this);
+  const RoutePath& path(routePath());
   
   for (unsigned int l=0; l<_legs.size(); ++l) {
     _legs[l]->_courseDeg = path.trackForIndex(l);
@@ -1748,15 +1758,26 @@ void FlightPlan::rebuildLegData()
   
 }
   
+const RoutePath& FlightPlan::routePath() const
+{
+    if (!_routePath) {
+        _routePath.reset(new RoutePath(this));
+    } else {
+        _routePath->update(this);
+    }
+
+    return *_routePath;
+}
+
 SGGeod FlightPlan::pointAlongRoute(int aIndex, double aOffsetNm) const
 {
-    RoutePath rp(this);
+    const RoutePath& rp(routePath());
     return rp.positionForDistanceFrom(aIndex, aOffsetNm * SG_NM_TO_METER);
 }
 
 SGGeod FlightPlan::pointAlongRouteNorm(int aIndex, double aOffsetNorm) const
 {
-    RoutePath rp(this);
+    const RoutePath& rp(routePath());
     if (fabs(aOffsetNorm) > 1.0) {
         SG_LOG(SG_AUTOPILOT, SG_ALERT, "FlightPlan::pointAlongRouteNorm: called with invalid arg:" << aOffsetNorm);
         return rp.positionForIndex(aIndex);
@@ -25,10 +25,13 @@
 #define FG_FLIGHTPLAN_HXX
 
 #include <functional>
+#include <memory>
 
 #include <Navaids/route.hxx>
 #include <Airports/airport.hxx>
 
+class RoutePath;
+
 namespace flightgear
 {
 
@@ -355,6 +358,14 @@ public:
      */
   SGGeod pointAlongRouteNorm(int aIndex, double aOffsetNorm) const;
 
+  /**
+   * Turn and path geometry for the legs. The path is cached and brought up
+   * to date on each call, recomputing only the legs around any which were
+   * changed since (or all of them, when the aircraft performance data
+   * changed), so this is cheap to call repeatedly.
+   */
+  const RoutePath& routePath() const;
+
   /**
     @brief given an index to insert a waypoint into the plan, find the geographical vicinity.
         This is used to aid disambiguration searches, etc: see the vicinity paramter to 'waypointFromString'
@@ -498,6 +509,8 @@ private:
     double _totalDistance;
     void rebuildLegData();
 
+    mutable std::unique_ptr<RoutePath> _routePath;
+
     using LegVec = std::vector<LegRef>;
     LegVec _legs;
 
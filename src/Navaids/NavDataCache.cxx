@@ -24,12 +24,16 @@
 #include "NavDataCache.hxx"
 
 // std
+#include <algorithm>
 #include <cstddef>  // for std::size_t
 #include <map>
+#include <set>
 #include <cstring>  // for memcoy
 #include <cassert>
 #include <stdint.h> // for int64_t
 #include <sstream>  // for std::ostringstream
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
 
 #ifdef SYSTEM_SQLITE
@@ -84,6 +88,7 @@
 #include <Navaids/airways.hxx>
 #include <Navaids/fixlist.hxx>
 #include <Navaids/navdb.hxx>
+#include <Navaids/ProcedureCache.hxx>
 
 using std::string;
 
@@ -96,6 +101,22 @@ const int MAX_RETRIES = 10;
 
 const int CACHE_SIZE_KBYTES= 32 * 1024;
 
+// items loaded by one query in loadByIds()
+const size_t LOAD_BATCH_SIZE = 32;
+
+// read-only connections opened for worker threads
+const unsigned int MAX_READ_CONNECTIONS = 4;
+
+// types in the name search index: airports, and the fixes and navaids
+// the launcher searches for (FIX, NDB, VOR)
+#define SEARCHABLE_TYPES "((type>=1 AND type<=3) OR (type>=9 AND type<=11))"
+static_assert((FGPositioned::SEAPORT == 3) && (FGPositioned::FIX == 9) &&
+              (FGPositioned::VOR == 11), "SEARCHABLE_TYPES is out of date");
+
+// trigrams of a search term used to find candidates; matches are checked
+// with LIKE anyway, so the rest only narrow the search further
+const size_t MAX_SEARCH_TRIGRAMS = 8;
+
 // bind a std::string to a sqlite statement. The std::string must live the
 // entire duration of the statement execution - do not pass a temporary
 // std::string, or the compiler may delete it, freeing the C-string storage,
@@ -154,6 +175,59 @@ static string cleanRunwayNo(const string& aRwyNo)
   return result;
 }
 
+int trigramOf(const string& s, size_t i)
+{
+    auto lower = [](char c) {
+        unsigned char u = static_cast<unsigned char>(c);
+        return ((u >= 'A') && (u <= 'Z')) ? u + ('a' - 'A') : u;
+    };
+
+    return (lower(s[i]) << 16) | (lower(s[i + 1]) << 8) | lower(s[i + 2]);
+}
+
+/**
+ * Add the trigrams of an ident or name to the search index set. Two spaces
+ * are appended, so every one or two character substring starts a trigram,
+ * see searchTrigramRange().
+ */
+void addSearchTrigrams(const string& text, std::set<int>& trigrams)
+{
+    if (text.empty()) {
+        return;
+    }
+
+    const string padded = text + "  ";
+    for (size_t i = 0; i + 3 <= padded.size(); ++i) {
+        trigrams.insert(trigramOf(padded, i));
+    }
+}
+
+// distinct trigrams of a term of at least three characters
+std::vector<int> searchTermTrigrams(const string& term)
+{
+    std::set<int> unique;
+    std::vector<int> result;
+    for (size_t i = 0; (i + 3 <= term.size()) && (result.size() < MAX_SEARCH_TRIGRAMS); ++i) {
+        const int t = trigramOf(term, i);
+        if (unique.insert(t).second) {
+            result.push_back(t);
+        }
+    }
+
+    return result;
+}
+
+// trigrams starting with a term of one or two characters
+std::pair<int, int> searchTrigramRange(const string& term)
+{
+    const int first = trigramOf(term + "  ", 0);
+    if (term.size() == 1) {
+        return std::make_pair(first & 0xff0000, first | 0xffff);
+    }
+
+    return std::make_pair(first & 0xffff00, first | 0xff);
+}
+
 class AbandonCacheException : public sg_exception
 {
 public:
@@ -255,6 +329,223 @@ public:
   }
 };
 
+// columns of every positioned type, so an item is loaded with one query
+#define LOAD_COLS "positioned.rowid, positioned.type, positioned.ident, positioned.name, " \
+    "positioned.airport, positioned.lon, positioned.lat, positioned.elev_m, " \
+    "airport.has_metar, " \
+    "runway.heading, runway.length_ft, runway.width_m, runway.surface, " \
+    "runway.displaced_threshold, runway.stopway, runway.reciprocal, runway.ils, " \
+    "navaid.range_nm, navaid.freq, navaid.multiuse, navaid.runway, navaid.colocated, " \
+    "comm.freq_khz, comm.range_nm"
+
+#define LOAD_FROM "positioned " \
+    "LEFT JOIN airport ON airport.rowid=positioned.rowid " \
+    "LEFT JOIN runway ON runway.rowid=positioned.rowid " \
+    "LEFT JOIN navaid ON navaid.rowid=positioned.rowid " \
+    "LEFT JOIN comm ON comm.rowid=positioned.rowid"
+
+enum LoadColumn {
+    LOAD_ROWID = 0,
+    LOAD_TYPE,
+    LOAD_IDENT,
+    LOAD_NAME,
+    LOAD_AIRPORT,
+    LOAD_LON,
+    LOAD_LAT,
+    LOAD_ELEV,
+    LOAD_HAS_METAR,
+    LOAD_RWY_HEADING,
+    LOAD_RWY_LENGTH,
+    LOAD_RWY_WIDTH,
+    LOAD_RWY_SURFACE,
+    LOAD_RWY_DISPLACED_THRESHOLD,
+    LOAD_RWY_STOPWAY,
+    LOAD_RWY_RECIPROCAL,
+    LOAD_RWY_ILS,
+    LOAD_NAV_RANGE,
+    LOAD_NAV_FREQ,
+    LOAD_NAV_MULTIUSE,
+    LOAD_NAV_RUNWAY,
+    LOAD_NAV_COLOCATED,
+    LOAD_COMM_FREQ,
+    LOAD_COMM_RANGE
+};
+
+string columnString(sqlite3_stmt_ptr stmt, int column)
+{
+    const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+    return text ? string(text) : string();
+}
+
+FGPositioned* loadRunway(sqlite3_stmt_ptr stmt, PositionedID rowId, FGPositioned::Type ty,
+                         const string& id, const SGGeod& pos, PositionedID apt)
+{
+    double heading = sqlite3_column_double(stmt, LOAD_RWY_HEADING);
+    double lengthM = sqlite3_column_int(stmt, LOAD_RWY_LENGTH);
+    double widthM = sqlite3_column_double(stmt, LOAD_RWY_WIDTH);
+    int surface = sqlite3_column_int(stmt, LOAD_RWY_SURFACE);
+
+    if (ty == FGPositioned::TAXIWAY) {
+        return new FGTaxiway(rowId, id, pos, heading, lengthM, widthM, surface);
+    } else if (ty == FGPositioned::HELIPAD) {
+        return new FGHelipad(rowId, apt, id, pos, heading, lengthM, widthM, surface);
+    }
+
+    double displacedThreshold = sqlite3_column_double(stmt, LOAD_RWY_DISPLACED_THRESHOLD);
+    double stopway = sqlite3_column_double(stmt, LOAD_RWY_STOPWAY);
+    PositionedID reciprocal = sqlite3_column_int64(stmt, LOAD_RWY_RECIPROCAL);
+    PositionedID ils = sqlite3_column_int64(stmt, LOAD_RWY_ILS);
+    FGRunway* r = new FGRunway(rowId, apt, id, pos, heading, lengthM, widthM,
+                               displacedThreshold, stopway, surface);
+
+    if (reciprocal > 0) {
+        r->setReciprocalRunway(reciprocal);
+    }
+
+    if (ils > 0) {
+        r->setILS(ils);
+    }
+
+    return r;
+}
+
+FGPositioned* loadNav(sqlite3_stmt_ptr stmt, PositionedID rowId, FGPositioned::Type ty,
+                      const string& id, const string& name, const SGGeod& pos)
+{
+    PositionedID runway = sqlite3_column_int64(stmt, LOAD_NAV_RUNWAY);
+    // marker beacons are light-weight
+    if ((ty == FGPositioned::OM) || (ty == FGPositioned::IM) ||
+        (ty == FGPositioned::MM))
+    {
+        return new FGMarkerBeaconRecord(rowId, ty, runway, pos);
+    }
+
+    int rangeNm = sqlite3_column_int(stmt, LOAD_NAV_RANGE),
+        freq = sqlite3_column_int(stmt, LOAD_NAV_FREQ);
+    double mulituse = sqlite3_column_double(stmt, LOAD_NAV_MULTIUSE);
+    PositionedID colocated = sqlite3_column_int64(stmt, LOAD_NAV_COLOCATED);
+
+    FGNavRecord* n =
+      (ty == FGPositioned::MOBILE_TACAN)
+      ? new FGMobileNavRecord
+            (rowId, ty, id, name, pos, freq, rangeNm, mulituse, runway)
+      : new FGNavRecord
+            (rowId, ty, id, name, pos, freq, rangeNm, mulituse, runway);
+
+    if (colocated)
+      n->setColocatedDME(colocated);
+
+    return n;
+}
+
+/**
+ * Build the item in the current row of a statement selecting LOAD_COLS.
+ * Only touches the statement, so it runs on any connection.
+ */
+FGPositioned* positionedFromRow(sqlite3_stmt_ptr stmt, sqlite3_int64& aptId)
+{
+    sqlite3_int64 rowid = sqlite3_column_int64(stmt, LOAD_ROWID);
+    FGPositioned::Type ty = (FGPositioned::Type)sqlite3_column_int(stmt, LOAD_TYPE);
+
+    PositionedID prowid = static_cast<PositionedID>(rowid);
+    string ident = columnString(stmt, LOAD_IDENT);
+    string name = columnString(stmt, LOAD_NAME);
+    aptId = sqlite3_column_int64(stmt, LOAD_AIRPORT);
+    double lon = sqlite3_column_double(stmt, LOAD_LON);
+    double lat = sqlite3_column_double(stmt, LOAD_LAT);
+    double elev = sqlite3_column_double(stmt, LOAD_ELEV);
+    SGGeod pos = SGGeod::fromDegM(lon, lat, elev);
+
+    switch (ty) {
+    case FGPositioned::AIRPORT:
+    case FGPositioned::SEAPORT:
+    case FGPositioned::HELIPORT:
+    {
+      bool hasMetar = (sqlite3_column_int(stmt, LOAD_HAS_METAR) > 0);
+      return new FGAirport(rowid, ident, pos, name, hasMetar, ty);
+    }
+
+    case FGPositioned::TOWER:
+      return new AirportTower(prowid, aptId, ident, pos);
+
+    case FGPositioned::RUNWAY:
+    case FGPositioned::HELIPAD:
+    case FGPositioned::TAXIWAY:
+      return loadRunway(stmt, rowid, ty, ident, pos, aptId);
+
+    case FGPositioned::LOC:
+    case FGPositioned::VOR:
+    case FGPositioned::GS:
+    case FGPositioned::ILS:
+    case FGPositioned::NDB:
+    case FGPositioned::OM:
+    case FGPositioned::MM:
+    case FGPositioned::IM:
+    case FGPositioned::DME:
+    case FGPositioned::TACAN:
+    case FGPositioned::MOBILE_TACAN:
+      return loadNav(stmt, rowid, ty, ident, name, pos);
+
+    case FGPositioned::FIX:
+      return new FGFix(rowid, ident, pos);
+
+    case FGPositioned::WAYPOINT:
+    case FGPositioned::COUNTRY:
+    case FGPositioned::CITY:
+    case FGPositioned::TOWN:
+    case FGPositioned::VILLAGE:
+    {
+        FGPositioned* wpt = new FGPositioned(rowid, ty, ident, pos);
+      return wpt;
+    }
+
+    case FGPositioned::FREQ_GROUND:
+    case FGPositioned::FREQ_TOWER:
+    case FGPositioned::FREQ_ATIS:
+    case FGPositioned::FREQ_AWOS:
+    case FGPositioned::FREQ_APP_DEP:
+    case FGPositioned::FREQ_ENROUTE:
+    case FGPositioned::FREQ_CLEARANCE:
+    case FGPositioned::FREQ_UNICOM:
+    {
+      int range = sqlite3_column_int(stmt, LOAD_COMM_RANGE);
+      int freqKhz = sqlite3_column_int(stmt, LOAD_COMM_FREQ);
+      CommStation* c = new CommStation(rowid, name, ty, pos, range, freqKhz);
+      c->setAirport(aptId);
+      return c;
+    }
+
+    default:
+      return NULL;
+    }
+}
+
+/**
+ * A sqlite connection with the statements used to load items and run
+ * searches. The main connection and each pooled read-only connection have
+ * their own, so the same code runs on either.
+ */
+class NavDataCache::Connection
+{
+public:
+    sqlite3* db = nullptr;
+    sqlite3_stmt_ptr loadPositioned = nullptr;
+    sqlite3_stmt_ptr loadPositionedBatch = nullptr;
+    sqlite3_stmt_ptr getOctreeLeafChildren = nullptr;
+
+    // since there's many permutations of ident/name queries, we create
+    // them programtically, but cache the exact query by its raw SQL once
+    // used.
+    std::map<string, sqlite3_stmt_ptr> findByString;
+
+    // finalized when the connection is closed
+    std::vector<sqlite3_stmt_ptr> prepared;
+
+    // opened past MAX_READ_CONNECTIONS for a caller which cannot wait,
+    // and closed again when released
+    bool overflow = false;
+};
+
 // useful for debugging 'hanging' queries: look for a statement
 // which starts but never completes
 #if 0
@@ -364,6 +655,8 @@ public:
 
   void close()
   {
+    closePool();
+    closeConnection(mainConnection);
     for (sqlite3_stmt_ptr stmt : prepared) {
       sqlite3_finalize(stmt);
     }
@@ -399,9 +692,14 @@ public:
 
     
     sqlite3_stmt_ptr prepareSQL(const std::string& sql)
+    {
+        return prepareSQL(db, sql);
+    }
+
+    sqlite3_stmt_ptr prepareSQL(sqlite3* conn, const std::string& sql)
     {
         sqlite3_stmt_ptr stmt;
-        int result = sqlite3_prepare_v2(db, sql.c_str(), sql.length(), &stmt, nullptr);
+        int result = sqlite3_prepare_v2(conn, sql.c_str(), sql.length(), &stmt, nullptr);
         int retries = 0;
         int retryMSec = 1;
         
@@ -414,7 +712,7 @@ public:
             SGTimeStamp::sleepForMSec(retryMSec);
             retryMSec = retryMSec << 1; // double each time
             // try again
-            result = sqlite3_prepare_v2(db, sql.c_str(), sql.length(), &stmt, nullptr);
+            result = sqlite3_prepare_v2(conn, sql.c_str(), sql.length(), &stmt, nullptr);
         }
         
         if (result == SQLITE_OK) {
@@ -426,7 +724,7 @@ public:
         errMsg = "Sqlite API abuse";
         SG_LOG(SG_NAVCACHE, SG_ALERT, "Sqlite API abuse");
       } else {
-        errMsg = sqlite3_errmsg(db);
+        errMsg = sqlite3_errmsg(conn);
         SG_LOG(SG_NAVCACHE, SG_ALERT, "Sqlite error:" << errMsg << " running:\n\t" << sql);
       }
 
@@ -468,7 +766,7 @@ public:
   {
     assert(stmt);
     if (sqlite3_reset(stmt) != SQLITE_OK) {
-      string errMsg = sqlite3_errmsg(db);
+      string errMsg = sqlite3_errmsg(sqlite3_db_handle(stmt));
       SG_LOG(SG_NAVCACHE, SG_ALERT, "Sqlite error resetting:" << errMsg);
       throw sg_exception("Sqlite error resetting:" + errMsg, sqlite3_sql(stmt));
     }
@@ -517,7 +815,7 @@ public:
       errMsg = "Sqlite API abuse";
       SG_LOG(SG_NAVCACHE, SG_ALERT, "Sqlite API abuse");
     } else {
-      errMsg = sqlite3_errmsg(db);
+      errMsg = sqlite3_errmsg(sqlite3_db_handle(stmt));
       SG_LOG(SG_NAVCACHE, SG_ALERT, "Sqlite error:" << errMsg << " (" << result
              << ") while running:\n\t" << sqlite3_sql(stmt));
     }
@@ -569,18 +867,17 @@ public:
     rollbackTransactionStmt = prepare("ROLLBACK");
 
 
-#define POSITIONED_COLS "rowid, type, ident, name, airport, lon, lat, elev_m, octree_node"
 #define AND_TYPED "AND type>=?2 AND type <=?3"
     statCacheCheck = prepare("SELECT stamp FROM stat_cache WHERE path=?");
     stampFileCache = prepare("INSERT OR REPLACE INTO stat_cache "
                              "(path, stamp) VALUES (?,?)");
+    readProcedures = prepare("SELECT stamp, data FROM procedures WHERE path=?");
+    hasProcedures = prepare("SELECT 1 FROM procedures WHERE path=?1 AND stamp=?2 AND length(data) > 0");
+    writeProcedures = prepare("INSERT OR REPLACE INTO procedures "
+                              "(path, stamp, data) VALUES (?,?,?)");
 
-    loadPositioned = prepare("SELECT " POSITIONED_COLS " FROM positioned WHERE rowid=?");
-    loadAirportStmt = prepare("SELECT has_metar FROM airport WHERE rowid=?");
-    loadNavaid = prepare("SELECT range_nm, freq, multiuse, runway, colocated FROM navaid WHERE rowid=?");
-    loadCommStation = prepare("SELECT freq_khz, range_nm FROM comm WHERE rowid=?");
-    loadRunwayStmt = prepare("SELECT heading, length_ft, width_m, surface, displaced_threshold,"
-                             "stopway, reciprocal, ils FROM runway WHERE rowid=?1");
+    mainConnection.db = db;
+    prepareConnection(mainConnection);
 
     getAirportItems = prepare("SELECT rowid FROM positioned WHERE airport=?1 " AND_TYPED);
 
@@ -647,13 +944,10 @@ public:
   // define a new octree node (with no children)
     insertOctree = prepare("INSERT INTO octree (rowid, children) VALUES (?1, 0)");
 
-    getOctreeLeafChildren = prepare("SELECT rowid, type FROM positioned WHERE octree_node=?1");
 
-    searchAirports = prepare("SELECT ident, name FROM positioned WHERE (name LIKE ?1 OR ident LIKE ?1) " AND_TYPED);
-    sqlite3_bind_int(searchAirports, 2, FGPositioned::AIRPORT);
-    sqlite3_bind_int(searchAirports, 3, FGPositioned::SEAPORT);
+    insertSearchTrigram = prepare("INSERT INTO search_trigram (trigram, positioned) VALUES (?1, ?2)");
 
-    getAllAirports = prepare("SELECT ident, name FROM positioned WHERE type>=?1 AND type <=?2");
+    getAllAirports = prepare("SELECT rowid, ident, name FROM positioned WHERE type>=?1 AND type <=?2");
     sqlite3_bind_int(getAllAirports, 1, FGPositioned::AIRPORT);
     sqlite3_bind_int(getAllAirports, 2, FGPositioned::SEAPORT);
 
@@ -707,110 +1001,127 @@ public:
   }
 
 
-  FGPositioned* loadById(sqlite_int64 rowId, sqlite3_int64& aptId);
+  FGPositioned* loadById(Connection& c, sqlite3_int64 rowId, sqlite3_int64& aptId);
 
-  FGAirport* loadAirport(sqlite_int64 rowId,
-                         FGPositioned::Type ty,
-                         const string& id, const string& name, const SGGeod& pos)
-  {
-    sqlite3_bind_int64(loadAirportStmt, 1, rowId);
-    execSelect1(loadAirportStmt);
-    bool hasMetar = (sqlite3_column_int(loadAirportStmt, 0) > 0);
-    reset(loadAirportStmt);
+  /**
+   * Load items, from the object cache where possible and with batched
+   * queries on the connection otherwise. Unknown IDs give null entries.
+   * Items loaded on the main thread are cached, and ILS data validated;
+   * worker threads do not cache ILS records, since their adjustment
+   * needs the main connection.
+   */
+  FGPositionedList loadByIds(Connection& c, const PositionedIDVec& ids, bool onMainThread);
 
-    return new FGAirport(rowId, id, pos, name, hasMetar, ty);
+  sqlite3_stmt_ptr prepareOn(Connection& c, const string& sql)
+  {
+    sqlite3_stmt_ptr stmt = prepareSQL(c.db, sql);
+    c.prepared.push_back(stmt);
+    return stmt;
   }
 
-  FGRunwayBase* loadRunway(sqlite3_int64 rowId, FGPositioned::Type ty,
-                           const string& id, const SGGeod& pos, PositionedID apt)
+  void prepareConnection(Connection& c)
   {
-    sqlite3_bind_int(loadRunwayStmt, 1, rowId);
-    execSelect1(loadRunwayStmt);
-
-    double heading = sqlite3_column_double(loadRunwayStmt, 0);
-    double lengthM = sqlite3_column_int(loadRunwayStmt, 1);
-    double widthM = sqlite3_column_double(loadRunwayStmt, 2);
-    int surface = sqlite3_column_int(loadRunwayStmt, 3);
+    c.loadPositioned = prepareOn(c, "SELECT " LOAD_COLS " FROM " LOAD_FROM
+                                 " WHERE positioned.rowid=?1");
 
-    if (ty == FGPositioned::TAXIWAY) {
-      reset(loadRunwayStmt);
-      return new FGTaxiway(rowId, id, pos, heading, lengthM, widthM, surface);
-    } else if (ty == FGPositioned::HELIPAD) {
-        reset(loadRunwayStmt);
-        return new FGHelipad(rowId, apt, id, pos, heading, lengthM, widthM, surface);
-    } else {
-      double displacedThreshold = sqlite3_column_double(loadRunwayStmt, 4);
-      double stopway = sqlite3_column_double(loadRunwayStmt, 5);
-      PositionedID reciprocal = sqlite3_column_int64(loadRunwayStmt, 6);
-      PositionedID ils = sqlite3_column_int64(loadRunwayStmt, 7);
-      FGRunway* r = new FGRunway(rowId, apt, id, pos, heading, lengthM, widthM,
-                          displacedThreshold, stopway, surface);
-
-      if (reciprocal > 0) {
-        r->setReciprocalRunway(reciprocal);
-      }
+    string batch = "SELECT " LOAD_COLS " FROM " LOAD_FROM " WHERE positioned.rowid IN (";
+    for (size_t i = 1; i <= LOAD_BATCH_SIZE; ++i) {
+      batch += ((i > 1) ? ",?" : "?") + std::to_string(i);
+    }
+    c.loadPositionedBatch = prepareOn(c, batch + ")");
 
-      if (ils > 0) {
-        r->setILS(ils);
-      }
+    c.getOctreeLeafChildren = prepareOn(c, "SELECT rowid, type, cart_x, cart_y, cart_z "
+                                        "FROM positioned WHERE octree_node=?1");
+  }
 
-      reset(loadRunwayStmt);
-      return r;
+  void closeConnection(Connection& c)
+  {
+    for (sqlite3_stmt_ptr stmt : c.prepared) {
+      sqlite3_finalize(stmt);
     }
+    c.prepared.clear();
+    c.findByString.clear();
   }
 
-  CommStation* loadComm(sqlite3_int64 rowId, FGPositioned::Type ty,
-                        const string& id, const string& name,
-                        const SGGeod& pos,
-                        PositionedID airport)
+  /**
+   * Lease a read-only connection for a worker thread, opening one if
+   * fewer than MAX_READ_CONNECTIONS exist, or waiting for one otherwise.
+   * Callers which must not block (the GUI thread) pass canWait = false,
+   * and get an extra connection for the lease instead.
+   */
+  Connection* acquireConnection(bool canWait = true)
   {
-      SG_UNUSED(id);
+    std::unique_lock<std::mutex> g(poolLock);
+    auto available = [this] {
+      return !idleConnections.empty() || (pool.size() < MAX_READ_CONNECTIONS);
+    };
+
+    bool overflow = false;
+    if (canWait) {
+      poolReturned.wait(g, available);
+    } else {
+      overflow = !available();
+    }
 
-      sqlite3_bind_int64(loadCommStation, 1, rowId);
-      execSelect1(loadCommStation);
+    if (!idleConnections.empty()) {
+      Connection* c = idleConnections.back();
+      idleConnections.pop_back();
+      return c;
+    }
 
-      int range = sqlite3_column_int(loadCommStation, 0);
-      int freqKhz = sqlite3_column_int(loadCommStation, 1);
-      reset(loadCommStation);
+    std::unique_ptr<Connection> c(new Connection);
+    std::string pathUtf8 = path.utf8Str();
+    if (sqlite3_open_v2(pathUtf8.c_str(), &c->db, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK) {
+      string errMsg = sqlite3_errmsg(c->db);
+      sqlite3_close(c->db);
+      throw sg_exception("Navcache failed to open read-only connection:" + errMsg);
+    }
 
-      CommStation* c = new CommStation(rowId, name, ty, pos, freqKhz, range);
-      c->setAirport(airport);
-      return c;
+    try {
+      prepareConnection(*c);
+    } catch (sg_exception&) {
+      closeConnection(*c);
+      sqlite3_close(c->db);
+      throw;
+    }
+
+    if (overflow) {
+      SG_LOG(SG_NAVCACHE, SG_DEBUG, "NavCache: all read-only connections are leased, opened an extra one");
+      c->overflow = true;
+      return c.release();
+    }
+
+    SG_LOG(SG_NAVCACHE, SG_DEBUG, "NavCache: opened read-only connection " << pool.size() + 1);
+    pool.push_back(std::move(c));
+    return pool.back().get();
   }
 
-  FGPositioned* loadNav(sqlite3_int64 rowId,
-                       FGPositioned::Type ty, const string& id,
-                       const string& name, const SGGeod& pos)
+  void releaseConnection(Connection* c)
   {
-    sqlite3_bind_int64(loadNavaid, 1, rowId);
-    execSelect1(loadNavaid);
+    if (c->overflow) {
+      closeConnection(*c);
+      sqlite3_close(c->db);
+      delete c;
+      return;
+    }
 
-    PositionedID runway = sqlite3_column_int64(loadNavaid, 3);
-    // marker beacons are light-weight
-    if ((ty == FGPositioned::OM) || (ty == FGPositioned::IM) ||
-        (ty == FGPositioned::MM))
     {
-      reset(loadNavaid);
-      return new FGMarkerBeaconRecord(rowId, ty, runway, pos);
+      std::lock_guard<std::mutex> g(poolLock);
+      idleConnections.push_back(c);
     }
+    poolReturned.notify_one();
+  }
 
-    int rangeNm = sqlite3_column_int(loadNavaid, 0),
-    freq = sqlite3_column_int(loadNavaid, 1);
-    double mulituse = sqlite3_column_double(loadNavaid, 2);
-    PositionedID colocated = sqlite3_column_int64(loadNavaid, 4);
-    reset(loadNavaid);
-
-    FGNavRecord* n =
-      (ty == FGPositioned::MOBILE_TACAN)
-      ? new FGMobileNavRecord
-            (rowId, ty, id, name, pos, freq, rangeNm, mulituse, runway)
-      : new FGNavRecord
-            (rowId, ty, id, name, pos, freq, rangeNm, mulituse, runway);
-
-    if (colocated)
-      n->setColocatedDME(colocated);
-
-    return n;
+  void closePool()
+  {
+    std::lock_guard<std::mutex> g(poolLock);
+    assert(idleConnections.size() == pool.size());
+    for (auto& c : pool) {
+      closeConnection(*c);
+      sqlite3_close(c->db);
+    }
+    pool.clear();
+    idleConnections.clear();
   }
 
   PositionedID insertPositioned(FGPositioned::Type ty, const string& ident,
@@ -846,8 +1157,9 @@ public:
     return r;
   }
 
-  FGPositionedList findAllByString(const string& s, const string& column,
-                                     FGPositioned::Filter* filter, bool exact)
+  FGPositionedList findAllByString(Connection& c, const string& s, const string& column,
+                                   FGPositioned::Filter* filter, bool exact,
+                                   bool onMainThread)
   {
     string query = s;
     if (!exact) query += "%";
@@ -860,10 +1172,10 @@ public:
     }
 
   // find or prepare a suitable statement frrm the SQL
-    sqlite3_stmt_ptr stmt = findByStringDict[sql];
+    sqlite3_stmt_ptr stmt = c.findByString[sql];
     if (!stmt) {
-      stmt = prepare(sql);
-      findByStringDict[sql] = stmt;
+      stmt = prepareOn(c, sql);
+      c.findByString[sql] = stmt;
     }
 
     sqlite_bind_stdstring(stmt, 1, query);
@@ -872,22 +1184,126 @@ public:
       sqlite3_bind_int(stmt, 3, filter->maxType());
     }
 
+  // run the prepared SQL, then load the matches together
+    PositionedIDVec ids = selectIds(stmt);
+
     FGPositionedList result;
-  // run the prepared SQL
-    while (stepSelect(stmt))
-    {
-      FGPositioned* pos = outer->loadById(sqlite3_column_int64(stmt, 0));
-      if (filter && !filter->pass(pos)) {
+    for (const auto& pos : loadByIds(c, ids, onMainThread)) {
+      if (!pos || (filter && !filter->pass(pos))) {
         continue;
       }
 
       result.push_back(pos);
     }
 
-    reset(stmt);
     return result;
   }
 
+  LocatedPositionedVec octreeLeafChildren(Connection& c, int64_t octreeNodeId)
+  {
+    sqlite3_bind_int64(c.getOctreeLeafChildren, 1, octreeNodeId);
+
+    LocatedPositionedVec r;
+    while (stepSelect(c.getOctreeLeafChildren)) {
+      FGPositioned::Type ty = static_cast<FGPositioned::Type>
+        (sqlite3_column_int(c.getOctreeLeafChildren, 1));
+      SGVec3d cart(sqlite3_column_double(c.getOctreeLeafChildren, 2),
+                   sqlite3_column_double(c.getOctreeLeafChildren, 3),
+                   sqlite3_column_double(c.getOctreeLeafChildren, 4));
+      r.push_back(LocatedPositioned{ty, sqlite3_column_int64(c.getOctreeLeafChildren, 0), cart});
+    }
+
+    reset(c.getOctreeLeafChildren);
+    return r;
+  }
+
+  /**
+   * Fill the search_trigram table with the trigrams of the idents and
+   * names of all searchable items, then index it. Run at the end of a
+   * rebuild, so the bulk insert does not maintain the index.
+   */
+  void buildSearchIndex()
+  {
+    sqlite3_stmt_ptr items = prepareSQL("SELECT rowid, ident, name FROM positioned "
+                                        "WHERE " SEARCHABLE_TYPES);
+    try {
+      std::set<int> trigrams;
+      while (stepSelect(items)) {
+        trigrams.clear();
+        addSearchTrigrams(columnString(items, 1), trigrams);
+        addSearchTrigrams(columnString(items, 2), trigrams);
+
+        sqlite3_bind_int64(insertSearchTrigram, 2, sqlite3_column_int64(items, 0));
+        for (int t : trigrams) {
+          sqlite3_bind_int(insertSearchTrigram, 1, t);
+          execUpdate(insertSearchTrigram);
+        }
+      }
+    } catch (sg_exception&) {
+      sqlite3_finalize(items);
+      throw; // re-throw
+    }
+
+    sqlite3_finalize(items);
+    runSQL(SEARCH_INDEX_SQL);
+  }
+
+  /**
+   * Statement finding the searchable items of a type range whose name, or
+   * optionally ident, contains a term. Candidates come from the trigram
+   * index and are checked with LIKE. Results are ranked, ignoring case:
+   * ident equal to the term, ident starting with it, name starting with it, a word of
+   * the name starting with it, then the rest, alphabetically within each.
+   * Columns are rowid, ident and name; the caller steps and resets it.
+   */
+  sqlite3_stmt_ptr nameSearch(Connection& c, const string& term, bool matchIdents,
+                              FGPositioned::Type minType, FGPositioned::Type maxType,
+                              unsigned int maxResults)
+  {
+    string sql = "SELECT rowid, ident, name FROM positioned "
+                 "WHERE type>=?6 AND type<=?7 AND " SEARCHABLE_TYPES;
+
+    std::vector<int> trigrams;
+    if (term.size() >= 3) {
+      trigrams = searchTermTrigrams(term);
+      sql += " AND rowid IN (SELECT positioned FROM search_trigram WHERE trigram IN (";
+      for (size_t i = 0; i < trigrams.size(); ++i) {
+        sql += ((i > 0) ? ",?" : "?") + std::to_string(i + 8);
+      }
+      sql += ") GROUP BY positioned HAVING COUNT(*)=" + std::to_string(trigrams.size()) + ")";
+    } else if (!term.empty()) {
+      const auto range = searchTrigramRange(term);
+      trigrams = {range.first, range.second};
+      sql += " AND rowid IN (SELECT positioned FROM search_trigram "
+             "WHERE trigram BETWEEN ?8 AND ?9)";
+    }
+
+    sql += matchIdents ? " AND (name LIKE ?4 OR ident LIKE ?4)" : " AND name LIKE ?4";
+    sql += " ORDER BY CASE WHEN ident LIKE ?1 THEN 0 WHEN ident LIKE ?2 THEN 1 "
+           "WHEN name LIKE ?2 THEN 2 WHEN name LIKE ?3 THEN 3 ELSE 4 END, name "
+           "LIMIT ?5";
+
+    sqlite3_stmt_ptr stmt = c.findByString[sql];
+    if (!stmt) {
+      stmt = prepareOn(c, sql);
+      c.findByString[sql] = stmt;
+    }
+
+    sqlite_bind_temp_stdstring(stmt, 1, term);
+    sqlite_bind_temp_stdstring(stmt, 2, term + "%");
+    sqlite_bind_temp_stdstring(stmt, 3, "% " + term + "%");
+    sqlite_bind_temp_stdstring(stmt, 4, "%" + term + "%");
+    // a negative limit returns all rows
+    sqlite3_bind_int(stmt, 5, (maxResults > 0) ? static_cast<int>(maxResults) : -1);
+    sqlite3_bind_int(stmt, 6, minType);
+    sqlite3_bind_int(stmt, 7, maxType);
+    for (size_t i = 0; i < trigrams.size(); ++i) {
+      sqlite3_bind_int(stmt, static_cast<int>(i + 8), trigrams[i]);
+    }
+
+    return stmt;
+  }
+
   PositionedIDVec selectIds(sqlite3_stmt_ptr query)
   {
     PositionedIDVec result;
@@ -933,7 +1349,7 @@ public:
 
     // flag set during shutdown: allows us to abandon queries, etc
     // if exit is requested during a rebuild.
-    bool abandonCache = false;
+    std::atomic<bool> abandonCache{false};
 
 
     /// the actual cache of ID -> instances. This holds an owning reference,
@@ -941,6 +1357,16 @@ public:
     /// the cache drops its reference
     PositionedCache cache;
     unsigned int cacheHits, cacheMisses;
+    std::mutex cacheLock; ///< guards the cache and its counters
+
+    /// statements of the main connection shared with the pool
+    Connection mainConnection;
+
+    /// read-only connections for worker threads, see acquireConnection()
+    std::vector<std::unique_ptr<Connection>> pool;
+    std::vector<Connection*> idleConnections;
+    std::mutex poolLock;
+    std::condition_variable poolReturned;
 
     /**
    * record the levels of open transaction objects we have
@@ -954,9 +1380,7 @@ public:
         carrierDatPath, airwayDatPath;
 
     sqlite3_stmt_ptr readPropertyQuery, writePropertyQuery,
-        stampFileCache, statCacheCheck,
-        loadAirportStmt, loadCommStation, loadPositioned, loadNavaid,
-        loadRunwayStmt;
+        stampFileCache, statCacheCheck, readProcedures, hasProcedures, writeProcedures;
     sqlite3_stmt_ptr writePropertyMulti, clearProperty;
 
     sqlite3_stmt_ptr insertPositionedQuery, insertAirport, insertTower, insertRunway,
@@ -967,10 +1391,9 @@ public:
 
     sqlite3_stmt_ptr findClosestWithIdent;
     // octree (spatial index) related queries
-    sqlite3_stmt_ptr getOctreeChildren, insertOctree, updateOctreeChildren,
-        getOctreeLeafChildren;
+    sqlite3_stmt_ptr getOctreeChildren, insertOctree, updateOctreeChildren;
 
-    sqlite3_stmt_ptr searchAirports, getAllAirports;
+    sqlite3_stmt_ptr insertSearchTrigram, getAllAirports;
     sqlite3_stmt_ptr findCommByFreq, findNavsByFreq,
         findNavsByFreqNoPos, findNavaidForRunway;
     sqlite3_stmt_ptr getAirportItems, getAirportItemByIdent;
@@ -985,11 +1408,6 @@ public:
         insertAirway, airwayEdges;
     sqlite3_stmt_ptr loadAirway;
 
-    // since there's many permutations of ident/name queries, we create
-    // them programtically, but cache the exact query by its raw SQL once
-    // used.
-    std::map<string, sqlite3_stmt_ptr> findByStringDict;
-
     typedef std::vector<sqlite3_stmt_ptr> StmtVec;
     StmtVec prepared;
 
@@ -1002,82 +1420,118 @@ public:
 
 //////////////////////////////////////////////////////////////////////
 
-FGPositioned* NavDataCache::NavDataCachePrivate::loadById(sqlite3_int64 rowid,
+FGPositioned* NavDataCache::NavDataCachePrivate::loadById(Connection& c,
+                                                          sqlite3_int64 rowid,
                                                           sqlite3_int64& aptId)
 {
     if (abandonCache)
         throw AbandonCacheException{};
 
-    sqlite3_bind_int64(loadPositioned, 1, rowid);
-    execSelect1(loadPositioned);
+    sqlite3_bind_int64(c.loadPositioned, 1, rowid);
+    execSelect1(c.loadPositioned);
 
-    assert(rowid == sqlite3_column_int64(loadPositioned, 0));
-    FGPositioned::Type ty = (FGPositioned::Type)sqlite3_column_int(loadPositioned, 1);
+    assert(rowid == sqlite3_column_int64(c.loadPositioned, 0));
+    FGPositioned* result = positionedFromRow(c.loadPositioned, aptId);
+    reset(c.loadPositioned);
+    return result;
+}
 
-    PositionedID prowid = static_cast<PositionedID>(rowid);
-    string ident = (char*)sqlite3_column_text(loadPositioned, 2);
-    string name = (char*)sqlite3_column_text(loadPositioned, 3);
-    aptId = sqlite3_column_int64(loadPositioned, 4);
-    double lon = sqlite3_column_double(loadPositioned, 5);
-    double lat = sqlite3_column_double(loadPositioned, 6);
-    double elev = sqlite3_column_double(loadPositioned, 7);
-    SGGeod pos = SGGeod::fromDegM(lon, lat, elev);
+FGPositionedList NavDataCache::NavDataCachePrivate::loadByIds(Connection& c,
+                                                              const PositionedIDVec& ids,
+                                                              bool onMainThread)
+{
+    FGPositionedList result(ids.size());
+    PositionedIDVec missing;
+    {
+        std::lock_guard<std::mutex> g(cacheLock);
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (ids[i] < 1) {
+                continue;
+            }
 
-    reset(loadPositioned);
+            auto it = cache.find(ids[i]);
+            if (it != cache.end()) {
+                result[i] = it->second;
+                cacheHits++;
+            } else {
+                missing.push_back(ids[i]);
+            }
+        }
+    }
 
-    switch (ty) {
-    case FGPositioned::AIRPORT:
-    case FGPositioned::SEAPORT:
-    case FGPositioned::HELIPORT:
-      return loadAirport(rowid, ty, ident, name, pos);
+    if (missing.empty()) {
+        return result;
+    }
 
-    case FGPositioned::TOWER:
-      return new AirportTower(prowid, aptId, ident, pos);
+    std::sort(missing.begin(), missing.end());
+    missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
 
-    case FGPositioned::RUNWAY:
-    case FGPositioned::HELIPAD:
-    case FGPositioned::TAXIWAY:
-      return loadRunway(rowid, ty, ident, pos, aptId);
+    std::map<PositionedID, FGPositionedRef> loaded;
+    PositionedIDVec ilsAirports;
+    for (size_t first = 0; first < missing.size(); first += LOAD_BATCH_SIZE) {
+        if (abandonCache)
+            throw AbandonCacheException{};
 
-    case FGPositioned::LOC:
-    case FGPositioned::VOR:
-    case FGPositioned::GS:
-    case FGPositioned::ILS:
-    case FGPositioned::NDB:
-    case FGPositioned::OM:
-    case FGPositioned::MM:
-    case FGPositioned::IM:
-    case FGPositioned::DME:
-    case FGPositioned::TACAN:
-    case FGPositioned::MOBILE_TACAN:
-      return loadNav(rowid, ty, ident, name, pos);
+        // unused parameters stay NULL, which matches no row
+        sqlite3_clear_bindings(c.loadPositionedBatch);
+        const size_t count = std::min(LOAD_BATCH_SIZE, missing.size() - first);
+        for (size_t i = 0; i < count; ++i) {
+            sqlite3_bind_int64(c.loadPositionedBatch, static_cast<int>(i + 1), missing[first + i]);
+        }
 
-    case FGPositioned::FIX:
-      return new FGFix(rowid, ident, pos);
+        while (stepSelect(c.loadPositionedBatch)) {
+            sqlite3_int64 aptId;
+            FGPositionedRef pos = positionedFromRow(c.loadPositionedBatch, aptId);
+            if (!pos) {
+                continue;
+            }
 
-    case FGPositioned::WAYPOINT:
-    case FGPositioned::COUNTRY:
-    case FGPositioned::CITY:
-    case FGPositioned::TOWN:
-    case FGPositioned::VILLAGE:
-    {
-        FGPositioned* wpt = new FGPositioned(rowid, ty, ident, pos);
-      return wpt;
+            if ((pos->type() == FGPositioned::ILS) && (aptId > 0)) {
+                ilsAirports.push_back(aptId);
+            }
+            loaded[pos->guid()] = pos;
+        }
+        reset(c.loadPositionedBatch);
     }
 
-    case FGPositioned::FREQ_GROUND:
-    case FGPositioned::FREQ_TOWER:
-    case FGPositioned::FREQ_ATIS:
-    case FGPositioned::FREQ_AWOS:
-    case FGPositioned::FREQ_APP_DEP:
-    case FGPositioned::FREQ_ENROUTE:
-    case FGPositioned::FREQ_CLEARANCE:
-    case FGPositioned::FREQ_UNICOM:
-      return loadComm(rowid, ty, ident, name, pos, aptId);
+    // see loadById: nothing is cached while rebuilding
+    if (!outer->rebuildInProgress) {
+        std::lock_guard<std::mutex> g(cacheLock);
+        for (auto& l : loaded) {
+            if (!onMainThread && (l.second->type() == FGPositioned::ILS)) {
+                continue;
+            }
 
-    default:
-      return NULL;
+            // another thread may have loaded the same item meanwhile
+            auto inserted = cache.insert(PositionedCache::value_type(l.first, l.second));
+            l.second = inserted.first->second;
+            if (inserted.second) {
+                cacheMisses++;
+            }
+        }
     }
+
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (result[i] || (ids[i] < 1)) {
+            continue;
+        }
+
+        auto it = loaded.find(ids[i]);
+        if (it != loaded.end()) {
+            result[i] = it->second;
+        } else {
+            SG_LOG(SG_NAVCACHE, SG_WARN, "NavCache: no item with ID " << ids[i]);
+        }
+    }
+
+    if (onMainThread && !outer->rebuildInProgress) {
+        for (auto aptId : ilsAirports) {
+            FGAirport* apt = FGPositioned::loadById<FGAirport>(aptId);
+            apt->validateILSData();
+        }
+    }
+
+    return result;
 }
 
 bool NavDataCache::NavDataCachePrivate::isCachedFileModified(const SGPath& path, bool verbose)
@@ -1356,6 +1810,7 @@ NavDataCache::~NavDataCache()
 // ensure we wip the airports cache too, or we'll get out
 // of sync during tests
   FGAirport::clearAirportsCache();
+  ProcedureCache::clearPrefetches();
 
   static_instance = nullptr;
   d.reset();
@@ -1739,6 +2194,10 @@ void NavDataCache::doRebuild()
 
           d->flushDeferredOctreeUpdates();
 
+          st.stamp();
+          d->buildSearchIndex();
+          SG_LOG(SG_NAVCACHE, SG_INFO, "search index build took:" << st.elapsedMSec());
+
           string sceneryPaths = SGPath::join(globals->get_fg_scenery(), ";");
           writeStringProperty("scenery_paths", sceneryPaths);
 
@@ -1899,6 +2358,45 @@ void NavDataCache::stampCacheFile(const SGPath& path)
     }
 }
 
+std::string NavDataCache::readProcedureData(const SGPath& path)
+{
+  sqlite_bind_temp_stdstring(d->readProcedures, 1, path.realpath().utf8Str());
+  string result;
+  if (d->execSelect(d->readProcedures)) {
+    if (sqlite3_column_int64(d->readProcedures, 0) == path.modTime()) {
+      const void* data = sqlite3_column_blob(d->readProcedures, 1);
+      const int length = sqlite3_column_bytes(d->readProcedures, 1);
+      if (data && (length > 0)) {
+        result.assign(static_cast<const char*>(data), length);
+      }
+    } else {
+      SG_LOG(SG_NAVCACHE, SG_DEBUG, "NavCache: stored procedures are stale for " << path);
+    }
+  }
+
+  d->reset(d->readProcedures);
+  return result;
+}
+
+bool NavDataCache::hasProcedureData(const SGPath& path)
+{
+  sqlite_bind_temp_stdstring(d->hasProcedures, 1, path.realpath().utf8Str());
+  sqlite3_bind_int64(d->hasProcedures, 2, path.modTime());
+  const bool result = d->execSelect(d->hasProcedures);
+  d->reset(d->hasProcedures);
+  return result;
+}
+
+void NavDataCache::writeProcedureData(const SGPath& path, const std::string& data)
+{
+    if (!isReadOnly()) {
+        sqlite_bind_temp_stdstring(d->writeProcedures, 1, path.realpath().utf8Str());
+        sqlite3_bind_int64(d->writeProcedures, 2, path.modTime());
+        sqlite3_bind_blob(d->writeProcedures, 3, data.data(), data.size(), SQLITE_TRANSIENT);
+        d->execInsert(d->writeProcedures);
+    }
+}
+
 void NavDataCache::beginTransaction()
 {
   if (d->transactionLevel == 0) {
@@ -1973,6 +2471,7 @@ void NavDataCache::abortTransaction()
 
 void NavDataCache::clearDynamicPositioneds()
 {
+    std::lock_guard<std::mutex> g(d->cacheLock);
     std::for_each(d->cache.begin(), d->cache.end(), [](PositionedCache::value_type& v) {
         if (v.second->type() == FGPositioned::MOBILE_TACAN) {
             auto mobile = fgpositioned_cast<FGMobileNavRecord>(v.second);
@@ -1987,22 +2486,33 @@ FGPositionedRef NavDataCache::loadById(PositionedID rowid)
     return NULL;
   }
   if (!d) return NULL;
-  PositionedCache::iterator it = d->cache.find(rowid);
-  if (it != d->cache.end()) {
-    d->cacheHits++;
-    return it->second; // cache it
+  {
+    std::lock_guard<std::mutex> g(d->cacheLock);
+    PositionedCache::iterator it = d->cache.find(rowid);
+    if (it != d->cache.end()) {
+      d->cacheHits++;
+      return it->second; // cache it
+    }
   }
 
   sqlite3_int64 aptId;
-  FGPositionedRef pos = d->loadById(rowid, aptId);
+  FGPositionedRef pos = d->loadById(d->mainConnection, rowid, aptId);
   if (rebuildInProgress) {
     // Do not cache and apply ILS adjustment while rebuilding the cache.
     // The adjustment process requires all ILS navaids to be present,
     // which is not true during the cache rebuild.
     return pos;
   }
-  d->cache.insert(it, PositionedCache::value_type(rowid, pos));
-  d->cacheMisses++;
+
+  {
+    std::lock_guard<std::mutex> g(d->cacheLock);
+    auto inserted = d->cache.insert(PositionedCache::value_type(rowid, pos));
+    if (!inserted.second) {
+      // a worker thread loaded it meanwhile (never an ILS, see loadByIds)
+      return inserted.first->second;
+    }
+    d->cacheMisses++;
+  }
 
   // when we loaded an ILS, we must apply per-airport changes
   if ((pos->type() == FGPositioned::ILS) && (aptId > 0)) {
@@ -2013,6 +2523,11 @@ FGPositionedRef NavDataCache::loadById(PositionedID rowid)
   return pos;
 }
 
+FGPositionedList NavDataCache::loadByIds(const PositionedIDVec& guids)
+{
+  return d->loadByIds(d->mainConnection, guids, true);
+}
+
 PositionedID NavDataCache::insertAirport(FGPositioned::Type ty, const string& ident,
                                          const string& name)
 {
@@ -2031,9 +2546,12 @@ PositionedID NavDataCache::insertAirport(FGPositioned::Type ty, const string& id
 
 void NavDataCache::updatePosition(PositionedID item, const SGGeod &pos)
 {
-  if (d->cache.find(item) != d->cache.end()) {
-    SG_LOG(SG_NAVCACHE, SG_DEBUG, "updating position of an item in the cache");
-    d->cache[item]->modifyPosition(pos);
+  {
+    std::lock_guard<std::mutex> g(d->cacheLock);
+    if (d->cache.find(item) != d->cache.end()) {
+      SG_LOG(SG_NAVCACHE, SG_DEBUG, "updating position of an item in the cache");
+      d->cache[item]->modifyPosition(pos);
+    }
   }
 
   SGVec3d cartPos(SGVec3d::fromGeod(pos));
@@ -2044,13 +2562,10 @@ void NavDataCache::updatePosition(PositionedID item, const SGGeod &pos)
   sqlite3_bind_double(d->setAirportPos, 4, pos.getElevationM());
 
 // bug 905; the octree leaf may change here, but the leaf may already be
-// loaded, and caching its children. (Either the old or new leaf!). Worse,
-// we may be called here as a result of loading one of those leaf's children.
-// instead of dealing with all those possibilites, such as modifying
-// the in-memory leaf's STL child container, we simply leave the runtime
-// structures alone. This is fine providing items do no move very far, since
-// all the spatial searches ultimately use the items' real cartesian position,
-// which was updated above.
+// loaded, and caching its children and their positions. (Either the old or
+// new leaf!). Worse, we may be called here as a result of loading one of
+// those leaf's children. So rather than patching the in-memory leaves, mark
+// every loaded leaf as stale, and they reload their children on next use.
   Octree::Leaf* octreeLeaf = Octree::globalPersistentOctree()->findLeafForPos(cartPos);
   sqlite3_bind_int64(d->setAirportPos, 5, octreeLeaf->guid());
 
@@ -2060,6 +2575,7 @@ void NavDataCache::updatePosition(PositionedID item, const SGGeod &pos)
 
 
   d->execUpdate(d->setAirportPos);
+  Octree::invalidateLeafChildren();
 }
 
 void NavDataCache::insertTower(PositionedID airportId, const SGGeod& pos)
@@ -2133,6 +2649,7 @@ void NavDataCache::setRunwayILS(PositionedID runway, PositionedID ils)
   d->execUpdate(d->setRunwayILS);
 
   // and the in-memory one
+  std::lock_guard<std::mutex> g(d->cacheLock);
   if (d->cache.find(runway) != d->cache.end()) {
     FGRunway* instance = (FGRunway*) d->cache[runway].ptr();
     instance->setILS(ils);
@@ -2169,6 +2686,7 @@ void NavDataCache::setNavaidColocated(PositionedID navaid, PositionedID colocate
   d->execUpdate(d->setNavaidColocated);
 
   // ...and the in-memory copy of the navrecord
+  std::lock_guard<std::mutex> g(d->cacheLock);
   if (d->cache.find(navaid) != d->cache.end()) {
     FGNavRecord* rec = (FGNavRecord*) d->cache[navaid].get();
     rec->setColocatedDME(colocatedDME);
@@ -2217,7 +2735,7 @@ FGPositionedList NavDataCache::findAllWithIdent( const string& s,
                                                  FGPositioned::Filter* filter,
                                                  bool exact )
 {
-  return d->findAllByString(s, "ident", filter, exact);
+  return d->findAllByString(d->mainConnection, s, "ident", filter, exact, true);
 }
 
 //------------------------------------------------------------------------------
@@ -2225,7 +2743,7 @@ FGPositionedList NavDataCache::findAllWithName( const string& s,
                                                 FGPositioned::Filter* filter,
                                                 bool exact )
 {
-  return d->findAllByString(s, "name", filter, exact);
+  return d->findAllByString(d->mainConnection, s, "name", filter, exact, true);
 }
 
 //------------------------------------------------------------------------------
@@ -2303,30 +2821,21 @@ void NavDataCache::defineOctreeNode(Octree::Branch* pr, Octree::Node* nd)
 #endif
 }
 
-TypedPositionedVec
+LocatedPositionedVec
 NavDataCache::getOctreeLeafChildren(int64_t octreeNodeId)
 {
-  sqlite3_bind_int64(d->getOctreeLeafChildren, 1, octreeNodeId);
-
-  TypedPositionedVec r;
-  while (d->stepSelect(d->getOctreeLeafChildren)) {
-    FGPositioned::Type ty = static_cast<FGPositioned::Type>
-      (sqlite3_column_int(d->getOctreeLeafChildren, 1));
-    r.push_back(std::make_pair(ty,
-                sqlite3_column_int64(d->getOctreeLeafChildren, 0)));
-  }
-
-  d->reset(d->getOctreeLeafChildren);
-  return r;
+  return d->octreeLeafChildren(d->mainConnection, octreeNodeId);
 }
 
 
 /**
  * A special purpose helper (used by FGAirport::searchNamesAndIdents) to
  * implement the AirportList dialog. It's unfortunate that it needs to reside
- * here, but for now it's least ugly solution.
+ * here, but for now it's least ugly solution. Filtered results come from the
+ * search index, best matches first.
  */
-char** NavDataCache::searchAirportNamesAndIdents(const std::string& searchInput)
+char** NavDataCache::searchAirportNamesAndIdents(const std::string& searchInput,
+                                                 unsigned int maxResults)
 {
   sqlite3_stmt_ptr stmt;
   unsigned int numMatches = 0, numAllocated = 16;
@@ -2334,22 +2843,16 @@ char** NavDataCache::searchAirportNamesAndIdents(const std::string& searchInput)
   bool heli_p = searchInput.substr(0, heliport.length()) == heliport;
   auto pos = searchInput.find(":");
   string aFilter((pos != string::npos) ? searchInput.substr(pos+1) : searchInput);
-  string searchTerm("%" + aFilter + "%");
 
   if (aFilter.empty() && !heli_p) {
     stmt = d->getAllAirports;
     numAllocated = 4096; // start much larger for all airports
+  } else if (heli_p) {
+    stmt = d->nameSearch(d->mainConnection, aFilter, true,
+                         FGPositioned::HELIPORT, FGPositioned::HELIPORT, maxResults);
   } else {
-    stmt = d->searchAirports;
-    sqlite_bind_stdstring(stmt, 1, searchTerm);
-    if (heli_p) {
-        sqlite3_bind_int(stmt, 2, FGPositioned::HELIPORT);
-        sqlite3_bind_int(stmt, 3, FGPositioned::HELIPORT);
-    }
-    else {
-        sqlite3_bind_int(stmt, 2, FGPositioned::AIRPORT);
-        sqlite3_bind_int(stmt, 3, FGPositioned::SEAPORT);
-    }
+    stmt = d->nameSearch(d->mainConnection, aFilter, true,
+                         FGPositioned::AIRPORT, FGPositioned::SEAPORT, maxResults);
   }
 
   char** result = (char**) malloc(sizeof(char*) * numAllocated);
@@ -2371,18 +2874,18 @@ char** NavDataCache::searchAirportNamesAndIdents(const std::string& searchInput)
     // which gives a grand total of 7 + name-length + icao-length.
     // note the ident can be three letters (non-ICAO local strip), four
     // (default ICAO) or more (extended format ICAO)
-    int nameLength = sqlite3_column_bytes(stmt, 1);
-    int icaoLength = sqlite3_column_bytes(stmt, 0);
+    int nameLength = sqlite3_column_bytes(stmt, 2);
+    int icaoLength = sqlite3_column_bytes(stmt, 1);
     char* entry = (char*) malloc(7 + nameLength + icaoLength);
     char* dst = entry;
     *dst++ = ' ';
-    memcpy(dst, sqlite3_column_text(stmt, 1), nameLength);
+    memcpy(dst, sqlite3_column_text(stmt, 2), nameLength);
     dst += nameLength;
     *dst++ = ' ';
     *dst++ = ' ';
     *dst++ = ' ';
     *dst++ = '(';
-    memcpy(dst, sqlite3_column_text(stmt, 0), icaoLength);
+    memcpy(dst, sqlite3_column_text(stmt, 1), icaoLength);
     dst += icaoLength;
     *dst++ = ')';
     *dst++ = 0;
@@ -2820,11 +3323,55 @@ void NavDataCache::Transaction::commit()
 
 /////////////////////////////////////////////////////////////////////////////
 
+NavDataCache::Reader::Reader() :
+    _cache(NavDataCache::instance())
+{
+    assert(_cache);
+    _connection = _cache->d->acquireConnection();
+}
+
+NavDataCache::Reader::~Reader()
+{
+    _cache->d->releaseConnection(_connection);
+}
+
+FGPositionedRef NavDataCache::Reader::loadById(PositionedID guid)
+{
+    return loadByIds({guid}).front();
+}
+
+FGPositionedList NavDataCache::Reader::loadByIds(const PositionedIDVec& guids)
+{
+    return _cache->d->loadByIds(*_connection, guids, false);
+}
+
+FGPositionedList NavDataCache::Reader::findAllWithIdent(const std::string& ident,
+                                                        FGPositioned::Filter* filter,
+                                                        bool exact)
+{
+    return _cache->d->findAllByString(*_connection, ident, "ident", filter, exact, false);
+}
+
+FGPositionedList NavDataCache::Reader::findAllWithName(const std::string& name,
+                                                       FGPositioned::Filter* filter,
+                                                       bool exact)
+{
+    return _cache->d->findAllByString(*_connection, name, "name", filter, exact, false);
+}
+
+LocatedPositionedVec NavDataCache::Reader::getOctreeLeafChildren(int64_t octreeNodeId)
+{
+    return _cache->d->octreeLeafChildren(*_connection, octreeNodeId);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 class NavDataCache::ThreadedGUISearch::ThreadedGUISearchPrivate : public SGThread
 {
 public:
     ThreadedGUISearchPrivate() :
-        db(NULL),
+        cache(NULL),
+        connection(NULL),
         isComplete(false),
         quit(false)
     {}
@@ -2843,8 +3390,9 @@ public:
                 // sleep a tiny amount
                 SGTimeStamp::sleepForMSec(1);
             } else {
-                std::string errMsg = sqlite3_errmsg(db);
+                std::string errMsg = sqlite3_errmsg(connection->db);
                 SG_LOG(SG_NAVCACHE, SG_ALERT, "Sqlite error:" << errMsg << " running threaded search query");
+                break;
             }
         }
 
@@ -2853,30 +3401,31 @@ public:
     }
 
     std::mutex lock;
-    sqlite3* db;
+    NavDataCachePrivate* cache;
+    Connection* connection;
     sqlite3_stmt_ptr query;
     PositionedIDVec results;
     bool isComplete;
     bool quit;
 };
 
-NavDataCache::ThreadedGUISearch::ThreadedGUISearch(const std::string& term, bool onlyAirports) :
+NavDataCache::ThreadedGUISearch::ThreadedGUISearch(const std::string& term, bool onlyAirports,
+                                                   unsigned int maxResults) :
     d(new ThreadedGUISearchPrivate)
 {
-    SGPath p = NavDataCache::instance()->path();
-    int openFlags = SQLITE_OPEN_READONLY;
-    std::string pathUtf8 = p.utf8Str();
-    sqlite3_open_v2(pathUtf8.c_str(), &d->db, openFlags, NULL);
+    d->cache = NavDataCache::instance()->d.get();
+    // created on the GUI thread, which must not wait for the workers
+    d->connection = d->cache->acquireConnection(false);
 
-    std::string sql;
-    if (onlyAirports) {
-        sql = "SELECT rowid FROM positioned WHERE name LIKE '%" + term
-                + "%' AND (type >= 1 AND type <= 3)";
-    } else {
-        sql = "SELECT rowid FROM positioned WHERE name LIKE '%" + term
-                + "%' AND ((type >= 1 AND type <= 3) OR ((type >= 9 AND type <= 11))) ";
+    // navaids are the searchable fixes, NDBs and VORs
+    const FGPositioned::Type maxType = onlyAirports ? FGPositioned::SEAPORT : FGPositioned::VOR;
+    try {
+        d->query = d->cache->nameSearch(*d->connection, term, false,
+                                        FGPositioned::AIRPORT, maxType, maxResults);
+    } catch (sg_exception&) {
+        d->cache->releaseConnection(d->connection);
+        throw;
     }
-    sqlite3_prepare_v2(d->db, sql.c_str(), sql.length(), &d->query, NULL);
 
     d->start();
 }
@@ -2889,8 +3438,9 @@ NavDataCache::ThreadedGUISearch::~ThreadedGUISearch()
     }
 
     d->join();
-    sqlite3_finalize(d->query);
-    sqlite3_close_v2(d->db);
+    // the statement belongs to the connection; an error was logged by run()
+    sqlite3_reset(d->query);
+    d->cache->releaseConnection(d->connection);
 }
 
 PositionedIDVec NavDataCache::ThreadedGUISearch::results() const
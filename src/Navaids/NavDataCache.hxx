@@ -44,6 +44,15 @@ typedef std::pair<PositionedID, PositionedID> AirportRunwayPair;
 typedef std::pair<FGPositioned::Type, PositionedID> TypedPositioned;
 typedef std::vector<TypedPositioned> TypedPositionedVec;
 
+// positioned item with its cartesian position, as stored in octree leaves
+struct LocatedPositioned
+{
+    FGPositioned::Type type;
+    PositionedID id;
+    SGVec3d cart;
+};
+typedef std::vector<LocatedPositioned> LocatedPositionedVec;
+
 // pair of airway ID, destination node ID
 typedef std::pair<int, PositionedID> AirwayEdge;
 typedef std::vector<AirwayEdge> AirwayEdgeVec;
@@ -135,6 +144,16 @@ public:
   bool isCachedFileModified(const SGPath& path) const;
   void stampCacheFile(const SGPath& path);
 
+  /**
+   * Pre-parsed form of an airport procedures file (see ProcedureCache),
+   * if one was stored for the file as it currently is on disk. Otherwise
+   * an empty string is returned.
+   */
+  std::string readProcedureData(const SGPath& path);
+  /// as readProcedureData() returning a non-empty string, without reading it
+  bool hasProcedureData(const SGPath& path);
+  void writeProcedureData(const SGPath& path, const std::string& data);
+
   int readIntProperty(const std::string& key);
   double readDoubleProperty(const std::string& key);
   std::string readStringProperty(const std::string& key);
@@ -161,6 +180,13 @@ public:
    */
   FGPositionedRef loadById(PositionedID guid);
 
+  /**
+   * retrieve several items at once, in the order of the IDs. Items which
+   * are not in the object cache are read with batched queries; unknown IDs
+   * give null entries.
+   */
+  FGPositionedList loadByIds(const PositionedIDVec& guids);
+
   PositionedID insertAirport(FGPositioned::Type ty, const std::string& ident,
                              const std::string& name);
   void insertTower(PositionedID airportId, const SGGeod& pos);
@@ -220,9 +246,12 @@ public:
   /**
    * Helper to implement the AirportSearch widget. Optimised text search of
    * airport names and idents, returning a list suitable for passing directly
-   * to PLIB.
+   * to PLIB. Matches are ranked (ident, then name prefix matches first) and
+   * limited to maxResults, if it is non-zero; an empty filter lists all
+   * airports.
    */
-  char** searchAirportNamesAndIdents(const std::string& aFilter);
+  char** searchAirportNamesAndIdents(const std::string& aFilter,
+                                     unsigned int maxResults = 0);
 
   /**
    * Find the closest matching comm-station on a frequency, to a position.
@@ -280,9 +309,10 @@ public:
   void defineOctreeNode(Octree::Branch* pr, Octree::Node* nd);
 
   /**
-   * given an octree leaf, return all its child positioned items and their types
+   * given an octree leaf, return all its child positioned items with their
+   * types and cartesian positions
    */
-  TypedPositionedVec getOctreeLeafChildren(int64_t octreeNodeId);
+  LocatedPositionedVec getOctreeLeafChildren(int64_t octreeNodeId);
 
 // airways
   int findAirway(int network, const std::string& aName, bool create);
@@ -327,10 +357,62 @@ public:
 
     bool isReadOnly() const;
 
+private:
+    class Connection;
+
+public:
+    /**
+     * Read-only access to the cache from a worker thread, through a pooled
+     * sqlite connection which the reader holds until it is destroyed.
+     * Constructing one blocks while all four pooled connections are held
+     * by other readers.
+     *
+     * Items are shared with the main thread through the object cache.
+     * ILS records are only cached, and adjusted to the airport's ils.xml
+     * data, once the main thread loads them: until then a reader returns
+     * its own unadjusted instance, so the main thread may hold a different
+     * (adjusted) instance of the same guid. Compare ILS by guid, and load
+     * them on the main thread where the adjusted position matters.
+     *
+     * Filters run on the calling thread, so they must not load further data.
+     */
+    class Reader
+    {
+    public:
+        Reader();
+        ~Reader();
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        FGPositionedRef loadById(PositionedID guid);
+        FGPositionedList loadByIds(const PositionedIDVec& guids);
+
+        FGPositionedList findAllWithIdent(const std::string& ident,
+                                          FGPositioned::Filter* filter,
+                                          bool exact);
+        FGPositionedList findAllWithName(const std::string& name,
+                                         FGPositioned::Filter* filter,
+                                         bool exact);
+
+        LocatedPositionedVec getOctreeLeafChildren(int64_t octreeNodeId);
+
+    private:
+        NavDataCache* _cache;
+        Connection* _connection;
+    };
+
+    /**
+     * Search airport, fix and NDB/VOR names on a pooled connection, using the
+     * search index. Results arrive best matches first, at most maxResults
+     * of them if it is non-zero. Unlike Reader, construction never waits:
+     * with all pooled connections leased, the search opens its own.
+     */
     class ThreadedGUISearch
     {
     public:
-        ThreadedGUISearch(const std::string& term, bool onlyAirports);
+        ThreadedGUISearch(const std::string& term, bool onlyAirports,
+                          unsigned int maxResults = 0);
         ~ThreadedGUISearch();
 
         PositionedIDVec results() const;
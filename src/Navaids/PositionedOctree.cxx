@@ -27,6 +27,7 @@
 #include "positioned.hxx"
 
 #include <cassert>
+#include <cmath>
 #include <algorithm> // for sort
 #include <cstring> // for memset
 #include <iostream>
@@ -48,6 +49,14 @@ static std::unique_ptr<Node> global_transientOctree;
 
 double RADIUS_EARTH_M = 7000 * 1000.0; // 7000km is plenty
 
+// bumped when persistent items move, see invalidateLeafChildren()
+static unsigned int global_leafGeneration = 0;
+
+static bool typeLess(const LocatedPositioned& a, const LocatedPositioned& b)
+{
+    return a.type < b.type;
+}
+
 Node* globalTransientOctree()
 {
     if (!global_transientOctree) {
@@ -68,6 +77,11 @@ Node* globalPersistentOctree()
     return global_spatialOctree.get();
 }
 
+void invalidateLeafChildren()
+{
+    ++global_leafGeneration;
+}
+
 Node::Node(const SGBoxd& aBox, int64_t aIdent, bool persistent) : _ident(aIdent),
                                                                   _persistent(persistent),
                                                                   _box(aBox)
@@ -115,22 +129,38 @@ void Leaf::visit(const SGVec3d& aPos, double aCutoff,
 
   loadChildren();
 
-  ChildMap::const_iterator it = children.lower_bound(aFilter->minType());
-  ChildMap::const_iterator end = children.upper_bound(aFilter->maxType());
+  LocatedPositioned minKey{aFilter->minType(), 0, SGVec3d()},
+    maxKey{aFilter->maxType(), 0, SGVec3d()};
+  auto it = std::lower_bound(children.begin(), children.end(), minKey, typeLess);
+  auto end = std::upper_bound(it, children.end(), maxKey, typeLess);
 
+  // cull on the stored position, only load the items in range
+  const double cutoffSqr = aCutoff * aCutoff;
+  PositionedIDVec inRange;
+  std::vector<double> distances;
   for (; it != end; ++it) {
-    FGPositioned* p = cache->loadById(it->second);
-    double d = dist(aPos, p->cart());
-    if (d > aCutoff) {
+    double dSqr = distSqr(aPos, it->cart);
+    if (dSqr > cutoffSqr) {
       continue;
     }
 
-    if (aFilter && !aFilter->pass(p)) {
+    inRange.push_back(it->id);
+    distances.push_back(sqrt(dSqr));
+  }
+
+  if (inRange.empty()) {
+    return;
+  }
+
+  const FGPositionedList items = cache->loadByIds(inRange);
+  for (size_t i = 0; i < items.size(); ++i) {
+    FGPositioned* p = items[i];
+    if (!p || (aFilter && !aFilter->pass(p))) {
       continue;
     }
 
     ++addedCount;
-    aResults.push_back(OrderedPositioned(p, d));
+    aResults.push_back(OrderedPositioned(p, distances[i]));
   }
 
   if (addedCount == 0) {
@@ -146,28 +176,27 @@ void Leaf::visit(const SGVec3d& aPos, double aCutoff,
                      aResults.begin() + previousResultsSize, aResults.end());
 }
 
-void Leaf::insertChild(FGPositioned::Type ty, PositionedID id)
+void Leaf::insertChild(FGPositioned::Type ty, PositionedID id, const SGVec3d& aCart)
 {
   assert(_childrenLoaded);
-  children.insert(children.end(), TypedPositioned(ty, id));
+  LocatedPositioned child{ty, id, aCart};
+  children.insert(std::upper_bound(children.begin(), children.end(), child, typeLess), child);
 }
 
 void Leaf::loadChildren()
 {
-    if (_childrenLoaded) {
+    if (_childrenLoaded && (!_persistent || (_childrenGeneration == global_leafGeneration))) {
         return;
     }
 
   NavDataCache* cache = NavDataCache::instance();
-  for (const auto& tp : cache->getOctreeLeafChildren(guid())) {
-    // REVIEW: Memory Leak - 1,728 bytes in 36 blocks are still reachable
-    children.insert(children.end(), tp);
-  } // of leaf members iteration
+  children = cache->getOctreeLeafChildren(guid());
+  std::stable_sort(children.begin(), children.end(), typeLess);
 
   _childrenLoaded = true;
+  _childrenGeneration = global_leafGeneration;
 }
 
-///////////////////////////////////////////////////////////////////////////////
 
 Branch::Branch(const SGBoxd& aBox, int64_t aIdent, bool persistent) : Node(aBox, aIdent, persistent)
 {
@@ -354,6 +383,12 @@ bool findNearestN(const SGVec3d& aPos, unsigned int aN, double aCutoffM, FGPosit
       }
     }
 
+    // once we have enough results, nothing further than the Nth can make
+    // it into them, so tighten the cutoff and avoid loading those items
+    if ((aN > 0) && (results.size() >= aN)) {
+      cut = std::min(cut, results[aN - 1].order());
+    }
+
     Node* nd = pq.top().get();
     pq.pop();
 
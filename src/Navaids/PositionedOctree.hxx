@@ -127,6 +127,12 @@ namespace Octree
 
   Node* globalTransientOctree();
 
+  /**
+   * Positions of persistent items changed in the cache: leaves which have
+   * loaded their children reload them (and their positions) on next use.
+   */
+  void invalidateLeafChildren();
+
   class Leaf;
 
   /**
@@ -192,13 +198,15 @@ namespace Octree
           return const_cast<Leaf*>(this);
     }
 
-    void insertChild(FGPositioned::Type ty, PositionedID id);
+    void insertChild(FGPositioned::Type ty, PositionedID id, const SGVec3d& aCart);
 
   private:
       bool _childrenLoaded = false;
+      unsigned int _childrenGeneration = 0;
 
-      typedef std::multimap<FGPositioned::Type, PositionedID> ChildMap;
-      ChildMap children;
+      // ordered by type, and carrying their positions so searches can cull
+      // on distance before loading anything from the cache
+      LocatedPositionedVec children;
 
       void loadChildren();
   };
@@ -0,0 +1,411 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "ProcedureCache.hxx"
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/misc/sg_path.hxx>
+#include <simgear/structure/exception.hxx>
+#include <simgear/xml/easyxml.hxx>
+
+#include <Navaids/NavDataCache.hxx>
+
+namespace flightgear {
+
+namespace {
+
+const char MAGIC[4] = {'F', 'G', 'P', 'D'};
+
+// bump when the encoding changes: stored data in the old format is
+// then rejected by replay() and re-parsed
+const char FORMAT_VERSION = 1;
+
+enum EventCode : unsigned char {
+    START_ELEMENT = 1,
+    END_ELEMENT,
+    TEXT
+};
+
+void writeVarint(std::string& out, uint32_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+/**
+ * Visitor recording the events of a procedures file. Text is only kept for
+ * leaf elements: the text around child elements is whitespace, and the
+ * NavdataVisitor clears its text buffer on every element start anyway.
+ */
+class Recorder : public XMLVisitor
+{
+public:
+    void startElement(const char* name, const XMLAttributes& atts) override
+    {
+        _events.push_back(START_ELEMENT);
+        writeString(name);
+        writeVarint(_events, atts.size());
+        for (int i = 0; i < atts.size(); ++i) {
+            writeString(atts.getName(i));
+            writeString(atts.getValue(i));
+        }
+
+        _leaf = true;
+        _text.clear();
+    }
+
+    void endElement(const char* name) override
+    {
+        if (_leaf && !_text.empty()) {
+            _events.push_back(TEXT);
+            writeString(_text);
+        }
+
+        _events.push_back(END_ELEMENT);
+        writeString(name);
+        _leaf = false;
+        _text.clear();
+    }
+
+    void data(const char* s, int len) override
+    {
+        if (_leaf) {
+            _text.append(s, len);
+        }
+    }
+
+    std::string finish() const
+    {
+        std::string result(MAGIC, sizeof(MAGIC));
+        result.push_back(FORMAT_VERSION);
+        writeVarint(result, _strings.size());
+        for (const auto& s : _strings) {
+            writeVarint(result, s.size());
+            result.append(s);
+        }
+
+        result.append(_events);
+        return result;
+    }
+
+private:
+    void writeString(const std::string& s)
+    {
+        auto it = _index.find(s);
+        if (it == _index.end()) {
+            it = _index.emplace(s, static_cast<uint32_t>(_strings.size())).first;
+            _strings.push_back(s);
+        }
+
+        writeVarint(_events, it->second);
+    }
+
+    std::vector<std::string> _strings;
+    std::unordered_map<std::string, uint32_t> _index;
+    std::string _events;
+    std::string _text;
+    bool _leaf = false;
+};
+
+class Reader
+{
+public:
+    explicit Reader(const std::string& data) :
+        _data(data)
+    {
+    }
+
+    bool atEnd() const { return _pos >= _data.size(); }
+
+    bool readByte(unsigned char& value)
+    {
+        if (atEnd()) {
+            return false;
+        }
+
+        value = static_cast<unsigned char>(_data[_pos++]);
+        return true;
+    }
+
+    bool readVarint(uint32_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 32; shift += 7) {
+            unsigned char byte;
+            if (!readByte(byte)) {
+                return false;
+            }
+
+            value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool readString(std::string& value)
+    {
+        uint32_t length;
+        if (!readVarint(length) || (length > _data.size() - _pos)) {
+            return false;
+        }
+
+        value.assign(_data, _pos, length);
+        _pos += length;
+        return true;
+    }
+
+    bool readHeader()
+    {
+        if ((_data.size() < sizeof(MAGIC) + 1) ||
+            (_data.compare(0, sizeof(MAGIC), MAGIC, sizeof(MAGIC)) != 0) ||
+            (_data[sizeof(MAGIC)] != FORMAT_VERSION)) {
+            return false;
+        }
+
+        _pos = sizeof(MAGIC) + 1;
+        return true;
+    }
+
+private:
+    const std::string& _data;
+    size_t _pos = 0;
+};
+
+struct Event {
+    EventCode code;
+    uint32_t string;
+    size_t firstAttribute;
+    uint32_t attributeCount;
+};
+
+// prefetches are only collected when the airport's procedures are loaded,
+// which may never happen: bound what is kept around
+const size_t MAX_PREFETCHES = 32;
+
+std::mutex s_prefetchLock;
+std::map<std::string, std::shared_future<std::string>> s_prefetched;
+
+bool isReady(const std::shared_future<std::string>& f)
+{
+    return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+} // of anonymous namespace
+
+std::string ProcedureCache::encode(const SGPath& path)
+{
+    Recorder recorder;
+    readXML(path, recorder);
+    return recorder.finish();
+}
+
+bool ProcedureCache::replay(const std::string& data, XMLVisitor& visitor)
+{
+    Reader in(data);
+    if (!in.readHeader()) {
+        return false;
+    }
+
+    uint32_t stringCount;
+    if (!in.readVarint(stringCount)) {
+        return false;
+    }
+
+    std::vector<std::string> strings;
+    for (uint32_t i = 0; i < stringCount; ++i) {
+        std::string s;
+        if (!in.readString(s)) {
+            return false;
+        }
+        strings.push_back(std::move(s));
+    }
+
+    // decode everything before calling the visitor, so damaged data does
+    // not leave it with half a file
+    std::vector<Event> events;
+    std::vector<uint32_t> attributes;
+    while (!in.atEnd()) {
+        unsigned char code;
+        Event e;
+        if (!in.readByte(code) || !in.readVarint(e.string) || (e.string >= strings.size())) {
+            return false;
+        }
+
+        e.code = static_cast<EventCode>(code);
+        e.firstAttribute = attributes.size();
+        e.attributeCount = 0;
+        if (e.code == START_ELEMENT) {
+            if (!in.readVarint(e.attributeCount)) {
+                return false;
+            }
+
+            for (uint32_t i = 0; i < 2 * e.attributeCount; ++i) {
+                uint32_t index;
+                if (!in.readVarint(index) || (index >= strings.size())) {
+                    return false;
+                }
+                attributes.push_back(index);
+            }
+        } else if ((e.code != END_ELEMENT) && (e.code != TEXT)) {
+            return false;
+        }
+
+        events.push_back(e);
+    }
+
+    visitor.startXML();
+    for (const auto& e : events) {
+        const std::string& s = strings[e.string];
+        switch (e.code) {
+        case START_ELEMENT: {
+            XMLAttributesDefault atts;
+            for (uint32_t i = 0; i < e.attributeCount; ++i) {
+                const size_t a = e.firstAttribute + 2 * i;
+                atts.addAttribute(strings[attributes[a]].c_str(),
+                                  strings[attributes[a + 1]].c_str());
+            }
+            visitor.startElement(s.c_str(), atts);
+            break;
+        }
+
+        case END_ELEMENT:
+            visitor.endElement(s.c_str());
+            break;
+
+        case TEXT:
+            visitor.data(s.c_str(), static_cast<int>(s.size()));
+            break;
+        }
+    }
+    visitor.endXML();
+    return true;
+}
+
+std::string ProcedureCache::load(const SGPath& path)
+{
+    NavDataCache* cache = NavDataCache::instance();
+    std::string data;
+
+    std::shared_future<std::string> pending;
+    {
+        std::lock_guard<std::mutex> g(s_prefetchLock);
+        auto it = s_prefetched.find(path.utf8Str());
+        if (it != s_prefetched.end()) {
+            pending = it->second;
+            s_prefetched.erase(it);
+        }
+    }
+
+    if (pending.valid()) {
+        try {
+            data = pending.get();
+        } catch (const sg_exception& e) {
+            SG_LOG(SG_NAVAID, SG_DEBUG, "prefetching procedures failed: " << path
+                   << ": " << e.getFormattedMessage());
+            return {};
+        }
+    } else if (cache) {
+        data = cache->readProcedureData(path);
+        if (Reader(data).readHeader()) {
+            return data;
+        }
+        data.clear();
+    }
+
+    if (data.empty()) {
+        try {
+            data = encode(path);
+        } catch (const sg_exception& e) {
+            SG_LOG(SG_NAVAID, SG_DEBUG, "parsing procedures failed: " << path
+                   << ": " << e.getFormattedMessage());
+            return {};
+        }
+    }
+
+    if (cache) {
+        cache->writeProcedureData(path, data);
+    }
+    return data;
+}
+
+void ProcedureCache::prefetch(const SGPath& path)
+{
+    const std::string key = path.utf8Str();
+    {
+        std::lock_guard<std::mutex> g(s_prefetchLock);
+        if (s_prefetched.find(key) != s_prefetched.end()) {
+            return;
+        }
+
+        if (s_prefetched.size() >= MAX_PREFETCHES) {
+            // drop finished ones nobody collected; dropping a running one
+            // would block until it is done
+            for (auto it = s_prefetched.begin(); it != s_prefetched.end();) {
+                it = isReady(it->second) ? s_prefetched.erase(it) : std::next(it);
+            }
+            if (s_prefetched.size() >= MAX_PREFETCHES) {
+                return;
+            }
+        }
+    }
+
+    NavDataCache* cache = NavDataCache::instance();
+    if (cache && cache->hasProcedureData(path)) {
+        return;
+    }
+
+    SG_LOG(SG_NAVAID, SG_DEBUG, "prefetching procedures from " << path);
+    auto future = std::async(std::launch::async, [path] { return encode(path); });
+
+    std::lock_guard<std::mutex> g(s_prefetchLock);
+    s_prefetched[key] = future.share();
+}
+
+unsigned int ProcedureCache::pendingPrefetches()
+{
+    std::lock_guard<std::mutex> g(s_prefetchLock);
+    return static_cast<unsigned int>(s_prefetched.size());
+}
+
+void ProcedureCache::clearPrefetches()
+{
+    std::map<std::string, std::shared_future<std::string>> dropped;
+    {
+        std::lock_guard<std::mutex> g(s_prefetchLock);
+        dropped.swap(s_prefetched);
+    }
+    // the futures wait for their parse to finish as they go out of scope
+}
+
+} // namespace flightgear
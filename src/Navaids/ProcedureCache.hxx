@@ -0,0 +1,81 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+
+class SGPath;
+class XMLVisitor;
+
+namespace flightgear {
+
+/**
+ * Pre-parsed store for Level-D procedure files.
+ *
+ * A procedures file is parsed once into a compact binary stream of the
+ * XML events the NavdataVisitor consumes: element names, attributes and
+ * the text of leaf elements, with every string interned. The stream is
+ * kept in the NavDataCache, stamped with the file's modification time,
+ * and replayed into a visitor instead of parsing the XML again.
+ *
+ * The procedure objects themselves reference runways and are still
+ * built by the visitor on the main thread; only the file parsing is
+ * cached, or moved to a worker thread by prefetch().
+ */
+class ProcedureCache
+{
+public:
+    /**
+     * Parse a procedures file into the binary form. Throws the same
+     * exceptions readXML() does. Safe to call from any thread.
+     */
+    static std::string encode(const SGPath& path);
+
+    /**
+     * Feed the binary form to a visitor, as readXML() would. Returns false
+     * if the data is not in the current format; exceptions thrown by the
+     * visitor are passed on.
+     */
+    static bool replay(const std::string& data, XMLVisitor& visitor);
+
+    /**
+     * Binary form of a procedures file: from a prefetch, the NavDataCache,
+     * or by parsing the file (and storing the result). Returns an empty
+     * string if the file could not be parsed. Main thread only.
+     */
+    static std::string load(const SGPath& path);
+
+    /**
+     * Start parsing a procedures file on a worker thread, unless its
+     * binary form is already stored or being prefetched. At most 32 are
+     * kept waiting to be collected; beyond that, finished ones are dropped
+     * and new ones are not started. Main thread only.
+     */
+    static void prefetch(const SGPath& path);
+
+    /// number of prefetches which were started and not yet collected
+    static unsigned int pendingPrefetches();
+
+    /**
+     * Drop the prefetches which were not collected, waiting for those still
+     * running. Called on reset, and when the NavDataCache goes away.
+     */
+    static void clearPrefetches();
+};
+
+} // namespace flightgear
@@ -427,6 +427,11 @@ FGPositionedRef FGPositioned::loadByIdImpl(PositionedID id)
   return flightgear::NavDataCache::instance()->loadById(id);
 }
 
+FGPositionedList FGPositioned::loadAllByIdImpl(const PositionedIDVec& ids)
+{
+  return flightgear::NavDataCache::instance()->loadByIds(ids);
+}
+
 FGPositioned::TypeFilter::TypeFilter(Type aTy)
 {
   addType(aTy);
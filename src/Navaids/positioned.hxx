@@ -264,10 +264,11 @@ public:
   template<class T>
   static std::vector<SGSharedPtr<T> > loadAllById(const PositionedIDVec& id_vec)
   {
-    std::vector<SGSharedPtr<T> > vec(id_vec.size());
+    const FGPositionedList items = loadAllByIdImpl(id_vec);
+    std::vector<SGSharedPtr<T> > vec(items.size());
 
-    for(size_t i = 0; i < id_vec.size(); ++i)
-      vec[i] = loadById<T>(id_vec[i]);
+    for(size_t i = 0; i < items.size(); ++i)
+      vec[i] = static_pointer_cast<T>(items[i]);
 
     return vec;
   }
@@ -294,6 +295,7 @@ protected:
   void invalidatePosition();
 
   static FGPositionedRef loadByIdImpl(PositionedID id);
+  static FGPositionedList loadAllByIdImpl(const PositionedIDVec& ids);
 
   const PositionedID mGuid;
   const Type mType;
@@ -42,6 +42,7 @@
 #include <Navaids/procedure.hxx>
 #include <Navaids/waypoint.hxx>
 #include <Navaids/LevelDXML.hxx>
+#include <Navaids/ProcedureCache.hxx>
 #include <Airports/airport.hxx>
 #include <Navaids/airways.hxx>
 
@@ -599,7 +600,11 @@ void RouteBase::loadAirportProcedures(const SGPath& aPath, FGAirport* aApt)
   assert(aApt);
   try {
     NavdataVisitor visitor(aApt, aPath);
+    const std::string data = ProcedureCache::load(aPath);
+    if (data.empty() || !ProcedureCache::replay(data, visitor)) {
+      // parse the XML directly, so failures are reported as before
       readXML(aPath, visitor);
+    }
   } catch (sg_io_exception& ex) {
     SG_LOG(SG_NAVAID, SG_WARN, "failure parsing procedures: " << aPath <<
       "\n\t" << ex.getMessage() << "\n\tat:" << ex.getLocation().asString());
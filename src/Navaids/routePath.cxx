@@ -259,9 +259,57 @@ public:
     pathDistanceM(0.0),
     turnPathDistanceM(0.0),
     overflightCompensationAngle(0.0),
-    flyOver(w->flag(WPT_OVERFLIGHT))
+    flyOver(w->flag(WPT_OVERFLIGHT)),
+    inputFlags(w->flags()),
+    inputAltRestrict(w->altitudeRestriction()),
+    inputAltFt(w->altitudeFt())
   {
   }
+
+  /**
+   * test if this data was computed for the waypoint as it is now; waypoint
+   * flags and restrictions can be changed without notifying the flight-plan
+   */
+  bool inputsMatch(const WayptRef& w) const
+  {
+    return (wpt == w) && (inputFlags == w->flags()) &&
+      (inputAltRestrict == w->altitudeRestriction()) &&
+      (inputAltFt == w->altitudeFt());
+  }
+
+  static bool sameGeod(const SGGeod& a, const SGGeod& b)
+  {
+    return (a.getLongitudeRad() == b.getLongitudeRad()) &&
+      (a.getLatitudeRad() == b.getLatitudeRad()) &&
+      (a.getElevationM() == b.getElevationM());
+  }
+
+  /**
+   * exact comparison of the computed data, used to detect when an
+   * incremental update has converged back onto the previous result
+   */
+  bool sameAs(const WayptData& o) const
+  {
+    return (wpt == o.wpt) && (hasEntry == o.hasEntry) && (posValid == o.posValid) &&
+      (legCourseValid == o.legCourseValid) && (skipped == o.skipped) &&
+      (flyOver == o.flyOver) &&
+      sameGeod(pos, o.pos) && sameGeod(turnEntryPos, o.turnEntryPos) &&
+      sameGeod(turnExitPos, o.turnExitPos) && sameGeod(turnEntryCenter, o.turnEntryCenter) &&
+      sameGeod(turnExitCenter, o.turnExitCenter) &&
+      (turnEntryAngle == o.turnEntryAngle) && (turnExitAngle == o.turnExitAngle) &&
+      (turnRadius == o.turnRadius) && (legCourseTrue == o.legCourseTrue) &&
+      (pathDistanceM == o.pathDistanceM) && (turnPathDistanceM == o.turnPathDistanceM) &&
+      (overflightCompensationAngle == o.overflightCompensationAngle);
+  }
+
+  /**
+   * waypoints which are neither skipped nor a discontinuity, i.e. the ones
+   * previousValidWaypoint / nextValidWaypoint stop at
+   */
+  bool isValid() const
+  {
+    return !skipped && (wpt->type() != "discontinuity");
+  }
   
   void initPass0()
   {
@@ -633,8 +681,34 @@ public:
   double turnPathDistanceM; // for flyBy, this is half the distance; for flyOver it's the complete distance
   double overflightCompensationAngle;
   bool flyOver;
+
+  // waypoint state this data was computed from
+  unsigned int inputFlags;
+  RouteRestriction inputAltRestrict;
+  double inputAltFt;
 };
 
+static int previousValidIndex(const WayptDataVec& waypoints, int index)
+{
+    for (--index; index >= 0; --index) {
+        if (waypoints[index].isValid()) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+static int nextValidIndex(const WayptDataVec& waypoints, int index)
+{
+    const int sz = waypoints.size();
+    for (++index; index < sz; ++index) {
+        if (waypoints[index].isValid()) {
+            break;
+        }
+    }
+    return index;
+}
+
 bool isDescentWaypoint(const WayptRef& wpt)
 {
   return (wpt->flag(WPT_APPROACH) && !wpt->flag(WPT_MISS)) || wpt->flag(WPT_ARRIVAL);
@@ -645,6 +719,15 @@ class RoutePath::RoutePathPrivate
 public:
     WayptDataVec waypoints;
 
+    // snapshots kept for incremental updates: the data after the static
+    // passes (initPass0 / initPass1), and the data as it was just before
+    // each waypoint's own step in the main pass
+    WayptDataVec initial;
+    WayptDataVec entry;
+
+    // waypoints before this index have their path distance resolved
+    unsigned int resolvedCount = 0;
+
     AircraftPerformance perf;
     bool constrainLegCourses;
     double maxFlyByTurnAngleDeg = 90.0;
@@ -821,6 +904,9 @@ public:
   {
     double total = 0.0;
     
+    // while computing, only count the legs resolved so far, so the result
+    // does not depend on whatever later legs held before
+    to = std::min(to, static_cast<int>(resolvedCount) - 1);
     for (int i=from+1; i<= to; ++i) {
       total += waypoints[i].pathDistanceM;
     }
@@ -911,9 +997,23 @@ void RoutePath::commonInit()
     d->waypoints[i].initPass1(prevPtr, nextPtr);
   }
 
+  d->initial = d->waypoints;
+  d->entry = d->waypoints;
+
   for (unsigned int i=0; i<d->waypoints.size(); ++i) {
+    computeLeg(i);
+  }
+
+  d->resolvedCount = d->waypoints.size();
+}
+
+void RoutePath::computeLeg(unsigned int i)
+{
+    d->entry[i] = d->waypoints[i];
+    d->resolvedCount = i;
+
       if (d->waypoints[i].skipped) {
-          continue;
+          return;
       }
 
       double alt = 0.0; // FIXME
@@ -947,7 +1047,153 @@ void RoutePath::commonInit()
     
     // now turn is computed, can resolve distances
     d->waypoints[i].pathDistanceM = computeDistanceForIndex(i);
-  }
+}
+
+int RoutePath::update(const flightgear::FlightPlan* fp)
+{
+    WayptVec wpts;
+    for (int l=0; l<fp->numLegs(); ++l) {
+        WayptRef wpt = fp->legAtIndex(l)->waypoint();
+        if (!wpt) {
+            SG_LOG(SG_NAVAID, SG_DEV_ALERT, "Waypoint " << l << " of " << fp->numLegs() << "is NULL");
+            break;
+        }
+        wpts.push_back(wpt);
+    }
+
+    // the performance data comes from the current aircraft, which may have
+    // been changed (or had its performance settings changed) since
+    if ((fp->followLegTrackToFixes() != d->constrainLegCourses) ||
+        (AircraftPerformance::dataRevision() != d->perf.revision())) {
+        // affects every turn, start again
+        *this = RoutePath(fp);
+        return d->waypoints.size();
+    }
+
+    const int oldSize = d->waypoints.size();
+    const int newSize = wpts.size();
+    int prefix = 0;
+    while ((prefix < oldSize) && (prefix < newSize) && d->waypoints[prefix].inputsMatch(wpts[prefix])) {
+        ++prefix;
+    }
+
+    if ((prefix == oldSize) && (prefix == newSize)) {
+        return 0; // nothing changed
+    }
+
+    if (newSize == 0) {
+        d->waypoints.clear();
+        d->initial.clear();
+        d->entry.clear();
+        d->resolvedCount = 0;
+        return 0;
+    }
+
+    int suffix = 0;
+    while ((prefix + suffix < oldSize) && (prefix + suffix < newSize) &&
+           d->waypoints[oldSize - 1 - suffix].inputsMatch(wpts[newSize - 1 - suffix])) {
+        ++suffix;
+    }
+
+    // splice fresh data for the changed waypoints in between the old head
+    // and tail; indices in the tail move by 'shift'
+    const RoutePathPrivate old(*d);
+    const int shift = newSize - oldSize;
+    const int changedEnd = newSize - suffix;
+
+    WayptDataVec fresh;
+    for (int i = prefix; i < changedEnd; ++i) {
+        fresh.push_back(WayptData(wpts[i]));
+    }
+
+    for (WayptDataVec* v : {&d->waypoints, &d->initial, &d->entry}) {
+        v->erase(v->begin() + prefix, v->begin() + (oldSize - suffix));
+        v->insert(v->begin() + prefix, fresh.begin(), fresh.end());
+    }
+
+    // static passes: the waypoint before the change can depend on the next
+    // position, and everything after depends on its valid predecessor, so
+    // carry on until the data matches what it was before
+    int staticEnd = std::max(prefix - 1, 0);
+    for (; staticEnd < newSize; ++staticEnd) {
+        WayptData w(wpts[staticEnd]);
+        w.initPass0();
+        if (staticEnd > 0) {
+            std::unique_ptr<WayptData> next;
+            if (staticEnd + 1 < newSize) {
+                next.reset(new WayptData(wpts[staticEnd + 1]));
+                next->initPass0();
+            }
+
+            const int prev = previousValidIndex(d->initial, staticEnd);
+            w.initPass1((prev < 0) ? nullptr : &d->initial[prev], next.get());
+        }
+
+        const bool converged = (staticEnd >= changedEnd) && w.isValid() &&
+            w.sameAs(d->initial[staticEnd]);
+        d->initial[staticEnd] = w;
+        if (converged) {
+            break;
+        }
+    }
+
+    // main pass: restart at the last valid waypoint before the first
+    // changed one, since its turn depends on the following leg
+    const int firstChanged = std::max(prefix - 1, 0);
+    const int previousValid = previousValidIndex(d->initial, firstChanged);
+    const int start = std::max(previousValid, 0);
+
+    // climbing heading-to-altitude legs depend on the path distance back to
+    // the last known altitude, so those spans can't be cut short
+    std::vector<std::pair<int, int>> vnavSpans;
+    for (int i = start + 1; i < newSize; ++i) {
+        const WayptRef& w = d->initial[i].wpt;
+        if ((w->type() == "hdgToAlt") && !isDescentWaypoint(d->initial[i - 1].wpt)) {
+            const int known = d->findPreceedingKnownAltitude(i - 1);
+            if (known >= 0) {
+                vnavSpans.push_back(std::make_pair(known, i));
+            }
+        }
+    }
+
+    auto needsVNAVUpdate = [&vnavSpans](int index) {
+        for (const auto& span : vnavSpans) {
+            if ((span.first < index) && (index < span.second)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // nothing writes to the first waypoint before its own step
+    d->waypoints[start] = (previousValid < 0) ? d->initial[start] : d->entry[start];
+    int resetEnd = start;
+    int computed = 0;
+    for (int i = start; i < newSize; ++i) {
+        // waypoints are rebuilt from their static data before the step
+        // that first writes to them, which is the previous valid one
+        const int nextIndex = std::min(nextValidIndex(d->initial, i), newSize - 1);
+        for (; resetEnd < nextIndex; ++resetEnd) {
+            d->waypoints[resetEnd + 1] = d->initial[resetEnd + 1];
+        }
+
+        computeLeg(i);
+        ++computed;
+
+        if ((i > start) && (i >= staticEnd) && d->waypoints[i].isValid() &&
+            d->waypoints[i].sameAs(old.waypoints[i - shift]) &&
+            d->entry[i].sameAs(old.entry[i - shift]) && !needsVNAVUpdate(i))
+        {
+            // back on the previous result, the rest of the route is unchanged
+            for (int j = i + 1; j <= resetEnd; ++j) {
+                d->waypoints[j] = old.waypoints[j - shift];
+            }
+            break;
+        }
+    }
+
+    d->resolvedCount = d->waypoints.size();
+    return computed;
 }
 
 SGGeodVec RoutePath::pathForIndex(int index) const
@@ -45,6 +45,14 @@ public:
   RoutePath(const RoutePath& other);
   RoutePath& operator=(const RoutePath& other);
 
+  /**
+   * Bring the path up to date with the legs of the flight-plan, recomputing
+   * only the legs around the ones which changed. A change of the aircraft
+   * performance data recomputes every leg. Returns the number of legs
+   * which were recomputed.
+   */
+  int update(const flightgear::FlightPlan* fp);
+
   flightgear::SGGeodVec pathForIndex(int index) const;
   
   SGGeod positionForIndex(int index) const;
@@ -61,6 +69,8 @@ private:
   class RoutePathPrivate;
   
   void commonInit();
+
+  void computeLeg(unsigned int index);
   
   double computeDistanceForIndex(int index) const;
 
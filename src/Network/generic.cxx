@@ -224,6 +224,9 @@ int FGSTXETXWrapper::unwrap( size_t n, uint8_t * buf )
 
 FGGeneric::FGGeneric(vector<string> tokens) : exitOnError(false), initOk(false), wrapper(NULL)
 {
+    _out_plan.valid = false;
+    _out_plan.length = 0;
+
     size_t configToken;
     if (tokens[1] == "socket") {
         configToken = 7;
@@ -265,11 +268,101 @@ union u64 {
     double doubleVal;
 };
 
-// generate the message
-bool FGGeneric::gen_message_binary() {
-    string generic_sentence;
-    length = 0;
+// Compile the binary output message into a fixed layout plan. Returns false
+// (and leaves the plan invalid) if the message has no fixed layout.
+bool FGGeneric::compile_binary_plan() {
+    _out_plan.valid = false;
+    _out_plan.length = 0;
+    for (auto& fields : _out_plan.fields) {
+        fields.clear();
+    }
+
+    int pos = 0;
+    for (const auto& chunk : _out_message) {
+        int size;
+        switch (chunk.type) {
+        case FG_BOOL:
+        case FG_BYTE:   size = 1; break;
+        case FG_WORD:   size = sizeof(int16_t); break;
+        case FG_DOUBLE: size = sizeof(uint64_t); break;
+        case FG_STRING: return false; // variable length
+        default:        size = sizeof(int32_t); break;
+        }
+
+        _binary_field field;
+        field.prop = chunk.prop;
+        field.offset = chunk.offset;
+        field.factor = chunk.factor;
+        field.pos = pos;
+        _out_plan.fields[chunk.type].push_back(field);
+        pos += size;
+    }
+
+    // leave room for the footer
+    if (pos + (int)sizeof(int32_t) > FG_MAX_MSG_SIZE) {
+        return false;
+    }
+
+    _out_plan.length = pos;
+    _out_plan.valid = true;
+    return true;
+}
+
+// Encode the message using the precompiled layout. Produces exactly the
+// same bytes as the per-chunk loop in gen_message_binary().
+template<bool Swap>
+void FGGeneric::gen_message_binary_plan() {
+    for (const auto& f : _out_plan.fields[FG_INT]) {
+        double val = f.offset + f.prop->getFloatValue() * f.factor;
+        int32_t intVal = val;
+        if (Swap) intVal = (int32_t) sg_bswap_32((uint32_t)intVal);
+        memcpy(&buf[f.pos], &intVal, sizeof(int32_t));
+    }
+
+    for (const auto& f : _out_plan.fields[FG_BOOL]) {
+        buf[f.pos] = (char) (f.prop->getBoolValue() ? true : false);
+    }
+
+    for (const auto& f : _out_plan.fields[FG_FIXED]) {
+        double val = f.offset + f.prop->getFloatValue() * f.factor;
+        int32_t fixed = (int)(val * 65536.0f);
+        if (Swap) fixed = (int32_t) sg_bswap_32((uint32_t)fixed);
+        memcpy(&buf[f.pos], &fixed, sizeof(int32_t));
+    }
 
+    for (const auto& f : _out_plan.fields[FG_FLOAT]) {
+        double val = f.offset + f.prop->getFloatValue() * f.factor;
+        u32 tmpun32;
+        tmpun32.floatVal = static_cast<float>(val);
+        if (Swap) tmpun32.intVal = sg_bswap_32(tmpun32.intVal);
+        memcpy(&buf[f.pos], &tmpun32.intVal, sizeof(uint32_t));
+    }
+
+    for (const auto& f : _out_plan.fields[FG_DOUBLE]) {
+        u64 tmpun64;
+        tmpun64.doubleVal = f.offset + f.prop->getDoubleValue() * f.factor;
+        if (Swap) tmpun64.longVal = sg_bswap_64(tmpun64.longVal);
+        memcpy(&buf[f.pos], &tmpun64.longVal, sizeof(uint64_t));
+    }
+
+    // bytes and words are written in host byte order
+    for (const auto& f : _out_plan.fields[FG_BYTE]) {
+        double val = f.offset + f.prop->getFloatValue() * f.factor;
+        int8_t byteVal = val;
+        memcpy(&buf[f.pos], &byteVal, sizeof(int8_t));
+    }
+
+    for (const auto& f : _out_plan.fields[FG_WORD]) {
+        double val = f.offset + f.prop->getFloatValue() * f.factor;
+        int16_t wordVal = val;
+        memcpy(&buf[f.pos], &wordVal, sizeof(int16_t));
+    }
+
+    length = _out_plan.length;
+}
+
+// Encode the message chunk by chunk, used if there is no precompiled plan.
+void FGGeneric::gen_message_binary_chunks() {
     double val;
     for (unsigned int i = 0; i < _out_message.size(); i++) {
 
@@ -381,6 +474,21 @@ bool FGGeneric::gen_message_binary() {
 
         }
     }
+}
+
+// generate the message
+bool FGGeneric::gen_message_binary() {
+    length = 0;
+
+    if (_out_plan.valid) {
+        if (binary_byte_order != BYTE_ORDER_MATCHES_NETWORK_ORDER) {
+            gen_message_binary_plan<true>();
+        } else {
+            gen_message_binary_plan<false>();
+        }
+    } else {
+        gen_message_binary_chunks();
+    }
 
     // add the footer to the packet ("line")
     switch (binary_footer_type) {
@@ -774,12 +882,19 @@ FGGeneric::reinit()
     if ((dir == SG_IO_OUT) || (dir == SG_IO_BI)) {
         SGPropertyNode *output = root.getNode("generic/output");
         if (output) {
+            _out_plan.valid = false;
             _out_message.clear();
             if (!read_config(output, _out_message))
             {
                 // bad configuration
                 return;
             }
+
+            // <binary_precompiled>false</binary_precompiled> keeps the
+            // per-chunk encoder, e.g. for comparison
+            if (binary_mode && output->getBoolValue("binary_precompiled", true)) {
+                compile_binary_plan();
+            }
         }
     }
 
@@ -53,6 +53,13 @@ public:
     void setExitOnError(bool val) { exitOnError = val; }
     bool getExitOnError() { return exitOnError; }
     bool getInitOk(void) { return initOk; }
+
+    // Last generated message, e.g. for testing and benchmarking.
+    const char* getMessageBuffer() const { return buf; }
+    int getMessageLength() const { return length; }
+
+    // True if binary output uses the precompiled layout (see _binary_plan).
+    bool hasBinaryPlan() const { return _out_plan.valid; }
 protected:
 
     enum e_type { FG_BOOL=0, FG_INT, FG_FLOAT, FG_DOUBLE, FG_STRING, FG_FIXED, FG_BYTE, FG_WORD };
@@ -69,6 +76,24 @@ protected:
         SGPropertyNode_ptr prop;
     } _serial_prot;
 
+    // A field of a precompiled binary output message.
+    typedef struct {
+        SGPropertyNode* prop;
+        double offset;
+        double factor;
+        int pos;            // byte position in the message
+    } _binary_field;
+
+    // Fixed layout of a binary output message, compiled once from the
+    // protocol definition: fields are grouped by type with their byte
+    // positions resolved, so encoding is one tight loop per type. Not
+    // possible for messages containing (variable length) strings.
+    typedef struct {
+        bool valid;
+        int length;         // message length without footer
+        vector<_binary_field> fields[FG_WORD + 1];
+    } _binary_plan;
+
 private:
 
     std::string file_name;
@@ -84,6 +109,7 @@ private:
     std::string line_sep_string;
     vector<_serial_prot> _out_message;
     vector<_serial_prot> _in_message;
+    _binary_plan _out_plan;
 
     bool binary_mode;
     enum {FOOTER_NONE, FOOTER_LENGTH, FOOTER_MAGIC} binary_footer_type;
@@ -93,6 +119,9 @@ private:
 
     bool gen_message_ascii();
     bool gen_message_binary();
+    void gen_message_binary_chunks();
+    bool compile_binary_plan();
+    template<bool Swap> void gen_message_binary_plan();
     bool parse_message_ascii(int length);
     bool parse_message_binary(int length);
     bool read_config(SGPropertyNode *root, vector<_serial_prot> &msg);
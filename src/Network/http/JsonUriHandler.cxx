@@ -28,6 +28,24 @@ using std::string;
 namespace flightgear {
 namespace http {
 
+static const char * KEY_JSON_WRITER = "JsonUriHandler::writer";
+
+/**
+ * State of a GET response that is sent in chunks over several frames.
+ */
+class JsonWriterData : public ConnectionData {
+public:
+  JsonWriterData( SGPropertyNode_ptr node, int depth, double timestamp, size_t nodesPerFrame ) :
+    writer( node, depth, timestamp ),
+    nodesPerFrame( nodesPerFrame )
+  {
+  }
+
+  JSONPropertyWriter writer;
+  size_t nodesPerFrame;
+  string buffer; // reused for every chunk
+};
+
 bool JsonUriHandler::handleRequest( const HTTPRequest & request, HTTPResponse & response, Connection * connection )
 {
   response.Header["Content-Type"] = "application/json; charset=UTF-8";
@@ -56,9 +74,26 @@ bool JsonUriHandler::handleRequest( const HTTPRequest & request, HTTPResponse &
       return true;
     } 
 
-    response.Content = JSON::toJsonString( indent, node, depth, timestamp ? fgGetDouble("/sim/time/elapsed-sec") : -1.0 );
+    double ts = timestamp ? fgGetDouble("/sim/time/elapsed-sec") : -1.0;
+    if( indent ) {
+      response.Content = JSON::toJsonString( indent, node, depth, ts );
+      return true;
+    }
 
-    return true;
+    // Large subtrees can be sent with chunked transfer encoding, a limited
+    // number of nodes per frame, so they do not stall the main loop.
+    long nodesPerFrame = fgGetLong("/sim/http/json/max-nodes-per-frame", 0);
+    if( nodesPerFrame <= 0 || NULL == connection ) {
+      JSONPropertyWriter( node, depth, ts ).write( response.Content );
+      return true;
+    }
+
+    SGSharedPtr<JsonWriterData> data = new JsonWriterData( node, depth, ts, nodesPerFrame );
+    if( data->writer.write( response.Content, data->nodesPerFrame ) )
+      return true;
+
+    connection->put( KEY_JSON_WRITER, data );
+    return false; // call me again thru poll
   }
 
   if( request.Method == "POST" ) {
@@ -88,6 +123,26 @@ bool JsonUriHandler::handleRequest( const HTTPRequest & request, HTTPResponse &
 
 }
 
+bool JsonUriHandler::poll( Connection * connection )
+{
+  SGSharedPtr<ConnectionData> data = connection->get( KEY_JSON_WRITER );
+  JsonWriterData * writerData = dynamic_cast<JsonWriterData*>( data.get() );
+  if( NULL == writerData ) return true; // Should not happen, kill the connection
+
+  writerData->buffer.clear();
+  bool done = writerData->writer.write( writerData->buffer, writerData->nodesPerFrame );
+  if( !writerData->buffer.empty() )
+    connection->write( writerData->buffer.data(), writerData->buffer.size() );
+
+  if( !done )
+    return false;
+
+  // send terminating chunk
+  connection->remove( KEY_JSON_WRITER );
+  connection->write( "", 0 );
+  return true;
+}
+
 SGPropertyNode_ptr JsonUriHandler::getRequestedNode(const HTTPRequest & request)
 {
   SG_LOG(SG_NETWORK,SG_INFO, "JsonUriHandler: request is '" << request.Uri << "'" );
@@ -21,10 +21,53 @@
 #include "PropertyChangeObserver.hxx"
 
 #include <Main/fg_props.hxx>
+
+#include <cmath>
+
 using std::string;
 namespace flightgear {
 namespace http {
 
+bool PropertyValueSnapshot::update(const SGPropertyNode* node)
+{
+  const simgear::props::Type type = node->getType();
+  const bool hasValue = node->hasValue();
+  bool changed = (type != _type) || (hasValue != _hasValue);
+  _type = type;
+  _hasValue = hasValue;
+
+  switch (type) {
+    case simgear::props::BOOL:
+    case simgear::props::INT:
+    case simgear::props::LONG: {
+      const long v = node->getLongValue();
+      changed = changed || (v != _long);
+      _long = v;
+      break;
+    }
+
+    case simgear::props::FLOAT:
+    case simgear::props::DOUBLE: {
+      const double v = node->getDoubleValue();
+      // NaN never compares equal; treat NaN -> NaN as unchanged
+      if (!(std::isnan(v) && std::isnan(_double)))
+        changed = changed || (v != _double);
+      _double = v;
+      break;
+    }
+
+    default: {
+      string v = node->getStringValue();
+      if (v != _string) {
+        changed = true;
+        _string.swap(v);
+      }
+      break;
+    }
+  }
+
+  return changed;
+}
 
 
 PropertyChangeObserver::PropertyChangeObserver()
@@ -39,7 +82,7 @@ PropertyChangeObserver::~PropertyChangeObserver()
 void PropertyChangeObserver::check()
 {
 
-  for (Entries_t::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+  for (Entries_t::iterator it = _entries.begin(); it != _entries.end(); ) {
     if (!(*it)->_node.isShared()) {
       // node is no longer used but by us - remove the entry
       it = _entries.erase(it);
@@ -47,11 +90,9 @@ void PropertyChangeObserver::check()
     }
 
     if(!(*it)->_changed ) {
-      (*it)->_changed = (*it)->_prevValue != (*it)->_node->getStringValue();
-      if ((*it)->_changed)
-        (*it)->_prevValue = (*it)->_node->getStringValue();
-
+      (*it)->_changed = (*it)->_prevValue.update((*it)->_node);
     }
+    ++it;
   }
 }
 
@@ -77,6 +118,7 @@ const SGPropertyNode_ptr PropertyChangeObserver::addObservation( const string pr
   try {
     PropertyChangeObserverEntryRef entry = new PropertyChangeObserverEntry();
     entry->_node = fgGetNode( propertyName, true );
+    entry->_prevValue.update( entry->_node );
     _entries.push_back( entry );
     return entry->_node;
   }
@@ -28,13 +28,41 @@
 namespace flightgear {
 namespace http {
 
+/**
+ * The last seen value of a property. Numeric and boolean values are compared
+ * as such, so only string properties are ever converted to text.
+ */
+class PropertyValueSnapshot {
+public:
+  PropertyValueSnapshot()
+      : _type(simgear::props::NONE),
+        _hasValue(false),
+        _long(0),
+        _double(0.0)
+  {
+  }
+
+  /**
+   * Take a new snapshot of node.
+   * @return true if the value or type differs from the previous snapshot
+   */
+  bool update(const SGPropertyNode* node);
+
+private:
+  simgear::props::Type _type;
+  bool _hasValue;
+  long _long;
+  double _double;
+  std::string _string;
+};
+
 struct PropertyChangeObserverEntry : public SGReferenced {
   PropertyChangeObserverEntry()
       : _changed(true)
   {
   }
   SGPropertyNode_ptr _node;
-  std::string _prevValue;
+  PropertyValueSnapshot _prevValue;
   bool _changed;
 };
 
@@ -31,6 +31,9 @@
 #include <Main/fg_props.hxx>
 
 #include <cJSON.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 
 namespace flightgear {
 namespace http {
@@ -121,7 +124,9 @@ PropertyChangeWebsocket::PropertyChangeWebsocket(PropertyChangeObserver * proper
     : id(++nextid),
       _propertyChangeObserver(propertyChangeObserver),
       _minTriggerInterval(fgGetDouble("/sim/http/property-websocket/update-interval-secs", 0.05)), // default 20Hz
-      _lastTrigger(-1000)
+      _lastTrigger(-1000),
+      _nextSubscriptionId(1),
+      _binarySubscriptions(false)
 {
 }
 
@@ -133,6 +138,7 @@ void PropertyChangeWebsocket::close()
 {
   SG_LOG(SG_NETWORK, SG_INFO, "closing PropertyChangeWebsocket #" << id);
   _watchedNodes.clear();
+  _subscriptions.clear();
 }
 
 void PropertyChangeWebsocket::handleGetCommand(const string_list& nodes, WebsocketWriter &writer)
@@ -164,6 +170,27 @@ void PropertyChangeWebsocket::handleRequest(const HTTPRequest & request, Websock
    ],
    node: '/bax/foo'
    }
+
+   * subscription mode: changes of all subscribed nodes are sent as one
+   * frame per poll, keyed by a numeric id assigned on subscription
+   {
+   command : 'subscribe',
+   nodes : [ '/bar/baz', '/foo/bar' ],
+   encoding : 'json' | 'binary'            (optional, default 'json')
+   }
+   replies { "subscribed" : [ { "id" : 1, "path" : "/bar/baz" }, ... ] },
+   then on each poll with changes, either the text frame
+   { "ts" : <sim time>, "values" : { "1" : 0.5, "2" : "abc" } }
+   or a binary frame (little endian):
+   double ts, uint32 count, count * ( uint32 id, uint8 tag, value ) with
+   tag 0 = null (no value), 1 = bool (uint8), 2 = number (double),
+   3 = string (uint32 length, utf-8 bytes)
+
+   {
+   command : 'unsubscribe',
+   nodes : [ '/bar/baz' ],                  and/or
+   ids : [ 2 ]
+   }
    */
   cJSON * json = cJSON_Parse(request.Content.c_str());
   if ( NULL != json) {
@@ -196,6 +223,10 @@ void PropertyChangeWebsocket::handleRequest(const HTTPRequest & request, Websock
       handleSetCommand(nodeNames, json, writer);
     } else if (command == "exec") {
       handleExecCommand(json);
+    } else if (command == "subscribe") {
+      handleSubscribeCommand(nodeNames, json, writer);
+    } else if (command == "unsubscribe") {
+      handleUnsubscribeCommand(nodeNames, json);
     } else {
       string_list::const_iterator it;
       for (it = nodeNames.begin(); it != nodeNames.end(); ++it) {
@@ -207,6 +238,172 @@ void PropertyChangeWebsocket::handleRequest(const HTTPRequest & request, Websock
   }
 }
 
+void PropertyChangeWebsocket::handleSubscribeCommand(const string_list& nodes, cJSON* json, WebsocketWriter &writer)
+{
+  cJSON * encoding = cJSON_GetObjectItem(json, "encoding");
+  if ( NULL != encoding && NULL != encoding->valuestring) {
+    _binarySubscriptions = (string(encoding->valuestring) == "binary");
+  }
+
+  cJSON * reply = cJSON_CreateObject();
+  cJSON * subscribed = cJSON_CreateArray();
+  for (const auto& name : nodes) {
+    SGPropertyNode_ptr n;
+    try {
+      n = fgGetNode(name, true);
+    }
+    catch( string & s ) {
+      SG_LOG(SG_NETWORK, SG_WARN, "httpd: subscribe '" << name << "' ignored (invalid name)");
+      continue;
+    }
+    if (!n) continue;
+
+    unsigned subId = 0;
+    for (auto& sub : _subscriptions) {
+      if (sub.node == n) {
+        // resend the current value to the client
+        sub.lastSent = PropertyValueSnapshot();
+        subId = sub.id;
+        break;
+      }
+    }
+
+    if (subId == 0) {
+      Subscription sub;
+      sub.id = subId = _nextSubscriptionId++;
+      sub.node = n;
+      _subscriptions.push_back(sub);
+    }
+
+    cJSON * entry = cJSON_CreateObject();
+    cJSON_AddItemToObject(entry, "id", cJSON_CreateNumber(subId));
+    cJSON_AddItemToObject(entry, "path", cJSON_CreateString(n->getPath(true).c_str()));
+    cJSON_AddItemToArray(subscribed, entry);
+  }
+  cJSON_AddItemToObject(reply, "subscribed", subscribed);
+
+  char * jsonString = cJSON_PrintUnformatted( reply );
+  writer.writeText( jsonString );
+  free( jsonString );
+  cJSON_Delete( reply );
+
+  SG_LOG(SG_NETWORK, SG_INFO, "httpd: subscribe " << nodes.size() << " node(s) #" << id
+         << ", " << _subscriptions.size() << " subscriptions");
+}
+
+void PropertyChangeWebsocket::handleUnsubscribeCommand(const string_list& nodes, cJSON* json)
+{
+  std::vector<unsigned> ids;
+  cJSON * jids = cJSON_GetObjectItem(json, "ids");
+  if ( NULL != jids) {
+    for (int i = 0; i < cJSON_GetArraySize(jids); i++) {
+      cJSON * jid = cJSON_GetArrayItem(jids, i);
+      if ( NULL != jid && jid->type == cJSON_Number) ids.push_back(jid->valueint);
+    }
+  }
+
+  for (auto it = _subscriptions.begin(); it != _subscriptions.end(); ) {
+    bool remove = std::find(ids.begin(), ids.end(), it->id) != ids.end();
+    if (!remove && !nodes.empty()) {
+      const string path = it->node->getPath(true);
+      remove = std::find(nodes.begin(), nodes.end(), path) != nodes.end();
+    }
+
+    if (remove) {
+      it = _subscriptions.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+static void appendUInt32(std::string& out, uint32_t v)
+{
+  char b[4];
+  for (int i = 0; i < 4; ++i) b[i] = static_cast<char>((v >> (8 * i)) & 0xff);
+  out.append(b, 4);
+}
+
+static void appendDouble(std::string& out, double d)
+{
+  uint64_t v;
+  memcpy(&v, &d, sizeof(v));
+  char b[8];
+  for (int i = 0; i < 8; ++i) b[i] = static_cast<char>((v >> (8 * i)) & 0xff);
+  out.append(b, 8);
+}
+
+void PropertyChangeWebsocket::encodeBinaryValue(unsigned subId, SGPropertyNode* node)
+{
+  appendUInt32(_frame, subId);
+  if (!node->hasValue()) {
+    _frame.push_back(0);
+    return;
+  }
+
+  switch (node->getType()) {
+    case simgear::props::BOOL:
+      _frame.push_back(1);
+      _frame.push_back(node->getBoolValue() ? 1 : 0);
+      break;
+
+    case simgear::props::INT:
+    case simgear::props::LONG:
+    case simgear::props::FLOAT:
+    case simgear::props::DOUBLE:
+      _frame.push_back(2);
+      appendDouble(_frame, node->getDoubleValue());
+      break;
+
+    default: {
+      const string s = node->getStringValue();
+      _frame.push_back(3);
+      appendUInt32(_frame, s.size());
+      _frame.append(s);
+      break;
+    }
+  }
+}
+
+void PropertyChangeWebsocket::pollSubscriptions(WebsocketWriter &writer, double now)
+{
+  if (_binarySubscriptions) {
+    _frame.clear();
+    appendDouble(_frame, now);
+    appendUInt32(_frame, 0); // patched below
+
+    uint32_t count = 0;
+    for (auto& sub : _subscriptions) {
+      if (!sub.lastSent.update(sub.node)) continue;
+      encodeBinaryValue(sub.id, sub.node);
+      ++count;
+    }
+
+    if (count > 0) {
+      for (int i = 0; i < 4; ++i) _frame[8 + i] = static_cast<char>((count >> (8 * i)) & 0xff);
+      writer.writeBinary(_frame.data(), _frame.size());
+    }
+    return;
+  }
+
+  cJSON * values = NULL;
+  for (auto& sub : _subscriptions) {
+    if (!sub.lastSent.update(sub.node)) continue;
+    if ( NULL == values) values = cJSON_CreateObject();
+    cJSON_AddItemToObject(values, std::to_string(sub.id).c_str(), JSON::valueToJson(sub.node));
+  }
+
+  if ( NULL == values) return;
+
+  cJSON * json = cJSON_CreateObject();
+  cJSON_AddItemToObject(json, "ts", cJSON_CreateNumber(now));
+  cJSON_AddItemToObject(json, "values", values);
+  char * jsonString = cJSON_PrintUnformatted( json );
+  writer.writeText( jsonString );
+  free( jsonString );
+  cJSON_Delete( json );
+}
+
 void PropertyChangeWebsocket::poll(WebsocketWriter & writer)
 {
   double now = fgGetDouble("/sim/time/elapsed-sec");
@@ -218,13 +415,17 @@ void PropertyChangeWebsocket::poll(WebsocketWriter & writer)
     _lastTrigger = now;
   }
 
+  if (!_subscriptions.empty()) {
+    pollSubscriptions(writer, now);
+  }
+
   for (WatchedNodesList::iterator it = _watchedNodes.begin(); it != _watchedNodes.end(); ++it) {
     SGPropertyNode_ptr node = *it;
 
     string newValue;
     if (_propertyChangeObserver->isChangedValue(node)) {
       string out = JSON::toJsonString( false, node, 0, now );
-      SG_LOG(SG_NETWORK, SG_DEBUG, "PropertyChangeWebsocket::poll() new Value for " << node->getPath(true) << " '" << node->getStringValue() << "' #" << id << ": " << out );
+      SG_LOG(SG_NETWORK, SG_DEBUG, "PropertyChangeWebsocket::poll() new Value for " << node->getPath(true) << " #" << id << ": " << out );
       writer.writeText( out );
     }
   }
@@ -22,8 +22,11 @@
 #define PROPERTYCHANGEWEBSOCKET_HXX_
 
 #include "Websocket.hxx"
+#include "PropertyChangeObserver.hxx"
 #include <simgear/props/props.hxx>
 
+#include <cJSON.h>
+#include <string>
 #include <vector>
 
 namespace flightgear {
@@ -44,6 +47,10 @@ private:
   PropertyChangeObserver * _propertyChangeObserver;
 
   void handleGetCommand(const string_list& nodes, WebsocketWriter &writer);
+  void handleSubscribeCommand(const string_list& nodes, cJSON* json, WebsocketWriter &writer);
+  void handleUnsubscribeCommand(const string_list& nodes, cJSON* json);
+  void pollSubscriptions(WebsocketWriter &writer, double now);
+  void encodeBinaryValue(unsigned subId, SGPropertyNode* node);
   
   class WatchedNodesList: public std::vector<SGPropertyNode_ptr> {
   public:
@@ -53,6 +60,22 @@ private:
   WatchedNodesList _watchedNodes;
   double _minTriggerInterval;
   double _lastTrigger;
+
+  /**
+   * A property watched in subscription mode. Changes are detected per
+   * client against the value last sent to it, and reported together with
+   * all other changes of the same poll in a single frame.
+   */
+  struct Subscription {
+    unsigned id;
+    SGPropertyNode_ptr node;
+    PropertyValueSnapshot lastSent;
+  };
+
+  std::vector<Subscription> _subscriptions;
+  unsigned _nextSubscriptionId;
+  bool _binarySubscriptions;
+  std::string _frame; // reused encoding buffer for binary frames
 };
 
 }
@@ -21,6 +21,11 @@
 #include "jsonprops.hxx"
 #include <simgear/misc/strutils.hxx>
 #include <simgear/math/SGMath.hxx>
+
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdio>
 namespace flightgear {
 namespace http {
 
@@ -202,6 +207,12 @@ void JSON::addChildrenToProp(cJSON * json, SGPropertyNode_ptr n)
 
 string JSON::toJsonString(bool indent, SGPropertyNode_ptr n, int depth, double timestamp )
 {
+  if( !indent ) {
+    string reply;
+    JSONPropertyWriter( n, depth, timestamp ).write( reply );
+    return reply;
+  }
+
   cJSON * json = toJson( n, depth, timestamp );
   char * jsonString = indent ? cJSON_Print( json ) : cJSON_PrintUnformatted( json );
   string reply(jsonString);
@@ -210,6 +221,154 @@ string JSON::toJsonString(bool indent, SGPropertyNode_ptr n, int depth, double t
   return reply;
 }
 
+JSONPropertyWriter::JSONPropertyWriter(SGPropertyNode_ptr n, int depth, double timestamp) :
+  _path(n->getPath(true)),
+  _timestamp(timestamp)
+{
+  Frame f;
+  f.node = n;
+  f.depth = depth;
+  f.nextChild = -1;
+  f.pathEnd = _path.size();
+  _stack.push_back(f);
+}
+
+// same escaping as cJSON's print_string_ptr()
+void JSONPropertyWriter::appendString(string & out, const char * s)
+{
+  out += '"';
+  for (const char * p = s; *p; ++p) {
+    const unsigned char c = static_cast<unsigned char>(*p);
+    if (c > 31 && c != '"' && c != '\\') {
+      out += *p;
+      continue;
+    }
+
+    out += '\\';
+    switch (c) {
+      case '\\': out += '\\'; break;
+      case '"':  out += '"';  break;
+      case '\b': out += 'b';  break;
+      case '\f': out += 'f';  break;
+      case '\n': out += 'n';  break;
+      case '\r': out += 'r';  break;
+      case '\t': out += 't';  break;
+      default: {
+        char buf[8];
+        snprintf(buf, sizeof(buf), "u%04x", c);
+        out += buf;
+        break;
+      }
+    }
+  }
+  out += '"';
+}
+
+// same formatting as cJSON's print_number()
+void JSONPropertyWriter::appendNumber(string & out, double d)
+{
+  char buf[64];
+  if (d <= INT_MAX && d >= INT_MIN && fabs(static_cast<double>(static_cast<int>(d)) - d) <= DBL_EPSILON)
+    snprintf(buf, sizeof(buf), "%d", static_cast<int>(d));
+  else if (fabs(floor(d) - d) <= DBL_EPSILON && fabs(d) < 1.0e60)
+    snprintf(buf, sizeof(buf), "%.0f", d);
+  else if (fabs(d) < 1.0e-6 || fabs(d) > 1.0e9)
+    snprintf(buf, sizeof(buf), "%e", d);
+  else
+    snprintf(buf, sizeof(buf), "%f", d);
+  out += buf;
+}
+
+void JSONPropertyWriter::writeMembers(string & out, SGPropertyNode * n)
+{
+  out += "{\"path\":";
+  appendString(out, _path.c_str());
+  out += ",\"name\":";
+  appendString(out, n->getNameString().c_str());
+  if( n->hasValue() ) {
+    out += ",\"value\":";
+    switch( n->getType() ) {
+      case simgear::props::BOOL:
+        out += n->getBoolValue() ? "true" : "false";
+        break;
+      case simgear::props::INT:
+      case simgear::props::LONG:
+      case simgear::props::FLOAT:
+      case simgear::props::DOUBLE: {
+        double val = n->getDoubleValue();
+        if( SGMiscd::isNaN(val) ) out += "null";
+        else appendNumber(out, val);
+        break;
+      }
+      default:
+        appendString(out, n->getStringValue().c_str());
+        break;
+    }
+  }
+  out += ",\"type\":";
+  appendString(out, JSON::getPropertyTypeString(n->getType()));
+  out += ",\"index\":";
+  appendNumber(out, n->getIndex());
+  if( _timestamp >= 0.0 ) {
+    out += ",\"ts\":";
+    appendNumber(out, _timestamp);
+  }
+  out += ",\"nChildren\":";
+  appendNumber(out, n->nChildren());
+}
+
+bool JSONPropertyWriter::write(string & out, size_t maxNodes)
+{
+  size_t count = 0;
+  while( !_stack.empty() ) {
+    Frame & f = _stack.back();
+
+    if( f.nextChild < 0 ) {
+      if( maxNodes > 0 && count >= maxNodes )
+        return false;
+
+      writeMembers(out, f.node);
+      ++count;
+      if( f.depth > 0 && f.node->nChildren() > 0 ) {
+        out += ",\"children\":[";
+        f.nextChild = 0;
+      } else {
+        out += '}';
+        _stack.pop_back();
+      }
+      continue;
+    }
+
+    // children may have been removed while we were suspended
+    if( f.nextChild >= f.node->nChildren() ) {
+      out += "]}";
+      _stack.pop_back();
+      continue;
+    }
+
+    if( f.nextChild > 0 )
+      out += ',';
+
+    SGPropertyNode * child = f.node->getChild(f.nextChild++);
+    _path.resize(f.pathEnd);
+    _path += '/';
+    _path += child->getNameString();
+    if( child->getIndex() != 0 ) {
+      _path += '[';
+      _path += std::to_string(child->getIndex());
+      _path += ']';
+    }
+
+    Frame c;
+    c.node = child;
+    c.depth = f.depth - 1;
+    c.nextChild = -1;
+    c.pathEnd = _path.size();
+    _stack.push_back(c); // invalidates f
+  }
+  return true;
+}
+
 }  // namespace http
 }  // namespace flightgear
 
@@ -24,6 +24,7 @@
 #include <simgear/props/props.hxx>
 #include <cJSON.h>
 #include <string>
+#include <vector>
 
 namespace flightgear {
 namespace http {
@@ -40,6 +41,46 @@ public:
   static void addChildrenToProp(cJSON * json, SGPropertyNode_ptr base);
 };
 
+/**
+ * Serialises a property subtree to compact JSON directly into a string,
+ * producing the same text as JSON::toJsonString(false, ...) without building
+ * a cJSON tree. Paths are built incrementally while walking down instead of
+ * calling getPath() for every node.
+ *
+ * The walk can be suspended after a number of nodes and resumed later, so
+ * large subtrees can be sent in chunks spread over several frames.
+ */
+class JSONPropertyWriter {
+public:
+  JSONPropertyWriter(SGPropertyNode_ptr n, int depth, double timestamp = -1.0);
+
+  /**
+   * Append the next part of the document to out.
+   * @param maxNodes maximum number of nodes to write, 0 for no limit
+   * @return true if the document is complete
+   */
+  bool write(std::string & out, size_t maxNodes = 0);
+
+  bool isComplete() const { return _stack.empty(); }
+
+  static void appendString(std::string & out, const char * s);
+  static void appendNumber(std::string & out, double d);
+
+private:
+  struct Frame {
+    SGPropertyNode_ptr node;
+    int depth;
+    int nextChild; // -1 until the node's own members have been written
+    size_t pathEnd;
+  };
+
+  void writeMembers(std::string & out, SGPropertyNode * n);
+
+  std::vector<Frame> _stack;
+  std::string _path;
+  double _timestamp;
+};
+
 }  // namespace http
 }  // namespace flightgear
 
@@ -0,0 +1,278 @@
+// propagation.cxx -- FGRadioPropagation: asynchronous radio propagation
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <config.h>
+
+#include <cmath>
+
+#include <simgear/threads/SGThread.hxx>
+
+#include <Main/fg_props.hxx>
+
+#include "propagation.hxx"
+
+
+/** Paths shorter than this many quantisation cells are sampled exactly
+*	and not cached, the endpoint error would distort them too much
+**/
+static const double MIN_CACHED_CELLS = 10.0;
+
+
+class FGRadioPropagation::WorkerThread : public SGThread
+{
+public:
+	explicit WorkerThread(FGRadioPropagation* propagation) :
+		_propagation(propagation)
+	{
+	}
+
+protected:
+	void run() override
+	{
+		for (;;) {
+			Job* job = _propagation->_jobs.pop();
+			if (!job)	// shutdown
+				break;
+			FGRadioTransmission::ITM_run(job->request);
+			_propagation->_results.push(job);
+		}
+	}
+
+private:
+	FGRadioPropagation* _propagation;
+};
+
+
+FGRadioPropagation::FGRadioPropagation() :
+	_use_counter(0),
+	_in_flight(0)
+{
+}
+
+FGRadioPropagation::~FGRadioPropagation()
+{
+	shutdown();
+}
+
+void FGRadioPropagation::init()
+{
+	_latitude_node = fgGetNode("/position/latitude-deg", true);
+	_longitude_node = fgGetNode("/position/longitude-deg", true);
+	_altitude_node = fgGetNode("/position/altitude-ft", true);
+	_heading_node = fgGetNode("/orientation/heading-deg", true);
+
+	SGPropertyNode* root = fgGetNode("/sim/radio", true);
+	_cache_size_node = root->getNode("profile-cache-size", true);
+	if (!_cache_size_node->hasValue())
+		_cache_size_node->setIntValue(64);
+	_quantization_node = root->getNode("profile-quantization-deg", true);
+	if (!_quantization_node->hasValue())
+		_quantization_node->setDoubleValue(0.005);	// about 500 meters
+	_samples_per_frame_node = root->getNode("samples-per-frame", true);
+	if (!_samples_per_frame_node->hasValue())
+		_samples_per_frame_node->setIntValue(250);
+
+	SGPropertyNode* stats = root->getNode("propagation", true);
+	_cache_hits_node = stats->getNode("cache-hits", true);
+	_cache_misses_node = stats->getNode("cache-misses", true);
+	_pending_node = stats->getNode("pending", true);
+	_cache_hits_node->setIntValue(0);
+	_cache_misses_node->setIntValue(0);
+	_pending_node->setIntValue(0);
+
+	if (root->getBoolValue("propagation-thread", true)) {
+		_worker.reset(new WorkerThread(this));
+		_worker->start();
+	}
+}
+
+void FGRadioPropagation::shutdown()
+{
+	if (_worker) {
+		_jobs.push(nullptr);
+		_worker->join();
+		_worker.reset();
+	}
+
+	// anything still queued is dropped, the receivers are not interested anymore
+	while (!_results.empty())
+		delete _results.pop();
+	for (PendingProfile& pending : _pending) {
+		for (Job* job : pending.jobs)
+			delete job;
+	}
+	_pending.clear();
+	_cache.clear();
+	_in_flight = 0;
+}
+
+void FGRadioPropagation::update(double dt)
+{
+	int samples_per_frame = _samples_per_frame_node->getIntValue();
+	unsigned budget = samples_per_frame > 0 ? samples_per_frame : 1;
+
+	while (!_pending.empty() && (budget > 0)) {
+		PendingProfile& pending = _pending.front();
+		size_t sampled = pending.profile->elevations.size();
+		bool complete = pending.profile->sample(budget);
+		budget -= (unsigned)(pending.profile->elevations.size() - sampled);
+		if (!complete)
+			break;
+
+		if (pending.cacheable && (pending.profile->missing == 0))
+			addProfile(pending.key, pending.profile);
+		for (Job* job : pending.jobs) {
+			job->request.profile = pending.profile;
+			dispatch(job);
+		}
+		_pending.pop_front();
+	}
+
+	while (!_results.empty()) {
+		Job* job = _results.pop();
+		--_in_flight;
+		job->callback(job->request);
+		delete job;
+	}
+
+	_pending_node->setIntValue(_pending.size() + _in_flight);
+}
+
+void FGRadioPropagation::submit(const FGRadioITMRequest& request, Callback callback)
+{
+	Job* job = new Job{request, callback};
+
+	ProfileKey key;
+	bool cacheable = makeKey(request, key);
+	if (cacheable) {
+		job->request.profile = findProfile(key);
+		if (job->request.profile) {
+			dispatch(job);
+			return;
+		}
+		for (PendingProfile& pending : _pending) {
+			if (pending.cacheable && (pending.key == key)) {
+				pending.jobs.push_back(job);
+				return;
+			}
+		}
+	}
+
+	_pending.push_back(PendingProfile{key, cacheable, newProfile(request, cacheable, key), {job}});
+}
+
+std::shared_ptr<const FGRadioTerrainProfile> FGRadioPropagation::getProfile(const FGRadioITMRequest& request)
+{
+	ProfileKey key;
+	bool cacheable = makeKey(request, key);
+	if (cacheable) {
+		std::shared_ptr<const FGRadioTerrainProfile> cached = findProfile(key);
+		if (cached)
+			return cached;
+	}
+
+	std::shared_ptr<FGRadioTerrainProfile> profile = newProfile(request, cacheable, key);
+	profile->sample(0);
+	if (cacheable && (profile->missing == 0))
+		addProfile(key, profile);
+	return profile;
+}
+
+void FGRadioPropagation::getOwnPosition(SGGeod& pos, double& heading) const
+{
+	pos = SGGeod::fromDegFt(_longitude_node->getDoubleValue(),
+		_latitude_node->getDoubleValue(), _altitude_node->getDoubleValue());
+	heading = _heading_node->getDoubleValue();
+}
+
+bool FGRadioPropagation::makeKey(const FGRadioITMRequest& request, ProfileKey& key) const
+{
+	double quantization = _quantization_node->getDoubleValue();
+	if (quantization <= 0.0)
+		return false;
+	if (request.distance_m < MIN_CACHED_CELLS * quantization * 60 * SG_NM_TO_METER)
+		return false;
+
+	key = ProfileKey(lround(request.own_pos.getLatitudeDeg() / quantization),
+		lround(request.own_pos.getLongitudeDeg() / quantization),
+		lround(request.sender_pos.getLatitudeDeg() / quantization),
+		lround(request.sender_pos.getLongitudeDeg() / quantization),
+		lround(request.point_distance));
+	return true;
+}
+
+std::shared_ptr<FGRadioTerrainProfile> FGRadioPropagation::newProfile(const FGRadioITMRequest& request,
+		bool cacheable, const ProfileKey& key) const
+{
+	if (!cacheable) {
+		return std::make_shared<FGRadioTerrainProfile>(request.own_pos, request.sender_pos,
+			request.point_distance);
+	}
+
+	// sample between the cell centres, so the profile fits every path in the cells
+	double quantization = _quantization_node->getDoubleValue();
+	SGGeod from = SGGeod::fromDeg(std::get<1>(key) * quantization, std::get<0>(key) * quantization);
+	SGGeod to = SGGeod::fromDeg(std::get<3>(key) * quantization, std::get<2>(key) * quantization);
+	return std::make_shared<FGRadioTerrainProfile>(from, to, request.point_distance);
+}
+
+std::shared_ptr<const FGRadioTerrainProfile> FGRadioPropagation::findProfile(const ProfileKey& key)
+{
+	auto it = _cache.find(key);
+	if (it == _cache.end()) {
+		_cache_misses_node->setIntValue(_cache_misses_node->getIntValue() + 1);
+		return std::shared_ptr<const FGRadioTerrainProfile>();
+	}
+
+	_cache_hits_node->setIntValue(_cache_hits_node->getIntValue() + 1);
+	it->second.last_used = ++_use_counter;
+	return it->second.profile;
+}
+
+void FGRadioPropagation::addProfile(const ProfileKey& key, std::shared_ptr<const FGRadioTerrainProfile> profile)
+{
+	int cache_size = _cache_size_node->getIntValue();
+	if (cache_size <= 0)
+		return;
+
+	// evict the least recently used profile, the cache is small
+	while (_cache.size() >= (size_t)cache_size) {
+		auto oldest = _cache.begin();
+		for (auto it = _cache.begin(); it != _cache.end(); ++it) {
+			if (it->second.last_used < oldest->second.last_used)
+				oldest = it;
+		}
+		_cache.erase(oldest);
+	}
+	_cache[key] = CacheEntry{profile, ++_use_counter};
+}
+
+void FGRadioPropagation::dispatch(Job* job)
+{
+	++_in_flight;
+	if (_worker) {
+		_jobs.push(job);
+	}
+	else {
+		FGRadioTransmission::ITM_run(job->request);
+		_results.push(job);
+	}
+}
+
+
+// Register the subsystem.
+SGSubsystemMgr::Registrant<FGRadioPropagation> registrantFGRadioPropagation(
+	SGSubsystemMgr::POST_FDM);
@@ -0,0 +1,123 @@
+// propagation.hxx -- FGRadioPropagation: asynchronous radio propagation
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include <simgear/props/props.hxx>
+#include <simgear/structure/subsystem_mgr.hxx>
+#include <simgear/threads/SGQueue.hxx>
+
+#include "radio.hxx"
+
+namespace FGTestApi { namespace PrivateAccessor { namespace Radio { class Accessor; } } }
+
+
+/*** Runs ITM calculations away from the frame.
+*	Terrain profiles are sampled on the main thread, a limited number of
+*	points per frame, and kept in a cache keyed by the path endpoints
+*	quantised to /sim/radio/profile-quantization-deg, so repeated
+*	transmissions from the same station reuse them. The model itself runs
+*	on a worker thread and the result is handed back from update().
+***/
+class FGRadioPropagation : public SGSubsystem
+{
+	friend class FGTestApi::PrivateAccessor::Radio::Accessor;
+
+public:
+	typedef std::function<void(const FGRadioITMRequest&)> Callback;
+
+	FGRadioPropagation();
+	virtual ~FGRadioPropagation();
+
+	// Subsystem API.
+	void init() override;
+	void shutdown() override;
+	void update(double dt) override;
+
+	// Subsystem identification.
+	static const char* staticSubsystemClassId() { return "radio-propagation"; }
+
+/*** Queue a request prepared by FGRadioTransmission::ITM_prepare()
+*	@param: request, function called from update() with the finished request
+*	@return: none
+***/
+	void submit(const FGRadioITMRequest& request, Callback callback);
+
+/*** Terrain profile for a request, from the cache or sampled right away
+*	@param: request prepared by FGRadioTransmission::ITM_prepare()
+*	@return: the complete profile
+***/
+	std::shared_ptr<const FGRadioTerrainProfile> getProfile(const FGRadioITMRequest& request);
+
+	void getOwnPosition(SGGeod& pos, double& heading) const;
+
+private:
+	class WorkerThread;
+
+	struct Job {
+		FGRadioITMRequest request;
+		Callback callback;
+	};
+
+	typedef std::tuple<long, long, long, long, long> ProfileKey;
+
+	struct CacheEntry {
+		std::shared_ptr<const FGRadioTerrainProfile> profile;
+		unsigned last_used;
+	};
+
+	struct PendingProfile {
+		ProfileKey key;
+		bool cacheable;
+		std::shared_ptr<FGRadioTerrainProfile> profile;
+		std::vector<Job*> jobs;
+	};
+
+	bool makeKey(const FGRadioITMRequest& request, ProfileKey& key) const;
+	std::shared_ptr<FGRadioTerrainProfile> newProfile(const FGRadioITMRequest& request,
+			bool cacheable, const ProfileKey& key) const;
+	std::shared_ptr<const FGRadioTerrainProfile> findProfile(const ProfileKey& key);
+	void addProfile(const ProfileKey& key, std::shared_ptr<const FGRadioTerrainProfile> profile);
+	void dispatch(Job* job);
+
+	SGPropertyNode_ptr _latitude_node;
+	SGPropertyNode_ptr _longitude_node;
+	SGPropertyNode_ptr _altitude_node;
+	SGPropertyNode_ptr _heading_node;
+
+	SGPropertyNode_ptr _cache_size_node;
+	SGPropertyNode_ptr _quantization_node;
+	SGPropertyNode_ptr _samples_per_frame_node;
+	SGPropertyNode_ptr _cache_hits_node;
+	SGPropertyNode_ptr _cache_misses_node;
+	SGPropertyNode_ptr _pending_node;
+
+	std::map<ProfileKey, CacheEntry> _cache;
+	unsigned _use_counter;
+	std::deque<PendingProfile> _pending;
+
+	std::unique_ptr<WorkerThread> _worker;
+	SGBlockingQueue<Job*> _jobs;
+	SGLockedQueue<Job*> _results;
+	unsigned _in_flight;
+};
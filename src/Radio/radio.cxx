@@ -23,8 +23,11 @@
 #include <cmath>
 
 #include <stdlib.h>
+#include <algorithm>
 #include <deque>
+#include <mutex>
 #include "radio.hxx"
+#include "propagation.hxx"
 #include <simgear/scene/material/mat.hxx>
 #include <Scenery/scenery.hxx>
 
@@ -169,130 +172,144 @@ void FGRadioTransmission::receiveATC(SGGeod tx_pos, double freq, string text, in
 		}
 		else if ( _propagation_model == 2 ) {	// Use ITM propagation model
 			
-			double signal = ITM_calculate_attenuation(tx_pos, freq, ground_to_air);
-			if (signal <= 0.0) {
+			FGRadioPropagation* propagation = globals->get_subsystem<FGRadioPropagation>();
+			if (!propagation) {
+				deliverATC(ITM_calculate_attenuation(tx_pos, freq, ground_to_air), text);
 				return;
 			}
-			if ((signal > 0.0) && (signal < 12.0)) {
-				/** for low SNR values need a way to make the conversation
-				*	hard to understand but audible
-				*	in the real world, the receiver AGC fails to capture the slope
-				*	and the signal, due to being amplitude modulated, decreases volume after demodulation
-				*	the workaround below is more akin to what would happen on a FM transmission
-				*	therefore the correct way would be to work on the volume
-				**/
-				/*
-				string hash_noise = " ";
-				int reps = (int) (fabs(floor(signal - 11.0)) * 2);
-				int t_size = text.size();
-				for (int n = 1; n <= reps; ++n) {
-					int pos = rand() % (t_size -1);
-					text.replace(pos,1, hash_noise);
-				}
-				*/
-				//double volume = (fabs(signal - 12.0) / 12);
-				//double old_volume = fgGetDouble("/sim/sound/voices/voice/volume");
-				
-				//fgSetDouble("/sim/sound/voices/voice/volume", volume);
-				fgSetString("/sim/messages/atc", text.c_str());
-				//fgSetDouble("/sim/sound/voices/voice/volume", old_volume);
-			}
-			else {
-				fgSetString("/sim/messages/atc", text.c_str());
+			
+			FGRadioITMRequest request;
+			double signal = -1.0;
+			if (!ITM_prepare(tx_pos, freq, ground_to_air, request, signal)) {
+				deliverATC(signal, text);
+				return;
 			}
+			
+			/** the caller usually discards this object right away,
+			*	so the reply is finished with a copy of our settings
+			**/
+			std::shared_ptr<FGRadioTransmission> self = std::make_shared<FGRadioTransmission>(*this);
+			propagation->submit(request, [self, text](const FGRadioITMRequest& result) {
+				deliverATC(self->ITM_finish(result), text);
+			});
+		}
+	}
+}
+
+
+void FGRadioTransmission::deliverATC(double signal, const string& text) {
+	
+	if (signal <= 0.0) {
+		return;
+	}
+	if ((signal > 0.0) && (signal < 12.0)) {
+		/** for low SNR values need a way to make the conversation
+		*	hard to understand but audible
+		*	in the real world, the receiver AGC fails to capture the slope
+		*	and the signal, due to being amplitude modulated, decreases volume after demodulation
+		*	the workaround below is more akin to what would happen on a FM transmission
+		*	therefore the correct way would be to work on the volume
+		**/
+		/*
+		string hash_noise = " ";
+		int reps = (int) (fabs(floor(signal - 11.0)) * 2);
+		int t_size = text.size();
+		for (int n = 1; n <= reps; ++n) {
+			int pos = rand() % (t_size -1);
+			text.replace(pos,1, hash_noise);
 		}
+		*/
+		//double volume = (fabs(signal - 12.0) / 12);
+		//double old_volume = fgGetDouble("/sim/sound/voices/voice/volume");
+		
+		//fgSetDouble("/sim/sound/voices/voice/volume", volume);
+		fgSetString("/sim/messages/atc", text.c_str());
+		//fgSetDouble("/sim/sound/voices/voice/volume", old_volume);
+	}
+	else {
+		fgSetString("/sim/messages/atc", text.c_str());
 	}
 }
 
 
 double FGRadioTransmission::ITM_calculate_attenuation(SGGeod pos, double freq, int transmission_type) {
 
+	FGRadioITMRequest request;
+	double signal = -1.0;
+	if (!ITM_prepare(pos, freq, transmission_type, request, signal))
+		return signal;
+	
+	FGRadioPropagation* propagation = globals->get_subsystem<FGRadioPropagation>();
+	if (propagation) {
+		request.profile = propagation->getProfile(request);
+	}
+	else {
+		std::shared_ptr<FGRadioTerrainProfile> profile = std::make_shared<FGRadioTerrainProfile>(
+			request.own_pos, request.sender_pos, request.point_distance);
+		profile->sample(0);
+		request.profile = profile;
+	}
 	
+	ITM_run(request);
+	return ITM_finish(request);
+}
+
+
+bool FGRadioTransmission::ITM_prepare(const SGGeod& pos, double freq, int transmission_type,
+		FGRadioITMRequest& request, double& signal) {
+	
+	signal = -1.0;
 	if((freq < 40.0) || (freq > 20000.0))	// frequency out of recommended range 
-		return -1;
-	/** ITM default parameters 
-		TODO: take them from tile materials (especially for sea)?
-	**/
-	double eps_dielect=15.0;
-	double sgm_conductivity = 0.005;
-	double eno = 301.0;
-	double frq_mhz = freq;
+		return false;
 	
-	int radio_climate = 5;		// continental temperate
-	int pol= _polarization;	
-	double conf = 0.90;	// 90% of situations and time, take into account speed
-	double rel = 0.90;	
+	double frq_mhz = freq;
 	double dbloss;
-	char strmode[150];
-	int p_mode = 0; // propgation mode selector: 0 LOS, 1 diffraction dominant, 2 troposcatter
-	double horizons[2];
-	int errnum;
-	
-	double clutter_loss = 0.0; 	// loss due to vegetation and urban
 	double tx_pow = _transmitter_power;
 	double ant_gain = _rx_antenna_gain + _tx_antenna_gain;
-	double signal = 0.0;
-	
-	
 	double link_budget = tx_pow - _receiver_sensitivity - _rx_line_losses - _tx_line_losses + ant_gain;	
-	double signal_strength = tx_pow - _rx_line_losses - _tx_line_losses + ant_gain;	
-	double tx_erp = dbm_to_watt(tx_pow + _tx_antenna_gain - _tx_line_losses);
-	
 
 	FGScenery * scenery = globals->get_scenery();
 	
-	double own_lat = fgGetDouble("/position/latitude-deg");
-	double own_lon = fgGetDouble("/position/longitude-deg");
-	double own_alt_ft = fgGetDouble("/position/altitude-ft");
-	double own_heading = fgGetDouble("/orientation/heading-deg");
-	double own_alt= own_alt_ft * SG_FEET_TO_METER;
-	
-	
-	
-	
-	SGGeod own_pos = SGGeod::fromDegM( own_lon, own_lat, own_alt );
-	SGGeod max_own_pos = SGGeod::fromDegM( own_lon, own_lat, SG_MAX_ELEVATION_M );
-	SGGeoc center = SGGeoc::fromGeod( max_own_pos );
+	SGGeod own_pos;
+	double own_heading = 0.0;
+	FGRadioPropagation* propagation = globals->get_subsystem<FGRadioPropagation>();
+	if (propagation) {
+		propagation->getOwnPosition(own_pos, own_heading);
+	}
+	else {
+		own_pos = SGGeod::fromDegFt( fgGetDouble("/position/longitude-deg"),
+			fgGetDouble("/position/latitude-deg"), fgGetDouble("/position/altitude-ft") );
+		own_heading = fgGetDouble("/orientation/heading-deg");
+	}
+	double own_alt = own_pos.getElevationM();
+	SGGeod max_own_pos = SGGeod::fromGeodM( own_pos, SG_MAX_ELEVATION_M );
 	SGGeoc own_pos_c = SGGeoc::fromGeod( own_pos );
 	
 	
-	double sender_alt_ft,sender_alt;
 	double transmitter_height=0.0;
 	double receiver_height=0.0;
 	SGGeod sender_pos = pos;
-	
-	sender_alt_ft = sender_pos.getElevationFt();
-	sender_alt = sender_alt_ft * SG_FEET_TO_METER;
+	double sender_alt = sender_pos.getElevationM();
 	SGGeod max_sender_pos = SGGeod::fromGeodM( pos, SG_MAX_ELEVATION_M );
 	SGGeoc sender_pos_c = SGGeoc::fromGeod( sender_pos );
 	
 	
-	double point_distance= _terrain_sampling_distance; 
 	double course = SGGeodesy::courseRad(own_pos_c, sender_pos_c);
 	double reverse_course = SGGeodesy::courseRad(sender_pos_c, own_pos_c);
 	double distance_m = SGGeodesy::distanceM(own_pos, sender_pos);
-	double probe_distance = 0.0;
 	/** If distance larger than this value (300 km), assume reception imposssible to spare CPU cycles */
 	if (distance_m > 300000)
-		return -1.0;
+		return false;
 	/** If above 8000 meters, consider LOS mode and calculate free-space att to spare CPU cycles */
 	if (own_alt > 8000) {
 		dbloss = 20 * log10(distance_m) +20 * log10(frq_mhz) -27.55;
 		SG_LOG(SG_GENERAL, SG_BULK,
 			"ITM Free-space mode:: Link budget: " << link_budget << ", Attenuation: " << dbloss << " dBm, free-space attenuation");
-		//cerr << "ITM Free-space mode:: Link budget: " << link_budget << ", Attenuation: " << dbloss << " dBm, free-space attenuation" << endl;
 		signal = link_budget - dbloss;
-		return signal;
+		return false;
 	}
 	
-		
-	int max_points = (int)floor(distance_m / point_distance);
-	//double delta_last = fmod(distance_m, point_distance);
 	
-	deque<double> elevations;
-	deque<string*> materials;
-	
-
 	double elevation_under_pilot = 0.0;
 	if (scenery->get_elevation_m( max_own_pos, elevation_under_pilot, NULL )) {
 		receiver_height = own_alt - elevation_under_pilot; 
@@ -315,95 +332,109 @@ double FGRadioTransmission::ITM_calculate_attenuation(SGGeod pos, double freq, i
 	_root_node->setDoubleValue("station[0]/tx-height", transmitter_height);
 	_root_node->setDoubleValue("station[0]/distance", distance_m / 1000);
 	
-	unsigned int e_size = (deque<unsigned>::size_type)max_points;
-	
-	while (elevations.size() <= e_size) {
-		probe_distance += point_distance;
-		SGGeod probe = SGGeod::fromGeoc(center.advanceRadM( course, probe_distance ));
-		const simgear::BVHMaterial *material = 0;
-		double elevation_m = 0.0;
-	
-		if (scenery->get_elevation_m( probe, elevation_m, &material )) {
-                        const SGMaterial *mat;
-                        mat = dynamic_cast<const SGMaterial*>(material);
-			if((transmission_type == 3) || (transmission_type == 4)) {
-				elevations.push_back(elevation_m);
-				if(mat) {
-					const std::vector<string> mat_names = mat->get_names();
-					string* name = new string(mat_names[0]);
-					materials.push_back(name);
-				}
-				else {
-					string* no_material = new string("None"); 
-					materials.push_back(no_material);
-				}
-			}
-			else {
-				 elevations.push_front(elevation_m);
-				 if(mat) {
-				 	 const std::vector<string> mat_names = mat->get_names();
-				 	 string* name = new string(mat_names[0]);
-				 	 materials.push_front(name);
-				}
-				else {
-					string* no_material = new string("None"); 
-					materials.push_front(no_material);
-				}
-			}
-		}
-		else {
-			if((transmission_type == 3) || (transmission_type == 4)) {
-				elevations.push_back(0.0);
-				string* no_material = new string("None"); 
-				materials.push_back(no_material);
-			}
-			else {
-				string* no_material = new string("None"); 
-				elevations.push_front(0.0);
-				materials.push_front(no_material);
-			}
-		}
-	}
-	if((transmission_type == 3) || (transmission_type == 4)) {
-		elevations.push_front(elevation_under_pilot);
-		//if (delta_last > (point_distance / 2) )			// only add last point if it's farther than half point_distance
-			elevations.push_back(elevation_under_sender);
-	}
-	else {
-		elevations.push_back(elevation_under_pilot);
-		//if (delta_last > (point_distance / 2) )
-			elevations.push_front(elevation_under_sender);
-	}
-	
-	
-	double num_points= (double)elevations.size();
-
+	request.freq = frq_mhz;
+	request.transmission_type = transmission_type;
+	request.polarization = _polarization;
+	request.use_clutter = _root_node->getBoolValue( "use-clutter-attenuation", false );
+	request.own_pos = own_pos;
+	request.sender_pos = sender_pos;
+	request.point_distance = _terrain_sampling_distance;
+	request.transmitter_height = transmitter_height;
+	request.receiver_height = receiver_height;
+	request.elevation_under_pilot = elevation_under_pilot;
+	request.elevation_under_sender = elevation_under_sender;
+	request.distance_m = distance_m;
+	request.course = course;
+	request.reverse_course = reverse_course;
+	request.own_heading = own_heading;
+	return true;
+}
 
-	elevations.push_front(point_distance);
-	elevations.push_front(num_points -1);
 
-	int size = elevations.size();
-    std::vector<double> itm_elev(size);
+/** the ITM code keeps its state in function statics, one calculation at a time */
+static std::mutex itm_mutex;
 
-	for(int i=0;i<size;i++) {
-		itm_elev[i]=elevations[i];
-	}
+void FGRadioTransmission::ITM_run(FGRadioITMRequest& request) {
 	
-	if((transmission_type == 3) || (transmission_type == 4)) {
-		// the sender and receiver roles are switched
-		ITM::point_to_point(itm_elev.data(), receiver_height, transmitter_height,
-			eps_dielect, sgm_conductivity, eno, frq_mhz, radio_climate,
-			pol, conf, rel, dbloss, strmode, p_mode, horizons, errnum);
-		if( _root_node->getBoolValue( "use-clutter-attenuation", false ) )
-			calculate_clutter_loss(frq_mhz, itm_elev.data(), materials, receiver_height, transmitter_height, p_mode, horizons, clutter_loss);
+	/** ITM default parameters 
+		TODO: take them from tile materials (especially for sea)?
+	**/
+	double eps_dielect=15.0;
+	double sgm_conductivity = 0.005;
+	double eno = 301.0;
+	double frq_mhz = request.freq;
+	
+	int radio_climate = 5;		// continental temperate
+	int pol= request.polarization;	
+	double conf = 0.90;	// 90% of situations and time, take into account speed
+	double rel = 0.90;	
+	double dbloss = 0.0;
+	char strmode[150];
+	int p_mode = 0; // propgation mode selector: 0 LOS, 1 diffraction dominant, 2 troposcatter
+	double horizons[2];
+	int errnum = 0;
+	double clutter_loss = 0.0; 	// loss due to vegetation and urban
+	
+	const FGRadioTerrainProfile& profile = *request.profile;
+	bool pilot_to_sender = (request.transmission_type == 3) || (request.transmission_type == 4);
+	
+	/** the profile runs from the pilot towards the sender, ITM wants it from the transmitter
+	*	except for transmissions from the pilot, where the sender and receiver roles are switched
+	**/
+	size_t num_samples = profile.elevations.size();
+	std::vector<double> itm_elev(num_samples + 4);
+	itm_elev[0] = (double)(num_samples + 1);
+	itm_elev[1] = profile.point_distance;
+	std::vector<string> reversed_materials;
+	const std::vector<string>* materials = &profile.materials;
+	if (pilot_to_sender) {
+		itm_elev[2] = request.elevation_under_pilot;
+		std::copy(profile.elevations.begin(), profile.elevations.end(), itm_elev.begin() + 3);
+		itm_elev[num_samples + 3] = request.elevation_under_sender;
 	}
 	else {
-		ITM::point_to_point(itm_elev.data(), transmitter_height, receiver_height,
+		itm_elev[2] = request.elevation_under_sender;
+		std::copy(profile.elevations.rbegin(), profile.elevations.rend(), itm_elev.begin() + 3);
+		itm_elev[num_samples + 3] = request.elevation_under_pilot;
+		if (request.use_clutter) {
+			reversed_materials.assign(profile.materials.rbegin(), profile.materials.rend());
+			materials = &reversed_materials;
+		}
+	}
+	
+	double tx_height = pilot_to_sender ? request.receiver_height : request.transmitter_height;
+	double rx_height = pilot_to_sender ? request.transmitter_height : request.receiver_height;
+	{
+		std::lock_guard<std::mutex> g(itm_mutex);
+		ITM::point_to_point(itm_elev.data(), tx_height, rx_height,
 			eps_dielect, sgm_conductivity, eno, frq_mhz, radio_climate,
 			pol, conf, rel, dbloss, strmode, p_mode, horizons, errnum);
-		if( _root_node->getBoolValue( "use-clutter-attenuation", false ) )
-			calculate_clutter_loss(frq_mhz, itm_elev.data(), materials, transmitter_height, receiver_height, p_mode, horizons, clutter_loss);
 	}
+	if (request.use_clutter)
+		calculate_clutter_loss(frq_mhz, itm_elev.data(), *materials, tx_height, rx_height, p_mode, horizons, clutter_loss);
+	
+	request.dbloss = dbloss;
+	request.clutter_loss = clutter_loss;
+	request.prop_mode = strmode;
+	request.p_mode = p_mode;
+	request.errnum = errnum;
+}
+
+
+double FGRadioTransmission::ITM_finish(const FGRadioITMRequest& request) {
+	
+	double tx_pow = _transmitter_power;
+	double ant_gain = _rx_antenna_gain + _tx_antenna_gain;
+	double signal = 0.0;
+	double dbloss = request.dbloss;
+	double clutter_loss = request.clutter_loss;
+	double transmitter_height = request.transmitter_height;
+	double receiver_height = request.receiver_height;
+	double distance_m = request.distance_m;
+	
+	double link_budget = tx_pow - _receiver_sensitivity - _rx_line_losses - _tx_line_losses + ant_gain;	
+	double signal_strength = tx_pow - _rx_line_losses - _tx_line_losses + ant_gain;	
+	double tx_erp = dbm_to_watt(tx_pow + _tx_antenna_gain - _tx_line_losses);
 	
 	double pol_loss = 0.0;
 	// TODO: remove this check after we check a bit the axis calculations in this function
@@ -411,23 +442,27 @@ double FGRadioTransmission::ITM_calculate_attenuation(SGGeod pos, double freq, i
 		pol_loss = polarization_loss();
 	}
 	//SG_LOG(SG_GENERAL, SG_BULK,
-	//		"ITM:: Link budget: " << link_budget << ", Attenuation: " << dbloss << " dBm, " << strmode << ", Error: " << errnum);
-	//cerr << "ITM:: Link budget: " << link_budget << ", Attenuation: " << dbloss << " dBm, " << strmode << ", Error: " << errnum << endl;
+	//		"ITM:: Link budget: " << link_budget << ", Attenuation: " << dbloss << " dBm, " << request.prop_mode << ", Error: " << request.errnum);
 	_root_node->setDoubleValue("station[0]/link-budget", link_budget);
 	_root_node->setDoubleValue("station[0]/terrain-attenuation", dbloss);
-	_root_node->setStringValue("station[0]/prop-mode", strmode);
+	_root_node->setStringValue("station[0]/prop-mode", request.prop_mode);
 	_root_node->setDoubleValue("station[0]/clutter-attenuation", clutter_loss);
 	_root_node->setDoubleValue("station[0]/polarization-attenuation", pol_loss);
-	//if (errnum == 4)	// if parameters are outside sane values for lrprop, bail out fast
+	//if (request.errnum == 4)	// if parameters are outside sane values for lrprop, bail out fast
 	//	return -1;
 	
+	// first and last points of the ITM elevation profile
+	bool pilot_to_sender = (request.transmission_type == 3) || (request.transmission_type == 4);
+	double first_elev = pilot_to_sender ? request.elevation_under_pilot : request.elevation_under_sender;
+	double last_elev = pilot_to_sender ? request.elevation_under_sender : request.elevation_under_pilot;
+	
 	// temporary, keep this antenna radiation pattern code here
 	double tx_pattern_gain = 0.0;
 	double rx_pattern_gain = 0.0;
 	double sender_heading = 270.0; // due West
-	double tx_antenna_bearing = sender_heading - reverse_course * SGD_RADIANS_TO_DEGREES;
-	double rx_antenna_bearing = own_heading - course * SGD_RADIANS_TO_DEGREES;
-	double rx_elev_angle = atan((itm_elev[2] + transmitter_height - itm_elev[(int)itm_elev[0] + 2] + receiver_height) / distance_m) * SGD_RADIANS_TO_DEGREES;
+	double tx_antenna_bearing = sender_heading - request.reverse_course * SGD_RADIANS_TO_DEGREES;
+	double rx_antenna_bearing = request.own_heading - request.course * SGD_RADIANS_TO_DEGREES;
+	double rx_elev_angle = atan((first_elev + transmitter_height - last_elev + receiver_height) / distance_m) * SGD_RADIANS_TO_DEGREES;
 	double tx_elev_angle = 0.0 - rx_elev_angle;
 	if (_root_node->getBoolValue("use-tx-antenna-pattern", false)) {
 		FGRadioAntenna* TX_antenna;
@@ -440,7 +475,7 @@ double FGRadioTransmission::ITM_calculate_attenuation(SGGeod pos, double freq, i
 	if (_root_node->getBoolValue("use-rx-antenna-pattern", false)) {
 		FGRadioAntenna* RX_antenna;
 		RX_antenna = new FGRadioAntenna("Plot2");
-		RX_antenna->set_heading(own_heading);
+		RX_antenna->set_heading(request.own_heading);
 		RX_antenna->set_elevation_angle(fgGetDouble("/orientation/pitch-deg"));
 		rx_pattern_gain = RX_antenna->calculate_gain(rx_antenna_bearing, rx_elev_angle);
 		delete RX_antenna;
@@ -456,17 +491,58 @@ double FGRadioTransmission::ITM_calculate_attenuation(SGGeod pos, double freq, i
 
 	//_root_node->setDoubleValue("station[0]/tx-pattern-gain", tx_pattern_gain);
 	//_root_node->setDoubleValue("station[0]/rx-pattern-gain", rx_pattern_gain);
-
-	for (unsigned i =0; i < materials.size(); i++) {
-		delete materials[i];
-	}
 	
 	return signal;
 
 }
 
 
-void FGRadioTransmission::calculate_clutter_loss(double freq, double itm_elev[], deque<string*> &materials,
+FGRadioTerrainProfile::FGRadioTerrainProfile(const SGGeod& from, const SGGeod& to, double sampling_distance) :
+	point_distance(sampling_distance),
+	missing(0),
+	_start(SGGeoc::fromGeod( SGGeod::fromGeodM( from, SG_MAX_ELEVATION_M ) )),
+	_course(SGGeodesy::courseRad(SGGeoc::fromGeod(from), SGGeoc::fromGeod(to))),
+	_num_samples((unsigned)floor(SGGeodesy::distanceM(from, to) / sampling_distance) + 1)
+{
+	elevations.reserve(_num_samples);
+	materials.reserve(_num_samples);
+}
+
+
+bool FGRadioTerrainProfile::sample(unsigned max_samples) {
+	
+	FGScenery * scenery = globals->get_scenery();
+	unsigned sampled = 0;
+	
+	while (!complete() && ((max_samples == 0) || (sampled < max_samples))) {
+		double probe_distance = (elevations.size() + 1) * point_distance;
+		SGGeod probe = SGGeod::fromGeoc(_start.advanceRadM( _course, probe_distance ));
+		const simgear::BVHMaterial *material = 0;
+		double elevation_m = 0.0;
+		
+		if (scenery && scenery->get_elevation_m( probe, elevation_m, &material )) {
+			const SGMaterial *mat = dynamic_cast<const SGMaterial*>(material);
+			elevations.push_back(elevation_m);
+			if (mat) {
+				materials.push_back(mat->get_names()[0]);
+			}
+			else {
+				materials.push_back("None");
+			}
+		}
+		else {
+			// terrain not loaded (yet), such a profile is not worth keeping
+			elevations.push_back(0.0);
+			materials.push_back("None");
+			++missing;
+		}
+		++sampled;
+	}
+	return complete();
+}
+
+
+void FGRadioTransmission::calculate_clutter_loss(double freq, double itm_elev[], const std::vector<string> &materials,
 	double transmitter_height, double receiver_height, int p_mode,
 	double horizons[], double &clutter_loss) {
 	
@@ -804,110 +880,107 @@ void FGRadioTransmission::calculate_clutter_loss(double freq, double itm_elev[],
 }
 
 
-void FGRadioTransmission::get_material_properties(string* mat_name, double &height, double &density) {
-	
-	if(!mat_name)
-		return;
+void FGRadioTransmission::get_material_properties(const string& mat_name, double &height, double &density) {
 	
-	if(*mat_name == "Landmass") {
+	if(mat_name == "Landmass") {
 		height = 15.0;
 		density = 0.2;
 	}
 
-	else if(*mat_name == "SomeSort") {
+	else if(mat_name == "SomeSort") {
 		height = 15.0;
 		density = 0.2;
 	}
 
-	else if(*mat_name == "Island") {
+	else if(mat_name == "Island") {
 		height = 15.0;
 		density = 0.2;
 	}
-	else if(*mat_name == "Default") {
+	else if(mat_name == "Default") {
 		height = 15.0;
 		density = 0.2;
 	}
-	else if(*mat_name == "EvergreenBroadCover") {
+	else if(mat_name == "EvergreenBroadCover") {
 		height = 20.0;
 		density = 0.2;
 	}
-	else if(*mat_name == "EvergreenForest") {
+	else if(mat_name == "EvergreenForest") {
 		height = 20.0;
 		density = 0.2;
 	}
-	else if(*mat_name == "DeciduousBroadCover") {
+	else if(mat_name == "DeciduousBroadCover") {
 		height = 15.0;
 		density = 0.3;
 	}
-	else if(*mat_name == "DeciduousForest") {
+	else if(mat_name == "DeciduousForest") {
 		height = 15.0;
 		density = 0.3;
 	}
-	else if(*mat_name == "MixedForestCover") {
+	else if(mat_name == "MixedForestCover") {
 		height = 20.0;
 		density = 0.25;
 	}
-	else if(*mat_name == "MixedForest") {
+	else if(mat_name == "MixedForest") {
 		height = 15.0;
 		density = 0.25;
 	}
-	else if(*mat_name == "RainForest") {
+	else if(mat_name == "RainForest") {
 		height = 25.0;
 		density = 0.55;
 	}
-	else if(*mat_name == "EvergreenNeedleCover") {
+	else if(mat_name == "EvergreenNeedleCover") {
 		height = 15.0;
 		density = 0.2;
 	}
-	else if(*mat_name == "WoodedTundraCover") {
+	else if(mat_name == "WoodedTundraCover") {
 		height = 5.0;
 		density = 0.15;
 	}
-	else if(*mat_name == "DeciduousNeedleCover") {
+	else if(mat_name == "DeciduousNeedleCover") {
 		height = 5.0;
 		density = 0.2;
 	}
-	else if(*mat_name == "ScrubCover") {
+	else if(mat_name == "ScrubCover") {
 		height = 3.0;
 		density = 0.15;
 	}
-	else if(*mat_name == "BuiltUpCover") {
+	else if(mat_name == "BuiltUpCover") {
 		height = 30.0;
 		density = 0.7;
 	}
-	else if(*mat_name == "Urban") {
+	else if(mat_name == "Urban") {
 		height = 30.0;
 		density = 0.7;
 	}
-	else if(*mat_name == "Construction") {
+	else if(mat_name == "Construction") {
 		height = 30.0;
 		density = 0.7;
 	}
-	else if(*mat_name == "Industrial") {
+	else if(mat_name == "Industrial") {
 		height = 30.0;
 		density = 0.7;
 	}
-	else if(*mat_name == "Port") {
+	else if(mat_name == "Port") {
 		height = 30.0;
 		density = 0.7;
 	}
-	else if(*mat_name == "Town") {
+	else if(mat_name == "Town") {
 		height = 10.0;
 		density = 0.5;
 	}
-	else if(*mat_name == "SubUrban") {
+	else if(mat_name == "SubUrban") {
 		height = 10.0;
 		density = 0.5;
 	}
-	else if(*mat_name == "CropWoodCover") {
+	else if(mat_name == "CropWoodCover") {
 		height = 10.0;
 		density = 0.1;
 	}
-	else if(*mat_name == "CropWood") {
+	else if(mat_name == "CropWood") {
 		height = 10.0;
 		density = 0.1;
 	}
-	else if(*mat_name == "AgroForest") {
+	else if(mat_name == "AgroForest") {
 		height = 10.0;
 		density = 0.1;
 	}
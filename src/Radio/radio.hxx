@@ -25,6 +25,8 @@
 #include <simgear/compiler.h>
 #include <simgear/structure/subsystem_mgr.hxx>
 #include <deque>
+#include <memory>
+#include <vector>
 #include <Main/fg_props.hxx>
 
 #include <simgear/math/sg_geodesy.hxx>
@@ -32,6 +34,67 @@
 #include "antenna.hxx"
 
 
+/*** Terrain along a propagation path, sampled every point_distance meters
+*	from the receiver towards the transmitter. The ground under both ends
+*	is not part of the profile, so a profile can be shared by all stations
+*	whose endpoints quantise to the same cells.
+*	Sampling queries the scene graph and must happen on the main thread.
+***/
+class FGRadioTerrainProfile
+{
+public:
+	FGRadioTerrainProfile(const SGGeod& from, const SGGeod& to, double sampling_distance);
+
+/***	Sample at most max_samples further points
+*	@param: sample budget, 0 for no limit
+*	@return: true once the whole profile has been sampled
+***/
+	bool sample(unsigned max_samples);
+	bool complete() const { return elevations.size() >= _num_samples; }
+
+	double point_distance;
+	std::vector<double> elevations;
+	std::vector<std::string> materials;
+	unsigned missing;	/// samples where no terrain was loaded
+
+private:
+	SGGeoc _start;
+	double _course;
+	unsigned _num_samples;
+};
+
+
+/*** Inputs and outputs of one ITM calculation. Everything is captured on the
+*	main thread, so that the model itself can run on the propagation worker.
+***/
+struct FGRadioITMRequest
+{
+	double freq = 0.0;
+	int transmission_type = 0;
+	int polarization = 1;
+	bool use_clutter = false;
+	SGGeod own_pos;
+	SGGeod sender_pos;
+	double point_distance = 0.0;
+	double transmitter_height = 0.0;
+	double receiver_height = 0.0;
+	double elevation_under_pilot = 0.0;
+	double elevation_under_sender = 0.0;
+	double distance_m = 0.0;
+	double course = 0.0;
+	double reverse_course = 0.0;
+	double own_heading = 0.0;
+	std::shared_ptr<const FGRadioTerrainProfile> profile;
+
+	// filled in by FGRadioTransmission::ITM_run()
+	double dbloss = 0.0;
+	double clutter_loss = 0.0;
+	std::string prop_mode;
+	int p_mode = 0;
+	int errnum = 0;
+};
+
+
 class FGRadioTransmission 
 {
 private:
@@ -60,6 +123,9 @@ private:
 *	@return: signal level above receiver treshhold sensitivity
 ***/
 	double ITM_calculate_attenuation(SGGeod tx_pos, double freq, int ground_to_air);
+
+/*** Display an ATC message if the signal is strong enough ***/
+	static void deliverATC(double signal, const std::string& text);
 	
 /*** a simple alternative LOS propagation model (WIP)
 *	@param: transmitter position, frequency, flag to indicate if the transmission is from a ground station
@@ -73,7 +139,7 @@ private:
 *	@param: frequency, elevation data, terrain type, horizon distances, calculated loss
 *	@return: none
 ***/
-	void calculate_clutter_loss(double freq, double itm_elev[], std::deque<std::string*> &materials,
+	static void calculate_clutter_loss(double freq, double itm_elev[], const std::vector<std::string> &materials,
 			double transmitter_height, double receiver_height, int p_mode,
 			double horizons[], double &clutter_loss);
 	
@@ -81,7 +147,7 @@ private:
 *		@param: terrain type, median clutter height, radiowave attenuation factor
 *		@return: none
 ***/
-	void get_material_properties(std::string* mat_name, double &height, double &density);
+	static void get_material_properties(const std::string& mat_name, double &height, double &density);
 	
 	
 public:
@@ -110,6 +176,20 @@ public:
     static double dbm_to_watt(double dbm);
     static double dbm_to_microvolt(double dbm);
     
+/*** The three stages of ITM_calculate_attenuation, so that the
+*	model can run away from the main thread
+*	ITM_prepare: read own position and the ground under both ends (main thread)
+*	@return: false if no model run is needed, signal then holds the result
+*	ITM_run: run the Longley-Rice model on the request profile (any thread)
+*	ITM_finish: apply aircraft attitude and antenna patterns, publish
+*	the station[0] properties (main thread)
+*	@return: signal level above receiver treshhold sensitivity
+***/
+    bool ITM_prepare(const SGGeod& tx_pos, double freq, int ground_to_air,
+    		FGRadioITMRequest& request, double& signal);
+    static void ITM_run(FGRadioITMRequest& request);
+    double ITM_finish(const FGRadioITMRequest& request);
+    
     
 /*** Receive ATC radio communication as text
 *	transmission_type: 0 for air to ground 1 for ground to air, 2 for air to air, 3 for pilot to ground, 4 for pilot to air
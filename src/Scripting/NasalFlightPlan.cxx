@@ -2036,7 +2036,7 @@ static naRef f_leg_courseAndDistanceFrom(naContext c, naRef me, int argc, naRef*
     SGGeod pos;
     geodFromArgs(args, 0, argc, pos);
 
-    RoutePath path(leg->owner());
+    const RoutePath& path(leg->owner()->routePath());
     SGGeod    wpPos = path.positionForIndex(leg->index());
     double    courseDeg, az2, distanceM;
     SGGeodesy::inverse(pos, wpPos, courseDeg, az2, distanceM);
@@ -2054,7 +2054,7 @@ static naRef f_leg_path(naContext c, naRef me, int argc, naRef* args)
         naRuntimeError(c, "leg.setAltitude called on non-flightplan-leg object");
     }
 
-    RoutePath path(leg->owner());
+    const RoutePath& path(leg->owner()->routePath());
     SGGeodVec gv(path.pathForIndex(leg->index()));
 
     naRef result = naNewVector(c);
@@ -27,6 +27,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <map>
 
 #include <simgear/structure/exception.hxx>
 #include <simgear/misc/sg_path.hxx>
@@ -420,8 +421,15 @@ void FGElectricalSystem::init () {
 
     if ( !enabled ) {
         _amps_out->setDoubleValue(0);
+        return;
     }
 
+    _alternator_amps = fgGetNode("/systems/electrical/suppliers/alternator", true);
+    _master_bat = fgGetNode("/controls/engines/engine[0]/master-bat", true);
+    _master_alt = fgGetNode("/controls/engines/engine[0]/master-alt", true);
+    _engine_rpm = fgGetNode("/engines/engine[0]/rpm", true);
+    _beacon_switch = fgGetNode("/controls/switches/flashing-beacon", true);
+    _nav_lights_switch = fgGetNode("/controls/switches/nav-lights", true);
 }
 
 
@@ -436,6 +444,12 @@ void FGElectricalSystem::unbind ()
     _serviceable_node.reset();
     _volts_out.reset();
     _amps_out.reset();
+    _alternator_amps.reset();
+    _master_bat.reset();
+    _master_alt.reset();
+    _engine_rpm.reset();
+    _beacon_switch.reset();
+    _nav_lights_switch.reset();
 }
 
 void FGElectricalSystem::deleteComponents(comp_list& comps)
@@ -454,6 +468,12 @@ void FGElectricalSystem::shutdown()
     deleteComponents(buses);
     deleteComponents(outputs);
     deleteComponents(connectors);
+
+    _compiled.clear();
+    _edges.clear();
+    _supplier_order.clear();
+    _stack.clear();
+    enabled = false;
 }
 
 void FGElectricalSystem::update (double dt)
@@ -464,102 +484,49 @@ void FGElectricalSystem::update (double dt)
 
     // cout << "Updating electrical system, dt = " << dt << endl;
     _serviceable = _serviceable_node->getBoolValue();
-    
-    unsigned int i;
 
     // zero out the voltage before we start, but don't clear the
     // requested load values.
-    for ( i = 0; i < suppliers.size(); ++i ) {
-        suppliers[i]->set_volts( 0.0 );
-    }
-    for ( i = 0; i < buses.size(); ++i ) {
-        buses[i]->set_volts( 0.0 );
-    }
-    for ( i = 0; i < outputs.size(); ++i ) {
-        outputs[i]->set_volts( 0.0 );
-    }
-    for ( i = 0; i < connectors.size(); ++i ) {
-        connectors[i]->set_volts( 0.0 );
-    }
-
-    // for each "external" supplier, propagate the electrical current
-    for ( i = 0; i < suppliers.size(); ++i ) {
-        FGElectricalSupplier *node = (FGElectricalSupplier *)suppliers[i];
-        if ( node->get_model() == FGElectricalSupplier::FG_EXTERNAL ) {
-            float load;
-            // cout << "Starting propagation: " << suppliers[i]->get_name()
-            //      << endl;
-            load = propagate( suppliers[i], dt,
-                              node->get_output_volts(),
-                              node->get_output_amps(),
-                              " " );
-
-            if ( node->apply_load( load, dt ) < 0.0 ) {
-                SG_LOG(SG_SYSTEMS, SG_ALERT,
-                       "Error drawing more current than available!");
-            }
-        }
-    }
-
-    // for each "alternator" supplier, propagate the electrical
-    // current
-    for ( i = 0; i < suppliers.size(); ++i ) {
-        FGElectricalSupplier *node = (FGElectricalSupplier *)suppliers[i];
-        if ( node->get_model() == FGElectricalSupplier::FG_ALTERNATOR) {
-            float load;
-            // cout << "Starting propagation: " << suppliers[i]->get_name()
-            //      << endl;
-            load = propagate( suppliers[i], dt,
-                              node->get_output_volts(),
-                              node->get_output_amps(),
-                              " " );
-
-            if ( node->apply_load( load, dt ) < 0.0 ) {
-                SG_LOG(SG_SYSTEMS, SG_ALERT,
-                       "Error drawing more current than available!");
-            }
-        }
-    }
-
-    // for each "battery" supplier, propagate the electrical
-    // current
-    for ( i = 0; i < suppliers.size(); ++i ) {
-        FGElectricalSupplier *node = (FGElectricalSupplier *)suppliers[i];
-        if ( node->get_model() == FGElectricalSupplier::FG_BATTERY ) {
-            float load;
-            // cout << "Starting propagation: " << suppliers[i]->get_name()
-            //      << endl;
-            load = propagate( suppliers[i], dt,
-                              node->get_output_volts(),
-                              node->get_output_amps(),
-                              " " );
-            // cout << "battery load = " << load << endl;
-
-            if ( node->apply_load( load, dt ) < 0.0 ) {
-                SG_LOG(SG_SYSTEMS, SG_ALERT,
-                       "Error drawing more current than available!");
-            }
+    for ( const auto& c : _compiled ) {
+        c.component->set_volts( 0.0 );
+    }
+
+    // propagate the electrical current from each "external", then each
+    // "alternator" and finally each "battery" supplier
+    for ( unsigned int index : _supplier_order ) {
+        FGElectricalSupplier *node = _compiled[index].supplier;
+        float load;
+        // cout << "Starting propagation: " << node->get_name() << endl;
+        load = propagate( index, dt,
+                          node->get_output_volts(),
+                          node->get_output_amps() );
+
+        if ( node->apply_load( load, dt ) < 0.0 ) {
+            SG_LOG(SG_SYSTEMS, SG_ALERT,
+                   "Error drawing more current than available!");
         }
     }
 
-    float alt_norm
-        = fgGetFloat("/systems/electrical/suppliers/alternator") / 60.0;
+    float alt_norm = _alternator_amps->getFloatValue() / 60.0;
+    const bool master_bat = _master_bat->getBoolValue();
+    const bool master_alt = _master_alt->getBoolValue();
+    const float rpm = _engine_rpm->getFloatValue();
 
     // impliment an extremely simplistic voltage model (assumes
     // certain naming conventions in electrical system config)
     // FIXME: we probably want to be able to feed power from all
     // engines if they are running and the master-alt is switched on
     float volts = 0.0;
-    if ( fgGetBool("/controls/engines/engine[0]/master-bat") ) {
+    if ( master_bat ) {
         volts = 24.0;
     }
-    if ( fgGetBool("/controls/engines/engine[0]/master-alt") ) {
-        if ( fgGetFloat("/engines/engine[0]/rpm") > 800 ) {
+    if ( master_alt ) {
+        if ( rpm > 800 ) {
             float alt_contrib = 28.0;
             if ( alt_contrib > volts ) {
                 volts = alt_contrib;
             }
-        } else if ( fgGetFloat("/engines/engine[0]/rpm") > 200 ) {
+        } else if ( rpm > 200 ) {
             float alt_contrib = 20.0;
             if ( alt_contrib > volts ) {
                 volts = alt_contrib;
@@ -572,17 +539,15 @@ void FGElectricalSystem::update (double dt)
     // naming conventions in the electrical system config) ... FIXME:
     // make this more generic
     float amps = 0.0;
-    if ( fgGetBool("/controls/engines/engine[0]/master-bat") ) {
-        if ( fgGetBool("/controls/engines/engine[0]/master-alt") &&
-             fgGetFloat("/engines/engine[0]/rpm") > 800 )
-        {
+    if ( master_bat ) {
+        if ( master_alt && rpm > 800 ) {
             amps += 40.0 * alt_norm;
         }
         amps -= 15.0;            // normal load
-        if ( fgGetBool("/controls/switches/flashing-beacon") ) {
+        if ( _beacon_switch->getBoolValue() ) {
             amps -= 7.5;
         }
-        if ( fgGetBool("/controls/switches/nav-lights") ) {
+        if ( _nav_lights_switch->getBoolValue() ) {
             amps -= 7.5;
         }
         if ( amps > 7.0 ) {
@@ -625,102 +590,173 @@ bool FGElectricalSystem::build (SGPropertyNode* config_props) {
         }
     }
 
+    compile();
     return true;
 }
 
 
-// propagate the electrical current through the network, returns the
-// total current drawn by the children of this node.
-float FGElectricalSystem::propagate( FGElectricalComponent *node, double dt,
-                                     float input_volts, float input_amps,
-                                     string s ) {
-    s += " ";
+// flatten the component graph built from the configuration into index
+// arrays.  Connections are kept in the order they were made, so the
+// propagation visits components in the same order as walking the
+// component objects would.
+void FGElectricalSystem::compile() {
+    _compiled.clear();
+    _edges.clear();
+    _supplier_order.clear();
+
+    std::map<FGElectricalComponent *, unsigned int> index_of;
+    auto add = [this, &index_of]( const comp_list& comps ) {
+        for ( FGElectricalComponent *c : comps ) {
+            index_of[c] = _compiled.size();
+            CompiledComponent cc;
+            cc.component = c;
+            cc.kind = c->get_kind();
+            cc.supplier = cc.kind == FGElectricalComponent::FG_SUPPLIER
+                ? static_cast<FGElectricalSupplier *>(c) : nullptr;
+            cc.connector = cc.kind == FGElectricalComponent::FG_CONNECTOR
+                ? static_cast<FGElectricalConnector *>(c) : nullptr;
+            cc.first_edge = 0;
+            cc.num_edges = 0;
+            _compiled.push_back( cc );
+        }
+    };
+    add( suppliers );
+    add( buses );
+    add( outputs );
+    add( connectors );
+
+    for ( auto& cc : _compiled ) {
+        cc.first_edge = _edges.size();
+        for ( int i = 0; i < cc.component->get_num_outputs(); ++i ) {
+            _edges.push_back( index_of[cc.component->get_output(i)] );
+        }
+        cc.num_edges = _edges.size() - cc.first_edge;
+    }
+
+    const FGElectricalSupplier::FGSupplierType order[] = {
+        FGElectricalSupplier::FG_EXTERNAL,
+        FGElectricalSupplier::FG_ALTERNATOR,
+        FGElectricalSupplier::FG_BATTERY
+    };
+    for ( auto model : order ) {
+        for ( unsigned int i = 0; i < suppliers.size(); ++i ) {
+            if ( _compiled[i].supplier->get_model() == model ) {
+                _supplier_order.push_back( i );
+            }
+        }
+    }
 
+    // a component is only ever on the stack once per propagation (it is
+    // only entered again with a higher voltage), so this is the deepest
+    // the propagation can get
+    _stack.resize( _compiled.size() );
+}
+
+
+// start propagating into a component: works out the voltage it passes
+// on, and if that is higher than what it already has, pushes it onto the
+// propagation stack.  Otherwise load is set to the current it draws.
+bool FGElectricalSystem::enter( unsigned int index, double dt,
+                                float input_volts, float input_amps,
+                                float& load, unsigned int& depth ) {
+    const CompiledComponent& cc = _compiled[index];
     float total_load = 0.0;
 
     // determine the current to carry forward
     float volts = 0.0;
-    if ( !_serviceable) {
+    if ( !_serviceable ) {
         volts = 0;
-    } else if ( node->get_kind() == FGElectricalComponent::FG_SUPPLIER ) {
-        // cout << s << "is a supplier (" << node->get_name() << ")" << endl;
-        FGElectricalSupplier *supplier = (FGElectricalSupplier *)node;
+    } else if ( cc.kind == FGElectricalComponent::FG_SUPPLIER ) {
+        FGElectricalSupplier *supplier = cc.supplier;
         if ( supplier->get_model() == FGElectricalSupplier::FG_BATTERY ) {
-            // cout << s << " (and is a battery)" << endl;
             float battery_volts = supplier->get_output_volts();
             if ( battery_volts < (input_volts - 0.1) ) {
                 // special handling of a battery charge condition
-                // cout << s << "  (and is being charged) in v = "
-                //      << input_volts << " current v = " << battery_volts
-                //      << endl;
                 supplier->apply_load( -supplier->get_charge_amps(), dt );
-                return supplier->get_charge_amps();
+                load = supplier->get_charge_amps();
+                return false;
             }
         }
         volts = input_volts;
-    } else if ( node->get_kind() == FGElectricalComponent::FG_BUS ) {
-        // cout << s << "is a bus (" << node->get_name() << ")" << endl;
+    } else if ( cc.kind == FGElectricalComponent::FG_BUS ) {
         volts = input_volts;
-    } else if ( node->get_kind() == FGElectricalComponent::FG_OUTPUT ) {
-        // cout << s << "is an output (" << node->get_name() << ")" << endl;
+    } else if ( cc.kind == FGElectricalComponent::FG_OUTPUT ) {
         volts = input_volts;
         if ( volts > 1.0 ) {
             // draw current if we have voltage
-            total_load = node->get_load_amps();
+            total_load = cc.component->get_load_amps();
         }
-    } else if ( node->get_kind() == FGElectricalComponent::FG_CONNECTOR ) {
-        // cout << s << "is a connector (" << node->get_name() << ")" << endl;
-        if ( ((FGElectricalConnector *)node)->get_state() ) {
+    } else if ( cc.kind == FGElectricalComponent::FG_CONNECTOR ) {
+        if ( cc.connector->get_state() ) {
             volts = input_volts;
         } else {
             volts = 0.0;
         }
-        // cout << s << "  input_volts = " << volts << endl;
     } else {
         SG_LOG( SG_SYSTEMS, SG_ALERT, "unknown node type" );
     }
 
-    int i;
+    // only a stronger power source propagates any further
+    if ( volts <= cc.component->get_volts() ) {
+        load = 0.0;
+        return false;
+    }
 
-    // if this node has found a stronger power source, update the
-    // value and propagate to all children
-    if ( volts > node->get_volts() ) {
-        node->set_volts( volts );
-        for ( i = 0; i < node->get_num_outputs(); ++i ) {
-            FGElectricalComponent *child = node->get_output(i);
+    cc.component->set_volts( volts );
+    PropagationFrame& frame = _stack[depth++];
+    frame.index = index;
+    frame.volts = volts;
+    frame.input_amps = input_amps;
+    frame.total_load = total_load;
+    frame.next_edge = 0;
+    return true;
+}
+
+
+// propagate the electrical current through the network, returns the
+// total current drawn by the components downstream of root.  This walks
+// the compiled graph depth first with an explicit stack; each component
+// reached with a higher voltage than it has takes it on and passes it on
+// to all its outputs.
+float FGElectricalSystem::propagate( unsigned int root, double dt,
+                                     float input_volts, float input_amps ) {
+    unsigned int depth = 0;
+    float load = 0.0;
+    if ( !enter( root, dt, input_volts, input_amps, load, depth ) ) {
+        return load;
+    }
+
+    while ( depth > 0 ) {
+        PropagationFrame& frame = _stack[depth - 1];
+        const CompiledComponent& cc = _compiled[frame.index];
+
+        if ( frame.next_edge < cc.num_edges ) {
+            unsigned int child = _edges[cc.first_edge + frame.next_edge++];
             // send current equal to load
-            total_load += propagate( child, dt,
-                                     volts, child->get_load_amps(),
-                                     s );
+            float child_load;
+            if ( !enter( child, dt, frame.volts,
+                         _compiled[child].component->get_load_amps(),
+                         child_load, depth ) ) {
+                frame.total_load += child_load;
+            }
+            continue;
         }
 
-        // if not an output node, register the downstream current draw
-        // (sum of all children) with this node.  If volts are zero,
-        // current draw should be zero.
-        if ( node->get_kind() != FGElectricalComponent::FG_OUTPUT ) {
-            node->set_load_amps( total_load );
+        // all outputs done.  If not an output node, register the
+        // downstream current draw (sum of all children) with this node.
+        if ( cc.kind != FGElectricalComponent::FG_OUTPUT ) {
+            cc.component->set_load_amps( frame.total_load );
         }
+        cc.component->set_available_amps( frame.input_amps - frame.total_load );
+        cc.component->publishVoltageToProps();
 
-        node->set_available_amps( input_amps - total_load );
-
-        node->publishVoltageToProps();
-
-        /*
-        cout << s << node->get_name() << " -> (volts) " << node->get_volts()
-             << endl;
-        cout << s << node->get_name() << " -> (load amps) " << total_load
-             << endl;
-        cout << s << node->get_name() << " -> (input amps) " << input_amps
-             << endl;
-        cout << s << node->get_name() << " -> (extra amps) "
-             << node->get_available_amps() << endl;
-        */
-
-        return total_load;
-    } else {
-        // cout << s << "no further propagation" << endl;
-        return 0.0;
+        load = frame.total_load;
+        if ( --depth > 0 ) {
+            _stack[depth - 1].total_load += load;
+        }
     }
+
+    return load;
 }
 
 
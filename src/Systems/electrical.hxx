@@ -230,9 +230,8 @@ public:
     static const char* staticSubsystemClassId() { return "electrical"; }
 
     bool build (SGPropertyNode* config_props);
-    float propagate( FGElectricalComponent *node, double dt,
-                     float input_volts, float input_amps,
-                     std::string s = "" );
+    float propagate( unsigned int root, double dt,
+                     float input_volts, float input_amps );
     FGElectricalComponent *find ( const std::string &name );
 
 protected:
@@ -241,6 +240,32 @@ protected:
 private:
     void deleteComponents(comp_list& comps);
 
+    // The component graph flattened by compile(): one entry per component
+    // with its downstream connections as a range of _edges, so the per
+    // frame propagation is index based and doesn't allocate.
+    struct CompiledComponent {
+        FGElectricalComponent *component;
+        FGElectricalSupplier *supplier;     // set for suppliers
+        FGElectricalConnector *connector;   // set for connectors
+        int kind;
+        unsigned int first_edge;
+        unsigned int num_edges;
+    };
+
+    // One level of the propagation, kept on _stack instead of the C++
+    // call stack.
+    struct PropagationFrame {
+        unsigned int index;
+        float volts;
+        float input_amps;
+        float total_load;
+        unsigned int next_edge;
+    };
+
+    void compile();
+    bool enter( unsigned int index, double dt, float input_volts,
+                float input_amps, float& load, unsigned int& depth );
+
     std::string name;
     int num;
     std::string path;
@@ -252,10 +277,23 @@ private:
     comp_list outputs;
     comp_list connectors;
 
+    std::vector<CompiledComponent> _compiled;
+    std::vector<unsigned int> _edges;
+    std::vector<unsigned int> _supplier_order; // external, alternator, battery
+    std::vector<PropagationFrame> _stack;
+
     SGPropertyNode_ptr _volts_out;
     SGPropertyNode_ptr _amps_out;
     SGPropertyNode_ptr _serviceable_node;
     bool _serviceable = true;
+
+    // inputs of the simplistic volts/amps summary
+    SGPropertyNode_ptr _alternator_amps;
+    SGPropertyNode_ptr _master_bat;
+    SGPropertyNode_ptr _master_alt;
+    SGPropertyNode_ptr _engine_rpm;
+    SGPropertyNode_ptr _beacon_switch;
+    SGPropertyNode_ptr _nav_lights_switch;
 };
 
 #endif // _SYSTEMS_ELECTRICAL_HXX
@@ -30,6 +30,8 @@
 #include <simgear/timing/sg_time.hxx>
 #include <simgear/math/SGMath.hxx>
 
+#include <FDM/FDMThread.hxx>
+#include <FDM/fdm_shell.hxx>
 #include <Main/fg_props.hxx>
 #include <Main/globals.hxx>
 #include <Time/bodysolver.hxx>
@@ -54,6 +56,20 @@ static bool do_timeofday (const SGPropertyNode * arg, SGPropertyNode * root)
     return true;
 }
 
+// A threaded FDM spends the queued time at model-hz by itself, publishing a
+// new state when each stepping window closes. Iterating the rest of the FDM
+// group model-hz times per frame would then run it against one unchanged
+// state, so it runs once per frame instead (autopilots which need the FDM
+// rate use fdm-substep).
+static double fdmGroupFixedUpdateTime(double modelHz)
+{
+    FDMShell* fdm = globals->get_subsystem<FDMShell>();
+    if (fdm && fdm->isThreaded()) {
+        return 0.0;
+    }
+    return 1.0 / modelHz;
+}
+
 TimeManager::TimeManager() :
   _inited(false),
   _impl(NULL)
@@ -255,7 +271,7 @@ void TimeManager::computeTimeDeltasSimple(double& simDt, double& realDt)
         _simple_time_utc = t;
         _simple_time_fdm = t;
         SGSubsystemGroup* fdmGroup = globals->get_subsystem_mgr()->get_group(SGSubsystemMgr::FDM);
-        fdmGroup->set_fixed_update_time(1.0 / modelHz);
+        fdmGroup->set_fixed_update_time(fdmGroupFixedUpdateTime(modelHz));
     }
 
     // Sleep if necessary to respect _maxFrameRate. It's simpler to do this
@@ -268,6 +284,7 @@ void TimeManager::computeTimeDeltasSimple(double& simDt, double& realDt)
             double delay_end = _simple_time_utc + 1.0/max_frame_rate;
             if (delay_end > t) {
                 sleep_time = delay_end - t;
+                flightgear::FDMThread::SteppingWindow window;
                 std::this_thread::sleep_for(std::chrono::milliseconds((int) (sleep_time * 1000)));
                 t = delay_end;
             }
@@ -415,7 +432,7 @@ void TimeManager::computeTimeDeltas(double& simDt, double& realDt)
     
   SGSubsystemGroup* fdmGroup = 
     globals->get_subsystem_mgr()->get_group(SGSubsystemMgr::FDM);
-  fdmGroup->set_fixed_update_time(1.0 / modelHz);
+  fdmGroup->set_fixed_update_time(fdmGroupFixedUpdateTime(modelHz));
 
   // round the real time down to a multiple of 1/model-hz.
   // this way all systems are updated the _same_ amount of dt.
@@ -548,7 +565,10 @@ void TimeManager::throttleUpdateRate()
     // we want to sleep until just after the next ideal timestamp wanted, we will
     // gain time from a 1/Hz step if the last timestamp was late.
     const double t = (round(modelHz / throttleHz) / modelHz) - _dtRemainder;
-    SGTimeStamp::sleepUntil(_lastStamp + SGTimeStamp::fromSec(t));
+    {
+        flightgear::FDMThread::SteppingWindow window;
+        SGTimeStamp::sleepUntil(_lastStamp + SGTimeStamp::fromSec(t));
+    }
     _frameWait->setDoubleValue(frameWaitStart.elapsedMSec());
 }
 
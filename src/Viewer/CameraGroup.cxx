@@ -910,7 +910,13 @@ CameraInfo* CameraGroup::getGUICamera() const
 
 osg::Camera* getGUICamera(CameraGroup* cgroup)
 {
-    return cgroup->getGUICamera()->compositor->getPass(0)->camera;
+    // no camera group at all when headless
+    if (!cgroup)
+        return nullptr;
+    CameraInfo* info = cgroup->getGUICamera();
+    if (!info)
+        return nullptr;
+    return info->compositor->getPass(0)->camera;
 }
 
 const CameraGroup::CameraList& CameraGroup::getCameras()
@@ -40,10 +40,12 @@
 #include <osg/Version>
 #include <osg/Notify>
 #include <osg/View>
+#include <osgDB/DatabasePager>
 #include <osgViewer/ViewerEventHandlers>
 #include <osgViewer/Viewer>
 #include <osgViewer/GraphicsWindow>
 
+#include <FDM/FDMThread.hxx>
 #include <Scenery/scenery.hxx>
 #include <Main/fg_os.hxx>
 #include <Main/fg_props.hxx>
@@ -205,6 +207,25 @@ void updateOSGNotifyLevel()
 {
    }
 
+// Without a window there is nothing to realize: like the test suite, keep
+// an unrealized view whose frame stamp and database pager still work
+static void openHeadlessView(osgViewer::CompositeViewer* composite_viewer)
+{
+    SG_LOG(SG_VIEW, SG_INFO, "Headless: not opening a window");
+    if (composite_viewer) {
+        osgViewer::View* view = new osgViewer::View;
+        view->setFrameStamp(composite_viewer->getFrameStamp());
+        view->setDatabasePager(FGScenery::getPagerSingleton());
+        view->setSceneData(new osg::Group);
+        globals->get_renderer()->setView(view);
+    } else {
+        viewer = new osgViewer::Viewer;
+        viewer->setDatabasePager(FGScenery::getPagerSingleton());
+        viewer->setSceneData(new osg::Group);
+        globals->get_renderer()->setView(viewer.get());
+    }
+}
+
 void fgOSOpenWindow(bool stencil)
 {
     osg::setNotifyHandler(new NotifyLogger);
@@ -212,7 +233,9 @@ void fgOSOpenWindow(bool stencil)
     auto composite_viewer = dynamic_cast<osgViewer::CompositeViewer*>(
             globals->get_renderer()->getViewerBase()
             );
-    if (0) {}
+    if (fgGetBool("/sim/headless/enabled")) {
+        openHeadlessView(composite_viewer);
+    }
     else if (composite_viewer) {
         /* We are using CompositeViewer. */
         SG_LOG(SG_VIEW, SG_DEBUG, "Using CompositeViewer");
@@ -312,7 +335,7 @@ void fgOSResetProperties()
     globals->addListenerToCleanup(l);
     osgLevel->addChangeListener(l, true);
 
-    osg::Camera* guiCamera = getGUICamera(CameraGroup::getDefault());
+    osg::Camera* guiCamera = CameraGroup::getDefault() ? getGUICamera(CameraGroup::getDefault()) : nullptr;
     if (guiCamera) {
         Viewport* guiViewport = guiCamera->getViewport();
         fgSetInt("/sim/startup/xsize", guiViewport->width());
@@ -354,14 +377,63 @@ void fgOSExit(int code)
 }
 SGTimeStamp _lastUpdate;
 
+// Run the simulation in fixed steps of /sim/time/fixed-dt, as fast as
+// possible or at most /sim/headless/max-speed-up times real time. Without
+// traversals, the viewer only provides the frame stamp and the pager which
+// loads scenery for ground queries.
+static int headlessMainLoop(osgViewer::ViewerBase* viewer_base)
+{
+    if (fgGetDouble("/sim/time/fixed-dt") <= 0.0) {
+        fgSetDouble("/sim/time/fixed-dt", 1.0 / 30);
+    }
+
+    while (!viewer_base->done()) {
+        const SGTimeStamp frameStart = SGTimeStamp::now();
+        const double simStart = globals->get_sim_time_sec();
+
+        // nothing to throttle for; set each frame, as a reset rebuilds the tree
+        fgSetDouble("/sim/frame-rate-throttle-hz", 0.0);
+        fgIdleHandler idleFunc = globals->get_renderer()->getEventHandler()->getIdleHandler();
+        if (idleFunc) {
+            (*idleFunc)();
+        }
+
+        FGRenderer* renderer = globals->get_renderer();
+        osg::FrameStamp* frameStamp = renderer->getFrameStamp();
+        osgDB::DatabasePager* pager = renderer->getView()->getDatabasePager();
+        viewer_base->advance(globals->get_sim_time_sec());
+        pager->signalBeginFrame(frameStamp);
+        pager->updateSceneGraph(*frameStamp);
+        pager->signalEndFrame();
+
+        // don't spin while starting up, loading scenery or paused
+        const double ratio = fgGetDouble("/sim/headless/max-speed-up");
+        const double simDt = globals->get_sim_time_sec() - simStart;
+        if (simDt <= 0.0) {
+            SGTimeStamp::sleepForMSec(10);
+        } else if (ratio > 0.0) {
+            flightgear::FDMThread::SteppingWindow window;
+            SGTimeStamp::sleepUntil(frameStart + SGTimeStamp::fromSec(simDt / ratio));
+        }
+    }
+
+    flightgear::addSentryBreadcrumb("main loop exited", "info");
+    return status;
+}
+
 int fgOSMainLoop()
 {
     osgViewer::ViewerBase* viewer_base = globals->get_renderer()->getViewerBase();
+    if (fgGetBool("/sim/headless/enabled")) {
+        return headlessMainLoop(viewer_base);
+    }
+
     viewer_base->setReleaseContextAtEndOfFrameHint(false);
     if (!viewer_base->isRealized()) {
         viewer_base->realize();
     }
 
+    bool firstFrame = true;
     while (!viewer_base->done()) {
         fgIdleHandler idleFunc = globals->get_renderer()->getEventHandler()->getIdleHandler();
         if (idleFunc)
@@ -399,7 +471,22 @@ int fgOSMainLoop()
 #ifdef ENABLE_OSGXR
         VRManager::instance()->update();
 #endif
-        viewer_base->frame( globals->get_sim_time_sec() );
+        if (firstFrame) {
+            // frame() does the viewer's one-off initialisation
+            viewer_base->frame( globals->get_sim_time_sec() );
+            firstFrame = false;
+            continue;
+        }
+
+        // a threaded FDM may step while we render, but not while events
+        // and update callbacks look at the simulation
+        viewer_base->advance( globals->get_sim_time_sec() );
+        viewer_base->eventTraversal();
+        viewer_base->updateTraversal();
+        {
+            flightgear::FDMThread::SteppingWindow window;
+            viewer_base->renderingTraversals();
+        }
     }
 
     flightgear::addSentryBreadcrumb("main loop exited", "info");
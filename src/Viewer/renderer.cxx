@@ -1123,6 +1123,11 @@ void
 FGRenderer::addCamera(osg::Camera* camera, bool useSceneData)
 {
     osg::Camera *guiCamera = getGUICamera(CameraGroup::getDefault());
+    if (!guiCamera) {
+        // headless: nothing renders, so there is no context to share
+        SG_LOG(SG_VIEW, SG_DEBUG, "FGRenderer::addCamera: no GUI camera, not adding camera");
+        return;
+    }
     osg::GraphicsContext *gc = guiCamera->getGraphicsContext();
     camera->setGraphicsContext(gc);
     if (composite_viewer) {
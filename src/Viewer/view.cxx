@@ -1489,7 +1489,9 @@ double View::getOrientation_z() const{
 
 double View::get_aspect_ratio() const
 {
-    return flightgear::CameraGroup::getDefault()->getMasterAspectRatio();
+    // there is no camera group when running headless
+    flightgear::CameraGroup* cameraGroup = flightgear::CameraGroup::getDefault();
+    return cameraGroup ? cameraGroup->getMasterAspectRatio() : 1.0;
 }
 
 double View::getLon_deg() const
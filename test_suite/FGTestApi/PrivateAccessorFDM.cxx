@@ -3,6 +3,8 @@
 #include <FDM/AIWake/AIWakeGroup.hxx>
 #include <FDM/AIWake/AircraftMesh.hxx>
 #include <FDM/AIWake/WakeMesh.hxx>
+#include <FDM/fdm_shell.hxx>
+#include <FDM/flight.hxx>
 #include <FDM/YASim/Atmosphere.hpp>
 
 
@@ -49,6 +51,21 @@ FGTestApi::PrivateAccessor::FDM::Accessor::read_FDM_AIWake_WakeMesh_Gamma(WakeMe
 }
 
 
+// Access variables from src/FDM/fdm_shell.hxx.
+int
+FGTestApi::PrivateAccessor::FDM::Accessor::call_FDM_FDMShell_substepsFor(const std::string& model) const
+{
+    return FDMShell::substepsFor(model);
+}
+
+void
+FGTestApi::PrivateAccessor::FDM::Accessor::write_FDM_FDMShell_impl(FDMShell* instance, FGInterface* impl, int substeps) const
+{
+    instance->_impl = impl;
+    instance->attachSubsteps(substeps);
+}
+
+
 // Access variables from src/FDM/YASim/Atmosphere.hxx.
 float
 FGTestApi::PrivateAccessor::FDM::Accessor::read_FDM_YASim_Atmosphere_numColumns(std::unique_ptr<yasim::Atmosphere> &instance) const
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <simgear/math/SGMath.hxx>
@@ -16,6 +17,10 @@ class WakeMesh;
 class AeroElement;
 typedef SGSharedPtr<AeroElement> AeroElement_ptr;
 
+// Forward declarations for src/FDM.
+class FDMShell;
+class FGInterface;
+
 // Forward declaration for: src/FDM/YASim.
 namespace yasim {
 class Atmosphere;
@@ -41,6 +46,10 @@ public:
     int read_FDM_AIWake_WakeMesh_nelm(WakeMesh* instance) const;
     double **read_FDM_AIWake_WakeMesh_Gamma(WakeMesh* instance) const;
 
+    // Access variables from src/FDM/fdm_shell.hxx.
+    int call_FDM_FDMShell_substepsFor(const std::string& model) const;
+    void write_FDM_FDMShell_impl(FDMShell* instance, FGInterface* impl, int substeps) const;
+
     // Access variables from src/FDM/YASim/Atmosphere.hxx.
     float read_FDM_YASim_Atmosphere_numColumns(std::unique_ptr<yasim::Atmosphere> &instance) const;
     float read_FDM_YASim_Atmosphere_data(std::unique_ptr<yasim::Atmosphere> &instance, int i, int j) const;
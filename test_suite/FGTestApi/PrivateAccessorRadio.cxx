@@ -0,0 +1,24 @@
+#include "PrivateAccessorRadio.hxx"
+
+#include <Radio/propagation.hxx>
+
+
+
+// Access variables from src/Radio/propagation.hxx.
+bool
+FGTestApi::PrivateAccessor::Radio::Accessor::call_Radio_FGRadioPropagation_addProfile(FGRadioPropagation* instance,
+                                                                                       const FGRadioITMRequest& request,
+                                                                                       std::shared_ptr<const FGRadioTerrainProfile> profile) const
+{
+    FGRadioPropagation::ProfileKey key;
+    if (!instance->makeKey(request, key))
+        return false;
+    instance->addProfile(key, profile);
+    return true;
+}
+
+std::size_t
+FGTestApi::PrivateAccessor::Radio::Accessor::read_Radio_FGRadioPropagation_cacheSize(FGRadioPropagation* instance) const
+{
+    return instance->_cache.size();
+}
@@ -0,0 +1,31 @@
+#ifndef _FG_PRIVATE_ACCESSOR_RADIO_HXX
+#define _FG_PRIVATE_ACCESSOR_RADIO_HXX
+
+#include <cstddef>
+#include <memory>
+
+// Forward declarations for src/Radio.
+class FGRadioPropagation;
+class FGRadioTerrainProfile;
+struct FGRadioITMRequest;
+
+
+namespace FGTestApi {
+namespace PrivateAccessor {
+namespace Radio {
+
+class Accessor
+{
+public:
+    // Access variables from src/Radio/propagation.hxx.
+    bool call_Radio_FGRadioPropagation_addProfile(FGRadioPropagation* instance,
+                                                  const FGRadioITMRequest& request,
+                                                  std::shared_ptr<const FGRadioTerrainProfile> profile) const;
+    std::size_t read_Radio_FGRadioPropagation_cacheSize(FGRadioPropagation* instance) const;
+};
+
+} // End of namespace Radio.
+} // End of namespace PrivateAccessor.
+} // End of namespace FGTestApi.
+
+#endif // _FG_PRIVATE_ACCESSOR_RADIO_HXX
@@ -10,6 +10,12 @@
 
 void FGAirport::testSuiteInjectGroundnetXML(const SGPath& path)
 {
+    if (_groundNetworkLoad.valid()) {
+        _groundNetworkLoad.wait();
+        _groundNetworkLoad = {};
+        _loadingGroundNetwork.reset();
+    }
+
     _groundNetwork.reset(new FGGroundNetwork(const_cast<FGAirport*>(this)));
     XMLLoader::loadFromPath(_groundNetwork.get(), path);
     _groundNetwork->init();
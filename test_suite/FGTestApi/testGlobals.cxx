@@ -69,6 +69,9 @@ void initTestGlobals(const std::string& testName)
 
     fgSetDefaults();
 
+    // the same headless mode as --headless: no cameras, inline FDM stepping
+    props->setBoolValue("sim/headless/enabled", true);
+
     auto t = globals->add_new_subsystem<TimeManager>(SGSubsystemMgr::INIT);
     t->bind();
     t->init(); // establish mag-var data
@@ -10,6 +10,7 @@
 
 #include <Canvas/canvas_mgr.hxx>
 #include <Canvas/FGCanvasSystemAdapter.hxx>
+#include <Viewer/CameraGroup.hxx>
 extern bool global_nasalMinimalInit;
 
 
@@ -121,3 +122,29 @@ void CanvasTests::testImagePixelOps()
     const uint8_t testColor2[] = {0xff, 0x1f, 0x3f, 0x7f}; // little endian
     verifyPixel(osgImage.get(), 20, 45, testColor2);
 }
+
+// The test globals have no camera group, just like a headless fgfs: updating
+// a canvas sets up its render-to-texture camera, which must not need one.
+void CanvasTests::testHeadlessUpdate()
+{
+    CPPUNIT_ASSERT(!flightgear::CameraGroup::getDefault());
+    CPPUNIT_ASSERT(!flightgear::getGUICamera(flightgear::CameraGroup::getDefault()));
+
+    bool ok = FGTestApi::executeNasal(R"(
+        var my_canvas = canvas.new({
+         "name": "HeadlessCanvas",
+             "size": [256, 256],
+             "view": [256, 256]
+           });
+        my_canvas.createGroup("root").createChild("path").moveTo(0, 0).lineTo(100, 100);
+       )");
+    CPPUNIT_ASSERT(ok);
+
+    auto mgr = globals->get_subsystem<CanvasMgr>();
+    auto canvasPtr = mgr->getCanvas("HeadlessCanvas");
+    CPPUNIT_ASSERT(canvasPtr.valid());
+
+    mgr->update(0.1);
+    mgr->update(0.1);
+    CPPUNIT_ASSERT_EQUAL(0u, mgr->getCanvasTexId(canvasPtr));
+}
@@ -32,6 +32,7 @@ class CanvasTests : public CppUnit::TestFixture
     CPPUNIT_TEST_SUITE(CanvasTests);
     CPPUNIT_TEST(testCanvasBasic);
     CPPUNIT_TEST(testImagePixelOps);
+    CPPUNIT_TEST(testHeadlessUpdate);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -44,6 +45,7 @@ public:
     // The tests.
     void testCanvasBasic();
     void testImagePixelOps();
+    void testHeadlessUpdate();
 };
 
 
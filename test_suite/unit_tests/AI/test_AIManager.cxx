@@ -129,3 +129,74 @@ void AIManagerTests::testAircraftWaypoints()
     std::unique_ptr<FGAIFlightPlan> aiFP(new FGAIFlightPlan);
     ai->setFlightPlan(std::move(aiFP));    
 }
+
+void AIManagerTests::testTrafficPicture()
+{
+    auto aim = globals->get_subsystem<FGAIManager>();
+    auto eggd = FGAirport::findByIdent("EGGD");
+    FGTestApi::setPositionAndStabilise(eggd->geod());
+
+    auto addAircraft = [aim](const std::string& callsign, const SGGeod& pos, double speedKt) {
+        SGPropertyNode_ptr def(new SGPropertyNode);
+        def->setStringValue("type", "aircraft");
+        def->setStringValue("callsign", callsign);
+        def->setDoubleValue("heading", 90.0);
+        def->setDoubleValue("latitude", pos.getLatitudeDeg());
+        def->setDoubleValue("longitude", pos.getLongitudeDeg());
+        def->setDoubleValue("altitude", pos.getElevationFt());
+        def->setDoubleValue("speed", speedKt);
+        return aim->addObject(def);
+    };
+
+    const SGGeod center = SGGeod::fromGeodFt(eggd->geod(), 6000.0);
+    auto offset = [&center](double course, double distanceNm) {
+        return SGGeod::fromGeodFt(SGGeodesy::direct(center, course, distanceNm * SG_NM_TO_METER),
+                                  center.getElevationFt());
+    };
+    auto nearby = addAircraft("NEAR", offset(45.0, 5.0), 250.0);
+    auto taxiing = addAircraft("TAXI", offset(90.0, 2.0), 10.0);
+    auto above = addAircraft("HIGH", SGGeod::fromGeodFt(center, 30000.0), 250.0);
+    auto distant = addAircraft("FAR", offset(180.0, 100.0), 250.0);
+
+    // the user aircraft is not part of the picture
+    const auto& traffic = aim->getTraffic();
+    CPPUNIT_ASSERT_EQUAL(size_t(4), traffic.size());
+
+    for (const auto& t : traffic) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(t.object->_getLatitude(), t.position.getLatitudeDeg(), 1e-9);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(t.object->_getAltitude(), t.position.getElevationFt(), 1e-6);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(90.0, t.headingDeg, 1e-6);
+        CPPUNIT_ASSERT(!t.hidden);
+        // AI traffic switches its transponder off at taxi speeds
+        if (t.object == taxiing.get()) {
+            CPPUNIT_ASSERT(!t.transponder);
+        } else {
+            CPPUNIT_ASSERT(t.transponder);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(t.object->_getAltitude(), t.reportedAltFt, 1e-6);
+        }
+    }
+
+    // coarse prefilter: range and vertical band
+    std::vector<const FGAIManager::TrafficTarget*> found;
+    aim->findTraffic(center, 20.0, 2000.0, found);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), found.size());
+    for (auto t : found) {
+        CPPUNIT_ASSERT(t->object == nearby.get() || t->object == taxiing.get());
+    }
+
+    aim->findTraffic(center, 120.0, 50000.0, found);
+    CPPUNIT_ASSERT_EQUAL(size_t(4), found.size());
+
+    // TCAS output nodes are only created on demand
+    CPPUNIT_ASSERT(!above->getThreatLevelNode(false));
+    above->getThreatLevelNode()->setIntValue(2);
+    CPPUNIT_ASSERT_EQUAL(2, above->getThreatLevelNode(false)->getIntValue());
+    CPPUNIT_ASSERT_EQUAL(2, above->_getProps()->getIntValue("tcas/threat-level"));
+
+    // hiding a pilot takes effect with the next frame's picture
+    distant->_getProps()->setBoolValue("controls/invisible", true);
+    FGTestApi::runForTime(0.1);
+    for (const auto& t : aim->getTraffic()) {
+        CPPUNIT_ASSERT_EQUAL(t.object == distant.get(), t.hidden);
+    }
+}
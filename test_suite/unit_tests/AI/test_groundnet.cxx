@@ -36,8 +36,10 @@
 #include <AIModel/performancedb.hxx>
 #include <Airports/airport.hxx>
 #include <Airports/airportdynamicsmanager.hxx>
+#include <Airports/groundnetcache.hxx>
 #include <Airports/groundnetwork.hxx>
 #include <Airports/parking.hxx>
+#include <Airports/xmlloader.hxx>
 #include <Traffic/TrafficMgr.hxx>
 
 #include <ATC/atc_mgr.hxx>
@@ -120,3 +122,128 @@ void GroundnetTests::testFind()
     CPPUNIT_ASSERT(pushForwardSegment);
     CPPUNIT_ASSERT_EQUAL(1025, pushForwardSegment->getEnd()->getIndex());
 }
+
+/**
+ * Routes answered from the precomputed table match the searched ones.
+ */
+
+void GroundnetTests::testPrecomputedRoutes()
+{
+    FGAirportRef egph = FGAirport::getByIdent("EGPH");
+    FGGroundNetwork* network = egph->groundNetwork();
+    CPPUNIT_ASSERT(!network->hasPrecomputedRoutes());
+
+    FGTaxiNodeVector runwayNodes;
+    for (unsigned int r = 0; r < egph->numRunways(); ++r) {
+        FGRunwayRef runway = egph->getRunwayByIndex(r);
+        FGTaxiNodeRef node = network->findNearestNodeOnRunway(runway->threshold());
+        if (node) {
+            runwayNodes.push_back(node);
+        }
+    }
+    CPPUNIT_ASSERT(!runwayNodes.empty());
+
+    std::vector<FGTaxiRoute> searched;
+    for (const auto& park : network->allParkings()) {
+        for (const auto& node : runwayNodes) {
+            searched.push_back(network->findShortestRoute(park, node, false));
+            searched.push_back(network->findShortestRoute(node, park, false));
+        }
+    }
+
+    network->precomputeRoutes();
+    network->waitForPrecomputedRoutes();
+    CPPUNIT_ASSERT(network->hasPrecomputedRoutes());
+
+    auto expected = searched.begin();
+    for (const auto& park : network->allParkings()) {
+        for (const auto& node : runwayNodes) {
+            for (int direction = 0; direction < 2; ++direction) {
+                FGTaxiRoute route = direction == 0 ?
+                    network->findShortestRoute(park, node, false) :
+                    network->findShortestRoute(node, park, false);
+                CPPUNIT_ASSERT_EQUAL(expected->size(), route.size());
+                CPPUNIT_ASSERT(!(*expected < route) && !(route < *expected));
+
+                FGTaxiNodeRef expectedNode, actualNode;
+                int expectedSegment = 0, actualSegment = 0;
+                expected->first();
+                route.first();
+                while ((route.size() > 1) && expected->next(expectedNode, &expectedSegment)) {
+                    CPPUNIT_ASSERT(route.next(actualNode, &actualSegment));
+                    CPPUNIT_ASSERT_EQUAL(expectedNode->getIndex(), actualNode->getIndex());
+                    CPPUNIT_ASSERT_EQUAL(expectedSegment, actualSegment);
+                }
+                ++expected;
+            }
+        }
+    }
+
+    FGParkingRef startParking = network->findParkingByName("main-apron10");
+    FGRunwayRef runway = egph->getRunwayByIndex(0);
+    FGTaxiNodeRef end = network->findNearestNodeOnRunway(runway->threshold());
+    CPPUNIT_ASSERT_EQUAL(29, network->findShortestRoute(startParking, end).size());
+}
+
+/**
+ * A network loaded back from the binary cache matches the parsed one.
+ */
+
+void GroundnetTests::testBinaryCache()
+{
+    FGAirportRef egph = FGAirport::getByIdent("EGPH");
+    const SGPath source = SGPath::fromUtf8(FG_TEST_SUITE_DATA) / "EGPH.groundnet.xml";
+    const SGPath cache = flightgear::GroundNetCache::pathForAirport("EGPH");
+
+    FGGroundNetwork parsed(egph.get());
+    XMLLoader::loadFromPath(&parsed, source);
+    CPPUNIT_ASSERT(flightgear::GroundNetCache::save(&parsed, cache, source));
+    parsed.init();
+
+    FGGroundNetwork cached(egph.get());
+    CPPUNIT_ASSERT(flightgear::GroundNetCache::load(&cached, cache, source));
+    cached.init();
+
+    CPPUNIT_ASSERT_EQUAL(parsed.getVersion(), cached.getVersion());
+    CPPUNIT_ASSERT(cached.findSegment(1));
+    unsigned int segments = 0;
+    while (parsed.findSegment(segments + 1)) {
+        FGTaxiSegment* expected = parsed.findSegment(segments + 1);
+        FGTaxiSegment* actual = cached.findSegment(segments + 1);
+        CPPUNIT_ASSERT(actual);
+        CPPUNIT_ASSERT_EQUAL(expected->getStart()->getIndex(), actual->getStart()->getIndex());
+        CPPUNIT_ASSERT_EQUAL(expected->getEnd()->getIndex(), actual->getEnd()->getIndex());
+        ++segments;
+    }
+    CPPUNIT_ASSERT(!cached.findSegment(segments + 1));
+
+    CPPUNIT_ASSERT_EQUAL(parsed.allParkings().size(), cached.allParkings().size());
+    for (size_t i = 0; i < parsed.allParkings().size(); ++i) {
+        FGParkingRef expected = parsed.allParkings()[i];
+        FGParkingRef actual = cached.allParkings()[i];
+        CPPUNIT_ASSERT_EQUAL(expected->getIndex(), actual->getIndex());
+        CPPUNIT_ASSERT_EQUAL(expected->getName(), actual->getName());
+        CPPUNIT_ASSERT_EQUAL(expected->getType(), actual->getType());
+        CPPUNIT_ASSERT_EQUAL(expected->getCodes(), actual->getCodes());
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected->getHeading(), actual->getHeading(), 1e-9);
+        CPPUNIT_ASSERT_EQUAL(expected->getPushBackPoint().valid(), actual->getPushBackPoint().valid());
+        if (expected->getPushBackPoint()) {
+            CPPUNIT_ASSERT_EQUAL(expected->getPushBackPoint()->getIndex(),
+                                 actual->getPushBackPoint()->getIndex());
+        }
+    }
+
+    CPPUNIT_ASSERT(parsed.getGroundFrequencies() == cached.getGroundFrequencies());
+    CPPUNIT_ASSERT(parsed.getTowerFrequencies() == cached.getTowerFrequencies());
+
+    FGParkingRef startParking = cached.findParkingByName("main-apron10");
+    FGRunwayRef runway = egph->getRunwayByIndex(0);
+    FGTaxiNodeRef end = cached.findNearestNodeOnRunway(runway->threshold());
+    CPPUNIT_ASSERT_EQUAL(29, cached.findShortestRoute(startParking, end).size());
+
+    // a different source file invalidates the cache
+    FGGroundNetwork stale(egph.get());
+    const SGPath other = SGPath::fromUtf8(FG_TEST_SUITE_DATA) / "YBBN.groundnet.xml";
+    CPPUNIT_ASSERT(!flightgear::GroundNetCache::load(&stale, cache, other));
+    CPPUNIT_ASSERT(stale.allParkings().empty());
+}
@@ -0,0 +1,387 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_multiplayer.hxx"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "test_suite/FGTestApi/TestPilot.hxx"
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <simgear/timing/timestamp.hxx>
+
+#include <AIModel/AIManager.hxx>
+#include <AIModel/AIMultiplayer.hxx>
+#include <Main/globals.hxx>
+#include <MultiPlayer/MPLoopbackGenerator.hxx>
+#include <MultiPlayer/mpmessages.hxx>
+#include <MultiPlayer/multiplaymgr.hxx>
+
+namespace {
+
+// Build a position packet in the form kept in the multiplayer message
+// history: header fields in host byte order, the rest as on the wire.
+std::vector<char> makePositionPacket(const std::string& callsign, double time,
+                                     const SGVec3d& position, int frame)
+{
+    std::vector<char> packet(sizeof(T_MsgHdr) + sizeof(T_PositionMsg), 0);
+    T_PositionMsg* pos = reinterpret_cast<T_PositionMsg*>(&packet[sizeof(T_MsgHdr)]);
+    strncpy(pos->Model, "Aircraft/c172p/Models/c172p.xml", MAX_MODEL_NAME_LEN - 1);
+    pos->time = XDR_encode_double(time);
+    pos->lag = XDR_encode_double(0.1);
+    for (unsigned i = 0; i < 3; ++i) {
+        pos->position[i] = XDR_encode_double(position(i));
+        pos->orientation[i] = XDR_encode_float(0.0f);
+        pos->linearVel[i] = XDR_encode_float(i == 0 ? 50.0f : 0.0f);
+        pos->angularVel[i] = XDR_encode_float(0.0f);
+        pos->linearAccel[i] = XDR_encode_float(0.0f);
+        pos->angularAccel[i] = XDR_encode_float(0.0f);
+    }
+    pos->pad = 0;
+
+    auto put = [&packet](xdr_data_t word) {
+        const char* bytes = reinterpret_cast<const char*>(&word);
+        packet.insert(packet.end(), bytes, bytes + sizeof(word));
+    };
+
+    // protocol version and control surfaces, short int encoded
+    put(XDR_encode_shortints32(10, 2));
+    for (int id = 100; id < 108; ++id) {
+        put(XDR_encode_shortints32(id, (frame * 37 + id) % 32767));
+    }
+    // a string in the compact encoding: raw characters, no padding
+    const std::string livery = "Liveries/test-" + std::to_string(frame % 10) + ".xml";
+    put(XDR_encode_shortints32(1101, livery.size()));
+    packet.insert(packet.end(), livery.begin(), livery.end());
+    // and one in the original encoding, one padded word per character
+    const std::string chat = "hello " + callsign;
+    put(XDR_encode_uint32(10002));
+    put(XDR_encode_uint32(chat.size()));
+    for (size_t i = 0; i < ((chat.size() + 3) & ~3); ++i) {
+        put(XDR_encode_int8(i < chat.size() ? chat[i] : 0));
+    }
+
+    T_MsgHdr* hdr = reinterpret_cast<T_MsgHdr*>(packet.data());
+    hdr->Magic = MSG_MAGIC;
+    hdr->Version = PROTO_VER;
+    hdr->MsgId = POS_DATA_ID;
+    hdr->MsgLen = packet.size();
+    strncpy(hdr->Callsign, callsign.c_str(), MAX_CALLSIGN_LEN - 1);
+    return packet;
+}
+
+const FGPropertyData* findProp(const FGExternalMotionData& motionInfo, unsigned id)
+{
+    for (const auto& p : motionInfo.properties) {
+        if (p.id == id)
+            return &p;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+
+// Set up function for each test.
+void MultiplayerTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("multiplayer");
+}
+
+
+// Clean up after each test.
+void MultiplayerTests::tearDown()
+{
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+
+void MultiplayerTests::testPropertyArena()
+{
+    FGPropertyArena arena;
+    const std::string big(5000, 'x');
+
+    const char* a = arena.copy("alpha", 5);
+    const char* b = arena.copy(big.c_str(), big.size());
+    const char* c = arena.copy("gamma", 5);
+
+    // earlier strings stay put while the arena grows
+    CPPUNIT_ASSERT_EQUAL(std::string("alpha"), std::string(a));
+    CPPUNIT_ASSERT_EQUAL(big, std::string(b));
+    CPPUNIT_ASSERT_EQUAL(std::string("gamma"), std::string(c));
+
+    // after a reset the same storage is handed out again
+    arena.reset();
+    const char* a2 = arena.copy("delta", 5);
+    CPPUNIT_ASSERT(a2 == a);
+    CPPUNIT_ASSERT_EQUAL(std::string("delta"), std::string(a2));
+}
+
+
+void MultiplayerTests::testMotionHistory()
+{
+    FGMotionHistory history(4);
+    FGExternalMotionData motionInfo;
+
+    auto add = [&](double t) {
+        motionInfo.time = t;
+        FGPropertyData p;
+        p.id = static_cast<unsigned>(t * 10);
+        p.type = simgear::props::INT;
+        p.int_value = 1;
+        motionInfo.properties.push_back(p);
+        history.insert(t, motionInfo);
+        CPPUNIT_ASSERT(motionInfo.properties.empty());
+    };
+
+    add(1.0);
+    add(2.0);
+    add(4.0);
+    add(3.0); // late packet is sorted into place
+    CPPUNIT_ASSERT_EQUAL(size_t(4), history.size());
+    for (size_t i = 0; i < history.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(double(i + 1), history[i].time);
+        CPPUNIT_ASSERT_EQUAL(unsigned((i + 1) * 10), history[i].data.properties.front().id);
+    }
+
+    add(3.0); // same time replaces
+    CPPUNIT_ASSERT_EQUAL(size_t(4), history.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), history.dropped());
+
+    add(5.0); // full, oldest is dropped
+    CPPUNIT_ASSERT_EQUAL(size_t(4), history.size());
+    CPPUNIT_ASSERT_EQUAL(2.0, history[0].time);
+    CPPUNIT_ASSERT_EQUAL(5.0, history.back().time);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), history.dropped());
+
+    add(0.5); // older than anything in a full history
+    CPPUNIT_ASSERT_EQUAL(2.0, history[0].time);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), history.dropped());
+
+    CPPUNIT_ASSERT_EQUAL(size_t(0), history.upperBound(1.0));
+    CPPUNIT_ASSERT_EQUAL(size_t(1), history.upperBound(2.0));
+    CPPUNIT_ASSERT_EQUAL(size_t(2), history.upperBound(3.5));
+    CPPUNIT_ASSERT_EQUAL(size_t(4), history.upperBound(9.0));
+
+    history.eraseFront(2); // pruning by the caller is not a drop
+    CPPUNIT_ASSERT_EQUAL(size_t(2), history.size());
+    CPPUNIT_ASSERT_EQUAL(4.0, history[0].time);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), history.dropped());
+
+    history.clear();
+    CPPUNIT_ASSERT(history.empty());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), history.dropped());
+}
+
+
+void MultiplayerTests::testDecodePositionPacket()
+{
+    FGMultiplayMgr mgr;
+    FGExternalMotionData motionInfo;
+
+    const SGVec3d position(4000000.0, 500000.0, 4900000.0);
+    auto packet = makePositionPacket("TEST1", 12.5, position, 3);
+    CPPUNIT_ASSERT(mgr.decodePositionPacket(packet, motionInfo));
+
+    CPPUNIT_ASSERT_EQUAL(12.5, motionInfo.time);
+    CPPUNIT_ASSERT_EQUAL(position(0), motionInfo.position(0));
+    CPPUNIT_ASSERT_EQUAL(size_t(11), motionInfo.properties.size());
+
+    const FGPropertyData* aileron = findProp(motionInfo, 100);
+    CPPUNIT_ASSERT(aileron);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL((3 * 37 + 100) / 32767.0, aileron->float_value, 1e-6);
+
+    const FGPropertyData* livery = findProp(motionInfo, 1101);
+    CPPUNIT_ASSERT(livery);
+    CPPUNIT_ASSERT_EQUAL(std::string("Liveries/test-3.xml"), std::string(livery->string_value));
+
+    const FGPropertyData* chat = findProp(motionInfo, 10002);
+    CPPUNIT_ASSERT(chat);
+    CPPUNIT_ASSERT_EQUAL(std::string("hello TEST1"), std::string(chat->string_value));
+
+    // decoding again reuses the storage
+    CPPUNIT_ASSERT(mgr.decodePositionPacket(packet, motionInfo));
+    CPPUNIT_ASSERT_EQUAL(size_t(11), motionInfo.properties.size());
+
+    // a truncated packet is rejected
+    packet.resize(sizeof(T_MsgHdr) + 8);
+    CPPUNIT_ASSERT(!mgr.decodePositionPacket(packet, motionInfo));
+}
+
+
+// Replay a packet stream as seen from a busy server through decoding and
+// the motion histories, the way FGMultiplayMgr and FGAIMultiplayer process
+// it. Once every history slot has been used, decoding must run entirely in
+// recycled property storage.
+void MultiplayerTests::testReceiveStream()
+{
+    const int aircraftCount = 12;
+    const int frames = 40;
+    const size_t historyCapacity = 8;
+    const double packetInterval = 0.1;
+
+    std::vector<std::vector<char>> stream;
+    stream.reserve(aircraftCount * frames);
+    for (int frame = 0; frame < frames; ++frame) {
+        for (int a = 0; a < aircraftCount; ++a) {
+            const SGVec3d position(4000000.0 + a * 100.0 + frame * 5.0, 500000.0, 4900000.0);
+            stream.push_back(makePositionPacket("MP" + std::to_string(a),
+                                                frame * packetInterval, position, frame));
+        }
+    }
+
+    FGMultiplayMgr mgr;
+    FGExternalMotionData motionInfo;
+    std::vector<std::unique_ptr<FGMotionHistory>> histories;
+    for (int a = 0; a < aircraftCount; ++a) {
+        histories.emplace_back(new FGMotionHistory(historyCapacity));
+    }
+
+    size_t decoded = 0;
+    size_t reused = 0;
+    for (size_t i = 0; i < stream.size(); ++i) {
+        const int frame = i / aircraftCount;
+        const FGPropertyData* storage = motionInfo.properties.data();
+        CPPUNIT_ASSERT(mgr.decodePositionPacket(stream[i], motionInfo));
+        ++decoded;
+
+        // past the first round through the slots, the storage handed back
+        // by the history is big enough for the whole packet
+        if (frame > static_cast<int>(historyCapacity)) {
+            CPPUNIT_ASSERT(motionInfo.properties.data() == storage);
+            ++reused;
+        }
+
+        const FGPropertyData* livery = findProp(motionInfo, 1101);
+        CPPUNIT_ASSERT(livery);
+        CPPUNIT_ASSERT_EQUAL("Liveries/test-" + std::to_string(frame % 10) + ".xml",
+                             std::string(livery->string_value));
+
+        FGMotionHistory& history = *histories[i % aircraftCount];
+        history.insert(motionInfo.time, motionInfo);
+        CPPUNIT_ASSERT(motionInfo.properties.empty());
+
+        // what update() does: interpolate a little in the past, then drop
+        // what is no longer needed
+        size_t next = history.upperBound(motionInfo.time - 3 * packetInterval);
+        if (next > 0)
+            history.eraseFront(next - 1);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(stream.size(), decoded);
+    CPPUNIT_ASSERT_EQUAL(size_t(aircraftCount * (frames - historyCapacity - 1)), reused);
+
+    // every history ends with its aircraft's last packet, its strings intact
+    // after all the recycling
+    for (int a = 0; a < aircraftCount; ++a) {
+        const FGMotionHistory& h = *histories[a];
+        CPPUNIT_ASSERT(!h.empty());
+        CPPUNIT_ASSERT(h.size() <= 5);
+        CPPUNIT_ASSERT_EQUAL(size_t(0), h.dropped());
+
+        const FGMotionHistory::Entry& last = h[h.size() - 1];
+        CPPUNIT_ASSERT_EQUAL((frames - 1) * packetInterval, last.time);
+        CPPUNIT_ASSERT_EQUAL(4000000.0 + a * 100.0 + (frames - 1) * 5.0, last.data.position(0));
+        CPPUNIT_ASSERT_EQUAL(size_t(11), last.data.properties.size());
+
+        const FGPropertyData* chat = findProp(last.data, 10002);
+        CPPUNIT_ASSERT(chat);
+        CPPUNIT_ASSERT_EQUAL("hello MP" + std::to_string(a), std::string(chat->string_value));
+        const FGPropertyData* livery = findProp(last.data, 1101);
+        CPPUNIT_ASSERT(livery);
+        CPPUNIT_ASSERT_EQUAL(std::string("Liveries/test-9.xml"), std::string(livery->string_value));
+    }
+}
+
+
+void MultiplayerTests::testLoopbackPacket()
+{
+    const SGGeod center = SGGeod::fromDegFt(-3.0, 55.0, 1000.0);
+    MPLoopbackGenerator generator(center, 4);
+
+    std::vector<char> packet;
+    generator.makePacket(2, 30.0, packet);
+
+    // the generator writes wire format, the history keeps the header in
+    // host byte order
+    T_MsgHdr* hdr = reinterpret_cast<T_MsgHdr*>(packet.data());
+    CPPUNIT_ASSERT_EQUAL(MSG_MAGIC, XDR_decode_uint32(hdr->Magic));
+    hdr->Magic = XDR_decode_uint32(hdr->Magic);
+    hdr->Version = XDR_decode_uint32(hdr->Version);
+    hdr->MsgId = XDR_decode_uint32(hdr->MsgId);
+    hdr->MsgLen = XDR_decode_uint32(hdr->MsgLen);
+    CPPUNIT_ASSERT_EQUAL(std::string("LOOP2"), std::string(hdr->Callsign));
+
+    FGMultiplayMgr mgr;
+    FGExternalMotionData motionInfo;
+    CPPUNIT_ASSERT(mgr.decodePositionPacket(packet, motionInfo));
+    CPPUNIT_ASSERT_EQUAL(30.0, motionInfo.time);
+    CPPUNIT_ASSERT_EQUAL(size_t(5), motionInfo.properties.size());
+
+    // on its circle around the center
+    const SGGeod pos = SGGeod::fromCart(motionInfo.position);
+    const double distance = SGGeodesy::distanceM(center, pos);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2300.0, distance, 1.0);
+}
+
+
+// End to end: the loopback generator sends to our own receive port and the
+// receive thread decodes the packets into multiplayer aircraft.
+void MultiplayerTests::testReceiveThread()
+{
+    globals->add_new_subsystem<FGAIManager>(SGSubsystemMgr::GENERAL);
+
+    auto props = globals->get_props();
+    props->setBoolValue("sim/ai/enabled", true);
+    props->setStringValue("sim/multiplay/callsign", "TESTER");
+    props->setStringValue("sim/multiplay/txhost", "127.0.0.1");
+    // nothing listens on the discard port; we receive on a port the OS picks
+    props->setIntValue("sim/multiplay/txport", 9);
+    props->setBoolValue("sim/multiplay/rxport-any", true);
+    props->setBoolValue("sim/multiplay/receive-thread", true);
+    props->setIntValue("sim/multiplay/loopback-generator/aircraft", 5);
+
+    // the generator circles around our own position, taken at init
+    auto pilot = SGSharedPtr<FGTestApi::TestPilot>(new FGTestApi::TestPilot);
+    pilot->resetAtPosition(SGGeod::fromDegFt(-3.0, 55.0, 3000.0));
+
+    auto mgr = globals->add_new_subsystem<FGMultiplayMgr>(SGSubsystemMgr::POST_FDM);
+
+    globals->get_subsystem_mgr()->bind();
+    globals->get_subsystem_mgr()->init();
+    globals->get_subsystem_mgr()->postinit();
+    CPPUNIT_ASSERT(props->getBoolValue("sim/multiplay/online"));
+    CPPUNIT_ASSERT(props->getIntValue("sim/multiplay/rxport") > 0);
+
+    bool allSeen = false;
+    for (int i = 0; i < 100 && !allSeen; ++i) {
+        FGTestApi::runForTime(0.1);
+        SGTimeStamp::sleepForMSec(10);
+
+        allSeen = true;
+        for (unsigned a = 0; a < 5; ++a) {
+            if (!mgr->getMultiplayer(MPLoopbackGenerator::callsign(a)))
+                allSeen = false;
+        }
+    }
+
+    CPPUNIT_ASSERT(allSeen);
+    CPPUNIT_ASSERT(!mgr->getMultiplayer("LOOP5"));
+}
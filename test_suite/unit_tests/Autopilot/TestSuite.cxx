@@ -17,6 +17,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "testCompiledAutopilot.hxx"
 #include "testDigitalFilter.hxx"
 #include "testPidController.hxx"
 #include "testInputValue.hxx"
@@ -25,4 +26,5 @@
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(DigitalFilterTests, "Unit tests");
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(PidControllerTests, "Unit tests");
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(InputValueTests, "Unit tests");
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(CompiledAutopilotTests, "Unit tests");
 
@@ -0,0 +1,387 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testCompiledAutopilot.hxx"
+
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+#include "test_suite/FGTestApi/PrivateAccessorFDM.hxx"
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <Autopilot/autopilot.hxx>
+#include <FDM/fdm_shell.hxx>
+#include <FDM/flight.hxx>
+#include <Main/fg_props.hxx>
+#include <Main/globals.hxx>
+
+#include <simgear/props/props_io.hxx>
+
+
+namespace {
+
+// integrates like YASim: the multiloop count of substeps, each of the dt
+// the FDM was constructed with, running the callbacks after every one
+class SubstepFDM : public FGInterface
+{
+public:
+    explicit SubstepFDM(double dt) : FGInterface(dt), _dt(dt) {}
+
+    bool supportsSubstepCallbacks() const override { return true; }
+
+    void update(double dt) override
+    {
+        int iterations = _calc_multiloop(dt);
+        for (int i = 0; i < iterations; ++i) {
+            run_substep_callbacks(_dt);
+        }
+    }
+
+private:
+    double _dt;
+};
+
+} // anonymous namespace
+
+
+// Set up function for each test.
+void CompiledAutopilotTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("ap-compiled");
+}
+
+
+// Clean up after each test.
+void CompiledAutopilotTests::tearDown()
+{
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+
+SGPropertyNode_ptr CompiledAutopilotTests::configFromString(const std::string& s)
+{
+    SGPropertyNode_ptr config = new SGPropertyNode;
+
+    std::istringstream iss(s);
+    readProperties(iss, config);
+    return config;
+}
+
+
+FGXMLAutopilot::Autopilot* CompiledAutopilotTests::createAutopilot(const std::string& name,
+                                                                   const std::string& propertyRoot,
+                                                                   bool compiled,
+                                                                   SGPropertyNode_ptr config,
+                                                                   bool fdmSubstep)
+{
+    SGPropertyNode_ptr apNode = fgGetNode("/test/systems/" + name, true);
+    apNode->setStringValue("property-root", propertyRoot);
+    apNode->setBoolValue("compiled", compiled);
+    apNode->setBoolValue("fdm-substep", fdmSubstep);
+
+    auto ap = new FGXMLAutopilot::Autopilot(apNode, config);
+    globals->add_subsystem(name.c_str(), ap, SGSubsystemMgr::FDM);
+    ap->bind();
+    ap->init();
+    return ap;
+}
+
+
+// Run the same property rules once as a subsystem group and once as a
+// compiled program, each on its own property root, and require bit
+// identical outputs on every frame.
+void CompiledAutopilotTests::testIdenticalOutputs()
+{
+    auto config = configFromString(R"(<?xml version="1.0" encoding="UTF-8"?>
+        <PropertyList>
+          <filter>
+            <name>lag</name>
+            <type>exponential</type>
+            <filter-time>0.5</filter-time>
+            <input>in/a</input>
+            <output>out/lag</output>
+          </filter>
+          <filter>
+            <name>gain</name>
+            <type>gain</type>
+            <gain>2.5</gain>
+            <input>
+              <property>in/b</property>
+              <scale>0.1</scale>
+              <offset><value>3</value><scale>2</scale></offset>
+            </input>
+            <output>out/gain</output>
+            <min>-10</min>
+            <max>10</max>
+          </filter>
+          <filter>
+            <name>rate</name>
+            <type>noise-spike</type>
+            <max-rate-of-change>4</max-rate-of-change>
+            <input>out/gain</input>
+            <output>out/rate</output>
+          </filter>
+          <filter>
+            <name>slow-average</name>
+            <type>moving-average</type>
+            <samples>5</samples>
+            <update-interval-secs>0.05</update-interval-secs>
+            <input>in/a</input>
+            <output>out/average</output>
+          </filter>
+          <logic>
+            <name>positive</name>
+            <input>
+              <greater-than>
+                <property>out/lag</property>
+                <value>0</value>
+              </greater-than>
+            </input>
+            <output>out/positive</output>
+          </logic>
+          <flipflop>
+            <name>latch</name>
+            <type>SR</type>
+            <S><property>out/positive</property></S>
+            <R>
+              <less-than>
+                <property>in/b</property>
+                <value>-50</value>
+              </less-than>
+            </R>
+            <output>out/latch</output>
+          </flipflop>
+          <pi-simple-controller>
+            <name>pi</name>
+            <input>out/rate</input>
+            <reference>out/feedback</reference>
+            <output>out/pi</output>
+            <config>
+              <Kp>0.3</Kp>
+              <Ki>0.05</Ki>
+              <min>-1</min>
+              <max>1</max>
+            </config>
+          </pi-simple-controller>
+          <pid-controller>
+            <name>pid</name>
+            <input>out/lag</input>
+            <reference><property>in/b</property><scale>0.01</scale></reference>
+            <output>out/pid</output>
+            <config>
+              <Kp>-0.025</Kp>
+              <beta>1.0</beta>
+              <alpha>0.1</alpha>
+              <gamma>0.0</gamma>
+              <Ti>5</Ti>
+              <Td>0.01</Td>
+              <u_min>-1</u_min>
+              <u_max>1</u_max>
+            </config>
+          </pid-controller>
+          <filter>
+            <!-- feeds back into the pi controller one frame late -->
+            <name>feedback</name>
+            <type>gain</type>
+            <gain>0.5</gain>
+            <input>out/pi</input>
+            <output>out/feedback</output>
+          </filter>
+        </PropertyList>
+        )");
+
+    auto interpreted = createAutopilot("ap-interpreted", "/test/interpreted", false, config);
+    auto compiled = createAutopilot("ap-compiled", "/test/compiled", true, config);
+    CPPUNIT_ASSERT(!interpreted->is_compiled());
+    CPPUNIT_ASSERT(compiled->is_compiled());
+
+    SGPropertyNode_ptr interpretedRoot = fgGetNode("/test/interpreted", true);
+    SGPropertyNode_ptr compiledRoot = fgGetNode("/test/compiled", true);
+    const char* outputs[] = {"out/lag", "out/gain", "out/rate", "out/average",
+                             "out/positive", "out/latch", "out/pi", "out/pid", "out/feedback"};
+
+    const double dt = 0.01;
+    for (int i = 0; i < 2000; ++i) {
+        const double t = i * dt;
+        const double a = std::sin(t * 1.3) + 0.25 * std::sin(t * 7.1);
+        const double b = 80.0 * std::sin(t * 0.4) + 3.0 * std::cos(t * 11.0);
+        for (auto root : {interpretedRoot, compiledRoot}) {
+            root->setDoubleValue("in/a", a);
+            root->setDoubleValue("in/b", b);
+        }
+
+        interpreted->update(dt);
+        compiled->update(dt);
+
+        for (auto output : outputs) {
+            CPPUNIT_ASSERT_EQUAL(interpretedRoot->getDoubleValue(output),
+                                 compiledRoot->getDoubleValue(output));
+        }
+    }
+
+    // make sure the network actually did something
+    CPPUNIT_ASSERT(compiledRoot->getBoolValue("out/latch"));
+    CPPUNIT_ASSERT(compiledRoot->getDoubleValue("out/average") != 0.0);
+}
+
+
+// An autopilot asking for fdm-substep must keep running from its group
+// update while the FDM does not run substep callbacks, here because the
+// FDMShell has no implementation yet.
+void CompiledAutopilotTests::testSubstepFallback()
+{
+    auto config = configFromString(R"(<?xml version="1.0" encoding="UTF-8"?>
+        <PropertyList>
+          <filter>
+            <name>gain</name>
+            <type>gain</type>
+            <gain>2</gain>
+            <input>in/a</input>
+            <output>out/gain</output>
+          </filter>
+        </PropertyList>
+        )");
+
+    // no FDM at all
+    auto standalone = createAutopilot("ap-standalone", "/test/standalone", true, config, true);
+    CPPUNIT_ASSERT(standalone->is_fdm_substep());
+
+    fgSetDouble("/test/standalone/in/a", 1.5);
+    standalone->update(0.01);
+    CPPUNIT_ASSERT_EQUAL(3.0, fgGetDouble("/test/standalone/out/gain"));
+
+    // an FDM which does not run the callbacks
+    auto fdm = new FDMShell;
+    globals->add_subsystem(FDMShell::staticSubsystemClassId(), fdm, SGSubsystemMgr::FDM);
+    CPPUNIT_ASSERT(!fdm->runsSubstepCallbacks());
+
+    auto registered = createAutopilot("ap-registered", "/test/registered", true, config, true);
+    CPPUNIT_ASSERT(registered->is_fdm_substep());
+
+    fgSetDouble("/test/registered/in/a", -2.0);
+    registered->update(0.01);
+    CPPUNIT_ASSERT_EQUAL(-4.0, fgGetDouble("/test/registered/out/gain"));
+
+    fgSetDouble("/test/registered/in/a", 0.25);
+    registered->update(0.01);
+    CPPUNIT_ASSERT_EQUAL(0.5, fgGetDouble("/test/registered/out/gain"));
+}
+
+
+// Drive a substep-capable FDM through the FDMShell: the callbacks run once
+// per substep with the substep dt, /sim/fdm-substeps splits the JSBSim and
+// YASim steps only, and registrations outlive an FDM reinit.
+void CompiledAutopilotTests::testSubstepCallbacks()
+{
+    FGTestApi::PrivateAccessor::FDM::Accessor accessor;
+
+    fgSetInt("/sim/model-hz", 120);
+    fgSetString("/sim/flight-model", "null");
+    fgSetInt("/sim/fdm-substeps", 4);
+    CPPUNIT_ASSERT_EQUAL(4, accessor.call_FDM_FDMShell_substepsFor("jsb"));
+    CPPUNIT_ASSERT_EQUAL(4, accessor.call_FDM_FDMShell_substepsFor("yasim"));
+    CPPUNIT_ASSERT_EQUAL(1, accessor.call_FDM_FDMShell_substepsFor("null"));
+    fgSetInt("/sim/fdm-substeps", 0);
+    CPPUNIT_ASSERT_EQUAL(1, accessor.call_FDM_FDMShell_substepsFor("yasim"));
+    fgSetInt("/sim/fdm-substeps", 4);
+
+    auto fdm = new FDMShell;
+    globals->add_subsystem(FDMShell::staticSubsystemClassId(), fdm, SGSubsystemMgr::FDM);
+    fdm->init();
+    fdm->postinit();
+    CPPUNIT_ASSERT(!fdm->runsSubstepCallbacks());
+
+    // what createImplementation() builds for YASim with four substeps
+    const int substeps = accessor.call_FDM_FDMShell_substepsFor("yasim");
+    const double frameDt = 1.0 / 120;
+    accessor.write_FDM_FDMShell_impl(fdm, new SubstepFDM(frameDt / substeps), substeps);
+    CPPUNIT_ASSERT(fdm->runsSubstepCallbacks());
+
+    // around the autopilot, in registration order: feed it the substep
+    // index and read back what it made of it
+    std::vector<double> dts;
+    std::vector<double> outputs;
+    int index = 0;
+    fdm->addSubstepCallback(&dts, [&](double dt) {
+        dts.push_back(dt);
+        fgSetDouble("/test/substep/in/a", ++index);
+    });
+
+    auto config = configFromString(R"(<?xml version="1.0" encoding="UTF-8"?>
+        <PropertyList>
+          <filter>
+            <name>gain</name>
+            <type>gain</type>
+            <gain>2</gain>
+            <input>in/a</input>
+            <output>out/gain</output>
+          </filter>
+        </PropertyList>
+        )");
+    auto ap = createAutopilot("ap-substep", "/test/substep", true, config, true);
+    CPPUNIT_ASSERT(ap->is_fdm_substep());
+
+    fdm->addSubstepCallback(&outputs, [&](double) {
+        outputs.push_back(fgGetDouble("/test/substep/out/gain"));
+    });
+
+    // the group update leaves the autopilot to the FDM
+    fgSetDouble("/test/substep/in/a", 100.0);
+    ap->update(frameDt);
+    CPPUNIT_ASSERT_EQUAL(0.0, fgGetDouble("/test/substep/out/gain"));
+
+    fdm->getInterface()->update(frameDt);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), dts.size());
+    double total = 0.0;
+    for (double dt : dts) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(frameDt / 4, dt, 1e-12);
+        total += dt;
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(frameDt, total, 1e-12);
+    CPPUNIT_ASSERT(outputs == std::vector<double>({2.0, 4.0, 6.0, 8.0}));
+
+    // paused: no substeps at all
+    fdm->getInterface()->update(0.0);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), dts.size());
+
+    // the reinit recreates the implementation, here a null FDM which does
+    // not run the callbacks, so the autopilot updates with its group again
+    fdm->reinit();
+    CPPUNIT_ASSERT(!fdm->runsSubstepCallbacks());
+    fgSetDouble("/test/substep/in/a", 1.5);
+    ap->update(frameDt);
+    CPPUNIT_ASSERT_EQUAL(3.0, fgGetDouble("/test/substep/out/gain"));
+
+    // a substep-capable implementation after the next one picks up every
+    // registration without anyone registering again
+    accessor.write_FDM_FDMShell_impl(fdm, new SubstepFDM(frameDt / substeps), substeps);
+    dts.clear();
+    outputs.clear();
+    index = 0;
+    fdm->getInterface()->update(frameDt);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), dts.size());
+    CPPUNIT_ASSERT(outputs == std::vector<double>({2.0, 4.0, 6.0, 8.0}));
+
+    // without the test's own registrations only the autopilot is left
+    fdm->removeSubstepCallbacks(&dts);
+    fdm->removeSubstepCallbacks(&outputs);
+    fgSetDouble("/test/substep/in/a", -1.0);
+    fdm->getInterface()->update(frameDt);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), dts.size());
+    CPPUNIT_ASSERT_EQUAL(-2.0, fgGetDouble("/test/substep/out/gain"));
+}
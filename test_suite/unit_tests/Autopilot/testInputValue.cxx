@@ -113,3 +113,44 @@ void InputValueTests::testPropertyPath()
     CPPUNIT_ASSERT(!valueB->is_enabled());
 
 }
+
+void InputValueTests::testConstantFolding()
+{
+    // static values with static transforms are evaluated once
+    auto config = configFromString(R"(<?xml version="1.0" encoding="UTF-8"?>
+                                <PropertyList>
+                                   <value>2</value>
+                                   <scale>3</scale>
+                                   <offset><value>1</value><scale>-2</scale></offset>
+                                   <max>5</max>
+                                </PropertyList>
+                                )");
+
+    InputValue_ptr clamped = new InputValue(*globals->get_props(), *config);
+    CPPUNIT_ASSERT(clamped->isConstant());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, clamped->get_value(), 1e-12);
+
+    auto config2 = configFromString(R"(<?xml version="1.0" encoding="UTF-8"?>
+                                <PropertyList>
+                                   <value>-2.5</value>
+                                   <abs>true</abs>
+                                </PropertyList>
+                                )");
+    InputValue_ptr absolute = new InputValue(*globals->get_props(), *config2);
+    CPPUNIT_ASSERT(absolute->isConstant());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.5, absolute->get_value(), 1e-12);
+
+    // a property anywhere in the transform keeps the value live
+    auto config3 = configFromString(R"(<?xml version="1.0" encoding="UTF-8"?>
+                                <PropertyList>
+                                   <value>2</value>
+                                   <scale><property>/test/folding/scale</property></scale>
+                                </PropertyList>
+                                )");
+    fgSetDouble("/test/folding/scale", 3.0);
+    InputValue_ptr scaled = new InputValue(*globals->get_props(), *config3);
+    CPPUNIT_ASSERT(!scaled->isConstant());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(6.0, scaled->get_value(), 1e-12);
+    fgSetDouble("/test/folding/scale", -1.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(-2.0, scaled->get_value(), 1e-12);
+}
@@ -18,6 +18,7 @@ class InputValueTests : public CppUnit::TestFixture
     // Set up the test suite.
     CPPUNIT_TEST_SUITE(InputValueTests);
     CPPUNIT_TEST(testPropertyPath);
+    CPPUNIT_TEST(testConstantFolding);
     CPPUNIT_TEST_SUITE_END();
 
     SGPropertyNode_ptr configFromString(const std::string& s);
@@ -32,4 +33,5 @@ public:
 
     // The tests.
     void testPropertyPath();
+    void testConstantFolding();
 };
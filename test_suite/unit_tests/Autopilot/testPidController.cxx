@@ -40,15 +40,26 @@ SGPropertyNode_ptr PidControllerTests::configFromString(const std::string& s)
 
 void PidControllerTests::test0()
 {
-    test(false /*startup_current*/);
+    test(false /*startup_current*/, false /*compiled*/);
 }
 
 void PidControllerTests::test1()
 {
-    test(true /*startup_current*/);
+    test(true /*startup_current*/, false /*compiled*/);
 }
 
-void PidControllerTests::test(bool startup_current)
+// The same golden data must come out of the compiled autopilot program.
+void PidControllerTests::test0Compiled()
+{
+    test(false /*startup_current*/, true /*compiled*/);
+}
+
+void PidControllerTests::test1Compiled()
+{
+    test(true /*startup_current*/, true /*compiled*/);
+}
+
+void PidControllerTests::test(bool startup_current, bool compiled)
 {
     sg_srandom(999);
 
@@ -98,6 +109,10 @@ void PidControllerTests::test(bool startup_current)
             (startup_current) ? "<startup-current>true</startup-current>" : "<startup-current>false</startup-current>"
             );
     assert(config_text != config_text0);
+    if (compiled) {
+        from = "<pid-controller>";
+        config_text.replace(config_text.find(from), 0, "<compiled>true</compiled>\n          ");
+    }
     std::cout << "config_text is:\n" << config_text << "\n";
     
     SGPropertyNode_ptr config = configFromString(config_text);
@@ -107,6 +122,7 @@ void PidControllerTests::test(bool startup_current)
     globals->add_subsystem("ap", ap, SGSubsystemMgr::FDM);
     ap->bind();
     ap->init();
+    CPPUNIT_ASSERT_EQUAL(compiled, ap->is_compiled());
 
     const std::vector<PidControllerOutput>& outputs = (startup_current) ? pidControllerOutputs1 : pidControllerOutputs0;
     assert(pidControllerInputs.size() == outputs.size());
@@ -37,6 +37,8 @@ struct PidControllerTests : public CppUnit::TestFixture
     // The tests.
     void test0();
     void test1();
+    void test0Compiled();
+    void test1Compiled();
     
     private:
     
@@ -44,8 +46,10 @@ struct PidControllerTests : public CppUnit::TestFixture
     CPPUNIT_TEST_SUITE(PidControllerTests);
     CPPUNIT_TEST(test0);
     CPPUNIT_TEST(test1);
+    CPPUNIT_TEST(test0Compiled);
+    CPPUNIT_TEST(test1Compiled);
     CPPUNIT_TEST_SUITE_END();
 
     SGPropertyNode_ptr configFromString(const std::string& s);
-    void test(bool startup_zeros);
+    void test(bool startup_zeros, bool compiled);
 };
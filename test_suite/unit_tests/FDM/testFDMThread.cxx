@@ -0,0 +1,162 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testFDMThread.hxx"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <simgear/constants.h>
+
+#include <FDM/FDMThread.hxx>
+#include <FDM/flight.hxx>
+
+using flightgear::FDMThread;
+
+namespace {
+
+// flies north at one degree of latitude per step
+class SteppingFDM : public FGInterface
+{
+public:
+    SteppingFDM() : FGInterface(1.0 / 120) {}
+
+    void update(double dt) override
+    {
+        Pose p = getPose();
+        p.position.setLatitudeDeg(p.position.getLatitudeDeg() + 1.0);
+        setPose(p);
+        ++steps;
+    }
+
+    std::atomic<int> steps{0};
+};
+
+bool waitForSteps(const SteppingFDM& fdm, int count)
+{
+    for (int i = 0; (i < 500) && (fdm.steps < count); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return fdm.steps >= count;
+}
+
+} // of anonymous namespace
+
+void FDMThreadTests::testInterpolation()
+{
+    FGInterface::Pose from{SGGeod::fromDegFt(179.0, 10.0, 1000.0),
+                           SGVec3d(0.0, 0.1, 350.0 * SGD_DEGREES_TO_RADIANS)};
+    FGInterface::Pose to{SGGeod::fromDegFt(-179.0, 12.0, 2000.0),
+                         SGVec3d(0.2, 0.3, 10.0 * SGD_DEGREES_TO_RADIANS)};
+
+    auto mid = FDMThread::interpolate(from, to, 0.5);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(11.0, mid.position.getLatitudeDeg(), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1500.0, mid.position.getElevationFt(), 1e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.1, mid.euler[0], 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.2, mid.euler[1], 1e-9);
+
+    // across the date line and through north, not the long way round
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(180.0, std::fabs(mid.position.getLongitudeDeg()), 1e-9);
+    const double psi = mid.euler[2] * SGD_RADIANS_TO_DEGREES;
+    CPPUNIT_ASSERT(psi < 1e-9 || psi > 360.0 - 1e-9);
+
+    auto end = FDMThread::interpolate(from, to, 1.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(-179.0, end.position.getLongitudeDeg(), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0, end.euler[2] * SGD_RADIANS_TO_DEGREES, 1e-9);
+}
+
+void FDMThreadTests::testSetPose()
+{
+    SteppingFDM fdm;
+    const SGGeod pos = SGGeod::fromDegFt(-3.37, 55.95, 5000.0);
+    fdm.setPose({pos, SGVec3d(0.1, 0.2, 0.3)});
+
+    // the other position representations follow the geodetic one
+    const SGVec3d cart = SGVec3d::fromGeod(pos);
+    const SGGeoc geoc = SGGeoc::fromCart(cart);
+    CPPUNIT_ASSERT(cart == fdm.getCartPosition());
+    CPPUNIT_ASSERT_EQUAL(geoc.getLatitudeRad(), fdm.get_Lat_geocentric());
+    CPPUNIT_ASSERT_EQUAL(geoc.getLongitudeRad(), fdm.get_Lon_geocentric());
+    CPPUNIT_ASSERT_EQUAL(geoc.getRadiusFt(), fdm.get_Radius_to_vehicle());
+    CPPUNIT_ASSERT_EQUAL(0.3, fdm.getPose().euler[2]);
+}
+
+void FDMThreadTests::testSteppingWindow()
+{
+    SteppingFDM fdm;
+    FDMThread thread(&fdm, 1.0 / 120);
+
+    // nothing steps outside a window
+    thread.queue(2.0 / 120);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CPPUNIT_ASSERT_EQUAL(0, fdm.steps.load());
+
+    FDMThread::openWindow();
+    const bool stepped = waitForSteps(fdm, 2);
+    FDMThread::closeWindow();
+    CPPUNIT_ASSERT(stepped);
+    CPPUNIT_ASSERT_EQUAL(2, fdm.steps.load());
+
+    // the presented latitude lies between the last two steps
+    const double lat = fdm.getPose().position.getLatitudeDeg();
+    CPPUNIT_ASSERT(lat >= 1.0 - 1e-9);
+    CPPUNIT_ASSERT(lat <= 2.0 + 1e-9);
+
+    // ... and the FDM carries on from its own pose
+    thread.queue(1.0 / 120);
+    FDMThread::openWindow();
+    const bool steppedAgain = waitForSteps(fdm, 3);
+    FDMThread::closeWindow();
+    CPPUNIT_ASSERT(steppedAgain);
+
+    const double lat2 = fdm.getPose().position.getLatitudeDeg();
+    CPPUNIT_ASSERT(lat2 >= 2.0 - 1e-9);
+    CPPUNIT_ASSERT(lat2 <= 3.0 + 1e-9);
+}
+
+void FDMThreadTests::testInlineCatchUp()
+{
+    SteppingFDM fdm;
+    FDMThread thread(&fdm, 1.0 / 120);
+
+    // without any window, a backlog over the limit is stepped by queue()
+    for (int i = 0; i < 60; ++i) {
+        thread.queue(1.0 / 120);
+    }
+
+    CPPUNIT_ASSERT(fdm.steps > 0);
+    CPPUNIT_ASSERT(fdm.steps <= 60);
+}
+
+void FDMThreadTests::testInlineStepLimit()
+{
+    SteppingFDM fdm;
+    FDMThread thread(&fdm, 1.0 / 120);
+
+    // a long stall is stepped a few steps per frame, not all at once
+    thread.queue(1.0);
+    CPPUNIT_ASSERT_EQUAL(4, fdm.steps.load());
+
+    // the rest was carried over, but only up to the lag limit
+    thread.queue(0.0);
+    CPPUNIT_ASSERT_EQUAL(4, fdm.steps.load());
+    thread.queue(1.0 / 120);
+    CPPUNIT_ASSERT_EQUAL(8, fdm.steps.load());
+    thread.queue(1.0 / 120);
+    CPPUNIT_ASSERT_EQUAL(8, fdm.steps.load());
+}
@@ -0,0 +1,251 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_radioPropagation.hxx"
+
+#include <memory>
+#include <thread>
+
+#include "test_suite/FGTestApi/PrivateAccessorRadio.hxx"
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <simgear/timing/timestamp.hxx>
+
+#include <Main/fg_props.hxx>
+#include <Main/globals.hxx>
+#include <Radio/propagation.hxx>
+
+namespace {
+
+// The pilot, 1000 m over flat terrain.
+const SGGeod ownPos = SGGeod::fromDegM(8.0, 47.0, 1000.0);
+
+// A request as FGRadioTransmission::ITM_prepare() would make it for a
+// ground station at the given position, without needing any scenery.
+FGRadioITMRequest makeRequest(double senderLon, double senderLat)
+{
+    FGRadioITMRequest request;
+    request.freq = 118.5;
+    request.transmission_type = 1;
+    request.own_pos = ownPos;
+    request.sender_pos = SGGeod::fromDegM(senderLon, senderLat, 0.0);
+    request.point_distance = 500.0;
+    request.transmitter_height = 10.0;
+    request.receiver_height = 1000.0;
+    request.distance_m = SGGeodesy::distanceM(request.own_pos, request.sender_pos);
+    request.course = SGGeodesy::courseRad(SGGeoc::fromGeod(request.own_pos),
+                                          SGGeoc::fromGeod(request.sender_pos));
+    request.reverse_course = SGGeodesy::courseRad(SGGeoc::fromGeod(request.sender_pos),
+                                                  SGGeoc::fromGeod(request.own_pos));
+    return request;
+}
+
+// A complete profile at sea level, as sampled over loaded terrain.
+std::shared_ptr<const FGRadioTerrainProfile> flatProfile(const FGRadioITMRequest& request)
+{
+    auto profile = std::make_shared<FGRadioTerrainProfile>(request.own_pos, request.sender_pos,
+                                                           request.point_distance);
+    while (!profile->complete()) {
+        profile->elevations.push_back(0.0);
+        profile->materials.push_back("None");
+    }
+    return profile;
+}
+
+int stat(const char* name)
+{
+    return fgGetInt(std::string("/sim/radio/propagation/") + name);
+}
+
+} // anonymous namespace
+
+
+// Set up function for each test.
+void RadioPropagationTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("radioPropagation");
+}
+
+
+// Clean up after each test.
+void RadioPropagationTests::tearDown()
+{
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+
+FGRadioPropagation* RadioPropagationTests::createPropagation(bool thread)
+{
+    fgSetBool("/sim/radio/propagation-thread", thread);
+    auto propagation = globals->add_new_subsystem<FGRadioPropagation>(SGSubsystemMgr::POST_FDM);
+    propagation->init();
+    return propagation;
+}
+
+
+// Complete profiles are cached by path, and the least recently used one is
+// evicted once the cache is full. Profiles with terrain missing (there is
+// no scenery here at all) are never cached.
+void RadioPropagationTests::testProfileCache()
+{
+    FGTestApi::PrivateAccessor::Radio::Accessor accessor;
+    fgSetInt("/sim/radio/profile-cache-size", 2);
+    auto propagation = createPropagation(false);
+
+    const FGRadioITMRequest a = makeRequest(8.0, 47.15);
+    const FGRadioITMRequest b = makeRequest(8.25, 47.0);
+    const FGRadioITMRequest c = makeRequest(8.0, 46.85);
+    const auto profileA = flatProfile(a);
+    const auto profileB = flatProfile(b);
+    CPPUNIT_ASSERT(accessor.call_Radio_FGRadioPropagation_addProfile(propagation, a, profileA));
+    CPPUNIT_ASSERT(accessor.call_Radio_FGRadioPropagation_addProfile(propagation, b, profileB));
+
+    int calls = 0;
+    std::shared_ptr<const FGRadioTerrainProfile> used;
+    auto callback = [&](const FGRadioITMRequest& result) {
+        ++calls;
+        used = result.profile;
+    };
+
+    // a hit runs the model straight away, the result comes from update()
+    propagation->submit(a, callback);
+    CPPUNIT_ASSERT_EQUAL(1, stat("cache-hits"));
+    CPPUNIT_ASSERT_EQUAL(0, stat("cache-misses"));
+    CPPUNIT_ASSERT_EQUAL(0, calls);
+    propagation->update(0.1);
+    CPPUNIT_ASSERT_EQUAL(1, calls);
+    CPPUNIT_ASSERT(used == profileA);
+
+    // a path in the same quantisation cells shares the profile
+    propagation->submit(makeRequest(8.0005, 47.1502), callback);
+    propagation->update(0.1);
+    CPPUNIT_ASSERT_EQUAL(2, stat("cache-hits"));
+    CPPUNIT_ASSERT(used == profileA);
+
+    // A was used last, so B makes room for C
+    CPPUNIT_ASSERT(accessor.call_Radio_FGRadioPropagation_addProfile(propagation, c, flatProfile(c)));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), accessor.read_Radio_FGRadioPropagation_cacheSize(propagation));
+    CPPUNIT_ASSERT(propagation->getProfile(a) == profileA);
+    CPPUNIT_ASSERT_EQUAL(3, stat("cache-hits"));
+
+    propagation->submit(b, callback);
+    CPPUNIT_ASSERT_EQUAL(1, stat("cache-misses"));
+    propagation->update(0.1);
+    CPPUNIT_ASSERT_EQUAL(3, calls);
+    CPPUNIT_ASSERT(used != profileB);
+    CPPUNIT_ASSERT(used->missing > 0);
+    CPPUNIT_ASSERT_EQUAL(0, stat("pending"));
+
+    // sampled without terrain, so B is still not cached
+    propagation->submit(b, callback);
+    CPPUNIT_ASSERT_EQUAL(2, stat("cache-misses"));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), accessor.read_Radio_FGRadioPropagation_cacheSize(propagation));
+
+    // paths too short for the quantisation are never cached
+    CPPUNIT_ASSERT(!accessor.call_Radio_FGRadioPropagation_addProfile(propagation, makeRequest(8.0, 47.02),
+                                                                      profileA));
+}
+
+
+// Terrain sampling is spread over frames, samples-per-frame points at a
+// time, shared by all pending profiles in submission order. Requests for a
+// path already being sampled wait for the same profile.
+void RadioPropagationTests::testSamplesPerFrame()
+{
+    fgSetInt("/sim/radio/samples-per-frame", 10);
+    auto propagation = createPropagation(false);
+
+    std::shared_ptr<const FGRadioTerrainProfile> first, second, shared;
+    int firstFrame = 0, secondFrame = 0, sharedFrame = 0;
+    int frame = 0;
+    propagation->submit(makeRequest(8.0, 47.15), [&](const FGRadioITMRequest& result) {
+        first = result.profile;
+        firstFrame = frame;
+    });
+    propagation->submit(makeRequest(8.25, 47.0), [&](const FGRadioITMRequest& result) {
+        second = result.profile;
+        secondFrame = frame;
+    });
+    propagation->submit(makeRequest(8.0, 47.15), [&](const FGRadioITMRequest& result) {
+        shared = result.profile;
+        sharedFrame = frame;
+    });
+    CPPUNIT_ASSERT_EQUAL(3, stat("cache-misses"));
+
+    while (!second && (frame < 100)) {
+        ++frame;
+        propagation->update(0.1);
+        if (!second) {
+            CPPUNIT_ASSERT(stat("pending") > 0);
+        }
+    }
+    CPPUNIT_ASSERT(first && second);
+    CPPUNIT_ASSERT_EQUAL(0, stat("pending"));
+
+    // whole frames of samples until both profiles were complete
+    const size_t firstSamples = first->elevations.size();
+    const size_t totalSamples = firstSamples + second->elevations.size();
+    CPPUNIT_ASSERT(firstSamples > 30);
+    CPPUNIT_ASSERT_EQUAL(int((firstSamples + 9) / 10), firstFrame);
+    CPPUNIT_ASSERT_EQUAL(int((totalSamples + 9) / 10), secondFrame);
+
+    CPPUNIT_ASSERT(shared == first);
+    CPPUNIT_ASSERT_EQUAL(firstFrame, sharedFrame);
+}
+
+
+// With the worker thread, the model runs off the main thread but the
+// callback is only ever delivered by update(), on the main thread.
+void RadioPropagationTests::testWorkerCallback()
+{
+    FGTestApi::PrivateAccessor::Radio::Accessor accessor;
+    auto propagation = createPropagation(true);
+
+    const FGRadioITMRequest a = makeRequest(8.0, 47.15);
+    CPPUNIT_ASSERT(accessor.call_Radio_FGRadioPropagation_addProfile(propagation, a, flatProfile(a)));
+
+    const std::thread::id mainThread = std::this_thread::get_id();
+    int calls = 0;
+    bool onMainThread = false;
+    FGRadioITMRequest result;
+    propagation->submit(a, [&](const FGRadioITMRequest& r) {
+        ++calls;
+        onMainThread = std::this_thread::get_id() == mainThread;
+        result = r;
+    });
+
+    // however long the worker takes, nothing is delivered behind our back
+    SGTimeStamp::sleepForMSec(100);
+    CPPUNIT_ASSERT_EQUAL(0, calls);
+
+    for (int i = 0; (i < 500) && (calls == 0); ++i) {
+        propagation->update(0.01);
+        if (calls == 0)
+            SGTimeStamp::sleepForMSec(10);
+    }
+    CPPUNIT_ASSERT_EQUAL(1, calls);
+    CPPUNIT_ASSERT(onMainThread);
+    CPPUNIT_ASSERT_EQUAL(0, stat("pending"));
+
+    // the model did run on the flat profile
+    CPPUNIT_ASSERT(!result.prop_mode.empty());
+    CPPUNIT_ASSERT(result.dbloss > 0.0);
+
+    // no second delivery
+    propagation->update(0.01);
+    CPPUNIT_ASSERT_EQUAL(1, calls);
+}
@@ -0,0 +1,51 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class FGRadioPropagation;
+
+
+// The unit tests of the asynchronous ITM radio propagation.
+class RadioPropagationTests : public CppUnit::TestFixture
+{
+    // Set up the test suite.
+    CPPUNIT_TEST_SUITE(RadioPropagationTests);
+    CPPUNIT_TEST(testProfileCache);
+    CPPUNIT_TEST(testSamplesPerFrame);
+    CPPUNIT_TEST(testWorkerCallback);
+    CPPUNIT_TEST_SUITE_END();
+
+    FGRadioPropagation* createPropagation(bool thread);
+
+public:
+    // Set up function for each test.
+    void setUp();
+
+    // Clean up after each test.
+    void tearDown();
+
+    // The tests.
+    void testProfileCache();
+    void testSamplesPerFrame();
+    void testWorkerCallback();
+};
@@ -18,11 +18,17 @@
  */
 
 #include "test_autosaveMigration.hxx"
+#include "test_fgProps.hxx"
 #include "test_posinit.hxx"
+#include "test_sceneCommands.hxx"
+#include "test_subsystemScheduler.hxx"
 #include "test_timeManager.hxx"
 
 
 // Set up the unit tests.
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(AutosaveMigrationTests, "Unit tests");
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(FGPropsTests, "Unit tests");
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(PosInitTests, "Unit tests");
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(SceneCommandsTests, "Unit tests");
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(SubsystemSchedulerTests, "Unit tests");
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(TimeManagerTests, "Unit tests");
@@ -0,0 +1,172 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "config.h"
+
+#include "test_fgProps.hxx"
+
+#include <cstring>
+#include <sstream>
+
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include "Main/PropertyAccessStats.hxx"
+#include "Main/fg_props.hxx"
+#include "Main/globals.hxx"
+
+using flightgear::PropertyAccessStats;
+
+namespace {
+
+class CountingListener : public SGPropertyChangeListener
+{
+public:
+    void valueChanged(SGPropertyNode*) override { ++changes; }
+
+    int changes = 0;
+};
+
+} // of anonymous namespace
+
+
+// Set up function for each test.
+void FGPropsTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("fgProps");
+}
+
+
+// Clean up after each test.
+void FGPropsTests::tearDown()
+{
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+
+void FGPropsTests::testPathCache()
+{
+    CPPUNIT_ASSERT(!fgHasNode("/test/cache/a"));
+    CPPUNIT_ASSERT_EQUAL(3.5, fgGetDouble("/test/cache/a", 3.5));
+
+    CPPUNIT_ASSERT(fgSetDouble("/test/cache/a", 1.25));
+    CPPUNIT_ASSERT_EQUAL(1.25, fgGetDouble("/test/cache/a"));
+
+    SGPropertyNode_ptr a = globals->get_props()->getNode("test/cache/a");
+    CPPUNIT_ASSERT(a);
+    CPPUNIT_ASSERT_EQUAL(a.get(), fgGetNode("/test/cache/a"));
+
+    // values written through the node are seen by the cached lookup
+    a->setDoubleValue(-2.0);
+    CPPUNIT_ASSERT_EQUAL(-2.0, fgGetDouble("/test/cache/a"));
+    CPPUNIT_ASSERT_EQUAL(-2.0f, fgGetFloat("/test/cache/a"));
+    CPPUNIT_ASSERT_EQUAL(-2, fgGetInt("/test/cache/a"));
+
+    // a buffer reused for a different path must not return the old node
+    char buf[64];
+    strcpy(buf, "/test/cache/x");
+    fgSetInt(buf, 1);
+    strcpy(buf, "/test/cache/y");
+    fgSetInt(buf, 2);
+    CPPUNIT_ASSERT_EQUAL(1, fgGetInt("/test/cache/x"));
+    CPPUNIT_ASSERT_EQUAL(2, fgGetInt("/test/cache/y"));
+    CPPUNIT_ASSERT_EQUAL(2, fgGetInt(buf));
+
+    fgSetString("/test/cache/s", "hello");
+    CPPUNIT_ASSERT_EQUAL(std::string{"hello"}, fgGetString("/test/cache/s"));
+    fgSetBool("/test/cache/b", true);
+    CPPUNIT_ASSERT(fgGetBool("/test/cache/b"));
+}
+
+
+void FGPropsTests::testPathCacheRemoval()
+{
+    fgSetDouble("/test/cache/a", 1.0);
+    SGPropertyNode_ptr first = fgGetNode("/test/cache/a");
+    CPPUNIT_ASSERT(first);
+
+    // removing the node itself
+    fgGetNode("/test/cache", true)->removeChild("a", 0);
+    CPPUNIT_ASSERT(!fgHasNode("/test/cache/a"));
+    CPPUNIT_ASSERT_EQUAL(5.0, fgGetDouble("/test/cache/a", 5.0));
+
+    fgSetDouble("/test/cache/a", 2.0);
+    SGPropertyNode_ptr second = fgGetNode("/test/cache/a");
+    CPPUNIT_ASSERT(second);
+    CPPUNIT_ASSERT(first != second);
+    CPPUNIT_ASSERT_EQUAL(2.0, fgGetDouble("/test/cache/a"));
+    // the removed node is cleared and flagged, not reused by the cache
+    CPPUNIT_ASSERT(first->getAttribute(SGPropertyNode::REMOVED));
+
+    // removing an ancestor
+    globals->get_props()->removeChild("test", 0);
+    CPPUNIT_ASSERT(!fgHasNode("/test/cache/a"));
+    CPPUNIT_ASSERT_EQUAL(7.0, fgGetDouble("/test/cache/a", 7.0));
+
+    fgSetDouble("/test/cache/a", 3.0);
+    CPPUNIT_ASSERT(second != fgGetNode("/test/cache/a"));
+    CPPUNIT_ASSERT_EQUAL(3.0, fgGetDouble("/test/cache/a"));
+}
+
+
+void FGPropsTests::testAccessStats()
+{
+    PropertyAccessStats stats;
+
+    // nothing is counted until enabled
+    fgSetDouble("/test/stats/hot", 1.0);
+    stats.setEnabled(true, globals->get_props());
+    CPPUNIT_ASSERT(stats.isEnabled());
+
+    CountingListener listener;
+    fgGetNode("/test/stats/watched", true)->addChangeListener(&listener);
+
+    for (int frame = 0; frame < 4; ++frame) {
+        for (int i = 0; i < 10; ++i) {
+            fgGetDouble("/test/stats/hot");
+        }
+        fgGetString("/test/stats/hot");
+        fgSetInt("/test/stats/watched", frame);
+        stats.frameDone();
+    }
+
+    CPPUNIT_ASSERT_EQUAL(4, listener.changes);
+
+    SGPropertyNode_ptr out = globals->get_props()->getNode("test/stats-out", true);
+    stats.updateProperties(out, 2);
+    CPPUNIT_ASSERT_EQUAL(4L, out->getLongValue("frames"));
+    CPPUNIT_ASSERT_EQUAL(2, out->nChildren() - 1);
+
+    // 11 gets a frame, one of which converts a double to a string
+    SGPropertyNode* hot = out->getChild("entry", 0);
+    CPPUNIT_ASSERT_EQUAL(std::string{"/test/stats/hot"}, hot->getStringValue("path"));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(11.0, hot->getDoubleValue("get"), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, hot->getDoubleValue("string-conversion"), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, hot->getDoubleValue("set"), 1e-9);
+
+    std::ostringstream os;
+    stats.writeReport(os, 10);
+    CPPUNIT_ASSERT(os.str().find("/test/stats/hot") != std::string::npos);
+    CPPUNIT_ASSERT(os.str().find("/test/stats/watched") != std::string::npos);
+
+    stats.setEnabled(false, nullptr);
+    CPPUNIT_ASSERT(!stats.isEnabled());
+    fgGetDouble("/test/stats/hot");
+
+    stats.reset();
+    std::ostringstream empty;
+    stats.writeReport(empty, 10);
+    CPPUNIT_ASSERT(empty.str().find("/test/stats/hot") == std::string::npos);
+
+    fgGetNode("/test/stats/watched")->removeChangeListener(&listener);
+}
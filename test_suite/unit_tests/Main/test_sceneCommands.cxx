@@ -0,0 +1,63 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "config.h"
+
+#include "test_sceneCommands.hxx"
+
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <simgear/structure/commands.hxx>
+
+#include "Main/fg_commands.hxx"
+#include "Main/fg_props.hxx"
+#include "Main/globals.hxx"
+
+
+// Set up function for each test.
+void SceneCommandsTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("sceneCommands");
+    fgInitSceneCommands();
+}
+
+
+// Clean up after each test.
+void SceneCommandsTests::tearDown()
+{
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+
+// Headless runs have no "gui" subsystem, but Nasal still calls the dialog
+// commands: they must fail instead of crashing.
+void SceneCommandsTests::testHeadlessDialogs()
+{
+    CPPUNIT_ASSERT(fgGetBool("/sim/headless/enabled"));
+    CPPUNIT_ASSERT(!globals->get_subsystem("gui"));
+
+    SGPropertyNode_ptr args(new SGPropertyNode);
+    args->setStringValue("dialog-name", "map");
+
+    auto commands = globals->get_commands();
+    for (auto name : {"dialog-show", "dialog-toggle", "dialog-close",
+                      "dialog-update", "dialog-apply", "gui-redraw"}) {
+        CPPUNIT_ASSERT_MESSAGE(name, !commands->execute(name, args));
+    }
+
+    // and without a dialog name, acting on the active dialog
+    SGPropertyNode_ptr noArgs(new SGPropertyNode);
+    CPPUNIT_ASSERT(!commands->execute("dialog-close", noArgs));
+    CPPUNIT_ASSERT(!commands->execute("dialog-apply", noArgs));
+}
@@ -0,0 +1,251 @@
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "config.h"
+
+#include "test_subsystemScheduler.hxx"
+
+
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <simgear/structure/subsystem_mgr.hxx>
+#include <simgear/timing/timestamp.hxx>
+
+#include "Main/SubsystemScheduler.hxx"
+#include "Main/globals.hxx"
+
+using flightgear::SubsystemScheduler;
+
+namespace {
+
+// records the order members ran in
+struct UpdateLog
+{
+    string_list order;
+};
+
+class RecordingSubsystem : public SGSubsystem
+{
+public:
+    RecordingSubsystem(UpdateLog& log, const std::string& name, int costMSec = 0) :
+        _log(log),
+        _name(name),
+        _costMSec(costMSec)
+    {
+    }
+
+    void update(double dt) override
+    {
+        if (_costMSec > 0) {
+            SGTimeStamp::sleepForMSec(_costMSec);
+        }
+
+        _log.order.push_back(_name);
+        totalDt += dt;
+        ++updates;
+    }
+
+    double totalDt = 0.0;
+    int updates = 0;
+
+private:
+    UpdateLog& _log;
+    const std::string _name;
+    const int _costMSec;
+};
+
+} // of anonymous namespace
+
+
+// Set up function for each test.
+void SubsystemSchedulerTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("subsystemScheduler");
+}
+
+
+// Clean up after each test.
+void SubsystemSchedulerTests::tearDown()
+{
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+
+void SubsystemSchedulerTests::testWaves()
+{
+    UpdateLog log;
+    SGSubsystemMgr mgr;
+    for (auto name : {"a", "b", "c", "d", "e"}) {
+        mgr.add(name, new RecordingSubsystem(log, name), SGSubsystemMgr::GENERAL);
+    }
+
+    SubsystemScheduler scheduler(&mgr);
+    scheduler.declare("a", {"/a"}, {"/x"});
+    scheduler.declare("b", {"/position"}, {"/y"});
+    // c is undeclared, so it runs on its own
+    scheduler.declare("d", {}, {"/x/child"});
+    scheduler.declare("e", {}, {"/z"}, {"b"});
+
+    auto waves = scheduler.waves(SGSubsystemMgr::GENERAL);
+    CPPUNIT_ASSERT_EQUAL(size_t{3}, waves.size());
+    CPPUNIT_ASSERT((waves[0] == string_list{"a", "b"}));
+    CPPUNIT_ASSERT((waves[1] == string_list{"c"}));
+    CPPUNIT_ASSERT((waves[2] == string_list{"d", "e"}));
+
+    mgr.remove("c");
+    waves = scheduler.waves(SGSubsystemMgr::GENERAL);
+    CPPUNIT_ASSERT_EQUAL(size_t{2}, waves.size());
+    CPPUNIT_ASSERT((waves[0] == string_list{"a", "b"}));
+    CPPUNIT_ASSERT((waves[1] == string_list{"d", "e"}));
+
+    // without the ordering edge e joins the first wave
+    scheduler.declare("e", {}, {"/z"});
+    waves = scheduler.waves(SGSubsystemMgr::GENERAL);
+    CPPUNIT_ASSERT_EQUAL(size_t{2}, waves.size());
+    CPPUNIT_ASSERT((waves[0] == string_list{"a", "b", "e"}));
+    CPPUNIT_ASSERT((waves[1] == string_list{"d"}));
+
+    // a write overlapping an earlier read forces a new wave
+    scheduler.declare("e", {}, {"/position/latitude-deg"});
+    waves = scheduler.waves(SGSubsystemMgr::GENERAL);
+    CPPUNIT_ASSERT_EQUAL(size_t{2}, waves.size());
+    CPPUNIT_ASSERT((waves[0] == string_list{"a", "b"}));
+    CPPUNIT_ASSERT((waves[1] == string_list{"d", "e"}));
+
+    // groups which are not scheduled keep one member per wave
+    mgr.add("f", new RecordingSubsystem(log, "f"), SGSubsystemMgr::DISPLAY);
+    scheduler.declare("f", {}, {});
+    CPPUNIT_ASSERT_EQUAL(size_t{1}, scheduler.waves(SGSubsystemMgr::DISPLAY).size());
+}
+
+
+void SubsystemSchedulerTests::testTimedUpdate()
+{
+    UpdateLog log;
+    SGSubsystemMgr mgr;
+    std::vector<RecordingSubsystem*> subsystems;
+    for (auto name : {"a", "b", "c", "d", "e"}) {
+        // c is cheap, the others take a couple of milliseconds
+        auto s = new RecordingSubsystem(log, name, (name[0] == 'c') ? 0 : 2);
+        subsystems.push_back(s);
+        mgr.add(name, s, SGSubsystemMgr::POST_FDM);
+    }
+    mgr.bind();
+    mgr.init();
+
+    SubsystemScheduler scheduler(&mgr);
+    scheduler.declare("a", {}, {"/a"});
+    scheduler.declare("b", {}, {"/b"});
+    scheduler.declare("d", {}, {"/d"});
+    scheduler.declare("e", {}, {"/e"});
+
+    // disabled: the plain manager update, in registration order
+    scheduler.update(0.1);
+    CPPUNIT_ASSERT((log.order == string_list{"a", "b", "c", "d", "e"}));
+
+    scheduler.setEnabled(true);
+    CPPUNIT_ASSERT(scheduler.isEnabled());
+
+    // enabled: still registration order, on this thread
+    const int frames = 5;
+    for (int f = 0; f < frames; ++f) {
+        log.order.clear();
+        scheduler.update(0.1);
+        CPPUNIT_ASSERT((log.order == string_list{"a", "b", "c", "d", "e"}));
+    }
+
+    for (auto s : subsystems) {
+        CPPUNIT_ASSERT_EQUAL(frames + 1, s->updates);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL((frames + 1) * 0.1, s->totalDt, 1e-9);
+    }
+
+    // timing is published per member of the scheduled groups
+    SGPropertyNode_ptr timing(new SGPropertyNode);
+    scheduler.publishTiming(timing);
+    CPPUNIT_ASSERT_EQUAL(5, static_cast<int>(timing->getChildren("subsystem").size()));
+    CPPUNIT_ASSERT_EQUAL(std::string{"c"}, timing->getStringValue("subsystem[2]/name"));
+    CPPUNIT_ASSERT_EQUAL(1, timing->getIntValue("subsystem[2]/wave"));
+    CPPUNIT_ASSERT(!timing->getBoolValue("subsystem[2]/declared"));
+    CPPUNIT_ASSERT(timing->getDoubleValue("subsystem[0]/mean-ms") >= 2.0);
+
+    // the waves {a, b}, {c}, {d, e} could take two members' time, not four
+    const double serial = timing->getDoubleValue("group[3]/last-ms");
+    const double critical = timing->getDoubleValue("group[3]/critical-path-ms");
+    CPPUNIT_ASSERT_EQUAL(3, timing->getIntValue("group[3]/waves"));
+    CPPUNIT_ASSERT(serial >= 8.0);
+    CPPUNIT_ASSERT(critical >= 4.0);
+    CPPUNIT_ASSERT(critical < serial - 2.0);
+}
+
+
+void SubsystemSchedulerTests::testMinStep()
+{
+    UpdateLog log;
+    SGSubsystemMgr mgr;
+    auto slow = new RecordingSubsystem(log, "slow");
+    auto fast = new RecordingSubsystem(log, "fast");
+    mgr.add("slow", slow, SGSubsystemMgr::GENERAL);
+    mgr.add("fast", fast, SGSubsystemMgr::GENERAL);
+    mgr.bind();
+    mgr.init();
+
+    SubsystemScheduler scheduler(&mgr);
+    scheduler.setMinStep("slow", 0.25);
+    scheduler.setEnabled(true);
+
+    for (int f = 0; f < 10; ++f) {
+        scheduler.update(0.1);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(10, fast->updates);
+    CPPUNIT_ASSERT_EQUAL(3, slow->updates);
+    // the skipped time is handed over on the next update
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.9, slow->totalDt, 1e-9);
+
+    slow->suspend();
+    scheduler.update(0.3);
+    CPPUNIT_ASSERT_EQUAL(3, slow->updates);
+    CPPUNIT_ASSERT_EQUAL(11, fast->updates);
+
+    // and time accumulated while suspended arrives once resumed
+    slow->resume();
+    scheduler.update(0.1);
+    CPPUNIT_ASSERT_EQUAL(4, slow->updates);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.4, slow->totalDt, 1e-9);
+}
+
+
+void SubsystemSchedulerTests::testMinStepHandover()
+{
+    UpdateLog log;
+    SGSubsystemMgr mgr;
+    auto slow = new RecordingSubsystem(log, "slow");
+    mgr.add("slow", slow, SGSubsystemMgr::GENERAL, 0.25);
+    mgr.bind();
+    mgr.init();
+
+    SubsystemScheduler scheduler(&mgr);
+    scheduler.setMinStep("slow", 0.25);
+
+    // switching mode every four frames, part way through the minimum step,
+    // neither drops nor repeats any time
+    for (int f = 0; f < 12; ++f) {
+        scheduler.setEnabled((f / 4) == 1);
+        scheduler.update(0.1);
+    }
+
+    CPPUNIT_ASSERT(!scheduler.isEnabled());
+    CPPUNIT_ASSERT_EQUAL(4, slow->updates);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.2, slow->totalDt, 1e-9);
+}
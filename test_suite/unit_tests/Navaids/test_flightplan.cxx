@@ -23,6 +23,7 @@
 #include "test_flightplan.hxx"
 
 #include <algorithm>
+#include <iostream>
 
 #include "test_suite/FGTestApi/testGlobals.hxx"
 #include "test_suite/FGTestApi/NavDataCache.hxx"
@@ -31,6 +32,7 @@
 #include <simgear/misc/sg_dir.hxx>
 #include <simgear/io/iostreams/sgstream.hxx>
 #include <simgear/structure/exception.hxx>
+#include <simgear/timing/timestamp.hxx>
 
 #include <Navaids/FlightPlan.hxx>
 #include <Navaids/routePath.hxx>
@@ -41,7 +43,9 @@
 #include <Navaids/airways.hxx>
 #include <Navaids/fix.hxx>
 
+#include <Aircraft/AircraftPerformance.hxx>
 #include <Airports/airport.hxx>
+#include <Main/fg_props.hxx>
 
 using namespace std::string_literals;
 using namespace flightgear;
@@ -812,6 +816,150 @@ void FlightplanTests::testRadialIntercept()
     CPPUNIT_ASSERT_DOUBLES_EQUAL(232, f->legAtIndex(3)->courseDeg(), 1.0);
 }
 
+// the cached path must match one computed from scratch, exactly
+static void checkCachedRoutePath(FlightPlanRef fp)
+{
+    const RoutePath& cached = fp->routePath();
+    RoutePath fresh(fp);
+
+    for (int l = 0; l < fp->numLegs(); ++l) {
+        CPPUNIT_ASSERT_EQUAL(fresh.trackForIndex(l), cached.trackForIndex(l));
+        CPPUNIT_ASSERT_EQUAL(fresh.distanceForIndex(l), cached.distanceForIndex(l));
+        const SGGeod a = fresh.positionForIndex(l), b = cached.positionForIndex(l);
+        CPPUNIT_ASSERT_EQUAL(a.getLatitudeDeg(), b.getLatitudeDeg());
+        CPPUNIT_ASSERT_EQUAL(a.getLongitudeDeg(), b.getLongitudeDeg());
+        CPPUNIT_ASSERT_EQUAL(fresh.pathForIndex(l).size(), cached.pathForIndex(l).size());
+    }
+}
+
+void FlightplanTests::testRoutePathIncremental()
+{
+    FlightPlanRef fp = makeTestFP("EGHI"s, "20"s, "EDDM"s, "08L"s,
+                                  "SFD LYD BNE CIV ELLX LUX SAA KRH WLD"s);
+    auto ha = new HeadingToAltitude(fp, "TO_5000"s, 200);
+    ha->setAltitude(5000, RESTRICT_AT);
+    fp->insertWayptAtIndex(ha, 1);
+    checkCachedRoutePath(fp);
+
+    // edits in the middle only recompute the legs around them
+    RoutePath rp(fp);
+    fp->insertWayptAtIndex(new BasicWaypt(SGGeod::fromDeg(3.0, 50.5), "MID"s, fp), 6);
+    const int recomputed = rp.update(fp);
+    CPPUNIT_ASSERT(recomputed > 0);
+    CPPUNIT_ASSERT(recomputed < fp->numLegs() - 4);
+    CPPUNIT_ASSERT_EQUAL(0, rp.update(fp));
+    checkCachedRoutePath(fp);
+
+    fp->deleteIndex(8);
+    checkCachedRoutePath(fp);
+
+    // waypoint changes which don't go through the flight-plan
+    fp->legAtIndex(4)->waypoint()->setFlag(WPT_OVERFLIGHT);
+    checkCachedRoutePath(fp);
+    fp->legAtIndex(5)->waypoint()->setAltitude(12000, RESTRICT_AT);
+    checkCachedRoutePath(fp);
+
+    fp->insertWayptAtIndex(new Discontinuity(fp), 7);
+    checkCachedRoutePath(fp);
+    fp->deleteIndex(7);
+    checkCachedRoutePath(fp);
+
+    fp->setFollowLegTrackToFixes(false);
+    checkCachedRoutePath(fp);
+
+    // the turn radius, and so the distances, depend on the aircraft category
+    auto totalDistance = [fp]() {
+        double d = 0.0;
+        for (int l = 0; l < fp->numLegs(); ++l) {
+            d += fp->routePath().distanceForIndex(l);
+        }
+        return d;
+    };
+    const double defaultDistance = totalDistance();
+    fgSetString("/aircraft/performance/icao-category", "A");
+    checkCachedRoutePath(fp);
+    CPPUNIT_ASSERT(totalDistance() != defaultDistance);
+    fgSetString("/aircraft/performance/icao-category", "");
+    checkCachedRoutePath(fp);
+    CPPUNIT_ASSERT_EQUAL(defaultDistance, totalDistance());
+
+    // the data is only re-read when something below /aircraft/performance
+    // changes, however deep
+    const unsigned int revision = AircraftPerformance::dataRevision();
+    checkCachedRoutePath(fp);
+    CPPUNIT_ASSERT_EQUAL(revision, AircraftPerformance::dataRevision());
+    fgSetInt("/aircraft/performance/bracket/at-or-below-ft", 10000);
+    CPPUNIT_ASSERT(AircraftPerformance::dataRevision() != revision);
+    fgGetNode("/aircraft/performance")->removeChildren("bracket");
+    checkCachedRoutePath(fp);
+    CPPUNIT_ASSERT_EQUAL(defaultDistance, totalDistance());
+
+    fp->deleteIndex(0);
+    checkCachedRoutePath(fp);
+    fp->deleteIndex(-1);
+    checkCachedRoutePath(fp);
+
+    fp->clearLegs();
+    checkCachedRoutePath(fp);
+    CPPUNIT_ASSERT_EQUAL(0.0, fp->routePath().distanceForIndex(0));
+}
+
+void FlightplanTests::testRoutePathBenchmark()
+{
+    FlightPlanRef fp = makeTestFP("EGHI"s, "20"s, "EDDM"s, "08L"s, "SFD"s);
+
+    // zig-zag from the channel to Munich
+    WayptVec wps;
+    const int legCount = 200;
+    for (int i = 0; i < legCount; ++i) {
+        const double t = i / static_cast<double>(legCount);
+        const double lon = 0.5 + t * 11.0;
+        const double lat = 50.5 - t * 2.5 + ((i % 2) ? 0.1 : -0.1);
+        wps.push_back(new BasicWaypt(SGGeod::fromDeg(lon, lat), "WP" + std::to_string(i), fp));
+    }
+    fp->insertWayptsAtIndex(wps, 2);
+    CPPUNIT_ASSERT(fp->numLegs() > legCount);
+    checkCachedRoutePath(fp);
+
+    // per-leg queries, as a map display does each frame
+    const int frames = 5;
+    SGTimeStamp timer;
+    timer.stamp();
+    for (int f = 0; f < frames; ++f) {
+        for (int l = 0; l < fp->numLegs(); ++l) {
+            RoutePath path(fp);
+            path.pathForIndex(l);
+        }
+    }
+    const double freshMsec = timer.elapsedMSec() / static_cast<double>(frames);
+
+    timer.stamp();
+    for (int f = 0; f < frames; ++f) {
+        for (int l = 0; l < fp->numLegs(); ++l) {
+            fp->routePath().pathForIndex(l);
+        }
+    }
+    const double cachedMsec = timer.elapsedMSec() / static_cast<double>(frames);
+
+    // a single edit in the middle of the plan
+    RoutePath rp(fp);
+    timer.stamp();
+    RoutePath full(fp);
+    const double fullUsec = timer.elapsedUSec();
+
+    fp->insertWayptAtIndex(new BasicWaypt(SGGeod::fromDeg(6.0, 49.2), "EDIT"s, fp), legCount / 2);
+    timer.stamp();
+    const int recomputed = rp.update(fp);
+    const double updateUsec = timer.elapsedUSec();
+    CPPUNIT_ASSERT(recomputed < 10);
+    checkCachedRoutePath(fp);
+
+    std::cout << "\nRoutePath, " << fp->numLegs() << " legs: per-leg queries "
+              << freshMsec << " ms/frame rebuilding, " << cachedMsec << " ms/frame cached; "
+              << "full build " << fullUsec << " us, edit update " << updateUsec
+              << " us (" << recomputed << " legs)" << std::endl;
+}
+
 void FlightplanTests::loadFGFPWithoutDepartureArrival()
 {
     static_factory = std::make_shared<TestFPDelegateFactory>();
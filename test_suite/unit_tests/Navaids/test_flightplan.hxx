@@ -46,6 +46,8 @@ class FlightplanTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testBasicDiscontinuity);
     CPPUNIT_TEST(testLeadingWPDynamic);
     CPPUNIT_TEST(testRadialIntercept);
+    CPPUNIT_TEST(testRoutePathIncremental);
+    CPPUNIT_TEST(testRoutePathBenchmark);
     CPPUNIT_TEST(loadFGFPWithoutDepartureArrival);
     CPPUNIT_TEST(loadFGFPWithEmbeddedProcedures);
     CPPUNIT_TEST(loadFGFPWithOldProcedures);
@@ -88,6 +90,8 @@ public:
     void testOnlyDiscontinuityRoute();
     void testLeadingWPDynamic();
     void testRadialIntercept();
+    void testRoutePathIncremental();
+    void testRoutePathBenchmark();
     void loadFGFPWithoutDepartureArrival();
     void loadFGFPWithEmbeddedProcedures();
     void loadFGFPWithOldProcedures();
@@ -1,11 +1,68 @@
+#include "config.h"
+
 #include "test_navaids2.hxx"
 
+#include <algorithm>
+#include <memory>
+#include <thread>
+
 #include "test_suite/FGTestApi/testGlobals.hxx"
 #include "test_suite/FGTestApi/NavDataCache.hxx"
 
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/strutils.hxx>
+#include <simgear/timing/timestamp.hxx>
+#include <simgear/xml/easyxml.hxx>
+
+#include <Airports/airport.hxx>
+#include <Main/globals.hxx>
 #include <Navaids/NavDataCache.hxx>
+#include <Navaids/ProcedureCache.hxx>
 #include <Navaids/navrecord.hxx>
 #include <Navaids/navlist.hxx>
+#include <Navaids/procedure.hxx>
+
+using namespace flightgear;
+
+namespace {
+
+// element structure and leaf text of an XML file
+class StructureVisitor : public XMLVisitor
+{
+public:
+    void startElement(const char* name, const XMLAttributes& atts) override
+    {
+        std::string e = std::string("<") + name;
+        for (int i = 0; i < atts.size(); ++i) {
+            e += std::string(" ") + atts.getName(i) + "=" + atts.getValue(i);
+        }
+
+        events.push_back(e);
+        text.clear();
+        leaf = true;
+    }
+
+    void endElement(const char* name) override
+    {
+        if (leaf) {
+            events.push_back(simgear::strutils::strip(text));
+        }
+
+        events.push_back(std::string("</") + name);
+        leaf = false;
+    }
+
+    void data(const char* s, int len) override
+    {
+        text.append(s, len);
+    }
+
+    string_list events;
+    std::string text;
+    bool leaf = false;
+};
+
+} // of anonymous namespace
 
 
 // Set up function for each test.
@@ -34,3 +91,255 @@ void NavaidsTests::testBasic()
     CPPUNIT_ASSERT_EQUAL(tla->get_freq(), 11570);
     CPPUNIT_ASSERT_EQUAL(tla->get_range(), 130);
 }
+
+void NavaidsTests::testSpatialSearch()
+{
+    SGGeod egccPos = SGGeod::fromDeg(-2.27, 53.35);
+    const SGVec3d egccCart = SGVec3d::fromGeod(egccPos);
+    const double rangeNm = 60.0;
+    FGPositioned::TypeFilter filter({FGPositioned::VOR, FGPositioned::NDB, FGPositioned::FIX});
+
+    FGPositionedList inRange = FGPositioned::findWithinRange(egccPos, rangeNm, &filter);
+    CPPUNIT_ASSERT(inRange.size() > 10);
+
+    double previous = 0.0;
+    for (const auto& p : inRange) {
+        const double d = dist(egccCart, p->cart());
+        CPPUNIT_ASSERT(d <= rangeNm * SG_NM_TO_METER);
+        CPPUNIT_ASSERT(d >= previous);
+        CPPUNIT_ASSERT(filter.pass(p));
+        previous = d;
+    }
+
+    // nearest-N matches the start of the full, ordered list
+    FGPositionedList closest = FGPositioned::findClosestN(egccPos, 10, rangeNm, &filter);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(10), closest.size());
+    for (unsigned int i = 0; i < closest.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(inRange[i]->guid(), closest[i]->guid());
+    }
+
+    FGNavRecordRef tnt = FGNavList::findByFreq(115.7, egccPos);
+    auto it = std::find_if(inRange.begin(), inRange.end(), [tnt](const FGPositionedRef& p) {
+        return p->guid() == tnt->guid();
+    });
+    CPPUNIT_ASSERT(it != inRange.end());
+}
+
+void NavaidsTests::testProcedureCache()
+{
+    const SGPath path = SGPath::fromUtf8(FG_TEST_SUITE_DATA) / "EDTY.procedures.xml";
+    const std::string data = ProcedureCache::encode(path);
+    CPPUNIT_ASSERT(data.size() < path.sizeInBytes());
+
+    StructureVisitor parsed, replayed;
+    readXML(path, parsed);
+    CPPUNIT_ASSERT(ProcedureCache::replay(data, replayed));
+    CPPUNIT_ASSERT(!parsed.events.empty());
+    CPPUNIT_ASSERT(parsed.events == replayed.events);
+
+    // damaged data is rejected without calling the visitor
+    StructureVisitor damaged;
+    CPPUNIT_ASSERT(!ProcedureCache::replay(data.substr(0, 8), damaged));
+    CPPUNIT_ASSERT(damaged.events.empty());
+
+    // stored in the cache on first use
+    CPPUNIT_ASSERT_EQUAL(data, ProcedureCache::load(path));
+    CPPUNIT_ASSERT_EQUAL(data, NavDataCache::instance()->readProcedureData(path));
+    CPPUNIT_ASSERT(NavDataCache::instance()->hasProcedureData(path));
+
+    ProcedureCache::prefetch(path);
+    CPPUNIT_ASSERT_EQUAL(0u, ProcedureCache::pendingPrefetches());
+
+    // a new file is parsed in the background, and collected on load
+    SGPath copy = globals->get_fg_home() / "EDTY.procedures.xml";
+    {
+        sg_ifstream in(path);
+        sg_ofstream out(copy);
+        out << in.rdbuf();
+    }
+
+    CPPUNIT_ASSERT(!NavDataCache::instance()->hasProcedureData(copy));
+    ProcedureCache::prefetch(copy);
+    CPPUNIT_ASSERT_EQUAL(1u, ProcedureCache::pendingPrefetches());
+    CPPUNIT_ASSERT_EQUAL(data, ProcedureCache::load(copy));
+    CPPUNIT_ASSERT_EQUAL(0u, ProcedureCache::pendingPrefetches());
+    CPPUNIT_ASSERT(NavDataCache::instance()->hasProcedureData(copy));
+
+    // prefetches which are never collected are bounded, and dropped on reset
+    std::vector<SGPath> copies;
+    for (int i = 0; i < 40; ++i) {
+        SGPath p = globals->get_fg_home() / ("PF" + std::to_string(i) + ".procedures.xml");
+        sg_ifstream in(path);
+        sg_ofstream out(p);
+        out << in.rdbuf();
+        copies.push_back(p);
+    }
+    for (const auto& p : copies) {
+        ProcedureCache::prefetch(p);
+    }
+    CPPUNIT_ASSERT(ProcedureCache::pendingPrefetches() > 0);
+    CPPUNIT_ASSERT(ProcedureCache::pendingPrefetches() <= 32);
+    ProcedureCache::clearPrefetches();
+    CPPUNIT_ASSERT_EQUAL(0u, ProcedureCache::pendingPrefetches());
+    for (auto& p : copies) {
+        p.remove();
+    }
+    copy.remove();
+
+    // procedures built from the stored form
+    auto edty = FGAirport::findByIdent("EDTY");
+    edty->testSuiteInjectProceduresXML(path);
+    Approach* ils28 = edty->findApproachWithIdent("ILS28");
+    CPPUNIT_ASSERT(ils28);
+    CPPUNIT_ASSERT_EQUAL(std::string("28"), ils28->runway()->ident());
+}
+
+void NavaidsTests::testBatchedLoad()
+{
+    auto cache = NavDataCache::instance();
+    auto edty = FGAirport::findByIdent("EDTY");
+    FGNavRecordRef tnt = FGNavList::findByFreq(115.7, SGGeod::fromDeg(-2.27, 53.35));
+
+    // enough items for several batches, some loaded and some not
+    PositionedIDVec ids = cache->airportItemsOfType(edty->guid(), FGPositioned::RUNWAY);
+    for (const auto& p : cache->findAllWithIdent("TNT", nullptr, true)) {
+        ids.push_back(p->guid());
+    }
+    for (const auto& p : cache->findAllWithIdent("EG", nullptr, false)) {
+        ids.push_back(p->guid());
+    }
+    CPPUNIT_ASSERT(ids.size() > 64);
+
+    ids.push_back(tnt->guid());
+    ids.push_back(0);
+
+    const FGPositionedList items = cache->loadByIds(ids);
+    CPPUNIT_ASSERT_EQUAL(ids.size(), items.size());
+    for (size_t i = 0; i + 1 < ids.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(ids[i], items[i]->guid());
+        CPPUNIT_ASSERT(items[i] == cache->loadById(ids[i]));
+    }
+
+    // duplicates share the cached item, the null ID gives a null entry
+    CPPUNIT_ASSERT(items[ids.size() - 2] == tnt);
+    CPPUNIT_ASSERT(!items.back());
+}
+
+void NavaidsTests::testReaderThreads()
+{
+    auto cache = NavDataCache::instance();
+    const FGPositionedList expected = cache->findAllWithIdent("TNT", nullptr, true);
+    CPPUNIT_ASSERT(!expected.empty());
+
+    const int threadCount = 6;
+    std::vector<FGPositionedList> found(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&found, t] {
+            NavDataCache::Reader reader;
+            for (int i = 0; i < 20; ++i) {
+                found[t] = reader.findAllWithIdent("TNT", nullptr, true);
+                reader.findAllWithName("MANCHESTER", nullptr, false);
+            }
+        });
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    // the readers see the items the main thread cached
+    for (const auto& f : found) {
+        CPPUNIT_ASSERT_EQUAL(expected.size(), f.size());
+        for (size_t i = 0; i < f.size(); ++i) {
+            CPPUNIT_ASSERT(f[i] == expected[i]);
+        }
+    }
+
+    // and the main thread the items readers loaded first
+    NavDataCache::Reader reader;
+    const FGPositionedList egll = reader.findAllWithIdent("EGLL", nullptr, true);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), egll.size());
+    CPPUNIT_ASSERT(egll.front() == FGAirport::findByIdent("EGLL"));
+
+    // with every pooled connection leased, the GUI search opens its own
+    // rather than waiting for a reader to finish
+    std::vector<std::unique_ptr<NavDataCache::Reader>> held;
+    for (int r = 0; r < 3; ++r) { // and the reader above
+        held.emplace_back(new NavDataCache::Reader);
+    }
+
+    NavDataCache::ThreadedGUISearch search("TRENT", false, 10);
+    for (int i = 0; (i < 1000) && !search.isComplete(); ++i) {
+        SGTimeStamp::sleepForMSec(10);
+    }
+    CPPUNIT_ASSERT(search.isComplete());
+    CPPUNIT_ASSERT(!search.results().empty());
+}
+
+void NavaidsTests::testNameSearch()
+{
+    auto cache = NavDataCache::instance();
+    auto firstEntry = [](char** entries) {
+        std::string r = entries[0] ? entries[0] : "";
+        for (char** e = entries; *e; ++e) {
+            free(*e);
+        }
+        free(entries);
+        return r;
+    };
+
+    // ident matches rank first, then names starting with the term
+    const std::string egll = firstEntry(cache->searchAirportNamesAndIdents("EGLL"));
+    CPPUNIT_ASSERT(simgear::strutils::ends_with(egll, "(EGLL)"));
+    const std::string egllLower = firstEntry(cache->searchAirportNamesAndIdents("egll"));
+    CPPUNIT_ASSERT(simgear::strutils::ends_with(egllLower, "(EGLL)"));
+    const std::string heathrow = firstEntry(cache->searchAirportNamesAndIdents("heathrow"));
+    CPPUNIT_ASSERT(heathrow.find("(EGLL)") != std::string::npos);
+
+    // infix matches are found, down to two characters
+    auto contains = [](char** entries, const std::string& ident) {
+        bool found = false;
+        int count = 0;
+        for (char** e = entries; *e; ++e, ++count) {
+            found |= (std::string(*e).find("(" + ident + ")") != std::string::npos);
+            free(*e);
+        }
+        free(entries);
+        return found ? count : -count;
+    };
+
+    CPPUNIT_ASSERT(contains(cache->searchAirportNamesAndIdents("GLL"), "EGLL") > 0);
+    CPPUNIT_ASSERT(contains(cache->searchAirportNamesAndIdents("GL"), "EGLL") > 0);
+
+    // and limited
+    CPPUNIT_ASSERT_EQUAL(-5, contains(cache->searchAirportNamesAndIdents("GL", 5), "NONE"));
+    CPPUNIT_ASSERT(!firstEntry(cache->searchAirportNamesAndIdents("x")).empty());
+    CPPUNIT_ASSERT(firstEntry(cache->searchAirportNamesAndIdents("QQQZZZQQQ")).empty());
+
+    // the launcher search sees navaid names too
+    NavDataCache::ThreadedGUISearch search("TRENT", false, 10);
+    for (int i = 0; (i < 1000) && !search.isComplete(); ++i) {
+        SGTimeStamp::sleepForMSec(10);
+    }
+    CPPUNIT_ASSERT(search.isComplete());
+
+    const PositionedIDVec ids = search.results();
+    CPPUNIT_ASSERT(!ids.empty() && (ids.size() <= 10));
+    FGNavRecordRef tnt = FGNavList::findByFreq(115.7, SGGeod::fromDeg(-2.27, 53.35));
+    CPPUNIT_ASSERT(std::find(ids.begin(), ids.end(), tnt->guid()) != ids.end());
+
+    // and fix names
+    FGPositioned::TypeFilter fixFilter(FGPositioned::FIX);
+    FGPositionedRef tirav = FGPositioned::findFirstWithIdent("TIRAV", &fixFilter);
+    CPPUNIT_ASSERT(tirav);
+
+    NavDataCache::ThreadedGUISearch fixSearch("TIRAV", false, 10);
+    for (int i = 0; (i < 1000) && !fixSearch.isComplete(); ++i) {
+        SGTimeStamp::sleepForMSec(10);
+    }
+    CPPUNIT_ASSERT(fixSearch.isComplete());
+
+    const PositionedIDVec fixIds = fixSearch.results();
+    CPPUNIT_ASSERT(std::find(fixIds.begin(), fixIds.end(), tirav->guid()) != fixIds.end());
+}
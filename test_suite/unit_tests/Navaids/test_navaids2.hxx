@@ -32,6 +32,11 @@ class NavaidsTests : public CppUnit::TestFixture
     // Set up the test suite.
     CPPUNIT_TEST_SUITE(NavaidsTests);
     CPPUNIT_TEST(testBasic);
+    CPPUNIT_TEST(testSpatialSearch);
+    CPPUNIT_TEST(testProcedureCache);
+    CPPUNIT_TEST(testBatchedLoad);
+    CPPUNIT_TEST(testReaderThreads);
+    CPPUNIT_TEST(testNameSearch);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -43,6 +48,11 @@ public:
 
     // The tests.
     void testBasic();
+    void testSpatialSearch();
+    void testProcedureCache();
+    void testBatchedLoad();
+    void testReaderThreads();
+    void testNameSearch();
 };
 
 #endif  // _FG_NAVAIDS_UNIT_TESTS_HXX
@@ -0,0 +1,183 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "test_generic.hxx"
+
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+
+#include "Main/fg_props.hxx"
+#include "Main/globals.hxx"
+#include <Network/generic.hxx>
+
+
+// A mix of all fixed size chunk types, with offsets and factors.
+static const char* mixedChunks = R"(
+    <chunk><type>int</type><node>/test/generic/int</node><factor>3</factor><offset>-2</offset></chunk>
+    <chunk><type>bool</type><node>/test/generic/bool</node></chunk>
+    <chunk><type>fixed</type><node>/test/generic/float</node></chunk>
+    <chunk><type>float</type><node>/test/generic/float</node><factor>0.5</factor></chunk>
+    <chunk><type>double</type><node>/test/generic/double</node><offset>100.25</offset></chunk>
+    <chunk><type>byte</type><node>/test/generic/int</node></chunk>
+    <chunk><type>word</type><node>/test/generic/int</node><factor>10</factor></chunk>
+    <chunk><type>float</type><const>1.5</const></chunk>
+    <chunk><type>double</type><node>/test/generic/float</node></chunk>
+)";
+
+
+// Set up function for each test.
+void GenericProtocolTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("generic");
+
+    _dataDir = simgear::Dir::current().path() / "test_generic_data";
+    simgear::Dir(_dataDir / "Protocol").create(0755);
+    globals->append_data_path(_dataDir);
+
+    fgSetInt("/test/generic/int", 42);
+    fgSetBool("/test/generic/bool", true);
+    fgSetFloat("/test/generic/float", -12.375f);
+    fgSetDouble("/test/generic/double", 4711.0625);
+}
+
+
+// Clean up after each test.
+void GenericProtocolTests::tearDown()
+{
+    simgear::Dir(_dataDir).remove(true);
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+
+void GenericProtocolTests::writeProtocol(const std::string& name, const std::string& header,
+                                         const std::string& chunks, bool precompiled)
+{
+    sg_ofstream s(_dataDir / "Protocol" / (name + ".xml"));
+    s << "<?xml version=\"1.0\"?>\n<PropertyList><generic><output>\n"
+      << "<binary_mode>true</binary_mode>\n"
+      << "<binary_precompiled>" << (precompiled ? "true" : "false") << "</binary_precompiled>\n"
+      << header << chunks
+      << "</output></generic></PropertyList>\n";
+}
+
+
+std::unique_ptr<FGGeneric> GenericProtocolTests::createGeneric(const std::string& name)
+{
+    std::vector<std::string> tokens = {"generic", "file", "out", "10", "generic-test.out", name};
+    std::unique_ptr<FGGeneric> generic(new FGGeneric(tokens));
+    CPPUNIT_ASSERT(generic->getInitOk());
+    return generic;
+}
+
+
+// Check that the precompiled encoder produces exactly the bytes of the
+// per-chunk encoder.
+void GenericProtocolTests::compareEncoders(const std::string& header, const std::string& chunks)
+{
+    writeProtocol("test-plan", header, chunks, true);
+    writeProtocol("test-chunks", header, chunks, false);
+    auto plan = createGeneric("test-plan");
+    auto perChunk = createGeneric("test-chunks");
+    CPPUNIT_ASSERT(!perChunk->hasBinaryPlan());
+
+    for (int i = 0; i < 3; ++i) {
+        fgSetInt("/test/generic/int", 42 - 37 * i);
+        fgSetFloat("/test/generic/float", -12.375f + 7.1f * i);
+
+        CPPUNIT_ASSERT(plan->gen_message());
+        CPPUNIT_ASSERT(perChunk->gen_message());
+        CPPUNIT_ASSERT_EQUAL(perChunk->getMessageLength(), plan->getMessageLength());
+        CPPUNIT_ASSERT(memcmp(perChunk->getMessageBuffer(), plan->getMessageBuffer(),
+                              plan->getMessageLength()) == 0);
+    }
+}
+
+
+void GenericProtocolTests::testBinaryPlanNetworkOrder()
+{
+    compareEncoders("<byte_order>network</byte_order><binary_footer>magic,0x12345678</binary_footer>\n",
+                    mixedChunks);
+
+    auto plan = createGeneric("test-plan");
+    CPPUNIT_ASSERT(plan->hasBinaryPlan());
+}
+
+
+void GenericProtocolTests::testBinaryPlanHostOrder()
+{
+    compareEncoders("<byte_order>host</byte_order><binary_footer>length</binary_footer>\n",
+                    mixedChunks);
+}
+
+
+void GenericProtocolTests::testBinaryPlanWithString()
+{
+    // strings have no fixed position, so the chunk encoder is used
+    writeProtocol("test-string", "",
+                  "<chunk><type>int</type><node>/test/generic/int</node></chunk>\n"
+                  "<chunk><type>string</type><node>/sim/aircraft</node></chunk>\n", true);
+    auto generic = createGeneric("test-string");
+    CPPUNIT_ASSERT(!generic->hasBinaryPlan());
+    CPPUNIT_ASSERT(generic->gen_message());
+}
+
+
+// A large message of many chunks reading many nodes: every byte of the
+// precompiled encoder's output must match the per-chunk encoder's, over
+// frames in which every value changes.
+void GenericProtocolTests::testBinaryPlanLargeMessage()
+{
+    const int count = 50;
+    std::ostringstream chunks;
+    for (int i = 0; i < count; ++i) {
+        chunks << "<chunk><type>float</type><node>/test/generic/large/float[" << i << "]</node><factor>2</factor></chunk>\n"
+               << "<chunk><type>double</type><node>/test/generic/large/double[" << i << "]</node></chunk>\n"
+               << "<chunk><type>int</type><node>/test/generic/large/int[" << i << "]</node></chunk>\n"
+               << "<chunk><type>bool</type><node>/test/generic/large/bool[" << i << "]</node></chunk>\n";
+    }
+    writeProtocol("test-plan", "<byte_order>network</byte_order>\n", chunks.str(), true);
+    writeProtocol("test-chunks", "<byte_order>network</byte_order>\n", chunks.str(), false);
+    auto plan = createGeneric("test-plan");
+    auto perChunk = createGeneric("test-chunks");
+    CPPUNIT_ASSERT(plan->hasBinaryPlan());
+    CPPUNIT_ASSERT(!perChunk->hasBinaryPlan());
+
+    for (int frame = 0; frame < 10; ++frame) {
+        for (int i = 0; i < count; ++i) {
+            const std::string index = "[" + std::to_string(i) + "]";
+            fgSetFloat("/test/generic/large/float" + index, 0.37f * i - 3.5f * frame);
+            fgSetDouble("/test/generic/large/double" + index, 1e6 / (i + 1) + frame * 0.001);
+            fgSetInt("/test/generic/large/int" + index, (i * 7919 - frame * 104729) % 65536);
+            fgSetBool("/test/generic/large/bool" + index, ((i + frame) % 3) == 0);
+        }
+
+        CPPUNIT_ASSERT(plan->gen_message());
+        CPPUNIT_ASSERT(perChunk->gen_message());
+        CPPUNIT_ASSERT_EQUAL(perChunk->getMessageLength(), plan->getMessageLength());
+        CPPUNIT_ASSERT_EQUAL(count * (4 + 8 + 4 + 1), plan->getMessageLength());
+        CPPUNIT_ASSERT(memcmp(perChunk->getMessageBuffer(), plan->getMessageBuffer(),
+                              plan->getMessageLength()) == 0);
+    }
+}
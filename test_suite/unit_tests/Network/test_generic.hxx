@@ -0,0 +1,63 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+
+#include <simgear/misc/sg_path.hxx>
+
+#include <memory>
+#include <string>
+
+class FGGeneric;
+
+
+// The unit tests of the generic protocol.
+class GenericProtocolTests : public CppUnit::TestFixture
+{
+    // Set up the test suite.
+    CPPUNIT_TEST_SUITE(GenericProtocolTests);
+    CPPUNIT_TEST(testBinaryPlanNetworkOrder);
+    CPPUNIT_TEST(testBinaryPlanHostOrder);
+    CPPUNIT_TEST(testBinaryPlanWithString);
+    CPPUNIT_TEST(testBinaryPlanLargeMessage);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    // Set up function for each test.
+    void setUp();
+
+    // Clean up after each test.
+    void tearDown();
+
+    // The tests.
+    void testBinaryPlanNetworkOrder();
+    void testBinaryPlanHostOrder();
+    void testBinaryPlanWithString();
+    void testBinaryPlanLargeMessage();
+
+private:
+    void writeProtocol(const std::string& name, const std::string& header,
+                       const std::string& chunks, bool precompiled);
+    std::unique_ptr<FGGeneric> createGeneric(const std::string& name);
+    void compareEncoders(const std::string& header, const std::string& chunks);
+
+    SGPath _dataDir;
+};
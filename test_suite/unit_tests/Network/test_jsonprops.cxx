@@ -0,0 +1,129 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "test_jsonprops.hxx"
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+#include <Network/http/jsonprops.hxx>
+
+using flightgear::http::JSON;
+using flightgear::http::JSONPropertyWriter;
+
+
+// Set up function for each test.
+void JsonPropsTests::setUp()
+{
+    _root = new SGPropertyNode;
+
+    // every value type, awkward numbers and strings, indexed and nested nodes
+    SGPropertyNode* test = _root->getNode("test", true);
+    test->setBoolValue("bool-true", true);
+    test->setBoolValue("bool-false", false);
+    test->setIntValue("int", -42);
+    test->setLongValue("long", 1234567890123LL);
+    test->setFloatValue("float", 0.1f);
+    test->setDoubleValue("double", 3.141592653589793);
+    test->setDoubleValue("tiny", 1.5e-12);
+    test->setDoubleValue("huge", 6.02e23);
+    test->setDoubleValue("integral", 1e9);
+    test->setDoubleValue("negative-zero", -0.0);
+    test->setDoubleValue("nan", std::numeric_limits<double>::quiet_NaN());
+    test->setStringValue("string", "plain");
+    test->setStringValue("escapes", "quote\" backslash\\ tab\t newline\n control\x01 slash/");
+    test->setStringValue("utf8", "Z\xc3\xbcrich \xe2\x82\xac");
+    test->setStringValue("empty", "");
+    test->getNode("no-value", true);
+
+    for (int i = 0; i < 3; ++i) {
+        SGPropertyNode* item = test->getNode("item", i, true);
+        item->setIntValue("id", i);
+        item->getNode("deeper", true)->setStringValue("leaf", "x");
+    }
+}
+
+
+// Clean up after each test.
+void JsonPropsTests::tearDown()
+{
+    _root.clear();
+}
+
+
+std::string JsonPropsTests::cjsonText(SGPropertyNode_ptr n, int depth, double timestamp)
+{
+    cJSON* json = JSON::toJson(n, depth, timestamp);
+    char* text = cJSON_PrintUnformatted(json);
+    std::string result(text);
+    free(text);
+    cJSON_Delete(json);
+    return result;
+}
+
+
+void JsonPropsTests::testWriterMatchesCJSON()
+{
+    SGPropertyNode_ptr test = _root->getNode("test");
+    const double timestamps[] = {-1.0, 0.0, 12345.678};
+
+    for (int depth = 0; depth <= 4; ++depth) {
+        for (double ts : timestamps) {
+            std::string out;
+            JSONPropertyWriter writer(test, depth, ts);
+            CPPUNIT_ASSERT(writer.write(out));
+            CPPUNIT_ASSERT_EQUAL(cjsonText(test, depth, ts), out);
+            CPPUNIT_ASSERT_EQUAL(out, JSON::toJsonString(false, test, depth, ts));
+        }
+    }
+
+    // single values, and the root itself
+    for (int i = 0; i < test->nChildren(); ++i) {
+        SGPropertyNode_ptr child = test->getChild(i);
+        std::string out;
+        JSONPropertyWriter(child, 1).write(out);
+        CPPUNIT_ASSERT_EQUAL(cjsonText(child, 1, -1.0), out);
+    }
+
+    std::string out;
+    JSONPropertyWriter(_root, 1).write(out);
+    CPPUNIT_ASSERT_EQUAL(cjsonText(_root, 1, -1.0), out);
+}
+
+
+void JsonPropsTests::testChunkedWriterMatchesCJSON()
+{
+    SGPropertyNode_ptr test = _root->getNode("test");
+    const std::string expected = cjsonText(test, 3, 1.0);
+
+    for (size_t maxNodes = 1; maxNodes <= 5; ++maxNodes) {
+        JSONPropertyWriter writer(test, 3, 1.0);
+        std::string out;
+        int chunks = 0;
+        while (!writer.write(out, maxNodes)) {
+            ++chunks;
+            CPPUNIT_ASSERT(chunks < 1000);
+        }
+
+        CPPUNIT_ASSERT(writer.isComplete());
+        CPPUNIT_ASSERT(chunks > 0);
+        CPPUNIT_ASSERT_EQUAL(expected, out);
+    }
+}
@@ -0,0 +1,447 @@
+/*
+ * This file is part of the program FlightGear.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "test_electrical.hxx"
+
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+
+#include "Main/fg_props.hxx"
+#include "Main/globals.hxx"
+#include <Systems/electrical.hxx>
+
+
+// A battery and an engine driven alternator feeding one bus with a radio
+// on it.  The bus also charges the battery when the alternator is running.
+static const char* smallNetwork = R"(
+    <supplier>
+      <name>Battery</name>
+      <kind>battery</kind>
+      <volts>24</volts>
+      <amp-hours>40</amp-hours>
+      <percent-remaining>0.5</percent-remaining>
+    </supplier>
+    <supplier>
+      <name>Alternator</name>
+      <kind>alternator</kind>
+      <volts>28</volts>
+      <rpm-source>/engines/engine[0]/rpm</rpm-source>
+      <amps>60</amps>
+    </supplier>
+    <bus>
+      <name>Main Bus</name>
+      <prop>/systems/electrical/test/main-bus</prop>
+    </bus>
+    <output>
+      <name>Radio</name>
+      <rated-draw>5</rated-draw>
+      <prop>/systems/electrical/outputs/test-radio</prop>
+    </output>
+    <connector>
+      <input>Battery</input>
+      <output>Main Bus</output>
+      <switch><prop>/controls/engines/engine[0]/master-bat</prop></switch>
+    </connector>
+    <connector>
+      <input>Alternator</input>
+      <output>Main Bus</output>
+      <switch><prop>/controls/engines/engine[0]/master-alt</prop></switch>
+    </connector>
+    <connector>
+      <input>Main Bus</input>
+      <output>Radio</output>
+      <switch><prop>/controls/switches/test-radio</prop></switch>
+    </connector>
+    <connector>
+      <input>Main Bus</input>
+      <output>Battery</output>
+      <switch><prop>/controls/engines/engine[0]/master-bat</prop></switch>
+    </connector>
+)";
+
+// the output voltage of a 24V battery at 50% charge
+static const float halfBatteryVolts = 24.0f * (32.0f - 1.0f / 32.0f) / 32.0f;
+
+
+// Set up function for each test.
+void ElectricalTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("electrical");
+
+    _dataDir = simgear::Dir::current().path() / "test_electrical_data";
+    simgear::Dir(_dataDir).create(0755);
+
+    fgSetBool("/systems/electrical/serviceable", true);
+}
+
+
+// Clean up after each test.
+void ElectricalTests::tearDown()
+{
+    simgear::Dir(_dataDir).remove(true);
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+
+std::unique_ptr<FGElectricalSystem>
+ElectricalTests::createSystem(const std::string& name, const std::string& components,
+                              const std::string& bus)
+{
+    const SGPath path = _dataDir / (name + ".xml");
+    {
+        sg_ofstream s(path);
+        s << "<?xml version=\"1.0\"?>\n<PropertyList>\n" << components << "</PropertyList>\n";
+    }
+
+    SGPropertyNode_ptr config = new SGPropertyNode;
+    config->setStringValue("path", path.utf8Str());
+
+    std::unique_ptr<FGElectricalSystem> system(new FGElectricalSystem(config));
+    system->bind();
+    system->init();
+    CPPUNIT_ASSERT(system->find(bus) != nullptr);
+    return system;
+}
+
+
+void ElectricalTests::testSwitchedOff()
+{
+    auto system = createSystem("switched-off", smallNetwork);
+    fgSetBool("/controls/engines/engine[0]/master-bat", false);
+    fgSetBool("/controls/engines/engine[0]/master-alt", false);
+
+    system->update(0.1);
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, system->find("Main Bus")->get_volts(), 1e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, system->find("Radio")->get_volts(), 1e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, fgGetDouble("/systems/electrical/volts"), 1e-6);
+}
+
+
+void ElectricalTests::testBatteryOnly()
+{
+    auto system = createSystem("battery-only", smallNetwork);
+    fgSetBool("/controls/engines/engine[0]/master-bat", true);
+    fgSetBool("/controls/engines/engine[0]/master-alt", false);
+
+    system->update(0.1);
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(halfBatteryVolts, fgGetDouble("/systems/electrical/test/main-bus"), 1e-4);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(halfBatteryVolts, fgGetDouble("/systems/electrical/outputs/test-radio"), 1e-4);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0, system->find("Main Bus")->get_load_amps(), 1e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(24.0, fgGetDouble("/systems/electrical/volts"), 1e-6);
+}
+
+
+void ElectricalTests::testAlternatorCharging()
+{
+    auto system = createSystem("charging", smallNetwork);
+    fgSetBool("/controls/engines/engine[0]/master-bat", true);
+    fgSetBool("/controls/engines/engine[0]/master-alt", true);
+    fgSetDouble("/engines/engine[0]/rpm", 2000.0);
+
+    auto battery = static_cast<FGElectricalSupplier*>(system->find("Battery"));
+    const float voltsBefore = battery->get_output_volts();
+
+    system->update(1.0);
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(28.0, fgGetDouble("/systems/electrical/test/main-bus"), 1e-4);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(28.0, fgGetDouble("/systems/electrical/outputs/test-radio"), 1e-4);
+    // the radio and the battery charge current
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0 + 7.0, system->find("Main Bus")->get_load_amps(), 1e-6);
+    CPPUNIT_ASSERT(battery->get_output_volts() > voltsBefore);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(28.0, fgGetDouble("/systems/electrical/volts"), 1e-6);
+}
+
+
+void ElectricalTests::testOpenSwitch()
+{
+    auto system = createSystem("open-switch", smallNetwork);
+    fgSetBool("/controls/engines/engine[0]/master-bat", true);
+    fgSetBool("/controls/engines/engine[0]/master-alt", false);
+    fgSetBool("/controls/switches/test-radio", false);
+
+    system->update(0.1);
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(halfBatteryVolts, system->find("Main Bus")->get_volts(), 1e-4);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, system->find("Radio")->get_volts(), 1e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, system->find("Main Bus")->get_load_amps(), 1e-6);
+}
+
+
+// The recursive propagation FGElectricalSystem used before it compiled
+// its network, as the reference the compiled form has to match exactly.
+static float legacyPropagate(FGElectricalComponent* node, double dt,
+                             float input_volts, float input_amps)
+{
+    float total_load = 0.0;
+
+    // determine the current to carry forward
+    float volts = 0.0;
+    if (node->get_kind() == FGElectricalComponent::FG_SUPPLIER) {
+        auto supplier = static_cast<FGElectricalSupplier*>(node);
+        if (supplier->get_model() == FGElectricalSupplier::FG_BATTERY) {
+            float battery_volts = supplier->get_output_volts();
+            if (battery_volts < (input_volts - 0.1)) {
+                // special handling of a battery charge condition
+                supplier->apply_load(-supplier->get_charge_amps(), dt);
+                return supplier->get_charge_amps();
+            }
+        }
+        volts = input_volts;
+    } else if (node->get_kind() == FGElectricalComponent::FG_BUS) {
+        volts = input_volts;
+    } else if (node->get_kind() == FGElectricalComponent::FG_OUTPUT) {
+        volts = input_volts;
+        if (volts > 1.0) {
+            // draw current if we have voltage
+            total_load = node->get_load_amps();
+        }
+    } else if (node->get_kind() == FGElectricalComponent::FG_CONNECTOR) {
+        if (static_cast<FGElectricalConnector*>(node)->get_state()) {
+            volts = input_volts;
+        }
+    }
+
+    // if this node has found a stronger power source, update the
+    // value and propagate to all children
+    if (volts <= node->get_volts()) {
+        return 0.0;
+    }
+
+    node->set_volts(volts);
+    for (int i = 0; i < node->get_num_outputs(); ++i) {
+        FGElectricalComponent* child = node->get_output(i);
+        // send current equal to load
+        total_load += legacyPropagate(child, dt, volts, child->get_load_amps());
+    }
+
+    if (node->get_kind() != FGElectricalComponent::FG_OUTPUT) {
+        node->set_load_amps(total_load);
+    }
+    node->set_available_amps(input_amps - total_load);
+    node->publishVoltageToProps();
+    return total_load;
+}
+
+
+// The legacy FGElectricalSystem::update() propagation: externals first,
+// then alternators, then batteries.
+static void legacyUpdate(const std::vector<FGElectricalComponent*>& components,
+                         const std::vector<FGElectricalSupplier*>& suppliers,
+                         double dt)
+{
+    for (auto c : components) {
+        c->set_volts(0.0);
+    }
+
+    for (auto model : {FGElectricalSupplier::FG_EXTERNAL,
+                       FGElectricalSupplier::FG_ALTERNATOR,
+                       FGElectricalSupplier::FG_BATTERY}) {
+        for (auto supplier : suppliers) {
+            if (supplier->get_model() == model) {
+                float load = legacyPropagate(supplier, dt,
+                                             supplier->get_output_volts(),
+                                             supplier->get_output_amps());
+                supplier->apply_load(load, dt);
+            }
+        }
+    }
+}
+
+
+// Every component downstream of the suppliers, in a fixed order.
+static std::vector<FGElectricalComponent*>
+collectComponents(const std::vector<FGElectricalSupplier*>& suppliers)
+{
+    std::vector<FGElectricalComponent*> components;
+    std::set<FGElectricalComponent*> seen;
+    std::vector<FGElectricalComponent*> pending(suppliers.rbegin(), suppliers.rend());
+    while (!pending.empty()) {
+        FGElectricalComponent* c = pending.back();
+        pending.pop_back();
+        if (!seen.insert(c).second) {
+            continue;
+        }
+        components.push_back(c);
+        for (int i = c->get_num_outputs() - 1; i >= 0; --i) {
+            pending.push_back(c->get_output(i));
+        }
+    }
+    return components;
+}
+
+
+// A network the size of an airliner's: four engine alternators, two
+// batteries and ground power feeding twenty buses, with 400 switched
+// loads.  One copy runs the compiled propagation, the other the legacy
+// recursive one, through a sequence of engine, switch and load changes;
+// every component must end each frame in the identical state.
+void ElectricalTests::testAirlinerEquivalence()
+{
+    const int numEngines = 4;
+    const int numBatteries = 2;
+    const int numDistBuses = 13;
+    const int numOutputs = 400;
+
+    std::ostringstream xml;
+    std::vector<std::string> supplierNames;
+    for (int e = 0; e < numEngines; ++e) {
+        xml << "<supplier><name>Gen " << e << "</name><kind>alternator</kind><volts>28</volts>"
+            << "<rpm-source>/engines/engine[" << e << "]/rpm</rpm-source><amps>200</amps></supplier>\n"
+            << "<bus><name>Gen Bus " << e << "</name></bus>\n"
+            << "<connector><input>Gen " << e << "</input><output>Gen Bus " << e << "</output>"
+            << "<switch><prop>/controls/electric/engine[" << e << "]/generator</prop></switch></connector>\n";
+        supplierNames.push_back("Gen " + std::to_string(e));
+    }
+    for (int b = 0; b < numBatteries; ++b) {
+        xml << "<supplier><name>Battery " << b << "</name><kind>battery</kind><volts>24</volts>"
+            << "<percent-remaining>0.8</percent-remaining></supplier>\n"
+            << "<bus><name>Battery Bus " << b << "</name></bus>\n"
+            << "<connector><input>Battery " << b << "</input><output>Battery Bus " << b << "</output>"
+            << "<switch><prop>/controls/electric/battery[" << b << "]</prop></switch></connector>\n"
+            << "<connector><input>Battery Bus " << b << "</input><output>Battery " << b << "</output>"
+            << "<switch><prop>/controls/electric/battery[" << b << "]</prop></switch></connector>\n";
+        supplierNames.push_back("Battery " + std::to_string(b));
+    }
+    xml << "<supplier><name>Ground Power</name><kind>external</kind><volts>28</volts><amps>400</amps></supplier>\n"
+        << "<bus><name>External Bus</name></bus>\n"
+        << "<connector><input>Ground Power</input><output>External Bus</output>"
+        << "<switch><prop>/controls/electric/external-power</prop><initial-state>off</initial-state></switch></connector>\n";
+    supplierNames.push_back("Ground Power");
+    for (int e = 0; e < numEngines; ++e) {
+        xml << "<connector><input>External Bus</input><output>Gen Bus " << e << "</output>"
+            << "<switch><prop>/controls/electric/external-power</prop><initial-state>off</initial-state></switch></connector>\n";
+    }
+    for (int d = 0; d < numDistBuses; ++d) {
+        xml << "<bus><name>Dist Bus " << d << "</name></bus>\n";
+        for (int feed : {d % numEngines, (d + 1) % numEngines}) {
+            xml << "<connector><input>Gen Bus " << feed << "</input><output>Dist Bus " << d << "</output>"
+                << "<switch><prop>/controls/electric/tie[" << d << "]</prop></switch></connector>\n";
+        }
+        xml << "<connector><input>Battery Bus " << d % numBatteries << "</input><output>Dist Bus " << d << "</output>"
+            << "<switch><prop>/controls/electric/tie[" << d << "]</prop></switch></connector>\n";
+    }
+
+    // spread the loads over all buses
+    const int numBuses = numEngines + numBatteries + 1 + numDistBuses;
+    std::vector<std::string> busNames;
+    for (int e = 0; e < numEngines; ++e) busNames.push_back("Gen Bus " + std::to_string(e));
+    for (int b = 0; b < numBatteries; ++b) busNames.push_back("Battery Bus " + std::to_string(b));
+    busNames.push_back("External Bus");
+    for (int d = 0; d < numDistBuses; ++d) busNames.push_back("Dist Bus " + std::to_string(d));
+    CPPUNIT_ASSERT_EQUAL(numBuses, static_cast<int>(busNames.size()));
+
+    for (int o = 0; o < numOutputs; ++o) {
+        xml << "<output><name>Load " << o << "</name><rated-draw>" << 0.5 + (o % 10) * 0.25 << "</rated-draw>"
+            << "<prop>/systems/electrical/outputs/load[" << o << "]</prop></output>\n"
+            << "<connector><input>" << busNames[o % numBuses] << "</input><output>Load " << o << "</output>"
+            << "<switch><prop>/controls/electric/load[" << o << "]</prop></switch></connector>\n";
+    }
+
+    auto compiled = createSystem("airliner-compiled", xml.str(), "Gen Bus 0");
+    auto legacy = createSystem("airliner-legacy", xml.str(), "Gen Bus 0");
+
+    auto suppliersOf = [&supplierNames](FGElectricalSystem& system) {
+        std::vector<FGElectricalSupplier*> suppliers;
+        for (const auto& name : supplierNames) {
+            suppliers.push_back(static_cast<FGElectricalSupplier*>(system.find(name)));
+            CPPUNIT_ASSERT(suppliers.back() != nullptr);
+        }
+        return suppliers;
+    };
+    const auto compiledSuppliers = suppliersOf(*compiled);
+    const auto legacySuppliers = suppliersOf(*legacy);
+    const auto compiledComponents = collectComponents(compiledSuppliers);
+    const auto legacyComponents = collectComponents(legacySuppliers);
+    CPPUNIT_ASSERT_EQUAL(legacyComponents.size(), compiledComponents.size());
+
+    for (int e = 0; e < numEngines; ++e) {
+        fgSetDouble("/engines/engine[" + std::to_string(e) + "]/rpm", 3000.0);
+    }
+
+    for (int frame = 0; frame < 200; ++frame) {
+        switch (frame) {
+        case 20: // an engine winds down
+            fgSetDouble("/engines/engine[1]/rpm", 0.0);
+            break;
+        case 40: // a generator is switched off
+            fgSetBool("/controls/electric/engine[2]/generator", false);
+            break;
+        case 60: // ground power connected
+            fgSetBool("/controls/electric/external-power", true);
+            break;
+        case 80: // a third of the loads switched off
+            for (int o = 0; o < numOutputs; o += 3) {
+                fgSetBool("/controls/electric/load[" + std::to_string(o) + "]", false);
+            }
+            break;
+        case 100: // a bus tie opened
+            fgSetBool("/controls/electric/tie[5]", false);
+            break;
+        case 120: // batteries only
+            fgSetBool("/controls/electric/external-power", false);
+            for (int e = 0; e < numEngines; ++e) {
+                fgSetDouble("/engines/engine[" + std::to_string(e) + "]/rpm", 0.0);
+            }
+            break;
+        case 150: // engines back, recharging the batteries
+            fgSetBool("/controls/electric/engine[2]/generator", true);
+            for (int e = 0; e < numEngines; ++e) {
+                fgSetDouble("/engines/engine[" + std::to_string(e) + "]/rpm", 3000.0);
+            }
+            break;
+        }
+
+        compiled->update(0.02);
+        legacyUpdate(legacyComponents, legacySuppliers, 0.02);
+
+        for (std::size_t i = 0; i < compiledComponents.size(); ++i) {
+            const auto c = compiledComponents[i];
+            const auto l = legacyComponents[i];
+            CPPUNIT_ASSERT_EQUAL(l->get_kind(), c->get_kind());
+            CPPUNIT_ASSERT_EQUAL(l->get_volts(), c->get_volts());
+            CPPUNIT_ASSERT_EQUAL(l->get_load_amps(), c->get_load_amps());
+            if (c->get_volts() > 0.0) {
+                CPPUNIT_ASSERT_EQUAL(l->get_available_amps(), c->get_available_amps());
+            }
+        }
+        for (std::size_t i = 0; i < compiledSuppliers.size(); ++i) {
+            CPPUNIT_ASSERT_EQUAL(legacySuppliers[i]->get_output_volts(),
+                                 compiledSuppliers[i]->get_output_volts());
+        }
+
+        // the scenario does reach the states it is meant to
+        if (frame == 0) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(28.0, compiled->find("Dist Bus 0")->get_volts(), 1e-4);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, compiled->find("External Bus")->get_volts(), 1e-6);
+        } else if (frame == 60) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(28.0, compiled->find("External Bus")->get_volts(), 1e-4);
+        } else if (frame == 120) {
+            const float volts = compiled->find("Dist Bus 0")->get_volts();
+            CPPUNIT_ASSERT(volts > 0.0 && volts < 28.0);
+        }
+    }
+}
@@ -20,13 +20,20 @@
 #include <config.h>
 #endif
 
-#include <iostream>
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <osg/ArgumentParser>
 #include <osg/Image>
 
+#include <simgear/bucket/newbucket.hxx>
 #include <simgear/props/props.hxx>
 #include <simgear/props/props_io.hxx>
 #include <simgear/misc/sg_path.hxx>
@@ -88,6 +95,201 @@ intersect(sg::BVHNode& node, sg::BVHPager& pager,
     return true;
 }
 
+static std::mutex holeMessageMutex;
+
+// Intersect the vertical at lon/lat, retrying with growing offsets when
+// the line happens to pass through a hole in the terrain mesh.
+static bool
+findElevation(sg::BVHNode& node, sg::BVHPager& pager, double lon, double lat,
+              double& elevation, bool& solid)
+{
+    SGVec3d start = SGVec3d::fromGeod(SGGeod::fromDegM(lon, lat, 10000));
+    SGVec3d end = SGVec3d::fromGeod(SGGeod::fromDegM(lon, lat, -1000));
+
+    const simgear::BVHMaterial* material = NULL;
+    // Try to find an intersection
+    bool found = intersect(node, pager, start, end, 0, &material);
+    double scale = 1e-5;
+    while (!found && scale <= 1) {
+        found = intersect(node, pager, start, end, scale, &material);
+        scale *= 2;
+    }
+    if (1e-5 < scale) {
+        std::lock_guard<std::mutex> lock(holeMessageMutex);
+        std::cerr << "Found hole of minimum diameter "
+                  << scale << "m at lon = " << lon
+                  << "deg lat = " << lat << "deg" << std::endl;
+    }
+
+    solid = material && material->get_solid();
+    if (!found) {
+        elevation = -1000;
+        return false;
+    }
+    elevation = SGGeod::fromCart(end).getElevationM();
+    return true;
+}
+
+/// Batch mode: points are read in blocks, sorted by tile so that each
+/// thread works on a compact area, and answered in input order.
+namespace batch {
+
+struct Point {
+    std::string id;
+    uint64_t binaryId = 0;
+    double lon = 0;
+    double lat = 0;
+    long tile = 0;
+    double elevation = -1000;
+    bool found = false;
+    bool solid = false;
+};
+
+// Every thread pages its own copy of the world tree. Loading a page
+// modifies the tree, so pagers cannot share one.
+struct Worker {
+    SGSharedPtr<sg::BVHNode> node;
+    sg::BVHPager pager;
+};
+
+static bool
+readText(std::istream& in, Point& point)
+{
+    in >> point.id >> point.lon >> point.lat;
+    if (in.fail())
+        return false;
+    in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    return true;
+}
+
+// Binary input records are a uint64 id followed by lon and lat as
+// doubles, all in host byte order.
+static bool
+readBinary(std::istream& in, Point& point)
+{
+    double lonlat[2];
+    if (!in.read(reinterpret_cast<char*>(&point.binaryId), sizeof(point.binaryId)))
+        return false;
+    if (!in.read(reinterpret_cast<char*>(lonlat), sizeof(lonlat)))
+        return false;
+    point.lon = lonlat[0];
+    point.lat = lonlat[1];
+    return true;
+}
+
+static void
+writeText(std::ostream& out, const Point& point, bool binaryInput, bool printSolidness)
+{
+    if (binaryInput)
+        out << point.binaryId << ": ";
+    else
+        out << point.id << ": ";
+    if (!point.found) {
+        out << "-1000\n";
+        return;
+    }
+    out << std::fixed << std::setprecision(3) << point.elevation;
+    if (printSolidness)
+        out << " " << (point.solid ? "solid" : "-");
+    out << "\n";
+}
+
+// Binary output records are a uint64 id, the elevation as a double
+// (-1000 when not found) and one byte that is 1 for solid ground.
+static void
+writeBinary(std::ostream& out, const Point& point)
+{
+    uint8_t solid = point.solid ? 1 : 0;
+    out.write(reinterpret_cast<const char*>(&point.binaryId), sizeof(point.binaryId));
+    out.write(reinterpret_cast<const char*>(&point.elevation), sizeof(point.elevation));
+    out.write(reinterpret_cast<const char*>(&solid), sizeof(solid));
+}
+
+static void
+process(Worker& worker, std::vector<Point>& points,
+        const std::vector<size_t>& order, size_t begin, size_t end, unsigned expire)
+{
+    for (size_t i = begin; i < end; ++i) {
+        // Same paging policy as the interactive mode, per thread
+        worker.pager.setUseStamp(1 + worker.pager.getUseStamp());
+        worker.pager.update(expire);
+
+        Point& point = points[order[i]];
+        point.found = findElevation(*worker.node, worker.pager, point.lon, point.lat,
+                                    point.elevation, point.solid);
+    }
+}
+
+static int
+run(std::vector<Worker>& workers, size_t blockSize, bool binaryInput,
+    bool binaryOutput, bool printSolidness, unsigned expire)
+{
+    std::vector<Point> points;
+    std::vector<size_t> order;
+    bool eof = false;
+
+    while (!eof) {
+        points.clear();
+        points.reserve(blockSize);
+        while (points.size() < blockSize) {
+            Point point;
+            if (!(binaryInput ? readBinary(std::cin, point) : readText(std::cin, point))) {
+                if (!std::cin.eof())
+                    return EXIT_FAILURE;
+                eof = true;
+                break;
+            }
+            if (!binaryInput && binaryOutput) {
+                char* idEnd = nullptr;
+                point.binaryId = std::strtoull(point.id.c_str(), &idEnd, 10);
+                if (*idEnd != '\0') {
+                    SG_LOG(SG_GENERAL, SG_ALERT, "Binary output needs numeric ids, got '"
+                           << point.id << "'");
+                    return EXIT_FAILURE;
+                }
+            }
+            point.tile = SGBucket(SGGeod::fromDeg(point.lon, point.lat)).gen_index();
+            points.push_back(point);
+        }
+        if (points.empty())
+            break;
+
+        order.resize(points.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&points](size_t a, size_t b) {
+            return points[a].tile < points[b].tile;
+        });
+
+        // Contiguous slices of the sorted block, so each thread keeps
+        // paging in the same few tiles.
+        size_t slice = (order.size() + workers.size() - 1) / workers.size();
+        std::vector<std::thread> threads;
+        for (size_t w = 0; w < workers.size(); ++w) {
+            size_t begin = std::min(order.size(), w * slice);
+            size_t end = std::min(order.size(), begin + slice);
+            if (begin == end)
+                break;
+            threads.emplace_back(process, std::ref(workers[w]), std::ref(points),
+                                 std::cref(order), begin, end, expire);
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        for (const auto& point : points) {
+            if (binaryOutput)
+                writeBinary(std::cout, point);
+            else
+                writeText(std::cout, point, binaryInput, printSolidness);
+        }
+        std::cout.flush();
+    }
+
+    return EXIT_SUCCESS;
+}
+
+} // namespace batch
+
 int
 main(int argc, char** argv)
 {
@@ -102,6 +304,20 @@ main(int argc, char** argv)
 
     bool printSolidness = arguments.read("--print-solidness");
 
+    // Batch mode, enabled by any of its options
+    bool batchMode = arguments.read("--batch");
+    unsigned threads = 0;
+    if (arguments.read("--threads", threads))
+        batchMode = true;
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned blockSize = 65536;
+    if (arguments.read("--block-size", blockSize))
+        batchMode = true;
+    bool binaryInput = arguments.read("--binary-input");
+    bool binaryOutput = arguments.read("--binary-output");
+    batchMode = batchMode || binaryInput || binaryOutput;
+
     std::string fg_root;
     if (arguments.read("--fg-root", fg_root)) {
     } else if (const char *fg_root_env = std::getenv("FG_ROOT")) {
@@ -200,6 +416,21 @@ main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
+    if (batchMode) {
+        std::vector<batch::Worker> workers(threads);
+        workers[0].node = node;
+        for (unsigned i = 1; i < threads; ++i) {
+            workers[i].node = sg::BVHPageNodeOSG::load(bvhFile, options);
+            if (!workers[i].node.valid()) {
+                SG_LOG(SG_GENERAL, SG_ALERT, arguments.getApplicationName()
+                       << ": No data loaded");
+                return EXIT_FAILURE;
+            }
+        }
+        return batch::run(workers, std::max(1u, blockSize), binaryInput,
+                          binaryOutput, printSolidness, expire);
+    }
+
     // We assume that the above is a paged database.
     sg::BVHPager pager;
 
@@ -217,31 +448,17 @@ main(int argc, char** argv)
             return EXIT_FAILURE;
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 
-        SGVec3d start = SGVec3d::fromGeod(SGGeod::fromDegM(lon, lat, 10000));
-        SGVec3d end = SGVec3d::fromGeod(SGGeod::fromDegM(lon, lat, -1000));
-
-        const simgear::BVHMaterial* material = NULL;
-        // Try to find an intersection
-        bool found = intersect(*node, pager, start, end, 0, &material);
-        double scale = 1e-5;
-        while (!found && scale <= 1) {
-            found = intersect(*node, pager, start, end, scale, &material);
-            scale *= 2;
-        }
-        if (1e-5 < scale)
-            std::cerr << "Found hole of minimum diameter "
-                      << scale << "m at lon = " << lon
-                      << "deg lat = " << lat << "deg" << std::endl;
+        double elev;
+        bool solid;
+        bool found = findElevation(*node, pager, lon, lat, elev, solid);
 
         std::cout << id << ": ";
-        string solid = material && material->get_solid() ? "solid" : "-";
         if (!found) {
             std::cout << "-1000" << std::endl;
         } else {
-            SGGeod geod = SGGeod::fromCart(end);
-            std::cout << std::fixed << std::setprecision(3) << geod.getElevationM();
+            std::cout << std::fixed << std::setprecision(3) << elev;
             if( printSolidness )
-                std::cout <<  " " << (material && material->get_solid() ? "solid" : "-");
+                std::cout <<  " " << (solid ? "solid" : "-");
             std::cout << std::endl;
         }
     }